@@ -16,6 +16,7 @@
 #include <cstdlib>
 
 #include <math.h>
+#include <cfloat>
 #include <map>
 #include <iomanip>
 
@@ -49,11 +50,12 @@ Clock::Clock(double starttime, double __dt, double abs_tol, double rel_tol, size
     atol(abs_tol), rtol(rel_tol), 
     acceptability(0.), err_val(0.), 
     failed_steps(0), max_failures(_maxfails), _success(0),
+    _rebalance(false), _rebalance_restart(0),
     Nbc(Input::List().BoundaryCells), world_rank(0), world_size(1),
     Solver(Y)
     {
-        MPI_Comm_rank(MPI_COMM_WORLD, &world_rank); 
-        MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+        MPI_Comm_rank(Time_Decomposition::Slice_Comm(), &world_rank); 
+        MPI_Comm_size(Time_Decomposition::Slice_Comm(), &world_size);
 
         acceptabilitylist = new double[world_size];
 
@@ -82,6 +84,12 @@ Clock::Clock(double starttime, double __dt, double abs_tol, double rel_tol, size
 
         start_time = tout_start*dt_out;
 
+        //  Counted from the actual start, which lies between outputs
+        //  after a restart from the in-memory checkpoints
+        buddy_count = 0;
+        dt_buddy = (Input::List().n_buddy_checkpoints > 0) ? Input::List().t_stop / Input::List().n_buddy_checkpoints : 0.;
+        next_buddy = starttime + dt_buddy;
+
         timings_at_current_timestep.push_back(0.);      // Vlasov
         timings_at_current_timestep.push_back(0.);      // Fokker-Planck
         timings_at_current_timestep.push_back(0.);      // Output Routines
@@ -99,11 +107,12 @@ Clock::Clock(double starttime, double __dt, double abs_tol, double rel_tol, size
     atol(abs_tol), rtol(rel_tol), 
     acceptability(0.), err_val(0.), 
     failed_steps(0), max_failures(_maxfails), _success(0),
+    _rebalance(false), _rebalance_restart(0),
     Nbc(Input::List().BoundaryCells), world_rank(0), world_size(1),
     Solver(Y)
     {
-        MPI_Comm_rank(MPI_COMM_WORLD, &world_rank); 
-        MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+        MPI_Comm_rank(Time_Decomposition::Slice_Comm(), &world_rank); 
+        MPI_Comm_size(Time_Decomposition::Slice_Comm(), &world_size);
 
         acceptabilitylist = new double[world_size];
 
@@ -150,6 +159,68 @@ Clock:: ~Clock(){
     delete[] acceptabilitylist;
 }
 //--------------------------------------------------------------
+//  Health row from the tallies the last update of each species took on the way, 
+//  the collisions being the last update of species 0 when they are on
+void Clock::gather_health(const State1D& Y_current, const valarray<double>& rk, const valarray<double>& coll, 
+    valarray<double>& health)
+{
+    health.resize(2+3*Y_current.Species());
+    health = 0.;
+
+    for (size_t s(0); s < Y_current.Species(); ++s) {
+        const double* t(NULL);
+        if ((s == 0) && (coll.size() == 4)) t = &coll[0];
+        else if (rk.size() == 4*Y_current.Species()) t = &rk[4*s];
+        if (t == NULL) continue;
+
+        health[0]    += t[0];
+        health[2+3*s] = t[1];
+        health[3+3*s] = t[2];
+        health[4+3*s] = t[3];
+    }
+
+    //  The fields are only a few numbers per cell
+    Y_current.field_health(Nbc, &health[0]);
+}
+//--------------------------------------------------------------
+void Clock::reduce_health(valarray<double>& health, Grid_Info& grid, valarray<double>& global_health)
+{
+    for (size_t i(1); i < health.size(); ++i) {
+        if ((i < 2) || ((i-2)%3 != 0)) health[i] *= grid.axis.dx(0);
+    }
+    global_health.resize(health.size());
+    MPI_Allreduce(&health[0], &global_health[0], health.size(), MPI_DOUBLE, MPI_SUM, Time_Decomposition::Slice_Comm());
+}
+//--------------------------------------------------------------
+//  Every rank sees the same totals, so all of them stop together
+void Clock::stop_on_nan(const valarray<double>& global_health, Grid_Info& grid, 
+    Output_Data::Output_Preprocessor &output, Parallel_Environment_1D& PE)
+{
+    if ((global_health.size() == 0) || (global_health[0] == 0.)) return;
+
+    if (!(PE.RANK())) cout << "\n\n ERROR :: " << global_health[0] << " NaN/Inf values at t = " << current_time << "\n\n";
+    output.histflush(grid, _dt, PE);
+    MPI_Finalize();
+    exit(1);
+}
+//--------------------------------------------------------------
+//  Only the collisions update f in place at the end of the implicit-E step, so the 
+//  species after the first, which they leave alone, are not tallied there
+void Clock::health_check(State1D& Y_current, const collisions_1D& collide, Grid_Info& grid, 
+    Output_Data::Output_Preprocessor &output, Parallel_Environment_1D& PE)
+{
+    if (!Input::List().health_check) return;
+
+    valarray<double> health, global_health;
+    gather_health(Y_current, valarray<double>(), collide.health(), health);
+    reduce_health(health, grid, global_health);
+
+    if (output.histsample()) 
+        output.histrecord("Health", health, current_time, _dt, grid, PE);
+
+    stop_on_nan(global_health, grid, output, PE);
+}
+//--------------------------------------------------------------
 Clock& Clock::advance(State1D& Y_current, Grid_Info& grid, 
     Output_Data::Output_Preprocessor &output, Export_Files::Restart_Facility &Re,
     Parallel_Environment_1D& PE) 
@@ -158,6 +229,12 @@ Clock& Clock::advance(State1D& Y_current, Grid_Info& grid,
 
     end_of_loop_time_updates();
 
+    Load_Balance::Add_Step(timings_at_current_timestep[0] + timings_at_current_timestep[1]);
+
+    //  Tallies taken during the step, one reduction per step
+    valarray<double> health(step_health), global_health;
+    if (Input::List().health_check) reduce_health(health, grid, global_health);
+
     timings_at_current_timestep[3] -= MPI_Wtime(); 
     if (current_time >= next_dist_out)
     {    
@@ -176,6 +253,13 @@ Clock& Clock::advance(State1D& Y_current, Grid_Info& grid,
     if (current_time >= next_restart)
     {
         if (!(PE.RANK())) cout << " \n Restart Output #" << t_out << "\n";        
+        //  The slabs are re-cut only from restarts that coincide with an output, 
+        //  so that the time histories are flushed before the re-entry
+        if (Input::List().load_balance && (current_time >= next_out) && (current_time < Input::List().t_stop))
+        {
+            _rebalance = Load_Balance::Rebalance(PE);
+            _rebalance_restart = t_out;
+        }
         Re.Write(PE.RANK(), t_out, Y_current, current_time);
         next_restart += dt_restart;
     }
@@ -183,14 +267,19 @@ Clock& Clock::advance(State1D& Y_current, Grid_Info& grid,
 
 
     
-    if (Input::List().o_Exhist) Ex_history1D.push_back(Y_current.FLD(0).array());
-    if (Input::List().o_Eyhist) Ey_history1D.push_back(Y_current.FLD(1).array());
-    if (Input::List().o_Ezhist) Ez_history1D.push_back(Y_current.FLD(2).array());
-    if (Input::List().o_Bxhist) Bx_history1D.push_back(Y_current.FLD(3).array());
-    if (Input::List().o_Byhist) By_history1D.push_back(Y_current.FLD(4).array());
-    if (Input::List().o_Bzhist) Bz_history1D.push_back(Y_current.FLD(5).array());
-    if (Input::List().o_fhat0hist)  fhat0_history1D.push_back(output.px_radial_hat0(Y_current,grid));
-    // if (Input::List().o_fhat1)  fhat0_history1D.push_back(Y_current.DF(0).getfhat1());
+    if (output.histsample())
+    {
+        if (Input::List().o_Exhist) output.histrecord("Exhist", Y_current.FLD(0).array(), current_time, _dt, grid, PE);
+        if (Input::List().o_Eyhist) output.histrecord("Eyhist", Y_current.FLD(1).array(), current_time, _dt, grid, PE);
+        if (Input::List().o_Ezhist) output.histrecord("Ezhist", Y_current.FLD(2).array(), current_time, _dt, grid, PE);
+        if (Input::List().o_Bxhist) output.histrecord("Bxhist", Y_current.FLD(3).array(), current_time, _dt, grid, PE);
+        if (Input::List().o_Byhist) output.histrecord("Byhist", Y_current.FLD(4).array(), current_time, _dt, grid, PE);
+        if (Input::List().o_Bzhist) output.histrecord("Bzhist", Y_current.FLD(5).array(), current_time, _dt, grid, PE);
+        if (Input::List().o_fhat0hist) output.histrecord("fhat0hist", output.px_radial_hat0(Y_current,grid), current_time, _dt, grid, PE);
+        if (Input::List().health_check) output.histrecord("Health", health, current_time, _dt, grid, PE);
+    }
+
+    if (Input::List().health_check) stop_on_nan(global_health, grid, output, PE);
 
     timing_history.push_back(timings_at_current_timestep); std::fill(timings_at_current_timestep.begin(),timings_at_current_timestep.end(),0.);
     time_history.push_back(current_time);
@@ -204,41 +293,7 @@ Clock& Clock::advance(State1D& Y_current, Grid_Info& grid,
             cout << " , Output #" << t_out;                        
         }
             
-        if (Input::List().o_fhat0hist) 
-        {
-            output.histdump(fhat0_history1D, time_history, grid,  t_out, current_time, _dt, PE, "fhat0hist");
-            fhat0_history1D.clear();
-        }
-        if (Input::List().o_Exhist) 
-        {
-            output.histdump(Ex_history1D, time_history, grid,  t_out, current_time, _dt, PE, "Exhist");
-            Ex_history1D.clear();
-        }
-        if (Input::List().o_Eyhist) 
-        {
-            output.histdump(Ey_history1D, time_history, grid,  t_out, current_time, _dt, PE, "Eyhist");
-            Ey_history1D.clear();
-        }
-        if (Input::List().o_Ezhist) 
-        {
-            output.histdump(Ez_history1D, time_history, grid,  t_out, current_time, _dt, PE, "Ezhist");
-            Ez_history1D.clear();
-        }
-        if (Input::List().o_Bxhist) 
-        {
-            output.histdump(Bx_history1D, time_history, grid,  t_out, current_time, _dt, PE, "Bxhist");
-            Bx_history1D.clear();
-        }
-        if (Input::List().o_Byhist) 
-        {
-            output.histdump(By_history1D, time_history, grid,  t_out, current_time, _dt, PE, "Byhist");
-            By_history1D.clear();
-        }
-        if (Input::List().o_Bzhist) 
-        {
-            output.histdump(Bz_history1D, time_history, grid,  t_out, current_time, _dt, PE, "Bzhist");
-            Bz_history1D.clear();
-        }
+        output.histflush(grid, _dt, PE);
         
         output(Y_current, grid, t_out, current_time, _dt, PE);
 
@@ -246,7 +301,7 @@ Clock& Clock::advance(State1D& Y_current, Grid_Info& grid,
         output.histdump(timing_history, time_history, timing_indices,  t_out, current_time, _dt, PE, "Timings");
 
         timing_history.clear();
-        Y_current.checknan();
+        if (!Input::List().health_check) Y_current.checknan();
 
         next_out += dt_out;
         ++t_out;
@@ -254,6 +309,17 @@ Clock& Clock::advance(State1D& Y_current, Grid_Info& grid,
         time_history.clear();
 
     }
+
+    if ((dt_buddy > 0.) && (current_time >= next_buddy) && (current_time < Input::List().t_stop))
+    {
+        timings_at_current_timestep[3] -= MPI_Wtime(); 
+        //  Every buddy_disk_every-th checkpoint is also kept in the restart folder
+        ++buddy_count;
+        bool to_disk((Input::List().buddy_disk_every > 0) && (buddy_count % Input::List().buddy_disk_every == 0));
+        Re.Write_Buddy(t_out-1, Y_current, current_time, to_disk);
+        next_buddy += dt_buddy;
+        timings_at_current_timestep[3] += MPI_Wtime(); 
+    }
     
     return *this;
 }
@@ -367,6 +433,26 @@ Clock& Clock::operator++()
     return *this;
 }
 //--------------------------------------------------------------
+void Clock::restart_at(const int first_out, const double lead)
+{
+    tout_start = first_out;
+    t_out = tout_start+1;
+
+    //  Early by lead, so that an output falls on the nearest step
+    next_out = t_out*dt_out - lead;
+    next_dist_out = (tout_start*dt_out)+dt_dist_out - lead;
+    next_big_dist_out = (tout_start*dt_out)+dt_big_dist_out - lead;
+    next_restart = (tout_start*dt_out)+dt_restart - lead;
+
+    start_time = tout_start*dt_out;
+    current_time = start_time;
+    _dt = Input::List().dt; dt_next = _dt;
+    failed_steps = 0; _success = 0;
+
+    timing_history.clear(); time_history.clear();
+    std::fill(timings_at_current_timestep.begin(),timings_at_current_timestep.end(),0.);
+}
+//--------------------------------------------------------------
 //  Collect all of the terms
 void Clock::end_of_loop_time_updates()
 {
@@ -424,6 +510,15 @@ void Clock::do_step(State1D& Ystar, State1D& Y_new, State1D& Y_old,
         //                             timings_at_current_timestep[0] += MPI_Wtime(); 
     }
 
+    //  Drop or restore the top harmonic cell by cell
+    if (Input::List().adaptive_lmax)
+    {
+        for (size_t s(0); s < Y_new.Species(); ++s)
+            Y_new.DF(s).Truncate();
+    }
+
+    if (Input::List().health_check) 
+        gather_health(Y_new, Solver.health(), Input::List().collisions? cF.health() : valarray<double>(), step_health);
 }
 //-------------------------------------------------------------------------------------------------------------------
 // //-------------------------------------------------------------------------------------------------------------------
@@ -491,7 +586,7 @@ void Clock::update_dt(State1D& Y_old, const State1D& Ystar, State1D& Y_new){
     std::cout << "\n dt = " << _dt;
 
     /// Error is shared so that global timestep can be determined on rank 0
-    MPI_Gather(&acceptability, 1, MPI_DOUBLE, acceptabilitylist, 1, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    MPI_Gather(&acceptability, 1, MPI_DOUBLE, acceptabilitylist, 1, MPI_DOUBLE, 0, Time_Decomposition::Slice_Comm());
     if (world_rank == 0)
     {   
 
@@ -522,8 +617,8 @@ void Clock::update_dt(State1D& Y_old, const State1D& Ystar, State1D& Y_new){
     }
 
     /// Share success and new timestep
-    MPI_Bcast(&_success, 1, MPI_INT, 0, MPI_COMM_WORLD);
-    MPI_Bcast(&dt_next, 1, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    MPI_Bcast(&_success, 1, MPI_INT, 0, Time_Decomposition::Slice_Comm());
+    MPI_Bcast(&dt_next, 1, MPI_DOUBLE, 0, Time_Decomposition::Slice_Comm());
 
     /// If failed, restore old state and updated time step.
     /// Success time-step is updated at the end of outer loop.
@@ -557,7 +652,7 @@ void Clock::update_dt(const State2D& Y_old, const State2D& Ystar, State2D& Y_new
     // std::cout << "\n dt = " << _dt;
 
     /// Error is shared so that global timestep can be determined on rank 0
-    MPI_Gather(&acceptability, 1, MPI_DOUBLE, acceptabilitylist, 1, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    MPI_Gather(&acceptability, 1, MPI_DOUBLE, acceptabilitylist, 1, MPI_DOUBLE, 0, Time_Decomposition::Slice_Comm());
     if (world_rank == 0)
     {   
 
@@ -588,8 +683,8 @@ void Clock::update_dt(const State2D& Y_old, const State2D& Ystar, State2D& Y_new
     }
 
     /// Share success and new timestep
-    MPI_Bcast(&_success, 1, MPI_INT, 0, MPI_COMM_WORLD);
-    MPI_Bcast(&dt_next, 1, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    MPI_Bcast(&_success, 1, MPI_INT, 0, Time_Decomposition::Slice_Comm());
+    MPI_Bcast(&dt_next, 1, MPI_DOUBLE, 0, Time_Decomposition::Slice_Comm());
 
     /// If failed, restore old state and updated time step.
     /// Success time-step is updated at the end of outer loop.
@@ -723,3 +818,465 @@ double Clock::check_js(const State1D& Ystar, const State1D& Y){
     // }
 
 }
+//**************************************************************
+//**************************************************************
+//   Parareal driver
+//**************************************************************
+//**************************************************************
+//--------------------------------------------------------------
+//  Harmonics of the coarse propagator, all of them by default
+static vector<size_t> coarse_ls() {
+    vector<size_t> ls(Input::List().ls);
+    for (size_t s(0); s < ls.size(); ++s)
+        if (Input::List().parareal_coarse_l0 > 0) ls[s] = min(ls[s], Input::List().parareal_coarse_l0);
+    return ls;
+}
+static vector<size_t> coarse_ms() {
+    vector<size_t> ls(coarse_ls()), ms(Input::List().ms);
+    for (size_t s(0); s < ms.size(); ++s) ms[s] = min(ms[s], ls[s]);
+    return ms;
+}
+//--------------------------------------------------------------
+Parareal::Parareal(State1D& Y, Grid_Info& grid): 
+    first_out(0), last_out(0), t_begin(0.), t_end(0.),
+    theclock(0.,Input::List().dt,Input::List().abs_tol,Input::List().rel_tol,Input::List().max_fails,Y),
+    Y_star(), Y_old(),
+    Yc(grid.axis.Nx(0), coarse_ls(), coarse_ms(), 
+        Input::List().dp, 
+        Input::List().qs, Input::List().mass, 
+        Input::List().hydromass, Input::List().hydrocharge),
+    vFc(coarse_ls(), coarse_ms(), Input::List().dp, grid.axis.xmin(0), grid.axis.xmax(0), grid.axis.Nx(0)),
+    cFc(Yc), coarse_solver(Yc),
+    coarse_dt(Input::List().parareal_coarse_ratio * Input::List().dt),
+    U(Y), U_new(Y), F(Y), G_old(Y), G_new(Y)
+    {
+        //  The outputs left in the run are shared out between the slices
+        int slice(Time_Decomposition::Slice()), slices(Time_Decomposition::Slices());
+        int out_start(Input::List().isthisarestart ? Input::List().restart_time : 0);
+        int outs(int(Input::List().n_outsteps) - out_start);
+
+        first_out = out_start + (slice*outs)/slices;
+        last_out  = out_start + ((slice+1)*outs)/slices;
+
+        double dt_out(Input::List().t_stop / (Input::List().n_outsteps));
+        t_begin = first_out*dt_out;
+        t_end   = last_out*dt_out;
+
+        //  The coarse step is held inside the explicit limit of SSP-RK3
+        int rank(0);
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+        double limit(stable_dt(Y, grid));
+        if (coarse_dt > limit)
+        {
+            if (!rank) cout << "\n Parareal coarse step " << coarse_dt << " reduced to the explicit limit " << limit << "\n";
+            coarse_dt = limit;
+        }
+        if (coarse_dt <= Input::List().dt)
+        {
+            if (!rank) cout << "\n ERROR :: the parareal coarse step must exceed dt, the explicit limit is " << limit << "\n";
+            MPI_Finalize();
+            exit(1);
+        }
+    }
+//--------------------------------------------------------------
+Parareal:: ~Parareal(){
+//--------------------------------------------------------------
+//  Destructor
+//--------------------------------------------------------------
+}
+//--------------------------------------------------------------
+void Parareal::run(State1D& Y, Grid_Info& grid, 
+    Output_Data::Output_Preprocessor &output, Export_Files::Restart_Facility &Re,
+    VlasovFunctor1D_explicitE& vF, collisions_1D& cF, Parallel_Environment_1D& PE)
+{
+    int slice(Time_Decomposition::Slice()), slices(Time_Decomposition::Slices());
+
+    //  After k corrections the first k+1 windows start exactly
+    int iterations(min(int(Input::List().parareal_iterations), slices-1));
+
+    for (int k(0); ; ++k)
+    {
+        //  Start of this window, fixed for the first slice
+        if (slice > 0) Time_Decomposition::Recv(U_new, slice-1);
+        else U_new = Y;
+
+        double local_change((k > 0) ? change(U_new, U) : 0.), max_change(0.);
+
+        G_new = U_new;
+        coarse(G_new, grid, PE);
+
+        //  Start of the next window
+        if (k > 0)
+        {
+            F += G_new; F -= G_old;
+        }
+        else F = G_new;
+
+        if (slice < slices-1) Time_Decomposition::Send(F, slice+1);
+
+        G_old = G_new;
+        U = U_new;
+
+        MPI_Allreduce(&local_change, &max_change, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+        if (!(PE.RANK()) && (slice == 0) && (k > 0)) 
+            cout << "\n Parareal iteration " << k << " , change = " << max_change;
+
+        if ((k == iterations) || ((k > 0) && (max_change < Input::List().parareal_tolerance))) break;
+
+        F = U;
+        fine(F, grid, output, Re, vF, cF, PE, false);
+    }
+
+    //  The histories are appended to the files in the order of the slices
+    Y = U;
+    output.histhold(slice > 0);
+    fine(Y, grid, output, Re, vF, cF, PE, true);
+
+    int token(0);
+    MPI_Status status;
+    if (slice > 0)
+    {
+        MPI_Recv(&token, 1, MPI_INT, slice-1, 1, Time_Decomposition::Time_Comm(), &status);
+        output.histhold(false);
+        output.histflush(grid, Input::List().dt, PE);
+    }
+    if (slice < slices-1) MPI_Send(&token, 1, MPI_INT, slice+1, 1, Time_Decomposition::Time_Comm());
+}
+//--------------------------------------------------------------
+void Parareal::coarse(State1D& Y, Grid_Info& grid, Parallel_Environment_1D& PE)
+{
+    //  Whole number of coarse steps across the window
+    size_t steps(max(1.0, ceil((t_end - t_begin)/coarse_dt - 1e-6)));
+    double h((t_end - t_begin)/double(steps));
+    double time(t_begin);
+
+    restrict_state(Y, Yc);
+    for (size_t i(0); i < steps; ++i)
+    {
+        if (Input::List().ext_fields) Setup_Y::applyexternalfields(grid, Yc, time);
+
+        coarse_solver.take_step(Yc, Yc, time, h, vFc, cFc, PE);
+        if (Input::List().collisions)
+        {
+            cFc.advance(Yc,time,h);
+            PE.Neighbor_Communications(Yc);
+        }
+        time += h;
+    }
+    prolong_state(Yc, Y);
+}
+//--------------------------------------------------------------
+void Parareal::fine(State1D& Y, Grid_Info& grid, 
+    Output_Data::Output_Preprocessor &output, Export_Files::Restart_Facility &Re,
+    VlasovFunctor1D_explicitE& vF, collisions_1D& cF, Parallel_Environment_1D& PE, const bool write)
+{
+    //  The window ends on the step nearest to t_end
+    theclock.restart_at(first_out, 0.5*Input::List().dt);
+
+    while (theclock.time() < t_end - 0.5*theclock.dt())
+    {
+        if (Input::List().ext_fields) Setup_Y::applyexternalfields(grid, Y, theclock.time());
+
+        theclock.do_step(Y_star, Y, Y_old, vF, cF, PE);
+
+        if (write) theclock.advance(Y, grid, output, Re, PE);
+        else ++theclock;
+    }
+}
+//--------------------------------------------------------------
+//  Largest stable SSP-RK3 step, which reaches sqrt(3) along the 
+//  imaginary axis. The plasma frequency is taken at the densest 
+//  cell, and the central x-differences add v/dx. The curl terms
+//  are implicit, Time_Decomposition::Setup insists on it.
+double Parareal::stable_dt(const State1D& Y, Grid_Info& grid)
+{
+    double wp2(0.), vmax(0.);
+
+    for (size_t s(0); s < Y.Species(); ++s)
+    {
+        valarray<double> p(grid.axis.p(s));
+        size_t np(grid.axis.Np(s));
+
+        double pmax(grid.axis.pmax(s)), mass(Y.DF(s).mass()), q(Y.DF(s).q());
+        vmax = max(vmax, Input::List().relativity ? pmax/sqrt(mass*mass+pmax*pmax) : pmax/mass);
+
+        for (size_t ix(0); ix < Y.SH(s,0,0).numx(); ++ix)
+        {
+            double n(0.);
+            for (size_t ip(0); ip < np; ++ip)
+            {
+                double span( ((ip+1 < np)? p[ip+1]:p[ip]) - ((ip > 0)? p[ip-1]:p[ip]) );
+                n += 0.5*p[ip]*p[ip]*span*Y.SH(s,0,0)(ip,ix).real();
+            }
+            wp2 = max(wp2, 4.0*M_PI*n*q*q/mass);
+        }
+    }
+
+    double local_rate(sqrt(wp2) + vmax/grid.axis.dx(0)), rate(0.);
+    MPI_Allreduce(&local_rate, &rate, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+
+    return sqrt(3.0)/rate;
+}
+//--------------------------------------------------------------
+void Parareal::restrict_state(const State1D& Y, State1D& Yc)
+{
+    for (size_t s(0); s < Yc.Species(); ++s)
+    {
+        for (size_t l(0); l < Yc.DF(s).l0()+1; ++l)
+        {
+            for (size_t m(0); m < ((Yc.DF(s).m0() < l) ? Yc.DF(s).m0() : l)+1; ++m)
+            {
+                Yc.SH(s,l,m) = Y.SH(s,l,m);
+            }
+        }
+    }
+    for (size_t i(0); i < Yc.Fields(); ++i) Yc.FLD(i) = Y.FLD(i);
+    Yc.HYDRO() = Y.HYDRO();
+}
+//--------------------------------------------------------------
+//  The harmonics the coarse state does not carry are zeroed, and
+//  so are taken from the fine propagator by the correction
+void Parareal::prolong_state(const State1D& Yc, State1D& Y)
+{
+    for (size_t s(0); s < Y.Species(); ++s)
+    {
+        Y.DF(s) = static_cast<complex<double> >(0.0);
+        for (size_t l(0); l < Yc.DF(s).l0()+1; ++l)
+        {
+            for (size_t m(0); m < ((Yc.DF(s).m0() < l) ? Yc.DF(s).m0() : l)+1; ++m)
+            {
+                Y.SH(s,l,m) = Yc.SH(s,l,m);
+            }
+        }
+    }
+    for (size_t i(0); i < Y.Fields(); ++i) Y.FLD(i) = Yc.FLD(i);
+    Y.HYDRO() = Yc.HYDRO();
+}
+//--------------------------------------------------------------
+double Parareal::change(const State1D& Y, const State1D& Y_ref)
+{
+    double diff(0.), norm(0.);
+
+    for (size_t s(0); s < Y.Species(); ++s)
+    {
+        for (size_t i(0); i < Y.DF(s).dim(); ++i)
+        {
+            for (size_t j(0); j < Y.DF(s)(i).dim(); ++j)
+            {
+                diff += std::norm(Y.DF(s)(i)(j) - Y_ref.DF(s)(i)(j));
+                norm += std::norm(Y_ref.DF(s)(i)(j));
+            }
+        }
+    }
+    for (size_t i(0); i < Y.Fields(); ++i)
+    {
+        for (size_t j(0); j < Y.FLD(i).numx(); ++j)
+        {
+            diff += std::norm(Y.FLD(i)(j) - Y_ref.FLD(i)(j));
+            norm += std::norm(Y_ref.FLD(i)(j));
+        }
+    }
+
+    return (norm > 0.) ? sqrt(diff/norm) : sqrt(diff);
+}
+//--------------------------------------------------------------
+//**************************************************************
+//**************************************************************
+//   Steady-state solver
+//**************************************************************
+//**************************************************************
+//--------------------------------------------------------------
+Steady_State::Steady_State(State1D& Y): 
+    first_out(Input::List().isthisarestart ? Input::List().restart_time : 0), steps(0),
+    theclock(0.,Input::List().dt,Input::List().abs_tol,Input::List().rel_tol,Input::List().max_fails,Y),
+    Y_star(), Y_old(),
+    R(Y), Rp(Y), Yp(Y), dY(Y), Z(Y),
+    V(Input::List().steady_state_krylov_iters+1, Y),
+    Hk(Input::List().steady_state_krylov_iters+1, Input::List().steady_state_krylov_iters),
+    gk(Input::List().steady_state_krylov_iters+1), 
+    cs(Input::List().steady_state_krylov_iters), sn(Input::List().steady_state_krylov_iters)
+    {}
+//--------------------------------------------------------------
+Steady_State:: ~Steady_State(){
+//--------------------------------------------------------------
+//  Destructor
+//--------------------------------------------------------------
+}
+//--------------------------------------------------------------
+void Steady_State::run(State1D& Y, Grid_Info& grid, 
+    Output_Data::Output_Preprocessor &output, Export_Files::Restart_Facility &Re,
+    VlasovFunctor1D_explicitE& vF, collisions_1D& cF, Parallel_Environment_1D& PE)
+{
+    //  Both make S(Y) non-smooth, which the difference Jacobian cannot follow
+    if (Input::List().adaptive_dt || Input::List().adaptive_lmax)
+    {
+        if (!PE.RANK()) std::cout << "\n\n ERROR :: steady_state requires a fixed time step and a fixed l0 \n\n";
+        MPI_Finalize();
+        exit(1);
+    }
+    //  Coefficients kept from an earlier step would make S(Y) depend on the call history
+    if ((Input::List().coll_coeff_tolerance > 0.) || (Input::List().coll_coeff_max_age != 1))
+    {
+        if (!PE.RANK()) std::cout << "\n\n ERROR :: steady_state requires collision_coefficients_tolerance = 0 and collision_coefficients_max_age = 1 \n\n";
+        MPI_Finalize();
+        exit(1);
+    }
+
+    const double tol(Input::List().steady_state_tol);
+    const size_t max_newton(Input::List().steady_state_newton_iters);
+    const size_t max_krylov(Input::List().steady_state_krylov_iters);
+
+    residual(Y, R, grid, vF, cF, PE);
+    double rnorm(sqrt(dot(R,R))), ynorm(sqrt(dot(Y,Y)));
+    if (!(PE.RANK())) cout << "\n Steady state iteration 0 , |S(Y)-Y|/|Y| = " << rnorm/ynorm;
+
+    size_t newton(0);
+    while ( rnorm > tol*ynorm && newton < max_newton ) {
+        ++newton;
+// - - - - - - - - - - - - - - - - - - - - - -
+//      GMRES on (S'(Y) - 1) dY = -R
+        double beta(rnorm);
+        double krylov_tol(max(1e-2*beta, 0.5*tol*ynorm));
+        double eps(sqrt(DBL_EPSILON) * (1.0+ynorm));
+
+        V[0] = R; V[0] *= complex<double>(-1.0/beta);
+        gk = 0.0; gk[0] = beta;
+
+        size_t k(0);
+        while (k < max_krylov) {
+            //  V[k+1] = (S'(Y) - 1) V[k], V[k] being of unit norm
+            Yp = V[k]; Yp *= complex<double>(eps); Yp += Y;
+            residual(Yp, Rp, grid, vF, cF, PE);
+            V[k+1] = Rp; V[k+1] -= R; V[k+1] *= complex<double>(1.0/eps);
+
+            //  Modified Gram-Schmidt
+            for (size_t i(0); i < k+1; ++i) {
+                Hk(i,k) = dot(V[i],V[k+1]);
+                Z = V[i]; Z *= complex<double>(Hk(i,k)); V[k+1] -= Z;
+            }
+            Hk(k+1,k) = sqrt(dot(V[k+1],V[k+1]));
+            bool breakdown(Hk(k+1,k) <= DBL_MIN);
+            if (!breakdown) V[k+1] *= complex<double>(1.0/Hk(k+1,k));
+
+            //  Givens rotations
+            for (size_t i(0); i < k; ++i) {
+                double tmp( cs[i]*Hk(i,k) + sn[i]*Hk(i+1,k) );
+                Hk(i+1,k) = -sn[i]*Hk(i,k) + cs[i]*Hk(i+1,k);
+                Hk(i,k)   = tmp;
+            }
+            double hd(sqrt(Hk(k,k)*Hk(k,k) + Hk(k+1,k)*Hk(k+1,k)));
+            cs[k] = (hd > 0.0) ? Hk(k,k)/hd   : 1.0;
+            sn[k] = (hd > 0.0) ? Hk(k+1,k)/hd : 0.0;
+            Hk(k,k)   = hd;
+            Hk(k+1,k) = 0.0;
+            gk[k+1]   = -sn[k]*gk[k];
+            gk[k]     = cs[k]*gk[k];
+
+            ++k;
+            if (breakdown || fabs(gk[k]) <= krylov_tol) break;
+        }
+
+        //  dY = V y, H y = g
+        for (size_t i(k); i-- > 0; ) {
+            for (size_t j(i+1); j < k; ++j) gk[i] -= Hk(i,j)*gk[j];
+            gk[i] = (fabs(Hk(i,i)) > 0.0) ? gk[i]/Hk(i,i) : 0.0;
+        }
+        dY = 0.0;
+        for (size_t i(0); i < k; ++i) {
+            Z = V[i]; Z *= complex<double>(gk[i]); dY += Z;
+        }
+// - - - - - - - - - - - - - - - - - - - - - -
+
+        //  Halve the update until the residual drops
+        double lambda(1.0), rtrial(0.0);
+        bool descent(false);
+        for (size_t tries(0); tries < 5 && !descent; ++tries) {
+            Yp = dY; Yp *= complex<double>(lambda); Yp += Y;
+            residual(Yp, Rp, grid, vF, cF, PE);
+            rtrial = sqrt(dot(Rp,Rp));
+            descent = (rtrial < rnorm);
+            lambda *= 0.5;
+        }
+        //  Otherwise fall back to a Picard step, Y = S(Y)
+        if (!descent) {
+            Yp = Y; Yp += R;
+            residual(Yp, Rp, grid, vF, cF, PE);
+            rtrial = sqrt(dot(Rp,Rp));
+            if (!(PE.RANK())) cout << "\n Steady state iteration " << newton << " , no Newton descent, Picard step";
+        }
+        Y = Yp; R = Rp;
+        rnorm = rtrial; ynorm = sqrt(dot(Y,Y));
+
+        if (!(PE.RANK())) 
+            cout << "\n Steady state iteration " << newton << " , |S(Y)-Y|/|Y| = " << rnorm/ynorm 
+                 << " , GMRES iterations = " << k;
+    }
+
+    if ( rnorm > tol*ynorm && !(PE.RANK()) ) {
+        cout << "\nWARNING, steady state Newton-Krylov stopped at |S(Y)-Y|/|Y| = " << rnorm/ynorm 
+             << " after " << newton << " iterations" << endl;
+    }
+
+    //  Against the steps the time march takes to the end of the run
+    if (!(PE.RANK())) {
+        double t_begin(first_out * Input::List().t_stop / Input::List().n_outsteps);
+        size_t march(ceil((Input::List().t_stop - t_begin)/Input::List().dt - 1e-6));
+        cout << "\n Steady state took " << steps << " time steps, the time march to t_stop takes " << march << "\n";
+    }
+
+    //  Written as the last output of the run
+    size_t t_out(Input::List().n_outsteps);
+    output(Y, grid, t_out, Input::List().t_stop, Input::List().dt, PE);
+    output.distdump(Y, grid, t_out, Input::List().t_stop, Input::List().dt, PE);
+    output.bigdistdump(Y, grid, t_out, Input::List().t_stop, Input::List().dt, PE);
+    Re.Write(PE.RANK(), t_out, Y, Input::List().t_stop);
+}
+//--------------------------------------------------------------
+void Steady_State::residual(const State1D& Y, State1D& Rout, Grid_Info& grid, 
+    VlasovFunctor1D_explicitE& vF, collisions_1D& cF, Parallel_Environment_1D& PE)
+{
+    theclock.restart_at(first_out);
+
+    Rout = Y;
+    for (size_t i(0); i < Input::List().steady_state_steps; ++i)
+    {
+        if (Input::List().ext_fields) Setup_Y::applyexternalfields(grid, Rout, theclock.time());
+
+        theclock.do_step(Y_star, Rout, Y_old, vF, cF, PE);
+        ++theclock;
+        ++steps;
+    }
+    Rout -= Y;
+}
+//--------------------------------------------------------------
+double Steady_State::dot(const State1D& A, const State1D& B)
+{
+    size_t Nbc(Input::List().BoundaryCells);
+    double sum(0.);
+
+    for (size_t s(0); s < A.Species(); ++s)
+    {
+        for (size_t i(0); i < A.DF(s).dim(); ++i)
+        {
+            for (size_t ix(Nbc); ix < A.DF(s)(i).numx()-Nbc; ++ix)
+            {
+                for (size_t ip(0); ip < A.DF(s)(i).nump(); ++ip)
+                {
+                    sum += real(conj(A.DF(s)(i)(ip,ix)) * B.DF(s)(i)(ip,ix));
+                }
+            }
+        }
+    }
+    for (size_t i(0); i < A.Fields(); ++i)
+    {
+        for (size_t ix(Nbc); ix < A.FLD(i).numx()-Nbc; ++ix)
+        {
+            sum += real(conj(A.FLD(i)(ix)) * B.FLD(i)(ix));
+        }
+    }
+
+    MPI_Allreduce(MPI_IN_PLACE, &sum, 1, MPI_DOUBLE, MPI_SUM, Time_Decomposition::Slice_Comm());
+    return sum;
+}
+//--------------------------------------------------------------
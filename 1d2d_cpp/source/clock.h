@@ -53,8 +53,23 @@ public:
     double nextdt() {return dt_next;}
     double time() {return current_time;}
     int success() {return _success;}
+    bool rebalance() {return _rebalance;}               // The x-slabs must be repartitioned from the last restart
+    size_t rebalance_restart() {return _rebalance_restart;}
+
+//      Put the clock at output #first_out and schedule the outputs from there, as for a restart
+    void restart_at(const int first_out, const double lead = 0.);
+
+//      Health check of the stored state for loops that do not go through advance()
+    void health_check(State1D& Y_current, const collisions_1D& collide, Grid_Info& grid, 
+        Output_Data::Output_Preprocessor &output, Parallel_Environment_1D& PE);
 
 private:
+//      Health row from the tallies of the steppers, see DistFunc1D::add_checked, and its global sum
+    void gather_health(const State1D& Y_current, const valarray<double>& rk, const valarray<double>& coll, 
+        valarray<double>& health);
+    void reduce_health(valarray<double>& health, Grid_Info& grid, valarray<double>& global_health);
+    void stop_on_nan(const valarray<double>& global_health, Grid_Info& grid, 
+        Output_Data::Output_Preprocessor &output, Parallel_Environment_1D& PE);
 
     double current_time, dt_next, _dt;
     double atol, rtol, acceptability, err_val;
@@ -63,6 +78,9 @@ private:
 
     int _success;
 
+    bool _rebalance;
+    size_t _rebalance_restart;
+
     size_t Nbc;
     int world_rank, world_size;
 
@@ -72,6 +90,7 @@ private:
     // RKCK45 Solver;
     // RKDP85 Solver;
     RK4C Solver;
+    valarray<double> step_health;
 
     int tout_start;
     size_t t_out;
@@ -79,10 +98,9 @@ private:
     double next_out, next_dist_out, next_big_dist_out;
     double next_restart;
     double start_time;
+    double dt_buddy, next_buddy;                        // In-memory checkpoints
+    size_t buddy_count;
 
-    vector<valarray<complex<double> > > Ex_history1D, Ey_history1D, Ez_history1D;
-    vector<valarray<complex<double> > > Bx_history1D, By_history1D, Bz_history1D;
-    vector<valarray<double> >          fhat0_history1D;
     vector<Array2D<complex<double> > > Ex_history2D, Ey_history2D, Ez_history2D;
     vector<Array2D<complex<double> > > Bx_history2D, By_history2D, Bz_history2D;
     
@@ -95,6 +113,97 @@ private:
 
 };
 //--------------------------------------------------------------
+//--------------------------------------------------------------
+//  Parareal driver for the 1D explicit loop. The run from the
+//  current output to t_stop is cut into one window per time
+//  slice, each window beginning at an output. A cheap coarse
+//  propagator (SSP-RK3 at a larger step, optionally with fewer
+//  harmonics) predicts the window starts in a sweep through the
+//  slices, the Clock with the usual fine stepper then advances
+//  all windows at once, and the starts are corrected with
+//      U_{n+1} = G(U_n) + F(U_n^old) - G(U_n^old)
+//  until they stop changing. A last fine pass writes the output.
+//--------------------------------------------------------------
+class Parareal {
+public:
+//      Constructor
+    Parareal(State1D& Y, Grid_Info& grid);
+    ~Parareal();
+
+    void run(State1D& Y, Grid_Info& grid, 
+        Output_Data::Output_Preprocessor &output, Export_Files::Restart_Facility &Re,
+        VlasovFunctor1D_explicitE& vF, collisions_1D& cF, Parallel_Environment_1D& PE);
+
+private:
+//      Propagators over the window of this slice
+    void coarse(State1D& Y, Grid_Info& grid, Parallel_Environment_1D& PE);
+    void fine(State1D& Y, Grid_Info& grid, 
+        Output_Data::Output_Preprocessor &output, Export_Files::Restart_Facility &Re,
+        VlasovFunctor1D_explicitE& vF, collisions_1D& cF, Parallel_Environment_1D& PE, const bool write);
+
+//      Harmonics and fields between the fine and the coarse states
+    void restrict_state(const State1D& Y, State1D& Yc);
+    void prolong_state(const State1D& Yc, State1D& Y);
+
+//      Largest stable coarse step for the initial state
+    double stable_dt(const State1D& Y, Grid_Info& grid);
+
+//      Relative L2 change between two fine states
+    double change(const State1D& Y, const State1D& Y_ref);
+
+    int first_out, last_out;
+    double t_begin, t_end;
+
+    Clock theclock;
+    State1D Y_star, Y_old;                          // For Clock::do_step
+
+    State1D Yc;                                     // Coarse state
+    VlasovFunctor1D_explicitE vFc;
+    collisions_1D cFc;
+    RK3SSP coarse_solver;
+    double coarse_dt;
+
+    State1D U, U_new, F, G_old, G_new;
+};
+//--------------------------------------------------------------
+//--------------------------------------------------------------
+//  Steady-state solve for the 1D explicit loop. Marching to a
+//  steady state is a Picard iteration Y <- S(Y), S being a few
+//  steps of the usual Vlasov and implicit collision stepping.
+//  Here Newton-GMRES solves S(Y) - Y = 0 instead, the Jacobian
+//  applied matrix-free by differencing two residuals. The fast
+//  modes are damped within S, so GMRES only sees the slow ones.
+//--------------------------------------------------------------
+class Steady_State {
+public:
+//      Constructor
+    Steady_State(State1D& Y);
+    ~Steady_State();
+
+    void run(State1D& Y, Grid_Info& grid, 
+        Output_Data::Output_Preprocessor &output, Export_Files::Restart_Facility &Re,
+        VlasovFunctor1D_explicitE& vF, collisions_1D& cF, Parallel_Environment_1D& PE);
+
+private:
+//      R = S(Y) - Y, S always starting from the same time
+    void residual(const State1D& Y, State1D& R, Grid_Info& grid, 
+        VlasovFunctor1D_explicitE& vF, collisions_1D& cF, Parallel_Environment_1D& PE);
+
+//      Real inner product over the interior cells of all the ranks
+    double dot(const State1D& A, const State1D& B);
+
+    int first_out;
+    size_t steps;                                   // Time steps taken by all the residuals
+
+    Clock theclock;
+    State1D Y_star, Y_old;                          // For Clock::do_step
+
+    State1D R, Rp, Yp, dY, Z;
+    vector<State1D> V;
+    Array2D<double> Hk;
+    valarray<double> gk, cs, sn;
+};
+//--------------------------------------------------------------
 
 //
 //**************************************************************
@@ -37,13 +37,81 @@
 #include "formulary.h"
 #include "nmethods.h"
 #include "collisions.h"
+#include "parallel.h"
 
 
+//---------------------------------------------------------------------------------------------
+//---------------------------------------------------------------------------------------------
+//*********************************************************************************************
+f00_moments_record::f00_moments_record():
+        recorded(false), age(0),
+        density(0.), I2(0.), I4(0.),
+        Zvalue(0.), step_size(0.)
+{}
+//---------------------------------------------------------------------------------------------
+bool f00_moments_record::drifted(const double current, const double previous)
+{
+    return (fabs(current - previous) > Input::List().coll_coeff_tolerance * fabs(previous));
+}
+//---------------------------------------------------------------------------------------------
+bool f00_moments_record::outdated(const valarray<double>& vr, const valarray<double>& fin)
+{
+    return outdated(vr, fin, 0., 0.);
+}
+//---------------------------------------------------------------------------------------------
+/// @brief      Decides whether the collision coefficients of a cell have to be rebuilt
+///
+/// @param[in]  vr          Velocity axis
+/// @param[in]  fin         f00 in this cell
+/// @param[in]  _Zvalue     Ionization used in the coefficients
+/// @param[in]  _step_size  Time-step used in the coefficients
+///
+/// The coefficients are rebuilt when the density, I2 = int f p^4 dp or I4 = int f p^6 dp
+/// drift by more than collision_coefficients_tolerance, when Z or the time-step change,
+/// or when they are older than collision_coefficients_max_age calls.
+///
+bool f00_moments_record::outdated(const valarray<double>& vr, const valarray<double>& fin, 
+                                    const double _Zvalue, const double _step_size)
+{
+    double I0_now(0.), I2_now(0.), I4_now(0.);
+    double p2dp;
+
+    for (size_t ip(0); ip < fin.size(); ++ip)
+    {
+        p2dp    = vr[ip] * vr[ip] * (vr[ip] - ((ip > 0) ? vr[ip-1] : 0.));
+        I0_now += p2dp * fin[ip];
+        p2dp   *= vr[ip] * vr[ip];
+        I2_now += p2dp * fin[ip];
+        p2dp   *= vr[ip] * vr[ip];
+        I4_now += p2dp * fin[ip];
+    }
+
+    ++age;
+
+    if ( recorded 
+        && ( (age < Input::List().coll_coeff_max_age) || (Input::List().coll_coeff_max_age == 0) )
+        && (_Zvalue == Zvalue) && (_step_size == step_size)
+        && !drifted(I0_now, density) && !drifted(I2_now, I2) && !drifted(I4_now, I4) )
+    {
+        return false;
+    }
+
+    recorded  = true;
+    age       = 0;
+    density   = I0_now;
+    I2        = I2_now;
+    I4        = I4_now;
+    Zvalue    = _Zvalue;
+    step_size = _step_size;
+
+    return true;
+}
+//---------------------------------------------------------------------------------------------
 #pragma optimize("", off)
 //---------------------------------------------------------------------------------------------
 //---------------------------------------------------------------------------------------------
 //*********************************************************************************************
-self_f00_implicit_step::self_f00_implicit_step(//const size_t &nump, const double &pmax,
+self_f00_implicit_step::self_f00_implicit_step(const size_t numxtotal,
                             const valarray<double>& dp,
                          const double _mass, bool _ib):
         mass(_mass), ib(_ib),
@@ -102,6 +170,15 @@ self_f00_implicit_step::self_f00_implicit_step(//const size_t &nump, const doubl
     for (size_t i(0); i < vr.size(); ++i) {
         oneoverv2[i] = 1.0 / vr[i] / vr[i] / dvr[i];
     }
+
+    for (size_t ix(0); ix < numxtotal; ++ix)
+    {
+        C_RB_x.push_back(valarray<double>(0.,dp.size()+1));
+        D_RB_x.push_back(valarray<double>(0.,dp.size()+1));
+        delta_CC_x.push_back(valarray<double>(0.,dp.size()+1));
+        I4_Lnee_x.push_back(0.);
+        coeff_record_x.push_back(f00_moments_record());
+    }
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
     /// Laser
@@ -282,21 +359,29 @@ void self_f00_implicit_step::update_D_inversebremsstrahlung(valarray<double> &C_
 
 //---------------------------------------------------------------------------------------------
 //---------------------------------------------------------------------------------------------
-void self_f00_implicit_step::takestep(valarray<double>  &fin, valarray<double> &fh, const double Z0, const double vos, const double step_size)//, const double cooling) {
+void self_f00_implicit_step::takestep(valarray<double>  &fin, valarray<double> &fh, const double Z0, const double vos, const double step_size, const size_t position)//, const double cooling) {
 {
 
     double collisional_coefficient;
     double heating_coefficient;
 
-    Array2D<double> LHS(fin.size(),fin.size());
+    /// Tridiagonal matrix, stored by its diagonals
+    valarray<double> LHS_lower(0.0,fin.size()), LHS_diag(0.0,fin.size()), LHS_upper(0.0,fin.size());
 
-    valarray<double> C_RB(0.0,fin.size()+1), D_RB(0.0,fin.size()+1);
-    double I4_Lnee(0.0); 
-    valarray<double> delta_CC(0.0,fin.size()+1);
+    valarray<double>& C_RB(C_RB_x[position]);
+    double& I4_Lnee(I4_Lnee_x[position]); 
+    valarray<double>& delta_CC(delta_CC_x[position]);
 
-    ///  Calculate Rosenbluth and Chang-Cooper quantities
-    update_C_Rosenbluth(C_RB, I4_Lnee, fin);   /// Also fills in I4_Lnee (the temperature for the Lnee calculation)
-    update_D_and_delta(C_RB, D_RB, delta_CC, fin);    /// And takes care of boundaries
+    ///  Calculate Rosenbluth and Chang-Cooper quantities, unless f00 has not changed
+    ///  enough since they were last calculated in this cell
+    if (coeff_record_x[position].outdated(vr, fin))
+    {
+        update_C_Rosenbluth(C_RB, I4_Lnee, fin);   /// Also fills in I4_Lnee (the temperature for the Lnee calculation)
+        update_D_and_delta(C_RB, D_RB_x[position], delta_CC, fin);    /// And takes care of boundaries
+    }
+
+    /// Inverse bremsstrahlung modifies D, so work on a copy
+    valarray<double> D_RB(D_RB_x[position]);
 
     /// Normalizing quantities (Inspired by previous collision routines and OSHUN notes by M. Tzoufras)
     collisional_coefficient  = formulas.LOGee(C_RB[C_RB.size()-1],2.*I4_Lnee/3.0/C_RB[C_RB.size()-1]);
@@ -315,26 +400,26 @@ void self_f00_implicit_step::takestep(valarray<double>  &fin, valarray<double> &
     size_t ip(0);
 
     /// Boundaries by hand -- This operates on f(0)
-    LHS(ip, ip + 1) = - oneoverv2[ip] * collisional_coefficient
+    LHS_upper[ip] = - oneoverv2[ip] * collisional_coefficient
           * (C_RB[ip + 1] * (1.0 - delta_CC[ip + 1])
              + D_RB[ip + 1] / dvr[ip + 1]);
 
-    LHS(ip    , ip) = 1.0 - oneoverv2[ip] * collisional_coefficient
+    LHS_diag[ip] = 1.0 - oneoverv2[ip] * collisional_coefficient
                 * (C_RB[ip + 1] * delta_CC[ip + 1] - D_RB[ip + 1] / dvr[ip + 1]
                    - C_RB[ip] * (1.0 - delta_CC[ip]) - D_RB[ip] / dvr[ip]);
 
 
     // #pragma ivdep
     for (ip = 1; ip < fin.size() - 1; ++ip){
-        LHS(ip, ip + 1) = - oneoverv2[ip] * collisional_coefficient
+        LHS_upper[ip] = - oneoverv2[ip] * collisional_coefficient
                   * (C_RB[ip + 1] * (1.0 - delta_CC[ip + 1])
                      + D_RB[ip + 1] / dvr[ip + 1]);
 
-        LHS(ip    , ip) = 1.0 - oneoverv2[ip] * collisional_coefficient
+        LHS_diag[ip] = 1.0 - oneoverv2[ip] * collisional_coefficient
                         * (C_RB[ip + 1] * delta_CC[ip + 1] - D_RB[ip + 1] / dvr[ip + 1]
                            - C_RB[ip] * (1.0 - delta_CC[ip]) - D_RB[ip] / dvr[ip]);
 
-        LHS(ip, ip - 1) = oneoverv2[ip] * collisional_coefficient
+        LHS_lower[ip] = oneoverv2[ip] * collisional_coefficient
                   * (C_RB[ip] * delta_CC[ip]
                      - D_RB[ip] / dvr[ip]);
 
@@ -342,23 +427,15 @@ void self_f00_implicit_step::takestep(valarray<double>  &fin, valarray<double> &
 
     ip = fin.size() - 1;
 
-    LHS(ip    , ip) = 1.0  - oneoverv2[ip] * collisional_coefficient
+    LHS_diag[ip] = 1.0  - oneoverv2[ip] * collisional_coefficient
                 * (C_RB[ip + 1] * delta_CC[ip + 1]
                    - C_RB[ip] * (1.0 - delta_CC[ip]) - D_RB[ip] / dvr[ip]);
 
-    LHS(ip, ip - 1) = oneoverv2[ip] * collisional_coefficient
+    LHS_lower[ip] = oneoverv2[ip] * collisional_coefficient
           * (C_RB[ip] * delta_CC[ip]
              - D_RB[ip] / dvr[ip]);
 
-    // std::cout << "\n\n LHS = \n";
-    // for (size_t i(0); i < LHS.dim1(); ++i) {
-    //     std::cout << "i = " << i << " :::: ";
-    //     for (size_t j(0); j < LHS.dim2(); ++j) {
-    //         std::cout << LHS(i, j) << "   ";
-    //     }
-    //     std::cout << "\n";
-    // }
-    Thomas_Tridiagonal(LHS,fin,fh);
+    TridiagonalSolve(LHS_lower,LHS_diag,LHS_upper,fin,fh);
 
 }
 
@@ -557,7 +634,8 @@ self_f00_implicit_collisions::self_f00_implicit_collisions(
             ygrid(Algorithms::MakeCAxis(Input::List().xminLocal[1],Input::List().xmaxLocal[1],Input::List().NxLocal[1])),
             ib(((charge == 1.0) && (mass == 1.0))),
             // collide(DFin(0,0).nump(),DFin.pmax(),DFin.mass(), deltat, ib),
-            collide(dp,mass, ib),
+            collide(Input::List().NxLocal[0]*((Input::List().dim == 1) ? 1 : Input::List().NxLocal[1]),
+                    dp, mass, ib),
             IB_heating(Input::List().IB_heating),// MX_cooling(Input::List().MX_cooling),
             heatingprofile_1d(0.0,Input::List().NxLocal[0]),
             // coolingprofile_1d(0.0,Input::List().NxLocal[0]),
@@ -591,7 +669,7 @@ void self_f00_implicit_collisions::loop(const SHarmonic1D& f00, const valarray<d
 
         /// Get time and heating profile
         /// Ray-trace would go here
-        Parser::parseprofile(xgrid, Input::List().intensity_profile_str, heatingprofile_1d);
+        Parser::parseprofile(xgrid, Input::List().intensity_profile_str, heatingprofile_1d, Input::List().ompthreads);
         Parser::parseprofile(time, Input::List().intensity_time_profile_str, timecoeff);
 
         /// Make vos(x,t)
@@ -602,6 +680,7 @@ void self_f00_implicit_collisions::loop(const SHarmonic1D& f00, const valarray<d
     #pragma omp parallel for num_threads(Input::List().ompthreads)
     for (size_t ix = 0; ix < szx; ++ix)
     {
+        double cell_time(omp_get_wtime());      // Measured cost of the cell for the slab balancing
         valarray<double> fin(0.0, f00.nump());
         valarray<double> fout(0.0, f00.nump());
         // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -619,7 +698,7 @@ void self_f00_implicit_collisions::loop(const SHarmonic1D& f00, const valarray<d
         // collide.takestep(fin,fout,Zarray[ix+Nbc],heatingprofile_1d[ix+Nbc],step_size);//,coolingprofile_1d[ix+Nbc]);
         if (Input::List().coll_op == 0 || Input::List().coll_op == 1)
         {
-            collide.takestep(fin,fout,Zarray[ix],heatingprofile_1d[ix],step_size);//,coolingprofile_1d[ix+Nbc]);
+            collide.takestep(fin,fout,Zarray[ix],heatingprofile_1d[ix],step_size,ix);//,coolingprofile_1d[ix+Nbc]);
         }
         else if (Input::List().coll_op == 2 || Input::List().coll_op == 3)
         {
@@ -637,6 +716,7 @@ void self_f00_implicit_collisions::loop(const SHarmonic1D& f00, const valarray<d
             
             
         }
+        Load_Balance::Add_Cost(ix, omp_get_wtime() - cell_time);
         
         // if (omp_get_thread_num())
                 // std::cout << "fout[ " << ix << "] = " << fout.sum() << "\n";
@@ -662,7 +742,7 @@ void self_f00_implicit_collisions::loop(SHarmonic1D& f00, const valarray<double>
 
         /// Get time and heating profile
         /// Ray-trace would go here
-        Parser::parseprofile(xgrid, Input::List().intensity_profile_str, heatingprofile_1d);
+        Parser::parseprofile(xgrid, Input::List().intensity_profile_str, heatingprofile_1d, Input::List().ompthreads);
         Parser::parseprofile(time, Input::List().intensity_time_profile_str, timecoeff);
 
         /// Make vos(x,t)
@@ -673,6 +753,7 @@ void self_f00_implicit_collisions::loop(SHarmonic1D& f00, const valarray<double>
     #pragma omp parallel for num_threads(Input::List().ompthreads)
     for (size_t ix = 0; ix < szx; ++ix)
     {
+        double cell_time(omp_get_wtime());      // Measured cost of the cell for the slab balancing
         valarray<double> fin(0.0, f00.nump());
         valarray<double> fout(0.0, f00.nump());
         // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -687,7 +768,7 @@ void self_f00_implicit_collisions::loop(SHarmonic1D& f00, const valarray<double>
         // collide.takestep(fin,fout,Zarray[ix+Nbc],heatingprofile_1d[ix+Nbc],step_size);//,coolingprofile_1d[ix+Nbc]);
         if (Input::List().coll_op == 0 || Input::List().coll_op == 1)
         {
-            collide.takestep(fin,fout,Zarray[ix],heatingprofile_1d[ix],step_size);//,coolingprofile_1d[ix+Nbc]);
+            collide.takestep(fin,fout,Zarray[ix],heatingprofile_1d[ix],step_size,ix);//,coolingprofile_1d[ix+Nbc]);
         }
         else if (Input::List().coll_op == 2 || Input::List().coll_op == 3)
         {
@@ -702,6 +783,7 @@ void self_f00_implicit_collisions::loop(SHarmonic1D& f00, const valarray<double>
             
             // std::cout << "fout[" << ip << "," << ix << "] = " << fout[ip] << "\n";
         }
+        Load_Balance::Add_Cost(ix, omp_get_wtime() - cell_time);
         
     }
     //-------------------------------------------------------------------
@@ -725,7 +807,7 @@ void self_f00_implicit_collisions::loop(const SHarmonic2D& f00, const Array2D<do
         /// Ray-trace would go here
         /// 
         
-        Parser::parseprofile(xgrid, ygrid, Input::List().intensity_profile_str, heatingprofile_2d);
+        Parser::parseprofile(xgrid, ygrid, Input::List().intensity_profile_str, heatingprofile_2d, Input::List().ompthreads);
         Parser::parseprofile(time, Input::List().intensity_time_profile_str, timecoeff);
 
         /// Make vos(x,t)
@@ -751,7 +833,7 @@ void self_f00_implicit_collisions::loop(const SHarmonic2D& f00, const Array2D<do
     //  
     //  
             // std::cout << "ix,iy = " << ix << " , " << iy << ", hfp = " << heatingprofile_2d(ix,iy) << "\n";
-            collide.takestep(fin,fout,Zarray(ix,iy),heatingprofile_2d(ix,iy),step_size);//,coolingprofile_2d(ix,iy));
+            collide.takestep(fin,fout,Zarray(ix,iy),heatingprofile_2d(ix,iy),step_size,ix*szy+iy);//,coolingprofile_2d(ix,iy));
 
             // Return updated data to the harmonic
             for (size_t ip(0); ip < fin.size(); ++ip)
@@ -783,7 +865,7 @@ void self_f00_implicit_collisions::loop(SHarmonic2D& f00, const Array2D<double>&
         /// Ray-trace would go here
         /// 
         
-        Parser::parseprofile(xgrid, ygrid, Input::List().intensity_profile_str, heatingprofile_2d);
+        Parser::parseprofile(xgrid, ygrid, Input::List().intensity_profile_str, heatingprofile_2d, Input::List().ompthreads);
         Parser::parseprofile(time, Input::List().intensity_time_profile_str, timecoeff);
 
         /// Make vos(x,t)
@@ -809,7 +891,7 @@ void self_f00_implicit_collisions::loop(SHarmonic2D& f00, const Array2D<double>&
     //  
     //  
             // std::cout << "ix,iy = " << ix << " , " << iy << ", hfp = " << heatingprofile_2d(ix,iy) << "\n";
-            collide.takestep(fin,fout,Zarray(ix,iy),heatingprofile_2d(ix,iy),step_size);//,coolingprofile_2d(ix,iy));
+            collide.takestep(fin,fout,Zarray(ix,iy),heatingprofile_2d(ix,iy),step_size,ix*szy+iy);//,coolingprofile_2d(ix,iy));
 
             // Return updated data to the harmonic
             for (size_t ip(0); ip < fin.size(); ++ip)
@@ -1159,7 +1241,8 @@ self_flm_implicit_step::self_flm_implicit_step(const size_t numxtotal, const siz
             U1m1(0.0,dp.size()),
             if_tridiagonal(Input::List().if_tridiagonal),
             Dt(0.),kpre(0.), id_low(2),
-            dist_il((((m0+1)*(2*l0-m0+2))/2)),dist_im((((m0+1)*(2*l0-m0+2))/2))
+            dist_il((((m0+1)*(2*l0-m0+2))/2)),dist_im((((m0+1)*(2*l0-m0+2))/2)),
+            num_factored( (Input::List().coll_op == 1 || Input::List().coll_op == 3) ? l0 : ((l0 < 2) ? l0 : 2) )
             // FPGPU()
 {
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -1194,9 +1277,14 @@ self_flm_implicit_step::self_flm_implicit_step(const size_t numxtotal, const siz
     {
         _LOGee_x.push_back(0.);
         Scattering_Term_x.push_back(valarray<double>(0.,dp.size()));
-        Alpha_Tri_x.push_back(Array2D<double>(dp.size(),dp.size()));
+        Alpha_Tri_lower_x.push_back(valarray<double>(0.,dp.size()));
+        Alpha_Tri_diag_x.push_back(valarray<double>(0.,dp.size()));
+        Alpha_Tri_upper_x.push_back(valarray<double>(0.,dp.size()));
         df0_x.push_back(valarray<double>(0.,dp.size()));
         ddf0_x.push_back(valarray<double>(0.,dp.size()));
+        coeff_record_x.push_back(f00_moments_record());
+        Alpha_Tri_upperfactor_x.push_back(vector<valarray<double> >(num_factored, valarray<double>(0.,dp.size())));
+        Alpha_Tri_invpivot_x.push_back(vector<valarray<double> >(num_factored, valarray<double>(0.,dp.size())));
     }
 
     
@@ -1282,19 +1370,22 @@ void  self_flm_implicit_step::reset_coeff_FP(valarray<double>& fin, const double
 //  Reset the coefficients based on f_0^0 
 //-------------------------------------------------------------------
     // std::cout << "ix = " << position << "\n";
+//     Calculate Dt
+    Dt = Delta_t;
+
+//     Keep the coefficients from the last rebuild if f00 has barely changed
+    if ( !(coeff_record_x[position].outdated(vr, fin, Zvalue, Delta_t)) ) return;
+
     //          Constant
     double I0_density, I2_temperature;
     double _ZLOGei, _LOGee;
 
     valarray<double>  df0(0.,fin.size()), ddf0(0.,fin.size());
-    Array2D<double> Alpha_Tri(fin.size(),fin.size());
+    valarray<double>  Alpha_Tri_lower(0.,fin.size()), Alpha_Tri_diag(0.,fin.size()), Alpha_Tri_upper(0.,fin.size());
     valarray<double> Scattering_Term(fin);
     //          Define the integrals
     valarray<double>  J1m(0.,fin.size()), I0(0.,fin.size()), I2(0.,fin.size());
 
-//     Calculate Dt
-    Dt = Delta_t;
-
 //     INTEGRALS
 //     - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
 //     Temperature integral I2 = 4*pi / (v^2) * int_0^v f(u)*u^4du
@@ -1380,7 +1471,6 @@ void  self_flm_implicit_step::reset_coeff_FP(valarray<double>& fin, const double
 
 //     MAKE TRIDIAGONAL ARRAY
 //     - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
-    Alpha_Tri = 0.0;
 
     double IvDnDm1, IvDnDp1, Ivsq2Dn;
 
@@ -1388,8 +1478,8 @@ void  self_flm_implicit_step::reset_coeff_FP(valarray<double>& fin, const double
     IvDnDp1 = 1.0 / (vr[0] * (vr[1]-vr[0]) * (vr[1] - vr[0]));       //  ( v*D_n*D_{n+1/2} )^(-1)
     Ivsq2Dn = 1.0 / (vr[0] * vr[0]                 * (vr[2] - vr[0]));       //  ( v^2 * 2*D_n )^(-1)
 
-    Alpha_Tri(0,0) = 8.0 * M_PI * fin[0]; //TriI1[0] * Ivsq2Dn - 2.*TriI2[0] * IvDnDp1;                                         //  8*pi*f0[0]
-    // Alpha_Tri(0,1) = TriI2[0] * IvDnDp1 + 2.*TriI1[0] * Ivsq2Dn;                                                                             //  
+    Alpha_Tri_diag[0] = 8.0 * M_PI * fin[0]; //TriI1[0] * Ivsq2Dn - 2.*TriI2[0] * IvDnDp1;                                         //  8*pi*f0[0]
+    // Alpha_Tri_upper[0] = TriI2[0] * IvDnDp1 + 2.*TriI1[0] * Ivsq2Dn;                                                                             //  
 
     #pragma ivdep
     for (size_t i(1); i < TriI1.size()-1; ++i)
@@ -1398,17 +1488,19 @@ void  self_flm_implicit_step::reset_coeff_FP(valarray<double>& fin, const double
         IvDnDp1 = 1.0 / (vr[i] * 0.5*(vr[i+1]-vr[i-1]) * (vr[i+1] - vr[i]  ));       //  ( v*D_n*D_{n+1/2} )^(-1)
         Ivsq2Dn = 1.0 / (vr[i] * vr[i]                 * (vr[i+1] - vr[i-1]));       //  ( v^2 * 2*D_n )^(-1)
         
-        Alpha_Tri(i, i  ) = 8.0 * M_PI * fin[i] - TriI2[i] * (IvDnDm1 + IvDnDp1);
-        Alpha_Tri(i, i-1) = TriI2[i] * IvDnDm1 - TriI1[i] * Ivsq2Dn;
-        Alpha_Tri(i, i+1) = TriI2[i] * IvDnDp1 + TriI1[i] * Ivsq2Dn;                                                                             //  
+        Alpha_Tri_diag[i] = 8.0 * M_PI * fin[i] - TriI2[i] * (IvDnDm1 + IvDnDp1);
+        Alpha_Tri_lower[i] = TriI2[i] * IvDnDm1 - TriI1[i] * Ivsq2Dn;
+        Alpha_Tri_upper[i] = TriI2[i] * IvDnDp1 + TriI1[i] * Ivsq2Dn;                                                                             //  
     }
 
-    Alpha_Tri(fin.size()-1, fin.size()-1) = 8.0 * M_PI * fin[fin.size()-1] +  2.*TriI1[fin.size()-1] * Ivsq2Dn;// - TriI2[i] * (IvDnDm1 + IvDnDp1);
-    Alpha_Tri(fin.size()-1, fin.size()-2) = -2.*TriI1[fin.size()-1] * Ivsq2Dn;
+    Alpha_Tri_diag[fin.size()-1] = 8.0 * M_PI * fin[fin.size()-1] +  2.*TriI1[fin.size()-1] * Ivsq2Dn;// - TriI2[i] * (IvDnDm1 + IvDnDp1);
+    Alpha_Tri_lower[fin.size()-1] = -2.*TriI1[fin.size()-1] * Ivsq2Dn;
 
 
 //     - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-    Alpha_Tri *=  (-1.0) * _LOGee * kpre * Dt;         // (-1) because the matrix moves to the LHS in the equation
+    Alpha_Tri_lower *=  (-1.0) * _LOGee * kpre * Dt;         // (-1) because the matrix moves to the LHS in the equation
+    Alpha_Tri_diag  *=  (-1.0) * _LOGee * kpre * Dt;
+    Alpha_Tri_upper *=  (-1.0) * _LOGee * kpre * Dt;
 //     - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
     //     Evaluate the derivative
@@ -1449,9 +1541,13 @@ void  self_flm_implicit_step::reset_coeff_FP(valarray<double>& fin, const double
     // Collect all terms to share with matrix solve routine
     (_LOGee_x)[position] = _LOGee;
     (Scattering_Term_x)[position] = Scattering_Term;
-    (Alpha_Tri_x)[position] = Alpha_Tri;
+    (Alpha_Tri_lower_x)[position] = Alpha_Tri_lower;
+    (Alpha_Tri_diag_x)[position] = Alpha_Tri_diag;
+    (Alpha_Tri_upper_x)[position] = Alpha_Tri_upper;
     (df0_x)[position] = df0;
     (ddf0_x)[position] = ddf0;
+
+    factorize(position);
     //     - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
     //     - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
 }
@@ -1468,19 +1564,22 @@ void  self_flm_implicit_step::reset_coeff_LB(valarray<double>& fin, const double
 //  Reset the coefficients based on f_0^0 
 //-------------------------------------------------------------------
     // std::cout << "ix = " << position << "\n";
+//     Calculate Dt
+    Dt = Delta_t;
+
+//     Keep the coefficients from the last rebuild if f00 has barely changed
+    if ( !(coeff_record_x[position].outdated(vr, fin, Zvalue, Delta_t)) ) return;
+
     //          Constant
     double I0_density, I2_temperature;
     double _ZLOGei, _LOGee;
 
     valarray<double>  df0(0.,fin.size()), ddf0(0.,fin.size());
-    Array2D<double> Alpha_Tri(fin.size(),fin.size());
+    valarray<double>  Alpha_Tri_lower(0.,fin.size()), Alpha_Tri_diag(0.,fin.size()), Alpha_Tri_upper(0.,fin.size());
     valarray<double> Scattering_Term(fin);
     //          Define the integrals
     valarray<double>  J1m(0.,fin.size()), I0(0.,fin.size()), I2(0.,fin.size());
 
-//     Calculate Dt
-    Dt = Delta_t;
-
 //     INTEGRALS
 //     - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
 //     Temperature integral I2 = 4*pi / (v^2) * int_0^v f(u)*u^4du
@@ -1532,57 +1631,123 @@ void  self_flm_implicit_step::reset_coeff_LB(valarray<double>& fin, const double
 
 //     MAKE TRIDIAGONAL ARRAY
 //     - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
-    Alpha_Tri = 0.0;
 
 
     double deltav = vr[2]-vr[1];
 
     size_t ip = 0;
-    // Alpha_Tri(ip, ip + 1)  = vr[ip]/2/deltav + I2_temperature/deltav/deltav;
-    // Alpha_Tri(ip, ip + 1) *= collisional_coefficient;
+    // Alpha_Tri_upper[ip]  = vr[ip]/2/deltav + I2_temperature/deltav/deltav;
+    // Alpha_Tri_upper[ip] *= collisional_coefficient;
 
-    Alpha_Tri(ip    , ip)  = 1.0;
-    // Alpha_Tri(ip    , ip) += -vr[ip]/2/deltav + I2_temperature/deltav/deltav;
-    // Alpha_Tri(ip    , ip) *= collisional_coefficient;
-    // Alpha_Tri(ip    , ip) += 1.;
+    Alpha_Tri_diag[ip]  = 1.0;
+    // Alpha_Tri_diag[ip] += -vr[ip]/2/deltav + I2_temperature/deltav/deltav;
+    // Alpha_Tri_diag[ip] *= collisional_coefficient;
+    // Alpha_Tri_diag[ip] += 1.;
 
     #pragma ivdep
     for (ip = 1; ip < fin.size() - 1; ++ip)
     {
-        Alpha_Tri(ip, ip + 1)  = vr[ip+1]/2/deltav + I2_temperature/deltav/deltav;
-        // Alpha_Tri(ip, ip + 1) *= collisional_coefficient;
+        Alpha_Tri_upper[ip]  = vr[ip+1]/2/deltav + I2_temperature/deltav/deltav;
+        // Alpha_Tri_upper[ip] *= collisional_coefficient;
 
-        Alpha_Tri(ip    , ip)  = - 2.*I2_temperature/deltav/deltav;
-        // Alpha_Tri(ip    , ip) *= collisional_coefficient;
-        // Alpha_Tri(ip    , ip) += 1.;
+        Alpha_Tri_diag[ip]  = - 2.*I2_temperature/deltav/deltav;
+        // Alpha_Tri_diag[ip] *= collisional_coefficient;
+        // Alpha_Tri_diag[ip] += 1.;
 
-        Alpha_Tri(ip, ip - 1)  = -vr[ip-1]/2/deltav + I2_temperature/deltav/deltav;
-        // Alpha_Tri(ip, ip - 1) *= collisional_coefficient;
+        Alpha_Tri_lower[ip]  = -vr[ip-1]/2/deltav + I2_temperature/deltav/deltav;
+        // Alpha_Tri_lower[ip] *= collisional_coefficient;
     }
 
     ip = fin.size() - 1;
 
-    Alpha_Tri(ip    , ip)  = 1.0;// + vr[ip]/deltav;//I2_temperature/4./deltav/deltav;
-    // Alpha_Tri(ip    , ip - 1)  = - vr[ip]/deltav;//I2_temperature/4./deltav/deltav;
+    Alpha_Tri_diag[ip]  = 1.0;// + vr[ip]/deltav;//I2_temperature/4./deltav/deltav;
+    // Alpha_Tri_lower[ip]  = - vr[ip]/deltav;//I2_temperature/4./deltav/deltav;
     // LHS(ip    , ip) += (vr[ip]+2.*I2_temperature/vr[ip])/(deltav);
     // LHS(ip    , ip) *= collisional_coefficient;
-    // Alpha_Tri(ip    , ip) += 1.;
+    // Alpha_Tri_diag[ip] += 1.;
 
 //     - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-    Alpha_Tri *=  (-1.0) * _LOGee * kpre * Dt / pow(I2_temperature,1.0);         // (-1) because the matrix moves to the LHS in the equation
+    Alpha_Tri_lower *=  (-1.0) * _LOGee * kpre * Dt / pow(I2_temperature,1.0);         // (-1) because the matrix moves to the LHS in the equation
+    Alpha_Tri_diag  *=  (-1.0) * _LOGee * kpre * Dt / pow(I2_temperature,1.0);
+    Alpha_Tri_upper *=  (-1.0) * _LOGee * kpre * Dt / pow(I2_temperature,1.0);
 //     - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 //     - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -     
     // Collect all terms to share with matrix solve routine
     (_LOGee_x)[position] = _LOGee;
     (Scattering_Term_x)[position] = Scattering_Term;
-    (Alpha_Tri_x)[position] = Alpha_Tri;
+    (Alpha_Tri_lower_x)[position] = Alpha_Tri_lower;
+    (Alpha_Tri_diag_x)[position] = Alpha_Tri_diag;
+    (Alpha_Tri_upper_x)[position] = Alpha_Tri_upper;
     (df0_x)[position] = df0;
     (ddf0_x)[position] = ddf0;
+
+    factorize(position);
     //     - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
     //     - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
 }
 //-------------------------------------------------------------------
 //------------------------------------------------------------------------------
+/// @brief      Forward-eliminates the tridiagonal systems at this position.
+///
+///             The matrix depends on l and x but not on m, so it is factored
+///             once per coefficient update. With coll_op FP1 or LB1 only
+///             l = 1 and l > 1 differ.
+///
+/// @param[in]  position  Spatial location
+///
+void  self_flm_implicit_step::factorize(const size_t position) {
+//-------------------------------------------------------------------
+    for (size_t ifac(0); ifac < num_factored; ++ifac)
+    {
+        double ll1(static_cast<double>(ifac+1));
+        ll1 *= (-0.5)*(ll1 + 1.0);
+
+        valarray<double>& Alpha_lower(Alpha_Tri_lower_x[position]);
+        valarray<double>& upper(Alpha_Tri_upperfactor_x[position][ifac]);
+        valarray<double>& invpivot(Alpha_Tri_invpivot_x[position][ifac]);
+        valarray<double>  diag(Alpha_Tri_diag_x[position]);
+
+//      ZEROTH CELL FOR TRIDIAGONAL ARRAY
+        if (ifac > 0) {
+            diag[0] = 0.0;
+        }
+
+//      INCLUDE SCATTERING TERM
+        if (Input::List().coll_op == 0 || Input::List().coll_op == 2)
+        {
+            diag += 1.0;
+        }
+        else if (Input::List().coll_op == 1 || Input::List().coll_op == 3)
+        {
+            for (size_t i(0); i < diag.size(); ++i)
+            {
+                diag[i] += 1.0 - ll1 * (Scattering_Term_x[position])[i];
+            }
+        }
+
+//      Elimination without pivoting is only safe for a diagonally dominant matrix
+        bool dominant(true);
+        for (size_t i(0); i < diag.size(); ++i)
+        {
+            double offdiag( ((i > 0) ? fabs(Alpha_lower[i]) : 0.0) 
+                          + ((i+1 < diag.size()) ? fabs(Alpha_Tri_upper_x[position][i]) : 0.0) );
+            if (fabs(diag[i]) < offdiag) dominant = false;
+        }
+        if (!dominant) cout << "WARNING: Matrix is not diagonally dominant" << endl;
+
+//      Forward elimination, see TridiagonalSolve
+        upper = Alpha_Tri_upper_x[position];
+        invpivot[0] = 1.0/diag[0];
+        upper[0]   /= diag[0];
+        for (size_t i(1); i < diag.size(); ++i)
+        {
+            invpivot[i] = 1.0/(diag[i]-upper[i-1]*Alpha_lower[i]);
+            upper[i]   *= invpivot[i];
+        }
+    }
+}
+//-------------------------------------------------------------------
+//------------------------------------------------------------------------------
 /// @brief      Perform a matrix solve to calculate effect of collisions on f >= 1
 ///
 /// @param      fin   Input distribution function
@@ -1593,14 +1758,13 @@ void  self_flm_implicit_step::advance(valarray<complex<double> >& fin, const int
 //-------------------------------------------------------------------
 //  Collisions
 //-------------------------------------------------------------------
-    Array2D<double> Alpha(Alpha_Tri_x[position]);
-    valarray<complex<double> > fout(fin);
+    size_t ifac( ((static_cast<size_t>(el) < num_factored) ? static_cast<size_t>(el) : num_factored) - 1 );
+
+    const valarray<double>& Alpha_lower(Alpha_Tri_lower_x[position]);
+    const valarray<double>& upper(Alpha_Tri_upperfactor_x[position][ifac]);
+    const valarray<double>& invpivot(Alpha_Tri_invpivot_x[position][ifac]);
+    size_t n(fin.size());
 
-//      ZEROTH CELL FOR TRIDIAGONAL ARRAY
-//     - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
-    if (el > 1) {
-        Alpha(0,0) = 0.0;
-    }
 //     - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
     if (Input::List().ee_bool)
     {
@@ -1610,60 +1774,19 @@ void  self_flm_implicit_step::advance(valarray<complex<double> >& fin, const int
         }
     }
 //     - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
-    // }
-
-//      INCLUDE SCATTERING TERM
-//     - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
-    double ll1(static_cast<double>(el));
-    ll1 *= (-0.5)*(ll1 + 1.0);
-
 
-    if (Input::List().coll_op == 0 || Input::List().coll_op == 2)
+    /// SOLVE A * Fout  = Fin with the stored factors of A
+    //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+    fin[0] *= invpivot[0];
+    for (size_t i(1); i < n; ++i)
     {
-        for (size_t i(0); i < Alpha.dim1(); ++i)
-        {
-            Alpha(i,i) += 1.0;
-        }
+        fin[i] -= fin[i-1] * Alpha_lower[i];
+        fin[i] *= invpivot[i];
     }
-    else if (Input::List().coll_op == 1 || Input::List().coll_op == 3)
+    for (size_t i(2); i < n+1; ++i)
     {
-        for (size_t i(0); i < Alpha.dim1(); ++i)
-        {
-            Alpha(i,i) += 1.0 - ll1 * (Scattering_Term_x[position])[i];
-        }
+        fin[n-i] -= upper[n-i] * fin[n-i+1];
     }
-    
-//     - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-
-    /// SOLVE A * Fout  = Fin
-    //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-    // std::cout << "\n10\n";
-    
-    // if ( !(if_tridiagonal) && (Input::List().coll_op < 2) )
-    // {
-    //     if ( !(Gauss_Seidel(Alpha, fin, fout)) ) 
-    //     {  // Invert A * fout = fin
-    //         cout << "WARNING: Matrix is not diagonally dominant" << endl;
-    //     }
-    // }
-    // else
-    // {
-        if ( !(Thomas_Tridiagonal(Alpha, fin, fout)) ) 
-        {  // Invert A * fout = fin
-            cout << "WARNING: Matrix is not diagonally dominant" << endl;
-        }
-    // }
-
-
-    // if (Input::List().ee_bool)
-    // {
-    //     if ( !(if_tridiagonal) && (Input::List().coll_op < 2)  )
-    //     {
-    //         collide_f0withRBflm(fin, double (el), position);
-    //     }
-    // }
-
-    fin = fout;
 
 //     - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
 
@@ -1778,11 +1901,11 @@ void  self_flm_implicit_step::flm_solve(const DistFunc1D& DF, DistFunc1D& DFh)
             /// And then pack it up
             for (size_t i(0); i < nump; ++i)
             {
-                dd_GPU[ i + base_index] = Alpha_Tri_x[ix+Nbc](i,i)  + (1.0 - ll1 * (Scattering_Term_x[ix+Nbc])[i]);
+                dd_GPU[ i + base_index] = Alpha_Tri_diag_x[ix+Nbc][i]  + (1.0 - ll1 * (Scattering_Term_x[ix+Nbc])[i]);
                 fin_GPU[i + base_index] = fin_singleharmonic[i].real();
                 //DF(dist_il[id+id_low],dist_im[id+id_low])(i,ix+Nbc).real();
 
-                dd_GPU[ i + base_index + nump] = Alpha_Tri_x[ix+Nbc](i,i)  + (1.0 - ll1 * (Scattering_Term_x[ix+Nbc])[i]);
+                dd_GPU[ i + base_index + nump] = Alpha_Tri_diag_x[ix+Nbc][i]  + (1.0 - ll1 * (Scattering_Term_x[ix+Nbc])[i]);
                 fin_GPU[i + base_index + nump] = fin_singleharmonic[i].imag();
                 // DF(dist_il[id+id_low],dist_im[id+id_low])(i,ix+Nbc).imag();
             }
@@ -1795,11 +1918,11 @@ void  self_flm_implicit_step::flm_solve(const DistFunc1D& DF, DistFunc1D& DFh)
 
             for (size_t i(0); i < nump - 1; ++i)
             {
-                ld_GPU[i + 1 + base_index] = Alpha_Tri_x[ix+Nbc](i+1,i);
-                ud_GPU[i +     base_index] = Alpha_Tri_x[ix+Nbc](i,i+1);
+                ld_GPU[i + 1 + base_index] = Alpha_Tri_lower_x[ix+Nbc][i+1];
+                ud_GPU[i +     base_index] = Alpha_Tri_upper_x[ix+Nbc][i];
                 
-                ld_GPU[i + 1 + base_index + nump] = Alpha_Tri_x[ix+Nbc](i+1,i);
-                ud_GPU[i +     base_index + nump] = Alpha_Tri_x[ix+Nbc](i,i+1);
+                ld_GPU[i + 1 + base_index + nump] = Alpha_Tri_lower_x[ix+Nbc][i+1];
+                ud_GPU[i +     base_index + nump] = Alpha_Tri_upper_x[ix+Nbc][i];
             }
         }
     }
@@ -1926,11 +2049,11 @@ void  self_flm_implicit_step::flm_solve(DistFunc1D& DF)
             /// And then pack it up
             for (size_t i(0); i < nump; ++i)
             {
-                dd_GPU[ i + base_index] = Alpha_Tri_x[ix+Nbc](i,i)  + (1.0 - ll1 * (Scattering_Term_x[ix+Nbc])[i]);
+                dd_GPU[ i + base_index] = Alpha_Tri_diag_x[ix+Nbc][i]  + (1.0 - ll1 * (Scattering_Term_x[ix+Nbc])[i]);
                 fin_GPU[i + base_index] = fin_singleharmonic[i].real();
                 //DF(dist_il[id+id_low],dist_im[id+id_low])(i,ix+Nbc).real();
 
-                dd_GPU[ i + base_index + nump] = Alpha_Tri_x[ix+Nbc](i,i)  + (1.0 - ll1 * (Scattering_Term_x[ix+Nbc])[i]);
+                dd_GPU[ i + base_index + nump] = Alpha_Tri_diag_x[ix+Nbc][i]  + (1.0 - ll1 * (Scattering_Term_x[ix+Nbc])[i]);
                 fin_GPU[i + base_index + nump] = fin_singleharmonic[i].imag();
                 // DF(dist_il[id+id_low],dist_im[id+id_low])(i,ix+Nbc).imag();
             }
@@ -1943,11 +2066,11 @@ void  self_flm_implicit_step::flm_solve(DistFunc1D& DF)
 
             for (size_t i(0); i < nump - 1; ++i)
             {
-                ld_GPU[i + 1 + base_index] = Alpha_Tri_x[ix+Nbc](i+1,i);
-                ud_GPU[i +     base_index] = Alpha_Tri_x[ix+Nbc](i,i+1);
+                ld_GPU[i + 1 + base_index] = Alpha_Tri_lower_x[ix+Nbc][i+1];
+                ud_GPU[i +     base_index] = Alpha_Tri_upper_x[ix+Nbc][i];
                 
-                ld_GPU[i + 1 + base_index + nump] = Alpha_Tri_x[ix+Nbc](i+1,i);
-                ud_GPU[i +     base_index + nump] = Alpha_Tri_x[ix+Nbc](i,i+1);
+                ld_GPU[i + 1 + base_index + nump] = Alpha_Tri_lower_x[ix+Nbc][i+1];
+                ud_GPU[i +     base_index + nump] = Alpha_Tri_upper_x[ix+Nbc][i];
             }
         }
     }
@@ -2093,6 +2216,15 @@ void self_flm_implicit_collisions::advanceflm(const DistFunc1D& DF, const valarr
             {
                 for(size_t m = 0; m < ((m0 < l)? m0:l)+1; ++m)
                 {
+                    //  Truncated harmonic, nothing to collide
+                    if (l > DF.l_active(ix+Nbc))
+                    {
+                        for (size_t ip(0); ip < DF(0,0).nump(); ++ip){
+                            DFh(l,m)(ip,ix+Nbc) = 0.0;
+                        }
+                        continue;
+                    }
+
                     valarray<complex<double> > fc(static_cast<complex<double> >(0.),DF(0,0).nump());
                     // This harmonic --> Valarray
                     for (size_t ip(0); ip < fc.size(); ++ip){
@@ -2157,6 +2289,8 @@ void self_flm_implicit_collisions::advanceflm(DistFunc1D& DF, const valarray<dou
             {
                 for(size_t m = 0; m < ((m0 < l)? m0:l)+1; ++m)
                 {
+                    if (l > DF.l_active(ix+Nbc)) continue;
+
                     valarray<complex<double> > fc(static_cast<complex<double> >(0.),DF(0,0).nump());
                     // This harmonic --> Valarray
                     for (size_t ip(0); ip < fc.size(); ++ip){
@@ -2663,6 +2797,14 @@ void collisions_1D::advance(State1D& Yin, const double time, const double step_s
     
     // if (Input::List().filterdistribution) Yh.DF(s) = Yh.DF(s).Filterp();
 
+    //  The copy back is the last update of f0 in the step, so the health tallies ride on it
+    if (Input::List().health_check)
+    {
+        tally.resize(4);
+        Yin.DF(0).assign_checked(Yh.DF(0), Input::List().BoundaryCells, &tally[0]);
+        return;
+    }
+
     #pragma omp parallel for num_threads(Input::List().ompthreads)
     // for (size_t s = 0; s < Yin.Species(); ++s){
     for (size_t i = 0; i < Yin.DF(0).dim(); ++i){
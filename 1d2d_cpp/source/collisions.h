@@ -18,6 +18,35 @@
 /** \addtogroup vfp1d
  *  @{
  */
+//-------------------------------------------------------------------
+/** \class  f00_moments_record
+ *  \brief  Moments of f00 that the collision coefficients of a cell were built from
+ *
+ *   The implicit collision operators only see f00 through a few integrals.
+ *   The record keeps the density, I2 and I4 of the f00 used for the last
+ *   rebuild of the coefficients in one cell, and decides whether the
+ *   coefficients can be reused for the current f00.
+ */
+class f00_moments_record {
+//-------------------------------------------------------------------
+public:
+    f00_moments_record();
+
+    /// Returns true, and records the new moments, if the coefficients
+    /// have to be rebuilt for this f00.
+    bool outdated(const valarray<double>& vr, const valarray<double>& fin);
+    bool outdated(const valarray<double>& vr, const valarray<double>& fin, const double _Zvalue, const double _step_size);
+
+private:
+    bool   recorded;
+    size_t age;
+    double density, I2, I4;
+    double Zvalue, step_size;
+
+    bool   drifted(const double current, const double previous);
+};
+//-------------------------------------------------------------------
+
 class self_f00_implicit_step {
 //-------------------------------------------------------------------
 private:
@@ -48,6 +77,11 @@ private:
     double c_kpre;
     double vw_coeff_cube;
 
+    ///     Rosenbluth and Chang-Cooper quantities for each spatial location
+    vector<valarray<double> >   C_RB_x, D_RB_x, delta_CC_x;
+    vector<double>              I4_Lnee_x;
+    vector<f00_moments_record>  coeff_record_x;
+
     Formulary formulas;
 
     void   update_C_Rosenbluth(valarray<double> &C_RB, double &I4_Lnee, valarray<double>& fin);
@@ -57,9 +91,9 @@ private:
     double calc_delta_ChangCooper(const size_t& k, const double C, const double D);
 
 public:
-    self_f00_implicit_step(const valarray<double>& dp, const double _mass, bool _ib);
+    self_f00_implicit_step(const size_t numxtotal, const valarray<double>& dp, const double _mass, bool _ib);
 
-    void takestep(valarray<double> &fin, valarray<double> &fh, const double Z0, const double heating, const double step_size);//, const double& cooling);
+    void takestep(valarray<double> &fin, valarray<double> &fh, const double Z0, const double heating, const double step_size, const size_t position);//, const double& cooling);
     void takeLBstep(valarray<double> &fin, valarray<double> &fh, const double step_size);//, const double& cooling);
 
 };
@@ -262,8 +296,14 @@ class self_f00_explicit_step {
 
             vector<double>              _LOGee_x;
             vector<valarray<double> >   Scattering_Term_x; 
-            vector<Array2D<double>  >   Alpha_Tri_x; 
+            vector<valarray<double> >   Alpha_Tri_lower_x, Alpha_Tri_diag_x, Alpha_Tri_upper_x;
             vector<valarray<double> >   df0_x, ddf0_x;
+            vector<f00_moments_record>  coeff_record_x;
+
+//          Forward-elimination factors of Alpha_Tri, one set per distinct l
+            size_t                                  num_factored;
+            vector<vector<valarray<double> > >      Alpha_Tri_upperfactor_x, Alpha_Tri_invpivot_x;
+            void factorize(const size_t position);
             
             Formulary formulas;
 
@@ -414,9 +454,13 @@ class self_f00_explicit_step {
             // void advancef1(State1D& Y);
             // void advanceflm(State1D& Y);
 
+        //  Health tallies of species 0 from the last advance, see DistFunc1D::assign_checked
+            const valarray<double>& health() const {return tally;}
+
         private:
         //  Variables
             State1D Yh;
+            valarray<double> tally;
             vector<self_collisions> self_coll;
             // vector<interspecies_collisions> unself_coll;
 //            vector<interspecies_f00_explicit_collisions> unself_f00_coll;
@@ -321,7 +321,7 @@ void Export_Files::Folders(){
 
     if (  Input::List().o_p1x1 || Input::List().o_p2x1 || Input::List().o_p3x1 ||
       Input::List().o_p1p3x1 || Input::List().o_p1p2x1 || Input::List().o_p2p3x1 ||
-      Input::List().o_p1x1_th0 ||
+      Input::List().o_p1p2p3x1 || Input::List().o_p1x1_th0 ||
       Input::List().o_f0x1 ||  Input::List().o_f10x1 ||  Input::List().o_f11x1 
       ||  Input::List().o_f20x1 || Input::List().o_fl0x1 
       || Input::List().o_allfs || Input::List().o_allfs_f2 || Input::List().o_allfs_flogf) {
@@ -445,9 +445,11 @@ Export_Files::DefaultTags::DefaultTags(size_t species){
         pvsx.push_back( "pxpy");
         pvsx.push_back( "pypz");
         pvsx.push_back( "pxpz");
+        pvsx.push_back( "pxpypz");
     }
 
     code.push_back("Timings");
+    code.push_back("Health");
 
 }
 
@@ -591,6 +593,7 @@ Export_Files::Xport::Xport(const Algorithms::AxisBundle<double>& _axis,
             string folder = homedir + "output/fields/" + nounits + "/";
                 
             Hdr[nounits] = Header(axis_units, dTags.fld[i], folder);
+            Deflate[nounits] = Input::List().h5_deflate_fields;
         }
     } // <--
 
@@ -604,6 +607,7 @@ Export_Files::Xport::Xport(const Algorithms::AxisBundle<double>& _axis,
             string folder = homedir + "output/moments/" + nounits + "/";
             //         Generate a header file for this tag
             Hdr[nounits] = Header(axis_units, dTags.mom[i], folder);
+            Deflate[nounits] = Input::List().h5_deflate_moments;
         }
     } // <--
 
@@ -618,6 +622,8 @@ Export_Files::Xport::Xport(const Algorithms::AxisBundle<double>& _axis,
 
 //          Generate a header file for this tag
             Hdr[dTags.pvsx[i]] = Header(axis_units, dTags.pvsx[i], folder);
+            Deflate[dTags.pvsx[i]] = Input::List().h5_deflate_distributions;
+            Lossy[dTags.pvsx[i]]   = true;
         }
     } //<--
 
@@ -634,6 +640,8 @@ Export_Files::Xport::Xport(const Algorithms::AxisBundle<double>& _axis,
             // Hdr[dTags.fvsx[i]] = Header( pr[i/5], xyz[0], imre[0],
             //  "f", 1.0, tlabel, tunits, tconv, folder);
             Hdr[dTags.fvsx[i]] = Header(axis_units, dTags.fvsx[i], folder);
+            Deflate[dTags.fvsx[i]] = Input::List().h5_deflate_distributions;
+            Lossy[dTags.fvsx[i]]   = true;
 
         }
     } //<--
@@ -681,17 +689,120 @@ string Export_Files::Xport::oH5Fextension(size_t step, int species){
     return sFilename.str();
 }
 //--------------------------------------------------------------
+//  Where a dump goes: the root of its own file or, with 
+//  h5_consolidate, the group of its step in a single file per 
+//  tag and species. A fresh run starts each such file over, a
+//  restarted run drops the steps it is about to redo.
+HighFive::Group Export_Files::Xport::dump_group(const std::string tag, const size_t step, const int spec, 
+    const bool create) {
+
+    string filename(Hdr[tag].Directory());
+
+    if (!Input::List().h5_consolidate)
+    {
+        filename.append(tag).append(oH5Fextension(step,spec));
+        if (create) return HighFive::File(filename, HighFive::File::ReadWrite | HighFive::File::Create | HighFive::File::Truncate).getGroup("/");
+        return HighFive::File(filename, HighFive::File::ReadWrite).getGroup("/");
+    }
+
+    stringstream sFilename;
+    if(spec >= 0) sFilename << "_s" << spec;
+    sFilename << ofconventions::h5file_extension;
+    filename.append(tag).append(sFilename.str());
+
+    struct stat buf;
+    if (!Opened[filename] && !(Input::List().isthisarestart && stat(filename.c_str(), &buf) == 0))
+    {
+        HighFive::File fresh(filename, HighFive::File::ReadWrite | HighFive::File::Create | HighFive::File::Truncate);
+    }
+
+    HighFive::File file(filename, HighFive::File::ReadWrite);
+
+    if (!Opened[filename])
+    {
+        vector<string> steps(file.listObjectNames());
+        for (size_t i(0); i < steps.size(); ++i)
+        {
+            if (size_t(atol(steps[i].c_str())) >= step) H5Ldelete(file.getId(), steps[i].c_str(), H5P_DEFAULT);
+        }
+        Opened[filename] = true;
+    }
+
+//  Groups are named like the step in the per-step file names
+    string group(oH5Fextension(step).substr(1, ofconventions::ofile_digits));
+
+    if (!create) return file.getGroup(group);
+
+    if (file.exist(group)) H5Ldelete(file.getId(), group.c_str(), H5P_DEFAULT);
+    return file.createGroup(group);
+}
+//--------------------------------------------------------------
 //**************************************************************
 
 
 
 //**************************************************************
 //--------------------------------------------------------------
+//  Complex arrays are stored as flat, interleaved (re, im) 
+//  datasets in chunks that fit in the default chunk cache, so 
+//  that single columns can be read back cheaply when remapping.
+static string restart_dataset(const string kind, const size_t s, const size_t n) {
+    stringstream name;
+    name << kind << "_s" << s << "_" << n;
+    return name.str();
+}
+//--------------------------------------------------------------
+static void write_restart_h5(HighFive::File& file, const string name, const complex<double>* data, const size_t n) {
+
+    hsize_t dims[1]  = {2*n};
+    hsize_t chunk[1] = {min(hsize_t(2*n), hsize_t(1 << 16))};
+
+    hid_t space(H5Screate_simple(1, dims, NULL));
+    hid_t dcpl(H5Pcreate(H5P_DATASET_CREATE));
+    if (n > 0 && H5Zfilter_avail(H5Z_FILTER_DEFLATE) > 0)
+    {
+        H5Pset_chunk(dcpl, 1, chunk);
+        H5Pset_shuffle(dcpl);
+        H5Pset_deflate(dcpl, Input::List().restart_deflate);
+    }
+    hid_t dset(H5Dcreate2(file.getId(), name.c_str(), H5T_NATIVE_DOUBLE, space, H5P_DEFAULT, dcpl, H5P_DEFAULT));
+    H5Dwrite(dset, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, (const double*) data);
+
+    H5Dclose(dset);
+    H5Pclose(dcpl);
+    H5Sclose(space);
+}
+//--------------------------------------------------------------
+//  Read n values starting at value offset
+static void read_restart_h5(HighFive::File& file, const string name, complex<double>* data, 
+    const size_t offset, const size_t n) {
+
+    hsize_t start[1] = {2*offset};
+    hsize_t count[1] = {2*n};
+
+    hid_t dset(H5Dopen2(file.getId(), name.c_str(), H5P_DEFAULT));
+    if (dset < 0) {
+        std::cout << "\n\n ERROR :: No dataset " << name << " in restart file\n\n";
+        exit(1);
+    }
+    hid_t fspace(H5Dget_space(dset));
+    H5Sselect_hyperslab(fspace, H5S_SELECT_SET, start, NULL, count, NULL);
+    hid_t mspace(H5Screate_simple(1, count, NULL));
+    H5Dread(dset, H5T_NATIVE_DOUBLE, mspace, fspace, H5P_DEFAULT, (double*) data);
+
+    H5Sclose(mspace);
+    H5Sclose(fspace);
+    H5Dclose(dset);
+}
+//--------------------------------------------------------------
 Export_Files::Restart_Facility::Restart_Facility(const int rank, string homedir) {
     hdir = homedir;
 
     if (!rank) Makefolder(hdir+"restart/");
 
+//      buddy_dir is node-local, so every rank makes sure it exists
+    if (Input::List().n_buddy_checkpoints > 0 && Input::List().buddy_dir != "none") Makefolder(Input::List().buddy_dir);
+
 //        if (Makefolder(hdir+"restart/") != 0) cout<<"Warning: Folder "<< hdir+"restart/"<<" exists\n";
 }
 
@@ -699,10 +810,26 @@ Export_Files::Restart_Facility::Restart_Facility(const int rank, string homedir)
 //  Read restart file
 void Export_Files::Restart_Facility::Read(const int rank, const size_t re_step, State1D& Y, double time_start) {
 
+//      Files written with other slabs are remapped column by column
+    const vector<size_t>& old_slabs(Load_Balance::Restart_Slabs());
+    if (!old_slabs.empty() && (old_slabs != Input::List().NxSlabs)) 
+    {
+        Read_Remapped(rank, re_step, Y, old_slabs);
+        return;
+    }
+
 //      Generate filename 
     string   filename(hdir+"restart/re_1D_");
+    string   h5name(filename + rFextension(rank,re_step,ofconventions::h5file_extension));
     filename.append(rFextension(rank,re_step));
 
+    struct stat buf;
+    if (stat(h5name.c_str(), &buf) == 0)
+    {
+        Read_h5(h5name, Y);
+        return;
+    }
+
 //      Open file
     ifstream  fin(filename.c_str(), ios::binary);
     if (fin)
@@ -744,6 +871,14 @@ void Export_Files::Restart_Facility::Write(const int rank, const size_t re_step,
 
 //      Generate filename 
     string   filename(hdir+"restart/re_1D_");
+
+    if (Input::List().restart_deflate > 0)
+    {
+        Write_h5(filename + rFextension(rank,re_step,ofconventions::h5file_extension), Y, time_dump);
+        if (!rank) Load_Balance::Write_Profile(hdir, re_step);
+        return;
+    }
+
     filename.append(rFextension(rank,re_step));
 
 //      Open file
@@ -770,16 +905,124 @@ void Export_Files::Restart_Facility::Write(const int rank, const size_t re_step,
 
     fout.flush();
     fout.close();
+
+//      The slabs of this dump and the measured cost profile
+    if (!rank) Load_Balance::Write_Profile(hdir, re_step);
+}
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+//  Read restart files written with the slabs old_slabs
+void Export_Files::Restart_Facility::Read_Remapped(const int rank, const size_t re_step, State1D& Y, const vector<size_t>& old_slabs) {
+
+    int Nbc(Input::List().BoundaryCells);
+    int Nx(Input::List().NxGlobal[0]);
+    size_t numx(Y.EMF().Ex().numx());
+
+//      Global index of the first interior cell of each old rank
+    vector<int> old_first(old_slabs.size(), 0);
+    for (size_t q(1); q < old_slabs.size(); ++q) old_first[q] = old_first[q-1] + old_slabs[q-1];
+
+    int first(-Nbc);
+    for (int q(0); q < rank; ++q) first += Input::List().NxSlabs[q];
+
+//      Old rank and column of every local column, guard cells included
+    vector<int> owner(numx), old_ix(numx);
+    for (size_t ix(0); ix < numx; ++ix) {
+        int g(first + int(ix)), q(0);
+        if (g >= Nx) q = old_slabs.size()-1;
+        else if (g >= 0) {
+            while ((q+1 < int(old_slabs.size())) && (g >= old_first[q+1])) ++q;
+        }
+        owner[ix]  = q;
+        old_ix[ix] = g - old_first[q] + Nbc;
+    }
+
+    for (int q(0); q < int(old_slabs.size()); ++q) {
+
+        if (find(owner.begin(), owner.end(), q) == owner.end()) continue;
+
+        string   filename(hdir+"restart/re_1D_");
+        string   h5name(filename + rFextension(q,re_step,ofconventions::h5file_extension));
+        filename.append(rFextension(q,re_step));
+
+        struct stat buf;
+        if (stat(h5name.c_str(), &buf) == 0)
+        {
+            HighFive::File file(h5name, HighFive::File::ReadOnly);
+
+            for(size_t s(0); s < Y.Species(); ++s) {
+                for(size_t nh(0); nh < Y.DF(s).dim(); ++nh) {
+                    size_t nump((Y.DF(s))(nh).nump());
+                    for(size_t ix(0); ix < numx; ++ix) {
+                        if (owner[ix] == q) read_restart_h5(file, restart_dataset("f", s, nh), 
+                            &(Y.DF(s))(nh)(nump*ix), nump*old_ix[ix], nump);
+                    }
+                }
+            }
+            for(size_t ifields(0); ifields < Y.Fields(); ++ifields){
+                for(size_t ix(0); ix < numx; ++ix) {
+                    if (owner[ix] == q) read_restart_h5(file, restart_dataset("field", 0, ifields), 
+                        &(Y.FLD(ifields))(ix), old_ix[ix], 1);
+                }
+            }
+            continue;
+        }
+
+        ifstream  fin(filename.c_str(), ios::binary);
+        if (!fin) {
+            std::cout << "\n\n ERROR :: No restart file " << filename << "\n\n";
+            exit(1);
+        }
+
+        size_t   old_numx(old_slabs[q] + 2*Nbc);
+        streamoff block(sizeof(double));        // time of the dump
+
+    //      Distribution functions, one contiguous momentum column per cell
+        for(size_t s(0); s < Y.Species(); ++s) {
+            for(size_t nh(0); nh < Y.DF(s).dim(); ++nh) {
+
+                size_t nump((Y.DF(s))(nh).nump());
+                for(size_t ix(0); ix < numx; ++ix) {
+                    if (owner[ix] != q) continue;
+                    fin.seekg(block + streamoff(sizeof(complex<double>) * nump * old_ix[ix]));
+                    fin.read((char *)&(Y.DF(s))(nh)(nump*ix), sizeof(complex<double>) * nump);
+                }
+                block += streamoff(sizeof(complex<double>) * nump * old_numx);
+            }
+        }
+
+    //      Fields
+        for(size_t ifields(0); ifields < Y.Fields(); ++ifields){
+            for(size_t ix(0); ix < numx; ++ix) {
+                if (owner[ix] != q) continue;
+                fin.seekg(block + streamoff(sizeof(complex<double>) * old_ix[ix]));
+                fin.read((char *)(&(Y.FLD(ifields))(ix)), sizeof(complex<double>));
+            }
+            block += streamoff(sizeof(complex<double>) * old_numx);
+        }
+
+        fin.close();
+    }
 }
 //--------------------------------------------------------------
+
 //--------------------------------------------------------------
 //  Read restart file
 void Export_Files::Restart_Facility::Read(const int rank, const size_t re_step, State2D& Y, double time_start) {
 
 //      Generate filename 
     string   filename(hdir+"restart/re_2D_");
+    string   h5name(filename + rFextension(rank,re_step,ofconventions::h5file_extension));
     filename.append(rFextension(rank,re_step));
 
+    struct stat buf;
+    if (stat(h5name.c_str(), &buf) == 0)
+    {
+        Read_h5(h5name, Y);
+        return;
+    }
+
 //      Open file
     ifstream  fin(filename.c_str(), ios::binary);
 
@@ -823,6 +1066,13 @@ void Export_Files::Restart_Facility::Write(const int rank, const size_t re_step,
 
 //      Generate filename 
     string   filename(hdir+"restart/re_2D_");
+
+    if (Input::List().restart_deflate > 0)
+    {
+        Write_h5(filename + rFextension(rank,re_step,ofconventions::h5file_extension), Y, time_dump);
+        return;
+    }
+
     filename.append(rFextension(rank,re_step));
 
 //      Open file
@@ -858,10 +1108,280 @@ void Export_Files::Restart_Facility::Write(const int rank, const size_t re_step,
 }
 //--------------------------------------------------------------
 
+//--------------------------------------------------------------
+void Export_Files::Restart_Facility::Write_h5(const string filename, State1D& Y, double time_dump) {
+
+    HighFive::File file(filename, HighFive::File::ReadWrite | HighFive::File::Create | HighFive::File::Truncate);
+
+    vector<double> t(1, time_dump);
+    HighFive::DataSet dataset_time = file.createDataSet<double>("time", HighFive::DataSpace::From(t));
+    dataset_time.write(t);
+
+    for (size_t s(0); s < Y.Species(); ++s) {
+        for (size_t nh(0); nh < Y.DF(s).dim(); ++nh) {
+            write_restart_h5(file, restart_dataset("f", s, nh), &(Y.DF(s))(nh)(0), (Y.DF(s))(nh).dim());
+        }
+    }
+    for(size_t ifields(0); ifields < Y.Fields(); ++ifields){
+        write_restart_h5(file, restart_dataset("field", 0, ifields), &(Y.FLD(ifields))(0), Y.EMF().Ex().numx());
+    }
+}
+//--------------------------------------------------------------
+void Export_Files::Restart_Facility::Read_h5(const string filename, State1D& Y) {
+
+    HighFive::File file(filename, HighFive::File::ReadOnly);
+
+    for (size_t s(0); s < Y.Species(); ++s) {
+        for (size_t nh(0); nh < Y.DF(s).dim(); ++nh) {
+            read_restart_h5(file, restart_dataset("f", s, nh), &(Y.DF(s))(nh)(0), 0, (Y.DF(s))(nh).dim());
+        }
+    }
+    for(size_t ifields(0); ifields < Y.Fields(); ++ifields){
+        read_restart_h5(file, restart_dataset("field", 0, ifields), &(Y.FLD(ifields))(0), 0, Y.EMF().Ex().numx());
+    }
+}
+//--------------------------------------------------------------
+void Export_Files::Restart_Facility::Write_h5(const string filename, State2D& Y, double time_dump) {
+
+    HighFive::File file(filename, HighFive::File::ReadWrite | HighFive::File::Create | HighFive::File::Truncate);
+
+    vector<double> t(1, time_dump);
+    HighFive::DataSet dataset_time = file.createDataSet<double>("time", HighFive::DataSpace::From(t));
+    dataset_time.write(t);
+
+    for (size_t s(0); s < Y.Species(); ++s) {
+        for (size_t nh(0); nh < Y.DF(s).dim(); ++nh) {
+            write_restart_h5(file, restart_dataset("f", s, nh), &(Y.DF(s))(nh)(0), (Y.DF(s))(nh).dim());
+        }
+    }
+    for(size_t ifields(0); ifields < Y.Fields(); ++ifields){
+        write_restart_h5(file, restart_dataset("field", 0, ifields), &(Y.FLD(ifields)).array().array()[0], 
+            Y.EMF().Ex().numx()*Y.EMF().Ex().numy());
+    }
+}
+//--------------------------------------------------------------
+void Export_Files::Restart_Facility::Read_h5(const string filename, State2D& Y) {
+
+    HighFive::File file(filename, HighFive::File::ReadOnly);
+
+    for (size_t s(0); s < Y.Species(); ++s) {
+        for (size_t nh(0); nh < Y.DF(s).dim(); ++nh) {
+            read_restart_h5(file, restart_dataset("f", s, nh), &(Y.DF(s))(nh)(0), 0, (Y.DF(s))(nh).dim());
+        }
+    }
+    for(size_t ifields(0); ifields < Y.Fields(); ++ifields){
+        read_restart_h5(file, restart_dataset("field", 0, ifields), &(Y.FLD(ifields)).array().array()[0], 0, 
+            Y.EMF().Ex().numx()*Y.EMF().Ex().numy());
+    }
+}
+//--------------------------------------------------------------
+//  Buddy copies go to a temporary file that is then renamed, so
+//  a crash in the middle of a checkpoint leaves the last one
+static void save_buddy(const string filename, const valarray< complex<double> >& copy) {
+
+    string tmpname(filename + ".tmp");
+    ofstream fout(tmpname.c_str(), ios::binary);
+    size_t n(copy.size());
+    fout.write((char *) &n, sizeof(n));
+    fout.write((char *) &copy[0], n*sizeof(copy[0]));
+    fout.close();
+
+    if (!fout || rename(tmpname.c_str(), filename.c_str()) != 0) {
+        std::cout << "\n\n ERROR :: Cannot write " << filename << "\n\n";
+        exit(1);
+    }
+}
+//--------------------------------------------------------------
+static bool load_buddy(const string filename, valarray< complex<double> >& copy) {
+
+    ifstream fin(filename.c_str(), ios::binary);
+    size_t n(0);
+    if (!fin.read((char *) &n, sizeof(n))) return false;
+
+    copy.resize(n);
+    return bool(fin.read((char *) &copy[0], n*sizeof(copy[0])));
+}
+//--------------------------------------------------------------
+string Export_Files::Restart_Facility::buddy_file(const string dir, const int owner, const int holder) {
+    stringstream sFilename;
+    sFilename << dir << "/re_1D_" << owner << "_on_" << holder << ofconventions::rfile_extension;
+    return sFilename.str();
+}
+//--------------------------------------------------------------
+//  The ring of buddies runs over the local ranks of every node in
+//  turn, i.e. node 0 local rank 0, node 1 local rank 0, ..., node 0 
+//  local rank 1, ... so that with more than one node the copy of 
+//  a rank is held on another node. next[r] holds the copy of r.
+void Export_Files::Restart_Facility::buddy_ring(MPI_Comm comm, vector<int>& next) {
+
+    int rank, nranks;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &nranks);
+
+    MPI_Comm node_comm;
+    int local_rank, node_leader(rank);
+    MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &node_comm);
+    MPI_Comm_rank(node_comm, &local_rank);
+    MPI_Bcast(&node_leader, 1, MPI_INT, 0, node_comm);
+    MPI_Comm_free(&node_comm);
+
+    int mine[2] = {local_rank, node_leader};
+    vector<int> all(2*nranks);
+    MPI_Allgather(mine, 2, MPI_INT, &all[0], 2, MPI_INT, comm);
+
+    vector< pair< pair<int,int>, int> > order;
+    for (int r(0); r < nranks; ++r) order.push_back(make_pair(make_pair(all[2*r], all[2*r+1]), r));
+    sort(order.begin(), order.end());
+
+    next.resize(nranks);
+    for (int i(0); i < nranks; ++i) next[order[i].second] = order[(i+1) % nranks].second;
+}
+//--------------------------------------------------------------
+//  Every rank sends its copy to the next one around the ring of
+//  spatial ranks and keeps the copy of the previous one
+void Export_Files::Restart_Facility::Write_Buddy(const size_t re_step, State1D& Y, const double time_dump, const bool to_disk) {
+
+    MPI_Comm comm(Time_Decomposition::Slice_Comm());
+    int rank, nranks;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &nranks);
+
+    if (int(buddy_next.size()) != nranks) buddy_ring(comm, buddy_next);
+    int next(buddy_next[rank]), prev(int(find(buddy_next.begin(), buddy_next.end(), rank) - buddy_next.begin()));
+
+    size_t n(1);
+    for (size_t s(0); s < Y.Species(); ++s) {
+        for (size_t nh(0); nh < Y.DF(s).dim(); ++nh) n += (Y.DF(s))(nh).dim();
+    }
+    n += Y.Fields()*Y.EMF().Ex().numx();
+
+    own_copy.resize(n);
+    own_copy[0] = complex<double>(time_dump, double(re_step));
+
+    complex<double>* pos(&own_copy[1]);
+    for (size_t s(0); s < Y.Species(); ++s) {
+        for (size_t nh(0); nh < Y.DF(s).dim(); ++nh) {
+            pos = std::copy(&(Y.DF(s))(nh)(0), &(Y.DF(s))(nh)(0) + (Y.DF(s))(nh).dim(), pos);
+        }
+    }
+    for(size_t ifields(0); ifields < Y.Fields(); ++ifields){
+        pos = std::copy(&(Y.FLD(ifields))(0), &(Y.FLD(ifields))(0) + Y.EMF().Ex().numx(), pos);
+    }
+
+//      Slabs may differ in width, so the size goes first
+    unsigned long own_size(n), held_size(0);
+    MPI_Sendrecv(&own_size, 1, MPI_UNSIGNED_LONG, next, 0, &held_size, 1, MPI_UNSIGNED_LONG, prev, 0, comm, MPI_STATUS_IGNORE);
+
+    held_copy.resize(held_size);
+    MPI_Sendrecv(&own_copy[0], 2*own_size, MPI_DOUBLE, next, 1, &held_copy[0], 2*held_size, MPI_DOUBLE, prev, 1, comm, MPI_STATUS_IGNORE);
+
+    if (Input::List().buddy_dir != "none")
+    {
+        save_buddy(buddy_file(Input::List().buddy_dir, rank, rank), own_copy);
+        save_buddy(buddy_file(Input::List().buddy_dir, prev, rank), held_copy);
+    }
+    if (to_disk) save_buddy(buddy_file(hdir+"restart", rank, rank), own_copy);
+
+//      The slabs of the copies, read back before the relaunch cuts its own
+    if (!rank) Load_Balance::Write_Buddy_Profile(hdir);
+}
+//--------------------------------------------------------------
+//  Each rank takes its own copy from buddy_dir if it is still 
+//  there, e.g. on a node that was replaced after a failure it 
+//  is not, and the next rank sends the copy it holds instead.
+//  If a copy is lost on both ranks, all ranks go back to the 
+//  last checkpoint kept in the restart folder.
+void Export_Files::Restart_Facility::Read_Buddy(size_t& re_step, State1D& Y, double& time_start) {
+
+    MPI_Comm comm(Time_Decomposition::Slice_Comm());
+    int rank, nranks;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &nranks);
+
+    if (int(buddy_next.size()) != nranks) buddy_ring(comm, buddy_next);
+    int next(buddy_next[rank]), prev(int(find(buddy_next.begin(), buddy_next.end(), rank) - buddy_next.begin()));
+
+    int have[2] = {0, 0};                               // own copy, copy of prev
+    if (Input::List().buddy_dir != "none")
+    {
+        have[0] = load_buddy(buddy_file(Input::List().buddy_dir, rank, rank), own_copy);
+        have[1] = load_buddy(buddy_file(Input::List().buddy_dir, prev, rank), held_copy);
+    }
+
+    vector<int> has(2*nranks);
+    MPI_Allgather(have, 2, MPI_INT, &has[0], 2, MPI_INT, comm);
+
+    bool recoverable(true);
+    for (int r(0); r < nranks; ++r) recoverable = recoverable && (has[2*r] || has[2*buddy_next[r]+1]);
+
+    if (recoverable)
+    {
+        MPI_Request requests[2];
+        unsigned long held_size(held_copy.size()), own_size(0);
+        if (!has[2*prev])
+        {
+            MPI_Isend(&held_size, 1, MPI_UNSIGNED_LONG, prev, 0, comm, &requests[0]);
+            MPI_Isend(&held_copy[0], 2*held_size, MPI_DOUBLE, prev, 1, comm, &requests[1]);
+        }
+        if (!have[0])
+        {
+            MPI_Recv(&own_size, 1, MPI_UNSIGNED_LONG, next, 0, comm, MPI_STATUS_IGNORE);
+            own_copy.resize(own_size);
+            MPI_Recv(&own_copy[0], 2*own_size, MPI_DOUBLE, next, 1, comm, MPI_STATUS_IGNORE);
+        }
+        if (!has[2*prev]) MPI_Waitall(2, requests, MPI_STATUSES_IGNORE);
+    }
+    else 
+    {
+        if (!rank) std::cout << "\n Some in-memory checkpoints are lost, using the copies in the restart folder \n";
+        if (!load_buddy(buddy_file(hdir+"restart", rank, rank), own_copy)) {
+            std::cout << "\n\n ERROR :: No checkpoint of rank " << rank << " left \n\n";
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+    }
+
+    size_t n(1);
+    for (size_t s(0); s < Y.Species(); ++s) {
+        for (size_t nh(0); nh < Y.DF(s).dim(); ++nh) n += (Y.DF(s))(nh).dim();
+    }
+    n += Y.Fields()*Y.EMF().Ex().numx();
+
+    if (own_copy.size() != n) {
+        std::cout << "\n\n ERROR :: The checkpoint of rank " << rank << " was taken with other x-slabs \n\n";
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+
+//      All copies must come from the same checkpoint
+    double step(own_copy[0].imag()), step_min, step_max;
+    MPI_Allreduce(&step, &step_min, 1, MPI_DOUBLE, MPI_MIN, comm);
+    MPI_Allreduce(&step, &step_max, 1, MPI_DOUBLE, MPI_MAX, comm);
+    double time(own_copy[0].real()), time_min, time_max;
+    MPI_Allreduce(&time, &time_min, 1, MPI_DOUBLE, MPI_MIN, comm);
+    MPI_Allreduce(&time, &time_max, 1, MPI_DOUBLE, MPI_MAX, comm);
+    if ((step_min != step_max) || (time_min != time_max)) {
+        if (!rank) std::cout << "\n\n ERROR :: The checkpoints of the ranks were taken at different times \n\n";
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+
+    time_start = time;
+    re_step    = size_t(step);
+
+    complex<double>* pos(&own_copy[1]);
+    for (size_t s(0); s < Y.Species(); ++s) {
+        for (size_t nh(0); nh < Y.DF(s).dim(); ++nh) {
+            std::copy(pos, pos + (Y.DF(s))(nh).dim(), &(Y.DF(s))(nh)(0));
+            pos += (Y.DF(s))(nh).dim();
+        }
+    }
+    for(size_t ifields(0); ifields < Y.Fields(); ++ifields){
+        std::copy(pos, pos + Y.EMF().Ex().numx(), &(Y.FLD(ifields))(0));
+        pos += Y.EMF().Ex().numx();
+    }
+}
 //--------------------------------------------------------------
 //  Adjust filenames with zeros to reach some prescribed length. 
 //  Add the filename extension. 
-string Export_Files::Restart_Facility::rFextension(const int rank, const size_t rstep){
+string Export_Files::Restart_Facility::rFextension(const int rank, const size_t rstep, const string extension){
     stringstream sFilename;
 
     // Number of zeros to add to the filename
@@ -878,7 +1398,7 @@ string Export_Files::Restart_Facility::rFextension(const int rank, const size_t
         sFilename << "0";
     }
 
-    sFilename << rstep << ofconventions::rfile_extension;
+    sFilename << rstep << extension;
 
     return sFilename.str();
 }
@@ -1011,182 +1531,235 @@ Array2D<double>  Output_Data::harmonicvsposition::operator()(DistFunc2D& df, siz
 
 //**************************************************************
 //--------------------------------------------------------------
-Output_Data::fulldist::fulldist( const Grid_Info& _G): grid(_G) 
-{
-    size_t szx = _G.axis.Nx(0) - 2*Input::List().BoundaryCells;
-    size_t szy = _G.axis.Nx(1) - 2*Input::List().BoundaryCells;
-    double py_sq, pz_sqppy_sq;
-    size_t pindlt;
-
-    //  Generate the required structures
-    for (size_t s(0); s < _G.axis.pdim(); ++s) 
-    {   
-        pvec.push_back(valtovec(_G.axis.p(s)));
-        p_cylindrical_polar_radius_squared.push_back( Array2D<double>( _G.axis.Npx(s),_G.axis.Np(s)) );
-        px_over_p.push_back( Array2D<double>( _G.axis.Npx(s),_G.axis.Np(s)) );
+Output_Data::momentengine::momentengine(const Grid_Info& _G) {
 
+    size_t nx(_G.axis.Nx(0) - 2*Input::List().BoundaryCells);
 
-        // std::cout << "\n LDb \n";
+//  Same trapezoidal rule as Algorithms::moment, folded into one weight per cell
+    for (size_t s(0); s < _G.axis.pdim(); ++s) {
+        valarray<double> p(_G.axis.p(s));
+        size_t np(p.size());
 
-        // PL2D.push_back( PLegendre2D( _G.l0[s], _G.m0[s],
-        //    _G.axis.px(s), _G.axis.p(s) ) );  
+        Array2D<double> w(np,kmax);
 
-        // std::cout << "\n LDone \n";
-        // vector<Array3D<double> > temp;
-        // for (size_t iy(0); iy < szy; ++iy)
-        // {
-        //     for (size_t ix(0); ix < szx; ++ix)
-        //     {
-        //         temp.push_back(Array3D<double>( _G.axis.Npx(s),_G.axis.Npy(s),_G.axis.Npz(s)));
-        //     }
-        // }
-        // pout3D.push_back(temp); 
-        
-        // pradius.push_back(Array3D<double>(_G.axis.Npx(s),_G.axis.Npy(s),_G.axis.Npz(s)));
-        // phi.push_back(Array2D<double>(_G.axis.Npy(s),_G.axis.Npz(s)));  phi[s] = 0.;
-        
-        for (size_t ipx(0); ipx < _G.axis.Npx(s); ++ipx)
-        {
-            for (size_t ip(0); ip < _G.axis.Np(s); ++ip)
-            {
-                p_cylindrical_polar_radius_squared[s](ipx,ip) = pow(grid.axis.p(s)[ip],2.) - pow(grid.axis.px(s)[ipx],2.);
-                px_over_p[s](ipx,ip) = (grid.axis.px(s)[ipx])/grid.axis.p(s)[ip];
+        for (size_t ip(0); ip < np; ++ip) {
+            double span( ((ip+1 < np)? p[ip+1]:p[ip]) - ((ip > 0)? p[ip-1]:p[ip]) );
+            for (size_t k(0); k < kmax; ++k) {
+                w(ip,k) = 0.5*pow(p[ip],k)*span;
             }
         }
 
+        weights.push_back(w);
 
-        // for (size_t ipy(0); ipy < _G.axis.Npy(s); ++ipy)
-        // {
-        //     py_sq = (_G.axis.py(s))[ipy]*(_G.axis.py(s))[ipy];
-        //     for (size_t ipz(0); ipz < _G.axis.Npz(s); ++ipz)
-        //     {
-        //         pz_sqppy_sq = py_sq + (_G.axis.pz(s))[ipz]*(_G.axis.pz(s))[ipz];
-        //         for (size_t ipx(0); ipx < _G.axis.Npx(s); ++ipx)
-        //         {
-        //             pradius[s](ipx,ipy,ipz) = sqrt((_G.axis.px(s))[ipx]*(_G.axis.px(s))[ipx]+pz_sqppy_sq);
-
-        //             if (pradius[s](ipx,ipy,ipz) < _G.axis.pmax(s))
-        //             { 
-        //                 phi[s](ipy,ipz) = (atan2((_G.axis.pz(s))[ipz],(_G.axis.py(s))[ipy]) + M_PI);
-        //             }
-        //         }
-        //     }       
-        // }
+        m00.push_back(Array2D<double>(kmax,nx));
+        m10.push_back(Array2D<double>(kmax,nx));
+        m11re.push_back(Array2D<double>(kmax,nx));
+        m11im.push_back(Array2D<double>(kmax,nx));
     }
 }
-//-------------------------------------------------------------
-/**
- * @brief      Destroys the object.
- */
-//-------------------------------------------------------------
-Output_Data::fulldist::~fulldist(){
-
-}
-//-------------------------------------------------------------
-/**
- * @brief      Creates p1 from a 3D grid
- */
-//-------------------------------------------------------------
-valarray<double>  Output_Data::fulldist::p1(DistFunc1D& df, size_t x0, size_t s) {
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
 
-    valarray<double> pout1D_p1(0.,grid.axis.Npx(s));     
+void Output_Data::momentengine::operator()(const State1D& Y, bool use_f00, bool use_f10, bool use_f11) {
 
-    size_t Npx(grid.axis.Npx(s));
-    size_t Np(grid.axis.Np(s));
-    size_t Nl(grid.l0[s]);
     size_t Nbc(Input::List().BoundaryCells);
 
-    double p_im1(0.0), p_ip1(0.0);
-    double integrant_low(0.0);
-    double integrant_high(0.0);
+    for (size_t s(0); s < Y.Species(); ++s) {
 
-    double InPx;
-    
-    double LP0(0.);
-    double LP1(0.);
-    double LPC(0.);
+        size_t np(Y.SH(s,0,0).nump());
+        size_t nx(Y.SH(s,0,0).numx() - 2*Nbc);
+        bool has_f11(use_f11 && Y.DF(s).m0() > 0);
 
-    
-    for (size_t ipx(0); ipx < Npx; ++ipx) // at each location in px
-    {
+        const Array2D<double>& w(weights[s]);
+        const SHarmonic1D& h00(Y.SH(s,0,0));
+        const SHarmonic1D& h10(Y.SH(s,1,0));
 
+        #pragma omp parallel for num_threads(Input::List().ompthreads)
+        for (size_t ix = 0; ix < nx; ++ix) {
 
-        InPx = 0.;
-        size_t ip(0);  
+            double a2(0.), a4(0.), a5(0.);
+            double b3(0.), b5(0.), b6(0.);
+            double c3(0.), c5(0.), c6(0.), d3(0.), d5(0.), d6(0.);
 
-        // std::cout << "ipx = " << ipx << " \n";
+            for (size_t ip(0); ip < np; ++ip) {
+                if (use_f00) {
+                    double f(h00(ip,ix+Nbc).real());
+                    a2 += w(ip,2)*f;    a4 += w(ip,4)*f;    a5 += w(ip,5)*f;
+                }
+                if (use_f10) {
+                    double f(h10(ip,ix+Nbc).real());
+                    b3 += w(ip,3)*f;    b5 += w(ip,5)*f;    b6 += w(ip,6)*f;
+                }
+                if (has_f11) {
+                    complex<double> f(Y.SH(s,1,1)(ip,ix+Nbc));
+                    c3 += w(ip,3)*f.real();     c5 += w(ip,5)*f.real();     c6 += w(ip,6)*f.real();
+                    d3 += w(ip,3)*f.imag();     d5 += w(ip,5)*f.imag();     d6 += w(ip,6)*f.imag();
+                }
+            }
 
-        while (p_cylindrical_polar_radius_squared[s](ipx,ip) < 0 && ip < Np) // at each location in pr
-        {
-            // std::cout << "ip = " << ip << " \n";
+            m00[s](2,ix) = a2;      m00[s](4,ix) = a4;      m00[s](5,ix) = a5;
+            m10[s](3,ix) = b3;      m10[s](5,ix) = b5;      m10[s](6,ix) = b6;
+            m11re[s](3,ix) = c3;    m11re[s](5,ix) = c5;    m11re[s](6,ix) = c6;
+            m11im[s](3,ix) = d3;    m11im[s](5,ix) = d5;    m11im[s](6,ix) = d6;
+        }
+    }
+}
+//--------------------------------------------------------------
+//**************************************************************
+
+//**************************************************************
+//--------------------------------------------------------------
+Output_Data::fulldist::fulldist( const Grid_Info& _G): grid(_G) 
+{
+    //  The cartesian tables are large, only build them if some output needs them
+    cartesian = (Input::List().o_p2x1 || Input::List().o_p3x1 || Input::List().o_p1p2x1 
+              || Input::List().o_p1p3x1 || Input::List().o_p2p3x1 || Input::List().o_p1p2p3x1);
+
+    //  Generate the required structures
+    for (size_t s(0); s < _G.axis.pdim(); ++s) 
+    {   
+        size_t Npx(_G.axis.Npx(s));
+        size_t Np(_G.axis.Np(s));
+        size_t Nl(_G.l0[s]);
+
+        pvec.push_back(valtovec(_G.axis.p(s)));
+        p_cylindrical_polar_radius_squared.push_back( Array2D<double>( Npx,Np) );
+        px_over_p.push_back( Array2D<double>( Npx,Np) );
+        p1_legendre.push_back( Array3D<double>( Nl+1,Np,Npx) );
+        p1_first.push_back( valarray<size_t>( Np,Npx) );
 
-            ++ip; 
+        for (size_t ipx(0); ipx < Npx; ++ipx)
+        {
+            for (size_t ip(0); ip < Np; ++ip)
+            {
+                p_cylindrical_polar_radius_squared[s](ipx,ip) = pow(grid.axis.p(s)[ip],2.) - pow(grid.axis.px(s)[ipx],2.);
+                px_over_p[s](ipx,ip) = (grid.axis.px(s)[ipx])/grid.axis.p(s)[ip];
+
+                if ((p_cylindrical_polar_radius_squared[s](ipx,ip) >= 0) && (p1_first[s][ipx] == Np)) p1_first[s][ipx] = ip;
+
+                valarray<double> LP(Algorithms::Legendre(px_over_p[s](ipx,ip), std::max(Nl+1,size_t(2))));
+                for (size_t il(0); il < Nl+1; ++il) p1_legendre[s](il,ip,ipx) = LP[il];
+            }
         }
 
+        if (cartesian) cartesian_tables(s);
+    }
+}
+//-------------------------------------------------------------
+//  Associated Legendre polynomials of px/p on the (px,p) grid 
+//  and cos/sin(m phi) on the (py,pz) grid
+//-------------------------------------------------------------
+void Output_Data::fulldist::cartesian_tables(size_t s) 
+{
+    size_t Npx(grid.axis.Npx(s)), Npy(grid.axis.Npy(s)), Npz(grid.axis.Npz(s));
+    size_t Np(grid.axis.Np(s));
+    size_t Nl(grid.l0[s]), Nm(grid.m0[s]);
+    size_t Nlm(((Nm+1)*(2*Nl-Nm+2))/2);
+
+    valarray<double> px(grid.axis.px(s)), py(grid.axis.py(s)), pz(grid.axis.pz(s));
 
-        if (ip < Np)
+    cart_legendre.push_back( Array3D<double>(Nlm,Np,Npx) );
+    cart_cosm.push_back( Array3D<double>(Nm+1,Npy,Npz) );
+    cart_sinm.push_back( Array3D<double>(Nm+1,Npy,Npz) );
+
+    for (size_t ipx(0); ipx < Npx; ++ipx)
+    {
+        for (size_t ip(0); ip < Np; ++ip)
         {
-            p_ip1 = sqrt(p_cylindrical_polar_radius_squared[s](ipx,ip));
-                
-            LP0 = 1.; LP1 = px_over_p[s](ipx,ip);
-        
-            for (size_t il(0); il < Nl+1; ++il) // calculate the integral for each harmonic separately
+            //  Nodes with p < |px| only enter as the lower end of an interpolation 
+            double cos8(std::max(-1.0, std::min(1.0, px[ipx]/pvec[s][ip])));
+            Array2D<double> PL(Algorithms::Legendre(cos8, Nl, Nm));
+
+            size_t k(0);
+            for (size_t il(0); il < Nl+1; ++il)
             {
-                if (il > 1)
+                for (size_t im(0); im < ((Nm < il) ? Nm : il)+1; ++im)
                 {
-                    LPC  = (2.*il+1)*px_over_p[s](ipx,ip)*LP1 - il*LP0;
-                    LPC /= il+1;
-    
-                    LP0 = LP1;
-                    LP1 = LPC;
-                }
-                else
-                {
-                    if (il == 0) LPC = LP0;
-                    else LPC = LP1;
+                    cart_legendre[s](k,ip,ipx) = PL(il,im);
+                    ++k;
                 }
-    
-                integrant_high = (static_cast<double>((df(il,0)(ip,x0+Nbc)).real())) * LPC;
-                InPx += p_ip1 * (0.5*p_ip1) * integrant_high; 
             }
-      
+        }
+    }
+
+    for (size_t ipz(0); ipz < Npz; ++ipz)
+    {
+        for (size_t ipy(0); ipy < Npy; ++ipy)
+        {
+            double phi(atan2(pz[ipz],py[ipy]));
+            for (size_t im(0); im < Nm+1; ++im)
+            {
+                cart_cosm[s](im,ipy,ipz) = cos(im*phi);
+                cart_sinm[s](im,ipy,ipz) = sin(im*phi);
+            }
+        }
+    }
+}
+//-------------------------------------------------------------
+/**
+ * @brief      Destroys the object.
+ */
+//-------------------------------------------------------------
+Output_Data::fulldist::~fulldist(){
+
+}
+//-------------------------------------------------------------
+/**
+ * @brief      Creates p1 from a 3D grid
+ */
+//-------------------------------------------------------------
+valarray<double>  Output_Data::fulldist::p1(DistFunc1D& df, size_t x0, size_t s) {
+
+    valarray<double> pout1D_p1(0.,grid.axis.Npx(s));     
+
+    size_t Npx(grid.axis.Npx(s));
+    size_t Np(grid.axis.Np(s));
+    size_t Nl(grid.l0[s]);
+    size_t Nbc(Input::List().BoundaryCells);
+    size_t l_top(std::min(Nl, df.l_active(x0+Nbc)));
+
+    //  f(p, cos8 = px/p) for m = 0 on the (px,p) grid is the same 
+    //  for every px, so only collect the harmonics once
+    Array2D<double> f_l(l_top+1,Np);
+    for (size_t il(0); il < l_top+1; ++il)
+    {
+        for (size_t ip(0); ip < Np; ++ip)
+        {
+            f_l(il,ip) = (df(il,0)(ip,x0+Nbc)).real();
+        }
+    }
+
+    double p_im1(0.0), p_ip1(0.0);
+    double integrant_low(0.0);
+    double integrant_high(0.0);
+
+    for (size_t ipx(0); ipx < Npx; ++ipx) // at each location in px
+    {
+        double InPx(0.);
+        size_t ip(p1_first[s][ipx]);
+
+        //  Trapezoidal rule in the cylindrical radius, p_r dp_r = p dp
+        while ( (ip < Np) && ((ip == p1_first[s][ipx]) || (p_cylindrical_polar_radius_squared[s](ipx,ip) > 0)) )
+        {
+            p_im1 = p_ip1;
+            integrant_low = integrant_high;
+
+            p_ip1 = sqrt(p_cylindrical_polar_radius_squared[s](ipx,ip));
+
+            integrant_high = 0.;
+            for (size_t il(0); il < l_top+1; ++il) 
+            {
+                integrant_high += f_l(il,ip) * p1_legendre[s](il,ip,ipx);
+            }
+
+            if (ip == p1_first[s][ipx]) InPx += p_ip1 * (0.5*p_ip1) * integrant_high;
+            else 
+            {
+                InPx += p_im1 * (0.5*(p_ip1-p_im1)) * integrant_low; 
+                InPx += p_ip1 * (0.5*(p_ip1-p_im1)) * integrant_high; 
+            }
             ++ip;
-    
-            while ( (ip <  Np) && (p_cylindrical_polar_radius_squared[s](ipx,ip) > 0 )  )   
-            {  // at each location in pr
-                p_im1 = p_ip1;
-                integrant_low = integrant_high;
-    
-                p_ip1 = sqrt(p_cylindrical_polar_radius_squared[s](ipx,ip));
-                
-                LP0 = 1.; LP1 = px_over_p[s](ipx,ip);
-                
-                for (size_t il(0); il < Nl+1; ++il) // calculate the integral for each harmonic separately
-                {
-                    if (il > 1)
-                    {
-                        LPC  = (2.*il+1)*px_over_p[s](ipx,ip)*LP1 - il*LP0;
-                        LPC /= il+1;
-    
-                        LP0 = LP1;
-                        LP1 = LPC;
-                    }
-                    else
-                    {
-                        if (il == 0) LPC = LP0;
-                        else LPC = LP1;
-                    }
-    
-                    integrant_high = (static_cast<double>((df(il,0)(ip,x0+Nbc)).real())) * LPC;
-    
-                    InPx += p_im1 * (0.5*(p_ip1-p_im1)) * integrant_low; 
-                    InPx += p_ip1 * (0.5*(p_ip1-p_im1)) * integrant_high; 
-                }
-    
-                ++ip;
-            }        
-            pout1D_p1[ipx] += InPx;
         }
+        pout1D_p1[ipx] = InPx;
     }
     
     pout1D_p1 *= 2.0 * M_PI;
@@ -1220,15 +1793,21 @@ valarray<double>  Output_Data::fulldist::p1(DistFunc2D& df, size_t x0, size_t y0
 valarray<double>  Output_Data::fulldist::p2(DistFunc1D& df, size_t x0, size_t s) {
 
     valarray<double> pout1D_p2(0.,grid.axis.Npy(s));     
+    valarray<double> dpx(grid.axis.dpx(s)), dpz(grid.axis.dpz(s));
+    if (!cartesian) return pout1D_p2;
 
-    for (size_t ipy(0); ipy < grid.axis.Npy(s); ++ipy) 
+    vector<Array2D<complex<double> > > G;
+    cylindrical(df, x0, s, G);
+    Array2D<double> f(grid.axis.Npx(s),grid.axis.Npy(s));
+
+    for (size_t ipz(0); ipz < grid.axis.Npz(s); ++ipz) 
     {
-        for (size_t ipx(0); ipx < grid.axis.Npx(s); ++ipx) 
+        pzplane(G, s, ipz, f);
+        for (size_t ipy(0); ipy < grid.axis.Npy(s); ++ipy) 
         {    
-            for (size_t ipz(0); ipz < grid.axis.Npz(s); ++ipz) 
+            for (size_t ipx(0); ipx < grid.axis.Npx(s); ++ipx) 
             {
-                
-                // pout1D_p2[ipy] += dist(s,x0)(ipx,ipy,ipz)*grid.axis.dpx(s)[ipx]*grid.axis.dpz(s)[ipz];
+                pout1D_p2[ipy] += f(ipx,ipy)*dpx[ipx]*dpz[ipz];
             }
         }
     }
@@ -1266,15 +1845,21 @@ valarray<double>  Output_Data::fulldist::p2(DistFunc2D& df, size_t x0, size_t y0
 valarray<double>  Output_Data::fulldist::p3(DistFunc1D& df, size_t x0, size_t s) {
 
     valarray<double> pout1D_p3(0.,grid.axis.Npz(s));     
+    valarray<double> dpx(grid.axis.dpx(s)), dpy(grid.axis.dpy(s));
+    if (!cartesian) return pout1D_p3;
+
+    vector<Array2D<complex<double> > > G;
+    cylindrical(df, x0, s, G);
+    Array2D<double> f(grid.axis.Npx(s),grid.axis.Npy(s));
 
     for (size_t ipz(0); ipz < grid.axis.Npz(s); ++ipz) 
     {
-        for (size_t ipx(0); ipx < grid.axis.Npx(s); ++ipx) 
+        pzplane(G, s, ipz, f);
+        for (size_t ipy(0); ipy < grid.axis.Npy(s); ++ipy) 
         {    
-            for (size_t ipy(0); ipy < grid.axis.Npy(s); ++ipy) 
+            for (size_t ipx(0); ipx < grid.axis.Npx(s); ++ipx) 
             {
-                
-                // pout1D_p3[ipz] += dist(s,x0)(ipx,ipy,ipz)*grid.axis.dpx(s)[ipx]*grid.axis.dpy(s)[ipy];
+                pout1D_p3[ipz] += f(ipx,ipy)*dpx[ipx]*dpy[ipy];
             }
         }
     }
@@ -1311,13 +1896,21 @@ Array2D<double>  Output_Data::fulldist::p1p2(DistFunc1D& df, size_t x0, size_t s
 
     Array2D<double> pout2D_p1p2(grid.axis.Npx(s),grid.axis.Npy(s));     
     pout2D_p1p2 = 0.;
-    for (size_t ipx(0); ipx < grid.axis.Npx(s); ++ipx) 
-    {    
+    valarray<double> dpz(grid.axis.dpz(s));
+    if (!cartesian) return pout2D_p1p2;
+
+    vector<Array2D<complex<double> > > G;
+    cylindrical(df, x0, s, G);
+    Array2D<double> f(grid.axis.Npx(s),grid.axis.Npy(s));
+
+    for (size_t ipz(0); ipz < grid.axis.Npz(s); ++ipz) 
+    {
+        pzplane(G, s, ipz, f);
         for (size_t ipy(0); ipy < grid.axis.Npy(s); ++ipy) 
-        {
-            for (size_t ipz(0); ipz < grid.axis.Npz(s); ++ipz) 
+        {    
+            for (size_t ipx(0); ipx < grid.axis.Npx(s); ++ipx) 
             {
-                // pout2D_p1p2(ipx,ipy) += dist(s,x0)(ipx,ipy,ipz)*grid.axis.dpz(s)[ipz];
+                pout2D_p1p2(ipx,ipy) += f(ipx,ipy)*dpz[ipz];
             }
         }
     }
@@ -1353,13 +1946,21 @@ Array2D<double>  Output_Data::fulldist::p2p3(DistFunc1D& df, size_t x0, size_t s
 
     Array2D<double> pout2D_p2p3(grid.axis.Npy(s),grid.axis.Npz(s));
     pout2D_p2p3 = 0.;
-    for (size_t ipy(0); ipy < grid.axis.Npy(s); ++ipy) 
+    valarray<double> dpx(grid.axis.dpx(s));
+    if (!cartesian) return pout2D_p2p3;
+
+    vector<Array2D<complex<double> > > G;
+    cylindrical(df, x0, s, G);
+    Array2D<double> f(grid.axis.Npx(s),grid.axis.Npy(s));
+
+    for (size_t ipz(0); ipz < grid.axis.Npz(s); ++ipz) 
     {
-        for (size_t ipz(0); ipz < grid.axis.Npz(s); ++ipz) 
-        {
+        pzplane(G, s, ipz, f);
+        for (size_t ipy(0); ipy < grid.axis.Npy(s); ++ipy) 
+        {    
             for (size_t ipx(0); ipx < grid.axis.Npx(s); ++ipx) 
-            {   
-                // pout2D_p2p3(ipy,ipz) += dist(s,x0)(ipx,ipy,ipz)*grid.axis.dpx(s)[ipx];
+            {
+                pout2D_p2p3(ipy,ipz) += f(ipx,ipy)*dpx[ipx];
             }
         }
     }
@@ -1395,13 +1996,21 @@ Array2D<double>  Output_Data::fulldist::p1p3(DistFunc1D& df, size_t x0, size_t s
   
     Array2D<double> pout2D_p1p3(grid.axis.Npx(s),grid.axis.Npz(s));
     pout2D_p1p3 = 0.;
+    valarray<double> dpy(grid.axis.dpy(s));
+    if (!cartesian) return pout2D_p1p3;
+
+    vector<Array2D<complex<double> > > G;
+    cylindrical(df, x0, s, G);
+    Array2D<double> f(grid.axis.Npx(s),grid.axis.Npy(s));
+
     for (size_t ipz(0); ipz < grid.axis.Npz(s); ++ipz) 
     {
-        for (size_t ipx(0); ipx < grid.axis.Npx(s); ++ipx) 
+        pzplane(G, s, ipz, f);
+        for (size_t ipy(0); ipy < grid.axis.Npy(s); ++ipy) 
         {    
-            for (size_t ipy(0); ipy < grid.axis.Npy(s); ++ipy) 
+            for (size_t ipx(0); ipx < grid.axis.Npx(s); ++ipx) 
             {
-                // pout2D_p1p3(ipx,ipz) += dist(s,x0)(ipx,ipy,ipz)*grid.axis.dpy(s)[ipy];
+                pout2D_p1p3(ipx,ipz) += f(ipx,ipy)*dpy[ipy];
             }
         }
     }
@@ -1429,115 +2038,112 @@ Array2D<double>  Output_Data::fulldist::p1p3(DistFunc2D& df, size_t x0, size_t y
     return pout2D_p1p3;  
 }
 //--------------------------------------------------------------
-void Output_Data::fulldist::p1p2p3(DistFunc1D& df, size_t x0, size_t s)
+Array3D<double> Output_Data::fulldist::p1p2p3(DistFunc1D& df, size_t x0, size_t s)
 {
 //--------------------------------------------------------------
-//  Turn the Distribution function at some spatial location (x0,y0) 
-//  into a cartesian grid.
+//  Turn the distribution function at x0 into a cartesian grid
 //--------------------------------------------------------------
-    // size_t Nbc(Input::List().BoundaryCells);
-    // dist(s,x0-Nbc) = 0.;
+    size_t Npx(grid.axis.Npx(s)), Npy(grid.axis.Npy(s)), Npz(grid.axis.Npz(s));
 
-    // #pragma omp parallel for num_threads(Input::List().ompthreads) 
-    // for(size_t il = 0; il < grid.l0[s]+1; ++il)
-    // {
-    //     size_t im(0);
-    //     size_t i_dist = ((il < grid.m0[s]+1)?((il*(il+1))/2+im):(il*(grid.m0[s]+1)-(grid.m0[s]*(grid.m0[s]+1))/2 + im));
-    //     vector<double> shdata_real( vdouble_real(   df(il,im).xVec(x0)));
-    //     tk::spline splSH;
-    //     splSH.set_points(pvec[s],shdata_real);
-
-    //     double YSH_re;
-    //     // size_t index(0);
-
-    //     for (size_t ipx(0); ipx < grid.axis.Npx(s); ++ipx) 
-    //     {
-    //         for (size_t ipy(0); ipy < grid.axis.Npy(s); ++ipy) 
-    //         {
-    //             for (size_t ipz(0); ipz < grid.axis.Npz(s); ++ipz) 
-    //             {
-    //                 if (pradius[s](ipx,ipy,ipz) <= grid.axis.pmax(s))
-    //                 {                       
-    //                     YSH_re = static_cast<double>(splSH(pradius[s](ipx,ipy,ipz)) * (PL2D[s])(i_dist)(ipx,ipy));
-
-    //                     // pout3D[s](ipx,ipy,ipz) += static_cast<double>(YSH_re * (PL2D[s])(i_dist)(ipx,ipy));
-
-    //                     #pragma omp atomic
-    //                         dist(s,x0-Nbc)(ipx,ipy,ipz) += YSH_re;
-    //                 }
-    //                 // else pout3D[s](ipx,ipy,ipz) += 0.;
-    //                 // ++index;
-    //             }
-    //         }
-    //     }
-    // }
-    
-    // #pragma omp parallel for schedule(dynamic) num_threads(Input::List().ompthreads)
-    // for (size_t il=1; il < grid.l0[s]+1 ; ++il)
-    // {
-    //     for (size_t im=1; im < ((grid.m0[s] < il)? grid.m0[s]:il)+1; ++im)
-    //     {
-    //         // std::cout << "(l,m) = " << il << "," << im << "\n";
-    //         vector<double> shdata_real( vdouble_real(   df(il,im).xVec(x0)));
-    //         vector<double> shdata_imag( vdouble_imag(   df(il,im).xVec(x0)));
-                 
-    //         tk::spline splSH_r, splSH_i;
-    //         splSH_r.set_points(pvec[s],shdata_real);
-    //         splSH_i.set_points(pvec[s],shdata_imag);
-
-    //         size_t i_dist = ((il < grid.m0[s]+1)?((il*(il+1))/2+im):(il*(grid.m0[s]+1)-(grid.m0[s]*(grid.m0[s]+1))/2 + im));
-
-    //         double YSH_re, YSH_im;
-
-    //         double mphi,calcos,calsin;
-
-    //         // size_t index(0);
-    //         for (size_t ipx(0); ipx < grid.axis.Npx(s); ++ipx) 
-    //         {
-    //             for (size_t ipy(0); ipy < grid.axis.Npy(s); ++ipy) 
-    //             {
-    //                 for (size_t ipz(0); ipz < grid.axis.Npz(s); ++ipz) 
-    //                 {
-    //                     mphi = im*phi[s](ipy,ipz);
-    //                     calcos = cos(mphi);
-    //                     calsin = sin(mphi);
-
-
-    //                     if (pradius[s](ipx,ipy,ipz) <= grid.axis.pmax(s))
-    //                     {                       
-    //                         YSH_re = (splSH_r(pradius[s](ipx,ipy,ipz)));
-    //                         YSH_im = (splSH_i(pradius[s](ipx,ipy,ipz)));
-
-    //                         YSH_re *= calcos; 
-    //                         YSH_im *= calsin; 
-    //                         YSH_re -= YSH_im;
-
-    //                         YSH_re = static_cast<double>(2.0*(PL2D[s])(i_dist)(ipx,ipy)*YSH_re);
-
-    //                         // pout3D[s](ipx,ipy,ipz) += static_cast<double>(2.0*(PL2D[s])(i_dist)(ipx,ipy)*YSH_re);//*dpy[s]*dpz[s];
-    //                         #pragma omp atomic
-    //                             dist(s,x0-Nbc)(ipx,ipy,ipz) += YSH_re;
-    //                     }
-    //                     // else pout3D[s](ipx,ipy,ipz) += 0.;
-    //                     // ++index;
-    //                 }
-    //             }
-    //         }
-    //     }
-    // }
+    Array3D<double> pout3D(Npx,Npy,Npz);
+    pout3D = 0.;
+    if (!cartesian) return pout3D;
 
-    // size_t index(0);
-    // for (size_t ipx(0); ipx < grid.axis.Npx(s); ++ipx) 
-    // {
-    //     for (size_t ipy(0); ipy < grid.axis.Npy(s); ++ipy) 
-    //     {
-    //         for (size_t ipz(0); ipz < grid.axis.Npz(s); ++ipz) 
-    //         {
-    //             dist(s,x0-Nbc)(ipx,ipy,ipz) = temp[index];
-    //             ++index;
-    //         }
-    //     }
-    // }
+    vector<Array2D<complex<double> > > G;
+    cylindrical(df, x0, s, G);
+
+    Array2D<double> f(Npx,Npy);
+    for (size_t ipz(0); ipz < Npz; ++ipz) 
+    {
+        pzplane(G, s, ipz, f);
+        for (size_t ipy(0); ipy < Npy; ++ipy) 
+        {
+            for (size_t ipx(0); ipx < Npx; ++ipx) 
+            {
+                pout3D(ipx,ipy,ipz) = f(ipx,ipy);
+            }
+        }
+    }
+
+    return pout3D;
+}
+//-------------------------------------------------------------
+void Output_Data::fulldist::cylindrical(DistFunc1D& df, size_t x0, size_t s, vector<Array2D<complex<double> > >& G)
+{
+    size_t Npx(grid.axis.Npx(s));
+    size_t Np(grid.axis.Np(s));
+    size_t Nl(grid.l0[s]), Nm(grid.m0[s]);
+    size_t Nbc(Input::List().BoundaryCells);
+    size_t l_top(std::min(Nl, df.l_active(x0+Nbc)));
+
+    G.clear();
+    for (size_t im(0); im < Nm+1; ++im)
+    {
+        G.push_back(Array2D<complex<double> >(Npx,Np));
+        G[im] = complex<double>(0.,0.);
+    }
+
+    size_t k(0);
+    for (size_t il(0); il < l_top+1; ++il)
+    {
+        for (size_t im(0); im < ((Nm < il) ? Nm : il)+1; ++im)
+        {
+            for (size_t ip(0); ip < Np; ++ip) 
+            {
+                complex<double> f_lm(df(il,im)(ip,x0+Nbc));
+                for (size_t ipx(0); ipx < Npx; ++ipx) 
+                {
+                    G[im](ipx,ip) += f_lm * cart_legendre[s](k,ip,ipx);
+                }
+            }
+            ++k;
+        }
+    }
+}
+//-------------------------------------------------------------
+//  f = sum_m G_m(|p|) e^{i m phi}, with f_{l,-m} = f_lm^*
+void Output_Data::fulldist::pzplane(const vector<Array2D<complex<double> > >& G, size_t s, size_t ipz, Array2D<double>& f)
+{
+    size_t Npx(grid.axis.Npx(s)), Npy(grid.axis.Npy(s));
+    size_t Np(grid.axis.Np(s));
+    size_t Nm(grid.m0[s]);
+    double pmax(grid.axis.pmax(s));
+    const vector<double>& p(pvec[s]);
+
+    valarray<double> px(grid.axis.px(s)), py(grid.axis.py(s));
+    double pz(grid.axis.pz(s)[ipz]);
+
+    for (size_t ipy(0); ipy < Npy; ++ipy)
+    {
+        double pperp_sq(py[ipy]*py[ipy] + pz*pz);
+
+        for (size_t ipx(0); ipx < Npx; ++ipx)
+        {
+            double pr(sqrt(px[ipx]*px[ipx] + pperp_sq));
+            f(ipx,ipy) = 0.;
+            if (pr > pmax) continue;
+
+            //  Linear interpolation weights onto the harmonic |p| grid
+            size_t ip(0);
+            double w(0.);
+            if (pr >= p[Np-1]) 
+            {
+                ip = Np-2;  w = 1.;
+            }
+            else if (pr > p[0]) 
+            {
+                ip = std::upper_bound(p.begin(), p.end(), pr) - p.begin() - 1;
+                w  = (pr - p[ip])/(p[ip+1] - p[ip]);
+            }
+
+            f(ipx,ipy) = (1.-w)*G[0](ipx,ip).real() + w*G[0](ipx,ip+1).real();
+            for (size_t im(1); im < Nm+1; ++im)
+            {
+                complex<double> G_p((1.-w)*G[im](ipx,ip) + w*G[im](ipx,ip+1));
+                f(ipx,ipy) += 2.0*(G_p.real()*cart_cosm[s](im,ipy,ipz) - G_p.imag()*cart_sinm[s](im,ipy,ipz));
+            }
+        }
+    }
 }
 //**************************************************************
 //--------------------------------------------------------------
@@ -1545,6 +2151,17 @@ void Output_Data::fulldist::p1p2p3(DistFunc1D& df, size_t x0, size_t s)
 void Output_Data::Output_Preprocessor::operator()(const State1D& Y, const Grid_Info& grid, const size_t tout, const double time, const double dt,
  const Parallel_Environment_1D& PE) {
 
+    //  Every p-integral the moment diagnostics need, in one pass
+    bool use_f00(Input::List().o_x1x2 || Input::List().o_Temperature 
+                || Input::List().o_vNx || Input::List().o_vNy || Input::List().o_vNz);
+    bool use_f10(Input::List().o_Jx || Input::List().o_Qx || Input::List().o_vNx);
+    bool use_f11(Input::List().o_Jy || Input::List().o_Jz || Input::List().o_Qy || Input::List().o_Qz
+                || Input::List().o_vNy || Input::List().o_vNz);
+
+    if (use_f00 || use_f10 || use_f11) {
+        moments(Y, use_f00, use_f10, use_f11);
+    }
+
     if (Input::List().o_Ex) {
         Ex( Y, grid, tout, time, dt, PE );
     }
@@ -1695,6 +2312,9 @@ void Output_Data::Output_Preprocessor::bigdistdump(const State1D& Y, const Grid_
     if (Input::List().o_p2x1){
         py( Y, grid, tout, time, dt, PE );
     }
+    if (Input::List().o_p3x1){
+        pz( Y, grid, tout, time, dt, PE );
+    }
     if (Input::List().o_p1p2x1)
     {
         pxpy( Y, grid, tout, time, dt, PE );
@@ -1709,7 +2329,7 @@ void Output_Data::Output_Preprocessor::bigdistdump(const State1D& Y, const Grid_
     }
     if (Input::List().o_p1p2p3x1)
     {
-        // pxpypz( Y, grid, tout, time, dt, PE );
+        pxpypz( Y, grid, tout, time, dt, PE );
     }
 }
 //------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -1874,25 +2494,18 @@ void Output_Data::Output_Preprocessor::Ex(const State1D& Y, const Grid_Info& gri
  const Parallel_Environment_1D& PE) {
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
     
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
 
     int msg_sz(outNxLocal); 
     
     valarray<double> Exbuf(0.,msg_sz);
-    vector<double> ExGlobal(outNxGlobal,0.);
-    vector<double> xaxis(valtovec(grid.axis.xg(0)));
 
     for(size_t i(0); i < msg_sz; ++i) {
         Exbuf[i] = static_cast<double>( Y.EMF().Ex()(Nbc+i).real() );
     }
 
-    MPI_Gather( &Exbuf[0], msg_sz, MPI_DOUBLE, &ExGlobal[0], msg_sz, MPI_DOUBLE, 0, MPI_COMM_WORLD);
-
-
-    if (PE.RANK() == 0) expo.Export_h5("Ex", xaxis, ExGlobal, tout, time, dt);
+    xdump("Ex", Exbuf, grid, tout, time, dt, -1, PE);
 
 }
 //--------------------------------------------------------------     
@@ -1902,24 +2515,18 @@ void Output_Data::Output_Preprocessor::Ey(const State1D& Y, const Grid_Info& gri
  const Parallel_Environment_1D& PE) {
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
      
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
 
     int msg_sz(outNxLocal);
-    double Eybuf[msg_sz];
+    valarray<double> Eybuf(outNxLocal);
     
-    vector<double> EyGlobal(outNxGlobal); 
-    vector<double> xaxis(valtovec(grid.axis.xg(0)));
 
     for(size_t i(0); i < msg_sz; ++i) {
         Eybuf[i] = static_cast<double>( Y.EMF().Ey()(Nbc+i).real() );
     }
 
-    MPI_Gather( Eybuf, msg_sz, MPI_DOUBLE, &EyGlobal[0], msg_sz, MPI_DOUBLE, 0, MPI_COMM_WORLD);
-
-    if (PE.RANK() == 0) expo.Export_h5("Ey", xaxis, EyGlobal, tout, time, dt);
+    xdump("Ey", Eybuf, grid, tout, time, dt, -1, PE);
 
 }
 //--------------------------------------------------------------     
@@ -1929,24 +2536,18 @@ void Output_Data::Output_Preprocessor::Ez(const State1D& Y, const Grid_Info& gri
  const Parallel_Environment_1D& PE) {
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
      
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
 
     int msg_sz(outNxLocal);
-    double Ezbuf[msg_sz];
+    valarray<double> Ezbuf(outNxLocal);
     
-    vector<double> EzGlobal(outNxGlobal);
-    vector<double> xaxis(valtovec(grid.axis.xg(0)));
 
     for(size_t i(0); i < msg_sz; ++i) {
         Ezbuf[i] = static_cast<double>( Y.EMF().Ez()(Nbc+i).real() );
     }
 
-    MPI_Gather( Ezbuf, msg_sz, MPI_DOUBLE, &EzGlobal[0], msg_sz, MPI_DOUBLE, 0, MPI_COMM_WORLD);
-
-    if (PE.RANK() == 0) expo.Export_h5("Ez", xaxis, EzGlobal, tout, time, dt);
+    xdump("Ez", Ezbuf, grid, tout, time, dt, -1, PE);
 
 
 }
@@ -1957,23 +2558,17 @@ void Output_Data::Output_Preprocessor::Bx(const State1D& Y, const Grid_Info& gri
  const Parallel_Environment_1D& PE) {
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
      
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
 
     int msg_sz(outNxLocal); //*szy);
-    double Bxbuf[msg_sz];
-    vector<double> BxGlobal(outNxGlobal);
-    vector<double> xaxis(valtovec(grid.axis.xg(0)));
+    valarray<double> Bxbuf(outNxLocal);
 
     for(size_t i(0); i < msg_sz; ++i) {
         Bxbuf[i] = static_cast<double>( Y.EMF().Bx()(Nbc+i).real() );
     }
 
-    MPI_Gather( Bxbuf, msg_sz, MPI_DOUBLE, &BxGlobal[0], msg_sz, MPI_DOUBLE, 0, MPI_COMM_WORLD);
-
-    if (PE.RANK() == 0) expo.Export_h5("Bx", xaxis, BxGlobal, tout, time, dt);
+    xdump("Bx", Bxbuf, grid, tout, time, dt, -1, PE);
 
 }
 //--------------------------------------------------------------     
@@ -1983,23 +2578,17 @@ void Output_Data::Output_Preprocessor::By(const State1D& Y, const Grid_Info& gri
  const Parallel_Environment_1D& PE) {
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
      
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
 
     int msg_sz(outNxLocal); //*szy);
-    double Bybuf[msg_sz];
-    vector<double> ByGlobal(outNxGlobal);
-    vector<double> xaxis(valtovec(grid.axis.xg(0)));
+    valarray<double> Bybuf(outNxLocal);
 
     for(size_t i(0); i < msg_sz; ++i) {
         Bybuf[i] = static_cast<double>( Y.EMF().By()(Nbc+i).real() );
     }
 
-    MPI_Gather( Bybuf, msg_sz, MPI_DOUBLE, &ByGlobal[0], msg_sz, MPI_DOUBLE, 0, MPI_COMM_WORLD);
-
-    if (PE.RANK() == 0) expo.Export_h5("By", xaxis, ByGlobal, tout, time, dt);
+    xdump("By", Bybuf, grid, tout, time, dt, -1, PE);
 
 
 }
@@ -2010,23 +2599,17 @@ void Output_Data::Output_Preprocessor::Bz(const State1D& Y, const Grid_Info& gri
  const Parallel_Environment_1D& PE) {
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
      
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
 
     int msg_sz(outNxLocal); //*szy);
-    double Bzbuf[msg_sz];
-    vector<double> BzGlobal(outNxGlobal); 
-    vector<double> xaxis(valtovec(grid.axis.xg(0)));
+    valarray<double> Bzbuf(outNxLocal);
 
     for(size_t i(0); i < msg_sz; ++i) {
         Bzbuf[i] = static_cast<double>( Y.EMF().Bz()(Nbc+i).real() );
     }
 
-    MPI_Gather( Bzbuf, msg_sz, MPI_DOUBLE, &BzGlobal[0], msg_sz, MPI_DOUBLE, 0, MPI_COMM_WORLD);
-
-    if (PE.RANK() == 0) expo.Export_h5("Bz", xaxis, BzGlobal, tout, time, dt);
+    xdump("Bz", Bzbuf, grid, tout, time, dt, -1, PE);
 
 
 }
@@ -2060,7 +2643,7 @@ void Output_Data::Output_Preprocessor::Ex(const State2D& Y, const Grid_Info& gri
 
     if (PE.MPI_Processes() > 1) {
         if (PE.RANK()!=0) {
-            MPI_Send(Exbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
+            MPI_Send(Exbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), Time_Decomposition::Slice_Comm());
         }
         else {
             // Fill data for rank = 0
@@ -2079,7 +2662,7 @@ void Output_Data::Output_Preprocessor::Ex(const State2D& Y, const Grid_Info& gri
                 ranky = rr / PE.MPI_X();
                 i = 0;
 
-                MPI_Recv(Exbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
+                MPI_Recv(Exbuf, msg_sz, MPI_DOUBLE, rr, rr, Time_Decomposition::Slice_Comm(), &status);
 
                 for(size_t ix(0); ix < outNxLocal; ++ix) {
                     for(size_t iy(0); iy < outNyLocal; ++iy) {
@@ -2132,7 +2715,7 @@ void Output_Data::Output_Preprocessor::Ey(const State2D& Y, const Grid_Info& gri
 
     if (PE.MPI_Processes() > 1) {
         if (PE.RANK()!=0) {
-            MPI_Send(Eybuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
+            MPI_Send(Eybuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), Time_Decomposition::Slice_Comm());
         }
         else {
             // Fill data for rank = 0
@@ -2151,7 +2734,7 @@ void Output_Data::Output_Preprocessor::Ey(const State2D& Y, const Grid_Info& gri
                 ranky = rr / PE.MPI_X();
                 i = 0;
 
-                MPI_Recv(Eybuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
+                MPI_Recv(Eybuf, msg_sz, MPI_DOUBLE, rr, rr, Time_Decomposition::Slice_Comm(), &status);
 
                 for(size_t ix(0); ix < outNxLocal; ++ix) {
                     for(size_t iy(0); iy < outNyLocal; ++iy) {
@@ -2204,7 +2787,7 @@ void Output_Data::Output_Preprocessor::Ez(const State2D& Y, const Grid_Info& gri
 
     if (PE.MPI_Processes() > 1) {
         if (PE.RANK()!=0) {
-            MPI_Send(Ezbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
+            MPI_Send(Ezbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), Time_Decomposition::Slice_Comm());
         }
         else {
             // Fill data for rank = 0
@@ -2223,7 +2806,7 @@ void Output_Data::Output_Preprocessor::Ez(const State2D& Y, const Grid_Info& gri
                 ranky = rr / PE.MPI_X();
                 i = 0;
 
-                MPI_Recv(Ezbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
+                MPI_Recv(Ezbuf, msg_sz, MPI_DOUBLE, rr, rr, Time_Decomposition::Slice_Comm(), &status);
 
                 for(size_t ix(0); ix < outNxLocal; ++ix) {
                     for(size_t iy(0); iy < outNyLocal; ++iy) {
@@ -2276,7 +2859,7 @@ void Output_Data::Output_Preprocessor::Bx(const State2D& Y, const Grid_Info& gri
 
     if (PE.MPI_Processes() > 1) {
         if (PE.RANK()!=0) {
-            MPI_Send(Bxbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
+            MPI_Send(Bxbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), Time_Decomposition::Slice_Comm());
         }
         else {
             // Fill data for rank = 0
@@ -2295,7 +2878,7 @@ void Output_Data::Output_Preprocessor::Bx(const State2D& Y, const Grid_Info& gri
                 ranky = rr / PE.MPI_X();
                 i = 0;
 
-                MPI_Recv(Bxbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
+                MPI_Recv(Bxbuf, msg_sz, MPI_DOUBLE, rr, rr, Time_Decomposition::Slice_Comm(), &status);
 
                 for(size_t ix(0); ix < outNxLocal; ++ix) {
                     for(size_t iy(0); iy < outNyLocal; ++iy) {
@@ -2347,7 +2930,7 @@ void Output_Data::Output_Preprocessor::By(const State2D& Y, const Grid_Info& gri
 
     if (PE.MPI_Processes() > 1) {
         if (PE.RANK()!=0) {
-            MPI_Send(Bybuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
+            MPI_Send(Bybuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), Time_Decomposition::Slice_Comm());
         }
         else {
             // Fill data for rank = 0
@@ -2366,7 +2949,7 @@ void Output_Data::Output_Preprocessor::By(const State2D& Y, const Grid_Info& gri
                 ranky = rr / PE.MPI_X();
                 i = 0;
 
-                MPI_Recv(Bybuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
+                MPI_Recv(Bybuf, msg_sz, MPI_DOUBLE, rr, rr, Time_Decomposition::Slice_Comm(), &status);
 
                 for(size_t ix(0); ix < outNxLocal; ++ix) {
                     for(size_t iy(0); iy < outNyLocal; ++iy) {
@@ -2418,7 +3001,7 @@ void Output_Data::Output_Preprocessor::Bz(const State2D& Y, const Grid_Info& gri
 
     if (PE.MPI_Processes() > 1) {
         if (PE.RANK()!=0) {
-            MPI_Send(Bzbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
+            MPI_Send(Bzbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), Time_Decomposition::Slice_Comm());
         }
         else {
             // Fill data for rank = 0
@@ -2437,7 +3020,7 @@ void Output_Data::Output_Preprocessor::Bz(const State2D& Y, const Grid_Info& gri
 
                 i = 0;
 
-                MPI_Recv(Bzbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
+                MPI_Recv(Bzbuf, msg_sz, MPI_DOUBLE, rr, rr, Time_Decomposition::Slice_Comm(), &status);
 
                 for(size_t ix(0); ix < outNxLocal; ++ix) {
                     for(size_t iy(0); iy < outNyLocal; ++iy) {
@@ -2463,86 +3046,199 @@ void Output_Data::Output_Preprocessor::Bz(const State2D& Y, const Grid_Info& gri
 }
 //--------------------------------------------------------------   
 //--------------------------------------------------------------
-void Output_Data::Output_Preprocessor::make_fp1p2p3(const State1D& Y, const Grid_Info& grid)
-{
-    size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
-     
-    size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    
-    for(int s(0); s < Y.Species(); ++s) 
+//--------------------------------------------------------------
+Output_Data::outwindow::outwindow(const std::string tag, const valarray<double>& xglobal)
+    : i0(0), i1(xglobal.size()) {
+
+    vector<double> window(Input::List().out_window);
+    for (size_t t(0); t < Input::List().out_window_tags.size(); ++t)
     {
-        for (size_t ix(0); ix < outNxLocal; ++ix)
-        {
-            p_x.p1p2p3(Y.DF(s), ix+Nbc, s);
-        }
+        if (Input::List().out_window_tags[t] == tag) window = Input::List().out_window_values[t];
     }
 
+    if (window[0] < window[1])
+    {
+        while (i0 < i1 && xglobal[i0] < window[0]) ++i0;
+        while (i1 > i0 && xglobal[i1-1] > window[1]) --i1;
+    }
+    sx = max(1, int(window[2]));
+    sp = max(1, int(window[3]));
 }
 //--------------------------------------------------------------
+size_t Output_Data::outwindow::first(size_t offset) const {
+    if (offset <= i0) return i0;
+    return i0 + ((offset - i0 + sx - 1)/sx)*sx;
+}
 //--------------------------------------------------------------
-void Output_Data::Output_Preprocessor::px(const State1D& Y, const Grid_Info& grid, const size_t tout, const double time, const double dt,
- const Parallel_Environment_1D& PE) {
-    
+size_t Output_Data::outwindow::count(size_t offset, size_t n) const {
+    size_t f(first(offset)), end(min(offset + n, i1));
+    if (f >= end) return 0;
+    return (end - f - 1)/sx + 1;
+}
+//--------------------------------------------------------------
+vector<double> Output_Data::outwindow::x(const valarray<double>& xglobal) const {
+    vector<double> xsel;
+    for (size_t i(i0); i < i1; i += sx) xsel.push_back(xglobal[i]);
+    return xsel;
+}
+//--------------------------------------------------------------
+vector<double> Output_Data::outwindow::p(const valarray<double>& paxis) const {
+    vector<double> psel;
+    for (size_t i(0); i < paxis.size(); i += sp) psel.push_back(paxis[i]);
+    return psel;
+}
+//--------------------------------------------------------------
+//--------------------------------------------------------------
+//  The selected cells of the local slab are packed in buf in 
+//  the order of the file, axes[xdim] being the selected x-axis. 
+//  Rank 0 writes its own slab, then reuses buf to receive and 
+//  write the others one at a time, so buf only needs to hold 
+//  the widest slab.
+//--------------------------------------------------------------
+void Output_Data::Output_Preprocessor::slabdump(const std::string tag, vector< vector<double> >& axes, const size_t xdim, 
+    valarray<double>& buf, const outwindow& w, const size_t tout, const double time, const double dt, const int s, 
+    const Parallel_Environment_1D& PE)
+{
+    MPI_Status status;
+
+    vector<size_t> start(axes.size(), 0), count(axes.size());
+    size_t vals_per_cell(1);
+    for (size_t d(0); d < axes.size(); ++d)
+    {
+        count[d] = axes[d].size();
+        if (d != xdim) vals_per_cell *= count[d];
+    }
+    size_t local_vals(w.count(PE.Slab_Offset(PE.RANK()), PE.Slab_Cells(PE.RANK()))*vals_per_cell);
+
+//  A relative lossy tolerance is taken from the largest |value| in the dataset
+    double local_max(0.), max_abs(0.);
+    if (Input::List().h5_lossy_tolerance > 0.)
+    {
+        for (size_t i(0); i < local_vals; ++i) local_max = max(local_max, fabs(buf[i]));
+        MPI_Reduce(&local_max, &max_abs, 1, MPI_DOUBLE, MPI_MAX, 0, Time_Decomposition::Slice_Comm());
+    }
+
+    if (PE.RANK() != 0)
+    {
+        MPI_Send(&buf[0], local_vals, MPI_DOUBLE, 0, PE.RANK(), Time_Decomposition::Slice_Comm());
+        return;
+    }
+
+    expo.Create_h5(tag, axes, tout, time, dt, s, max_abs);
+
+    for (int rr(0); rr < PE.MPI_Processes(); ++rr)
+    {
+        start[xdim] = w.start(PE.Slab_Offset(rr));
+        count[xdim] = w.count(PE.Slab_Offset(rr), PE.Slab_Cells(rr));
+
+        if (rr > 0) MPI_Recv(&buf[0], count[xdim]*vals_per_cell, MPI_DOUBLE, rr, rr, Time_Decomposition::Slice_Comm(), &status);
+
+        if (count[xdim] > 0) expo.Write_h5(tag, start, count, &buf[0], tout, s);
+    }
+}
+//--------------------------------------------------------------
+void Output_Data::Output_Preprocessor::xdump(const std::string tag, const valarray<double>& xbuf, const Grid_Info& grid,
+    const size_t tout, const double time, const double dt, const int s, const Parallel_Environment_1D& PE)
+{
+    outwindow w(tag, grid.axis.xg(0));
+    size_t offset(PE.Slab_Offset(PE.RANK()));
+    size_t i_first(w.first(offset) - offset);
+
+    valarray<double> buf(PE.Max_Slab_Cells());
+    for (size_t k(0); k < w.count(offset, PE.Slab_Cells(PE.RANK())); ++k) buf[k] = xbuf[i_first + k*w.sx];
+
+    vector< vector<double> > axes;
+    axes.push_back(w.x(grid.axis.xg(0)));
+
+    slabdump(tag, axes, 0, buf, w, tout, time, dt, s, PE);
+}
+//--------------------------------------------------------------
+//  2D tiles are all the same size; x and y are the axes xdim 
+//  and xdim+1
+//--------------------------------------------------------------
+void Output_Data::Output_Preprocessor::slabdump(const std::string tag, vector< vector<double> >& axes, const size_t xdim, 
+    valarray<double>& buf, const size_t tout, const double time, const double dt, const int s, const Parallel_Environment_2D& PE)
+{
+    MPI_Status status;
+
+    vector<size_t> start(axes.size(), 0), count(axes.size());
+    for (size_t d(0); d < axes.size(); ++d) count[d] = axes[d].size();
+    count[xdim]   /= PE.MPI_X();
+    count[xdim+1] /= PE.MPI_Y();
+
+    double local_max(0.), max_abs(0.);
+    if (Input::List().h5_lossy_tolerance > 0.)
+    {
+        local_max = abs(buf).max();
+        MPI_Reduce(&local_max, &max_abs, 1, MPI_DOUBLE, MPI_MAX, 0, Time_Decomposition::Slice_Comm());
+    }
+
+    if (PE.RANK() != 0)
+    {
+        MPI_Send(&buf[0], buf.size(), MPI_DOUBLE, 0, PE.RANK(), Time_Decomposition::Slice_Comm());
+        return;
+    }
+
+    expo.Create_h5(tag, axes, tout, time, dt, s, max_abs);
+
+    for (int rr(0); rr < PE.MPI_Processes(); ++rr)
+    {
+        if (rr > 0) MPI_Recv(&buf[0], buf.size(), MPI_DOUBLE, rr, rr, Time_Decomposition::Slice_Comm(), &status);
+
+        start[xdim]   = count[xdim]   * (rr % PE.MPI_X());
+        start[xdim+1] = count[xdim+1] * (rr / PE.MPI_X());
+        expo.Write_h5(tag, start, count, &buf[0], tout, s);
+    }
+}
+//--------------------------------------------------------------
+void Output_Data::Output_Preprocessor::make_fp1p2p3(const State1D& Y, const Grid_Info& grid)
+{
     size_t Nbc = Input::List().BoundaryCells;
     MPI_Status status;
      
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
+    
+    for(int s(0); s < Y.Species(); ++s) 
+    {
+        for (size_t ix(0); ix < outNxLocal; ++ix)
+        {
+            p_x.p1p2p3(Y.DF(s), ix, s);
+        }
+    }
 
-    vector<double> xaxis(valtovec(grid.axis.xg(0)));
+}
+//--------------------------------------------------------------
+//--------------------------------------------------------------
+void Output_Data::Output_Preprocessor::px(const State1D& Y, const Grid_Info& grid, const size_t tout, const double time, const double dt,
+ const Parallel_Environment_1D& PE) {
+    
+    size_t Nbc = Input::List().BoundaryCells;
+     
+    size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
+
+    outwindow w("px", grid.axis.xg(0));
+    size_t offset(PE.Slab_Offset(PE.RANK()));
+    size_t nsel(w.count(offset, outNxLocal)), i_first(w.first(offset) - offset);
 
     for(int s(0); s < Y.Species(); ++s) 
     {
-        size_t Npx(grid.axis.Npx(s));
-        int msg_sz(outNxLocal*Npx);
-        
-        Array2D<double> p1x1Global(Npx,outNxGlobal); 
-        vector<double> p1axis(valtovec(grid.axis.px(s)));
+        size_t Npx(w.Np(grid.axis.Npx(s)));
+        valarray<double> pxbuf(PE.Max_Slab_Cells()*Npx);
 
-        double pxbuf[Npx*outNxLocal];
+        vector< vector<double> > axes;
+        axes.push_back(w.p(grid.axis.px(s)));
+        axes.push_back(w.x(grid.axis.xg(0)));
 
         #pragma omp parallel for num_threads(Input::List().ompthreads)
-        for (size_t i = 0; i < outNxLocal; ++i) 
+        for (size_t k = 0; k < nsel; ++k) 
         {
-            valarray<double> data1D = p_x.p1( Y.DF(s), i, s);
+            valarray<double> data1D = p_x.p1( Y.DF(s), i_first + k*w.sx, s);
             for (size_t j(0); j < Npx; ++j) {
-                pxbuf[j+i*Npx]=data1D[j];
+                pxbuf[k+j*nsel]=data1D[j*w.sp];
             }
         }
 
-        if (PE.MPI_Processes() > 1) {
-            if (PE.RANK()!=0) {
-                MPI_Send(pxbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            }
-            else {
-                // Fill data for rank = 0
-                for(size_t i(0); i < outNxLocal; i++) {
-                    for (size_t j(0); j < Npx; ++j) {
-                        p1x1Global(j,i) = pxbuf[j+i*Npx];
-                    }
-                }
-                // Fill data for rank > 0
-                for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                    MPI_Recv(pxbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                    for(size_t i(0); i < outNxLocal; i++) {
-                        for (size_t j(0); j < Npx; ++j) {
-                            p1x1Global(j,i + outNxLocal*rr) = pxbuf[j+i*Npx];
-                        }
-                    }
-                }
-            }
-        }
-        else {
-            for(size_t i(0); i < outNxGlobal; i++) {
-                for (size_t j(0); j < Npx; ++j) {
-                    p1x1Global(j,i) = pxbuf[j+i*Npx];
-                }
-            }
-        }
-
-        if (PE.RANK() == 0) expo.Export_h5("px", p1axis, xaxis, p1x1Global, tout, time, dt, s);
-
+        slabdump("px", axes, 1, pxbuf, w, tout, time, dt, s, PE);
     }
 
 }
@@ -2618,13 +3314,14 @@ void Output_Data::Output_Preprocessor::px_radial(const State1D& Y, const Grid_In
     {
         size_t Npx(grid.axis.Npx(s));
         int msg_sz(outNxLocal*Npx);
+        int recv_sz(PE.Max_Slab_Cells()*Npx);
         size_t Np(grid.axis.Np(s));
         vector<double> pvec(valtovec(grid.axis.p(s)));
         
         Array2D<double> p1x1Global(Npx,outNxGlobal); 
         vector<double> p1axis(valtovec(grid.axis.px(s)));
 
-        valarray<double> pxbuf(Npx*outNxLocal);
+        valarray<double> pxbuf(recv_sz);
         
         pxbuf = 0.;
 
@@ -2669,7 +3366,7 @@ void Output_Data::Output_Preprocessor::px_radial(const State1D& Y, const Grid_In
 
         if (PE.MPI_Processes() > 1) {
             if (PE.RANK()!=0) {
-                MPI_Send(&pxbuf[0], msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
+                MPI_Send(&pxbuf[0], msg_sz, MPI_DOUBLE, 0, PE.RANK(), Time_Decomposition::Slice_Comm());
             }
             else {
                 // Fill data for rank = 0
@@ -2680,10 +3377,10 @@ void Output_Data::Output_Preprocessor::px_radial(const State1D& Y, const Grid_In
                 }
                 // Fill data for rank > 0
                 for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                    MPI_Recv(&pxbuf[0], msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                    for(size_t i(0); i < outNxLocal; i++) {
+                    MPI_Recv(&pxbuf[0], recv_sz, MPI_DOUBLE, rr, rr, Time_Decomposition::Slice_Comm(), &status);
+                    for(size_t i(0); i < PE.Slab_Cells(rr); i++) {
                         for (size_t j(0); j < Npx; ++j) {
-                            p1x1Global(j,i + outNxLocal*rr) = pxbuf[j+i*Npx];
+                            p1x1Global(j,i + PE.Slab_Offset(rr)) = pxbuf[j+i*Npx];
                         }
                     }
                 }
@@ -2706,132 +3403,68 @@ void Output_Data::Output_Preprocessor::px_radial(const State1D& Y, const Grid_In
 //--------------------------------------------------------------
 void Output_Data::Output_Preprocessor::py(const State1D& Y, const Grid_Info& grid, const size_t tout, const double time, const double dt,
  const Parallel_Environment_1D& PE) {
-    // std::cout << "0 \n";
+    
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
      
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
 
-    vector<double> xaxis(valtovec(grid.axis.xg(0)));
-
-    for(int s(0); s < Y.Species(); ++s) {
-        size_t Npy(grid.axis.Npy(s));
-        int msg_sz(outNxLocal*Npy);
-        Array2D<double> p2x1Global(Npy,outNxGlobal); 
-
-        vector<double> p2axis(valtovec(grid.axis.py(s)));
+    outwindow w("py", grid.axis.xg(0));
+    size_t offset(PE.Slab_Offset(PE.RANK()));
+    size_t nsel(w.count(offset, outNxLocal)), i_first(w.first(offset) - offset);
 
+    for(int s(0); s < Y.Species(); ++s) 
+    {
+        size_t Npy(w.Np(grid.axis.Npy(s)));
+        valarray<double> pybuf(PE.Max_Slab_Cells()*Npy);
 
-        double pybuf[Npy*outNxLocal];
+        vector< vector<double> > axes;
+        axes.push_back(w.p(grid.axis.py(s)));
+        axes.push_back(w.x(grid.axis.xg(0)));
 
-        for (size_t i(0); i < outNxLocal; ++i) 
+        #pragma omp parallel for num_threads(Input::List().ompthreads)
+        for (size_t k = 0; k < nsel; ++k) 
         {
-            valarray<double> data1D = p_x.p2( Y.DF(s), i, s);
-
+            valarray<double> data1D = p_x.p2( Y.DF(s), i_first + k*w.sx, s);
             for (size_t j(0); j < Npy; ++j) {
-                pybuf[j+i*Npy]=data1D[j];
-            }       
-        }
-
-        if (PE.MPI_Processes() > 1) {
-            if (PE.RANK()!=0) {
-                MPI_Send(pybuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            }
-            else {
-                // Fill data for rank = 0
-                for(size_t i(0); i < outNxLocal; i++) {
-                    for (size_t j(0); j < Npy; ++j) {
-                        p2x1Global(j,i) = pybuf[j+i*Npy];
-                    }
-                }
-                // Fill data for rank > 0
-                for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                    MPI_Recv(pybuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                    for(size_t i(0); i < outNxLocal; i++) {
-                        for (size_t j(0); j < Npy; ++j) {
-                            p2x1Global(j,i + outNxLocal*rr) = pybuf[j+i*Npy];
-                        }
-                    }
-                }
+                pybuf[k+j*nsel]=data1D[j*w.sp];
             }
         }
-        else {
-            for(size_t i(0); i < outNxGlobal; i++) 
-            {
-                for (size_t j(0); j < Npy; ++j) 
-                {
-                    p2x1Global(j,i) = pybuf[j+i*Npy];
-                }
-            }
-        }
-
-        if (PE.RANK() == 0) expo.Export_h5("py", p2axis, xaxis, p2x1Global, tout, time, dt, s);
 
+        slabdump("py", axes, 1, pybuf, w, tout, time, dt, s, PE);
     }
 
 }
 //--------------------------------------------------------------
 void Output_Data::Output_Preprocessor::pz(const State1D& Y, const Grid_Info& grid, const size_t tout, const double time, const double dt,
  const Parallel_Environment_1D& PE) {
-    // std::cout << "0 \n";
+    
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
+     
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
-
-    vector<double> xaxis(valtovec(grid.axis.xg(0)));
-
-    for(int s(0); s < Y.Species(); ++s) {
-        size_t Npz(grid.axis.Npz(s));
-        int msg_sz(outNxLocal*Npz);
-        
-        Array2D<double> p3x1Global(Npz,outNxGlobal); 
-        vector<double> p3axis(valtovec(grid.axis.pz(s)));
 
-        double pzbuf[Npz*outNxLocal];
+    outwindow w("pz", grid.axis.xg(0));
+    size_t offset(PE.Slab_Offset(PE.RANK()));
+    size_t nsel(w.count(offset, outNxLocal)), i_first(w.first(offset) - offset);
 
-        for (size_t i(0); i < outNxLocal; ++i) {
+    for(int s(0); s < Y.Species(); ++s) 
+    {
+        size_t Npz(w.Np(grid.axis.Npz(s)));
+        valarray<double> pzbuf(PE.Max_Slab_Cells()*Npz);
 
-            valarray<double> data1D = p_x.p3( Y.DF(s), i, s);
+        vector< vector<double> > axes;
+        axes.push_back(w.p(grid.axis.pz(s)));
+        axes.push_back(w.x(grid.axis.xg(0)));
 
+        #pragma omp parallel for num_threads(Input::List().ompthreads)
+        for (size_t k = 0; k < nsel; ++k) 
+        {
+            valarray<double> data1D = p_x.p3( Y.DF(s), i_first + k*w.sx, s);
             for (size_t j(0); j < Npz; ++j) {
-                pzbuf[j+i*Npz]=data1D[j];
+                pzbuf[k+j*nsel]=data1D[j*w.sp];
             }
         }
 
-        if (PE.MPI_Processes() > 1) {
-            if (PE.RANK()!=0) {
-                MPI_Send(pzbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            }
-            else {
-                // Fill data for rank = 0
-                for(size_t i(0); i < outNxLocal; i++) {
-                    for (size_t j(0); j < Npz; ++j) {
-                        p3x1Global(j,i) = pzbuf[j+i*Npz];
-                    }
-                }
-                // Fill data for rank > 0
-                for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                    MPI_Recv(pzbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                    for(size_t i(0); i < outNxLocal; i++) {
-                        for (size_t j(0); j < Npz; ++j) {
-                            p3x1Global(j,i + outNxLocal*rr) = pzbuf[j+i*Npz];
-                        }
-                    }
-                }
-            }
-        }
-        else {
-            for(size_t i(0); i < outNxGlobal; i++) {
-                for (size_t j(0); j < Npz; ++j) {
-                    p3x1Global(j,i) = pzbuf[j+i*Npz];
-                }
-            }
-        }
-
-        if (PE.RANK() == 0) expo.Export_h5("pz", p3axis, xaxis, p3x1Global, tout, time, dt, s);
-
+        slabdump("pz", axes, 1, pzbuf, w, tout, time, dt, s, PE);
     }
 
 }
@@ -2840,101 +3473,34 @@ void Output_Data::Output_Preprocessor::pz(const State1D& Y, const Grid_Info& gri
 //-----------------------------------------------------------------------------------
 void Output_Data::Output_Preprocessor::px(const State2D& Y, const Grid_Info& grid, const size_t tout, const double time, const double dt,
  const Parallel_Environment_2D& PE) {
-    // std::cout << "0 \n";
+
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
     
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc), outNyLocal(grid.axis.Nx(1) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0)), outNyGlobal(grid.axis.Nxg(1));
-
-    int rankx,ranky;
-    vector<double> xaxis(valtovec(grid.axis.xg(0)));
-    vector<double> yaxis(valtovec(grid.axis.xg(1)));
 
     for(int s(0); s < Y.Species(); ++s) 
     {
         size_t Npx(grid.axis.Npx(s));
-        int msg_sz(outNxLocal*outNyLocal*Npx);
-        Array3D<double> p1x1Global(Npx,outNxGlobal,outNyGlobal); //, yglob_axis.dim());
-        double pxbuf[Npx*outNxLocal*outNyLocal];
+        valarray<double> pbuf(Npx*outNxLocal*outNyLocal);
 
-        vector<double> p1axis(valtovec(grid.axis.px(s)));
-
-        size_t counter(0);
+        vector< vector<double> > axes;
+        axes.push_back(valtovec(grid.axis.px(s)));
+        axes.push_back(valtovec(grid.axis.xg(0)));
+        axes.push_back(valtovec(grid.axis.xg(1)));
 
         for(size_t ix(0); ix < outNxLocal; ++ix) 
         {
             for(size_t iy(0); iy < outNyLocal; ++iy) 
             {
-
                 valarray<double> data1D = p_x.p1( Y.DF(s), ix, iy, s);
 
                 for (size_t j(0); j < Npx; ++j) {
-                    pxbuf[counter]=data1D[j];
-                    ++counter;
-                }
-            }
-        }
-
-        if (PE.MPI_Processes() > 1) {
-            if (PE.RANK()!=0) {
-                MPI_Send(pxbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            }
-            else 
-            {
-                size_t counter(0);
-                // Fill data for rank = 0
-                for(size_t ix(0); ix < outNxLocal; ++ix) 
-                {
-                    for(size_t iy(0); iy < outNyLocal; ++iy) 
-                    {
-                        for (size_t j(0); j < Npx; ++j) 
-                        {
-                            p1x1Global(j,ix,iy) = pxbuf[counter];
-                            ++counter;
-                        }
-                    }
-                }
-                // Fill data for rank > 0
-                for (int rr = 1; rr < PE.MPI_Processes(); ++rr)
-                {
-                    rankx = rr % PE.MPI_X();
-                    ranky = rr / PE.MPI_X();
-
-                    MPI_Recv(pxbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                    counter = 0;    
-                    for(size_t ix(0); ix < outNxLocal; ++ix) 
-                    {
-                        for(size_t iy(0); iy < outNyLocal; ++iy) 
-                        {
-                            for (size_t j(0); j < Npx; ++j) 
-                            {
-                                p1x1Global(j,ix + outNxLocal*rankx, iy + outNyLocal*ranky) = pxbuf[counter];
-                                ++counter;
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        else 
-        {
-            size_t counter(0);            
-            for(size_t ix(0); ix < outNxLocal; ++ix) 
-            {
-                for(size_t iy(0); iy < outNyLocal; ++iy) 
-                {
-                    for (size_t j(0); j < Npx; ++j) 
-                    {
-                        p1x1Global(j,ix,iy) = pxbuf[counter];
-                        ++counter;
-                    }
+                    pbuf[(j*outNxLocal+ix)*outNyLocal+iy]=data1D[j];
                 }
             }
         }
 
-        if (PE.RANK() == 0) expo.Export_h5("px", p1axis,xaxis, yaxis, p1x1Global, tout, time, dt, s);
-
+        slabdump("px", axes, 1, pbuf, tout, time, dt, s, PE);
     }
 
 }
@@ -2943,26 +3509,20 @@ void Output_Data::Output_Preprocessor::px(const State2D& Y, const Grid_Info& gri
 //-----------------------------------------------------------------------------------
 void Output_Data::Output_Preprocessor::py(const State2D& Y, const Grid_Info& grid, const size_t tout, const double time, const double dt,
  const Parallel_Environment_2D& PE) {
-    // std::cout << "0 \n";
+
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
     
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc), outNyLocal(grid.axis.Nx(1) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0)), outNyGlobal(grid.axis.Nxg(1));
 
-    int rankx,ranky;
-    vector<double> xaxis(valtovec(grid.axis.xg(0)));
-    vector<double> yaxis(valtovec(grid.axis.xg(1)));
-
-    for(int s(0); s < Y.Species(); ++s) {
+    for(int s(0); s < Y.Species(); ++s) 
+    {
         size_t Npy(grid.axis.Npy(s));
-        int msg_sz(outNxLocal*outNyLocal*Npy);
-        Array3D<double> p1x1Global(Npy,outNxGlobal,outNyGlobal); //, yglob_axis.dim());
-        double pxbuf[Npy*outNxLocal*outNyLocal];
-        vector<double> p2axis(valtovec(grid.axis.py(s)));
-        
+        valarray<double> pbuf(Npy*outNxLocal*outNyLocal);
 
-        size_t counter(0);
+        vector< vector<double> > axes;
+        axes.push_back(valtovec(grid.axis.py(s)));
+        axes.push_back(valtovec(grid.axis.xg(0)));
+        axes.push_back(valtovec(grid.axis.xg(1)));
 
         for(size_t ix(0); ix < outNxLocal; ++ix) 
         {
@@ -2971,72 +3531,12 @@ void Output_Data::Output_Preprocessor::py(const State2D& Y, const Grid_Info& gri
                 valarray<double> data1D = p_x.p2( Y.DF(s), ix, iy, s);
 
                 for (size_t j(0); j < Npy; ++j) {
-                    pxbuf[counter]=data1D[j];
-                    ++counter;
-                }
-            }
-        }
-
-        if (PE.MPI_Processes() > 1) 
-        {
-            if (PE.RANK()!=0) {
-                MPI_Send(pxbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            }
-            else 
-            {
-                size_t counter(0);
-                // Fill data for rank = 0
-                for(size_t ix(0); ix < outNxLocal; ++ix) 
-                {
-                    for(size_t iy(0); iy < outNyLocal; ++iy) 
-                    {
-                        for (size_t j(0); j < Npy; ++j) 
-                        {
-                            p1x1Global(j,ix,iy) = pxbuf[counter];
-                            ++counter;
-                        }
-                    }
-                }
-                // Fill data for rank > 0
-                for (int rr = 1; rr < PE.MPI_Processes(); ++rr)
-                {
-                    rankx = rr % PE.MPI_X();
-                    ranky = rr / PE.MPI_X();
-
-                    MPI_Recv(pxbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                    counter = 0;    
-                    for(size_t ix(0); ix < outNxLocal; ++ix) 
-                    {
-                        for(size_t iy(0); iy < outNyLocal; ++iy) 
-                        {
-                            for (size_t j(0); j < Npy; ++j) 
-                            {
-                                p1x1Global(j,ix + outNxLocal*rankx, iy + outNyLocal*ranky) = pxbuf[counter];
-                                ++counter;
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        else 
-        {
-            size_t counter(0);            
-            for(size_t ix(0); ix < outNxLocal; ++ix) 
-            {
-                for(size_t iy(0); iy < outNyLocal; ++iy) 
-                {
-                    for (size_t j(0); j < Npy; ++j) 
-                    {
-                        p1x1Global(j,ix,iy) = pxbuf[counter];
-                        ++counter;
-                    }
+                    pbuf[(j*outNxLocal+ix)*outNyLocal+iy]=data1D[j];
                 }
             }
         }
 
-        if (PE.RANK() == 0) expo.Export_h5("py", p2axis, xaxis, yaxis, p1x1Global, tout, time, dt, s);
-
+        slabdump("py", axes, 1, pbuf, tout, time, dt, s, PE);
     }
 
 }
@@ -3044,99 +3544,34 @@ void Output_Data::Output_Preprocessor::py(const State2D& Y, const Grid_Info& gri
 //-----------------------------------------------------------------------------------
 void Output_Data::Output_Preprocessor::pz(const State2D& Y, const Grid_Info& grid, const size_t tout, const double time, const double dt,
  const Parallel_Environment_2D& PE) {
-    // std::cout << "0 \n";
+
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
     
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc), outNyLocal(grid.axis.Nx(1) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0)), outNyGlobal(grid.axis.Nxg(1));
-
-    int rankx,ranky;
-    vector<double> xaxis(valtovec(grid.axis.xg(0)));
-    vector<double> yaxis(valtovec(grid.axis.xg(1)));
 
-    for(int s(0); s < Y.Species(); ++s) {
+    for(int s(0); s < Y.Species(); ++s) 
+    {
         size_t Npz(grid.axis.Npz(s));
-        int msg_sz(outNxLocal*outNyLocal*Npz);
-        Array3D<double> p1x1Global(Npz,outNxGlobal,outNyGlobal); //, yglob_axis.dim());
-        double pxbuf[Npz*outNxLocal*outNyLocal];
-        vector<double> p3axis(valtovec(grid.axis.pz(s)));
+        valarray<double> pbuf(Npz*outNxLocal*outNyLocal);
 
-        size_t counter(0);
+        vector< vector<double> > axes;
+        axes.push_back(valtovec(grid.axis.pz(s)));
+        axes.push_back(valtovec(grid.axis.xg(0)));
+        axes.push_back(valtovec(grid.axis.xg(1)));
 
         for(size_t ix(0); ix < outNxLocal; ++ix) 
         {
             for(size_t iy(0); iy < outNyLocal; ++iy) 
             {
-
                 valarray<double> data1D = p_x.p3( Y.DF(s), ix, iy, s);
 
                 for (size_t j(0); j < Npz; ++j) {
-                    pxbuf[counter]=data1D[j];
-                    ++counter;
+                    pbuf[(j*outNxLocal+ix)*outNyLocal+iy]=data1D[j];
                 }
             }
         }
 
-        if (PE.MPI_Processes() > 1) {
-            if (PE.RANK()!=0) {
-                MPI_Send(pxbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            }
-            else 
-            {
-                size_t counter(0);
-                // Fill data for rank = 0
-                for(size_t ix(0); ix < outNxLocal; ++ix) 
-                {
-                    for(size_t iy(0); iy < outNyLocal; ++iy) 
-                    {
-                        for (size_t j(0); j < Npz; ++j) 
-                        {
-                            p1x1Global(j,ix,iy) = pxbuf[counter];
-                            ++counter;
-                        }
-                    }
-                }
-                // Fill data for rank > 0
-                for (int rr = 1; rr < PE.MPI_Processes(); ++rr)
-                {
-                    rankx = rr % PE.MPI_X();
-                    ranky = rr / PE.MPI_X();
-
-                    MPI_Recv(pxbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                    counter = 0;    
-                    for(size_t ix(0); ix < outNxLocal; ++ix) 
-                    {
-                        for(size_t iy(0); iy < outNyLocal; ++iy) 
-                        {
-                            for (size_t j(0); j < Npz; ++j) 
-                            {
-                                p1x1Global(j,ix + outNxLocal*rankx, iy + outNyLocal*ranky) = pxbuf[counter];
-                                ++counter;
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        else 
-        {
-            size_t counter(0);            
-            for(size_t ix(0); ix < outNxLocal; ++ix) 
-            {
-                for(size_t iy(0); iy < outNyLocal; ++iy) 
-                {
-                    for (size_t j(0); j < Npz; ++j) 
-                    {
-                        p1x1Global(j,ix,iy) = pxbuf[counter];
-                        ++counter;
-                    }
-                }
-            }
-        }
-
-        if (PE.RANK() == 0) expo.Export_h5("pz", p3axis, xaxis, yaxis, p1x1Global, tout, time, dt, s);
-
+        slabdump("pz", axes, 1, pbuf, tout, time, dt, s, PE);
     }
 
 }
@@ -3151,217 +3586,83 @@ void Output_Data::Output_Preprocessor::pz(const State2D& Y, const Grid_Info& gri
  */
 //--------------------------------------------------------------
 void Output_Data::Output_Preprocessor::pxpy(const State1D& Y, const Grid_Info& grid, const size_t tout, const double time, const double dt,
-  const Parallel_Environment_1D& PE) 
+ const Parallel_Environment_1D& PE)
 {
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
 
-    
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
-    size_t ind(0);
 
-    vector<double> xaxis(valtovec(grid.axis.xg(0)));
-    
+    outwindow w("pxpy", grid.axis.xg(0));
+    size_t offset(PE.Slab_Offset(PE.RANK()));
+    size_t nsel(w.count(offset, outNxLocal)), i_first(w.first(offset) - offset);
+
     for(int s(0); s < Y.Species(); ++s) 
     {
-        
-        int msg_sz(outNxLocal*grid.axis.Npx(s)*grid.axis.Npy(s));        
-        Array3D<double> pxpyGlobal(grid.axis.Npx(s),grid.axis.Npy(s),outNxGlobal);
-        
-        double pbuf[grid.axis.Npx(s)*grid.axis.Npy(s)*outNxLocal];        
-        vector<double> p1axis(valtovec(grid.axis.px(s)));
-        vector<double> p2axis(valtovec(grid.axis.py(s)));
+        size_t Npx(w.Np(grid.axis.Npx(s))), Npy(w.Np(grid.axis.Npy(s)));
+        valarray<double> pbuf(PE.Max_Slab_Cells()*Npx*Npy);
+
+        vector< vector<double> > axes;
+        axes.push_back(w.p(grid.axis.px(s)));
+        axes.push_back(w.p(grid.axis.py(s)));
+        axes.push_back(w.x(grid.axis.xg(0)));
 
-        ind = 0;    
-        for (size_t i(0); i < outNxLocal; ++i) 
+        #pragma omp parallel for num_threads(Input::List().ompthreads)
+        for (size_t i = 0; i < nsel; ++i) 
         {
-            Array2D<double> data2D = p_x.p1p2( Y.DF(s), i, s);
-            for (size_t j(0); j < grid.axis.Npx(s); ++j) 
-            {
+            Array2D<double> data2D = p_x.p1p2( Y.DF(s), i_first + i*w.sx, s);
 
-                for (size_t k(0); k < grid.axis.Npy(s); ++k) 
+            for (size_t j(0); j < Npx; ++j) 
+            {
+                for (size_t k(0); k < Npy; ++k) 
                 {
-                    pbuf[ind]=data2D(j,k);
-                    ++ind;
+                    pbuf[(j*Npy+k)*nsel+i]=data2D(j*w.sp,k*w.sp);
                 }
-
             }
-            
         }
 
-        if (PE.MPI_Processes() > 1) 
-        {
-           if (PE.RANK()!=0) {
-               MPI_Send(pbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-           }
-           else {
-               // Fill data for rank = 0
-               ind = 0;
-               for(size_t i(0); i < outNxLocal; i++) 
-               {
-                    for (size_t j(0); j < grid.axis.Npx(s); ++j) 
-                    {
-                        for (size_t k(0); k < grid.axis.Npy(s); ++k) 
-                        {
-                            pxpyGlobal(j,k,i) = pbuf[ind];
-                            ++ind;
-                        }
-                    }
-                }
-                // Fill data for rank > 0
-                for (int rr(1); rr < PE.MPI_Processes(); ++rr){
-                    MPI_Recv(pbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                    ind = 0;
-                    for(size_t i(0); i < outNxLocal; i++) 
-                    {
-                        for (size_t j(0); j < grid.axis.Npx(s); ++j) 
-                        {
-                            for (size_t k(0); k < grid.axis.Npy(s); ++k) 
-                            {
-                                pxpyGlobal(j,k,i + outNxLocal*rr) = pbuf[ind];
-                                ++ind;
-                            }
-                        }
-                    }
-                }
-            }
-        }
-       else {
-           ind = 0;
-           for(size_t i(0); i < outNxLocal; i++) {
-               for (size_t j(0); j < grid.axis.Npx(s); ++j) {
-                   for (size_t k(0); k < grid.axis.Npy(s); ++k) {
-                       pxpyGlobal(j,k,i) = pbuf[ind];
-                       ++ind;
-                   }
-               }
-           }
-       }
-
-       if (PE.RANK() == 0) expo.Export_h5("pxpy", p1axis, p2axis, xaxis, pxpyGlobal, tout, time, dt, s);
-
-   }
+        slabdump("pxpy", axes, 2, pbuf, w, tout, time, dt, s, PE);
+    }
 
 }
 //--------------------------------------------------------------
 //--------------------------------------------------------------
 void Output_Data::Output_Preprocessor::pxpy(const State2D& Y, const Grid_Info& grid, const size_t tout, const double time, const double dt,
-  const Parallel_Environment_2D& PE) {
+ const Parallel_Environment_2D& PE) {
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
-
-    size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc), outNyLocal(grid.axis.Nx(1) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0)), outNyGlobal(grid.axis.Nxg(1));
-
-    int rankx,ranky;
-    vector<double> xaxis(valtovec(grid.axis.xg(0)));
-    vector<double> yaxis(valtovec(grid.axis.xg(1)));
-    size_t counter;
-
-    for(int s(0); s < Y.Species(); ++s) 
-    {
-
-        int msg_sz(outNxLocal*outNyLocal*grid.axis.Npx(s)*grid.axis.Npy(s));
-        Array4D<double> pxpyGlobal(grid.axis.Npx(s),grid.axis.Npy(s),outNxGlobal,outNyGlobal); //, yglob_axis.dim());
-        double pbuf[grid.axis.Npx(s)*grid.axis.Npy(s)*outNxLocal*outNyLocal];
-        vector<double> p1axis(valtovec(grid.axis.px(s)));
-        vector<double> p2axis(valtovec(grid.axis.py(s)));
-
-        counter = 0;
-        for(size_t ix(0); ix < outNxLocal; ++ix) 
-        {
-            for(size_t iy(0); iy < outNyLocal; ++iy) 
-            {
-                Array2D<double> data2D = p_x.p1p2( Y.DF(s), ix, iy, s);
-
-                for (size_t j(0); j < grid.axis.Npx(s); ++j) 
-                {
-                    for (size_t k(0); k < grid.axis.Npy(s); ++k) 
-                    {
-                        pbuf[counter]=data2D(j,k);
-                        ++counter;
-                    }
-                }
-            }
-        }
-
-        if (PE.MPI_Processes() > 1) 
-        {
-            if (PE.RANK()!=0) {
-                MPI_Send(pbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            }
-            else 
-            {
-                // Fill data for rank = 0
-                counter = 0;
-                for(size_t ix(0); ix < outNxLocal; ++ix) 
-                {
-                    for(size_t iy(0); iy < outNyLocal; ++iy) 
-                    {
-                        for (size_t j(0); j < grid.axis.Npx(s); ++j) 
-                        {
-                            for (size_t k(0); k < grid.axis.Npy(s); ++k) 
-                            {
-                                pxpyGlobal(j,k,ix,iy) = pbuf[counter];
-                                ++counter;
-                            }
-                        }
-                   }
-               }
-               // Fill data for rank > 0
-               for (int rr(1); rr < PE.MPI_Processes(); ++rr)
-               {
-                    rankx = rr % PE.MPI_X();
-                    ranky = rr / PE.MPI_X();
-
-                    counter = 0;
-
-                    MPI_Recv(pbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-
-                    for(size_t ix(0); ix < outNxLocal; ++ix) 
-                    {
-                        for(size_t iy(0); iy < outNyLocal; ++iy)
-                        {
-                            for (size_t j(0); j < grid.axis.Npx(s); ++j) 
-                            {
-                                for (size_t k(0); k < grid.axis.Npy(s); ++k) 
-                                {
-                                    pxpyGlobal(j,k,ix + outNxLocal*rankx,iy + outNyLocal*ranky) = pbuf[counter];
-                                    ++counter;
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        else 
-        {
-            counter = 0;
 
-            for(size_t ix(0); ix < outNxLocal; ++ix) 
+    size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc), outNyLocal(grid.axis.Nx(1) - 2*Nbc);
+
+    for(int s(0); s < Y.Species(); ++s) 
+    {
+        size_t Npx(grid.axis.Npx(s)), Npy(grid.axis.Npy(s));
+        valarray<double> pbuf(Npx*Npy*outNxLocal*outNyLocal);
+
+        vector< vector<double> > axes;
+        axes.push_back(valtovec(grid.axis.px(s)));
+        axes.push_back(valtovec(grid.axis.py(s)));
+        axes.push_back(valtovec(grid.axis.xg(0)));
+        axes.push_back(valtovec(grid.axis.xg(1)));
+
+        for(size_t ix(0); ix < outNxLocal; ++ix) 
+        {
+            for(size_t iy(0); iy < outNyLocal; ++iy) 
             {
-                for(size_t iy(0); iy < outNyLocal; ++iy) 
+                Array2D<double> data2D = p_x.p1p2( Y.DF(s), ix, iy, s);
+
+                for (size_t j(0); j < Npx; ++j) 
                 {
-                    for (size_t j(0); j < grid.axis.Npx(s); ++j) 
+                    for (size_t k(0); k < Npy; ++k) 
                     {
-                        for (size_t k(0); k < grid.axis.Npy(s); ++k) 
-                        {
-                            pxpyGlobal(j,k,ix,iy) = pbuf[counter];
-                            ++counter;
-                        }
+                        pbuf[((j*Npy+k)*outNxLocal+ix)*outNyLocal+iy]=data2D(j,k);
                     }
                 }
             }
         }
-       
 
-       if (PE.RANK() == 0) expo.Export_h5("pxpy", p1axis, p2axis, xaxis, yaxis, pxpyGlobal, tout, time, dt, s);
-
-   }
+        slabdump("pxpy", axes, 2, pbuf, tout, time, dt, s, PE);
+    }
 
 }
 //--------------------------------------------------------------
@@ -3377,214 +3678,83 @@ void Output_Data::Output_Preprocessor::pxpy(const State2D& Y, const Grid_Info& g
  */
 //--------------------------------------------------------------
 void Output_Data::Output_Preprocessor::pypz(const State1D& Y, const Grid_Info& grid, const size_t tout, const double time, const double dt,
-  const Parallel_Environment_1D& PE) {
+ const Parallel_Environment_1D& PE)
+{
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
 
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
-    size_t ind(0);
-
-    vector<double> xaxis(valtovec(grid.axis.xg(0)));
-
-    for(int s(0); s < Y.Species(); ++s) {
 
-        int msg_sz(outNxLocal*grid.axis.Npy(s)*grid.axis.Npz(s));
-        Array3D<double> pypzGlobal(grid.axis.Npy(s),grid.axis.Npz(s),outNxGlobal);
-        double pbuf[grid.axis.Npy(s)*grid.axis.Npz(s)*outNxLocal];
+    outwindow w("pypz", grid.axis.xg(0));
+    size_t offset(PE.Slab_Offset(PE.RANK()));
+    size_t nsel(w.count(offset, outNxLocal)), i_first(w.first(offset) - offset);
 
-        ind = 0;
-
-        vector<double> p2axis(valtovec(grid.axis.py(s)));
-        vector<double> p3axis(valtovec(grid.axis.pz(s)));
-
-        for (size_t i(0); i < outNxLocal; ++i) {
+    for(int s(0); s < Y.Species(); ++s) 
+    {
+        size_t Npy(w.Np(grid.axis.Npy(s))), Npz(w.Np(grid.axis.Npz(s)));
+        valarray<double> pbuf(PE.Max_Slab_Cells()*Npy*Npz);
 
-            Array2D<double> data2D = p_x.p2p3( Y.DF(s), i, s);
+        vector< vector<double> > axes;
+        axes.push_back(w.p(grid.axis.py(s)));
+        axes.push_back(w.p(grid.axis.pz(s)));
+        axes.push_back(w.x(grid.axis.xg(0)));
 
-            for (size_t j(0); j < grid.axis.Npy(s); ++j) 
-            {
-               for (size_t k(0); k < grid.axis.Npz(s); ++k) 
-                {
-                   pbuf[ind]=data2D(j,k);
-                   ++ind;
-                }
-           }
-       }
-
-       if (PE.MPI_Processes() > 1) {
-           if (PE.RANK()!=0) {
-               MPI_Send(pbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-           }
-           else 
-           {
-               // Fill data for rank = 0
-                ind = 0;
-                for(size_t i(0); i < outNxLocal; i++) 
-                {
-                    for (size_t j(0); j < grid.axis.Npy(s); ++j) 
-                    {
-                        for (size_t k(0); k < grid.axis.Npz(s); ++k) 
-                        {
-                           pypzGlobal(j,k,i) = pbuf[ind];
-                           ++ind;
-                        }
-                    }
-                }
-                // Fill data for rank > 0
-                for (int rr(1); rr < PE.MPI_Processes(); ++rr){
-                    MPI_Recv(pbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                    ind = 0;
-                    for(size_t i(0); i < outNxLocal; i++) {
-                        for (size_t j(0); j < grid.axis.Npy(s); ++j) {
-                            for (size_t k(0); k < grid.axis.Npz(s); ++k) {
-                                pypzGlobal(j,k,i + outNxLocal*rr) = pbuf[ind];
-                                ++ind;
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        else 
+        #pragma omp parallel for num_threads(Input::List().ompthreads)
+        for (size_t i = 0; i < nsel; ++i) 
         {
-            ind = 0;
-            for(size_t i(0); i < outNxLocal; i++) 
+            Array2D<double> data2D = p_x.p2p3( Y.DF(s), i_first + i*w.sx, s);
+
+            for (size_t j(0); j < Npy; ++j) 
             {
-                for (size_t j(0); j < grid.axis.Npy(s); ++j) 
+                for (size_t k(0); k < Npz; ++k) 
                 {
-                    for (size_t k(0); k < grid.axis.Npz(s); ++k) 
-                    {
-                        pypzGlobal(j,k,i) = pbuf[ind];
-                        ++ind;
-                    }
+                    pbuf[(j*Npz+k)*nsel+i]=data2D(j*w.sp,k*w.sp);
                 }
             }
         }
 
-       if (PE.RANK() == 0) expo.Export_h5("pypz", p2axis, p3axis, xaxis, pypzGlobal, tout, time, dt, s);
-
-   }
+        slabdump("pypz", axes, 2, pbuf, w, tout, time, dt, s, PE);
+    }
 
 }
 //--------------------------------------------------------------
 //--------------------------------------------------------------
 void Output_Data::Output_Preprocessor::pypz(const State2D& Y, const Grid_Info& grid, const size_t tout, const double time, const double dt,
-  const Parallel_Environment_2D& PE) {
+ const Parallel_Environment_2D& PE) {
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
 
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc), outNyLocal(grid.axis.Nx(1) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0)), outNyGlobal(grid.axis.Nxg(1));
-
-    int rankx,ranky;
-    vector<double> xaxis(valtovec(grid.axis.xg(0)));
-    vector<double> yaxis(valtovec(grid.axis.xg(1)));
-    size_t counter;
-
 
     for(int s(0); s < Y.Species(); ++s) 
     {
-        int msg_sz(outNxLocal*outNyLocal*grid.axis.Npx(s)*grid.axis.Npy(s));
-        Array4D<double> dataGlobal(grid.axis.Npx(s),grid.axis.Npy(s),outNxGlobal,outNyGlobal); 
-        double pbuf[grid.axis.Npx(s)*grid.axis.Npy(s)*outNxLocal*outNyLocal];
-        vector<double> p2axis(valtovec(grid.axis.py(s)));
-        vector<double> p3axis(valtovec(grid.axis.pz(s)));
+        size_t Npy(grid.axis.Npy(s)), Npz(grid.axis.Npz(s));
+        valarray<double> pbuf(Npy*Npz*outNxLocal*outNyLocal);
+
+        vector< vector<double> > axes;
+        axes.push_back(valtovec(grid.axis.py(s)));
+        axes.push_back(valtovec(grid.axis.pz(s)));
+        axes.push_back(valtovec(grid.axis.xg(0)));
+        axes.push_back(valtovec(grid.axis.xg(1)));
 
-        counter = 0;
         for(size_t ix(0); ix < outNxLocal; ++ix) 
         {
             for(size_t iy(0); iy < outNyLocal; ++iy) 
             {
                 Array2D<double> data2D = p_x.p2p3( Y.DF(s), ix, iy, s);
 
-                for (size_t j(0); j < grid.axis.Npx(s); ++j) 
-                {
-                    for (size_t k(0); k < grid.axis.Npy(s); ++k) 
-                    {
-                        pbuf[counter]=data2D(j,k);
-                        ++counter;
-                    }
-                }
-            }
-        }
-
-        if (PE.MPI_Processes() > 1) 
-        {
-            if (PE.RANK()!=0) {
-                MPI_Send(pbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            }
-            else 
-            {
-                // Fill data for rank = 0
-                counter = 0;
-                for(size_t ix(0); ix < outNxLocal; ++ix) 
-                {
-                    for(size_t iy(0); iy < outNyLocal; ++iy) 
-                    {
-                        for (size_t j(0); j < grid.axis.Npx(s); ++j) 
-                        {
-                            for (size_t k(0); k < grid.axis.Npy(s); ++k) 
-                            {
-                                dataGlobal(j,k,ix,iy) = pbuf[counter];
-                                ++counter;
-                            }
-                        }
-                   }
-               }
-               // Fill data for rank > 0
-               for (int rr(1); rr < PE.MPI_Processes(); ++rr)
-               {
-                    rankx = rr % PE.MPI_X();
-                    ranky = rr / PE.MPI_X();
-
-                    counter = 0;
-
-                    MPI_Recv(pbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                    
-                    for(size_t ix(0); ix < outNxLocal; ++ix) 
-                    {
-                        for(size_t iy(0); iy < outNyLocal; ++iy)
-                        {
-                            for (size_t j(0); j < grid.axis.Npx(s); ++j) 
-                            {
-                                for (size_t k(0); k < grid.axis.Npy(s); ++k) 
-                                {
-                                    dataGlobal(j,k,ix + outNxLocal*rankx,iy + outNyLocal*ranky) = pbuf[counter];
-                                    ++counter;
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        else 
-        {
-            counter = 0;
-
-            for(size_t ix(0); ix < outNxLocal; ++ix) 
-            {
-                for(size_t iy(0); iy < outNyLocal; ++iy) 
+                for (size_t j(0); j < Npy; ++j) 
                 {
-                    for (size_t j(0); j < grid.axis.Npx(s); ++j) 
+                    for (size_t k(0); k < Npz; ++k) 
                     {
-                        for (size_t k(0); k < grid.axis.Npy(s); ++k) 
-                        {
-                            dataGlobal(j,k,ix,iy) = pbuf[counter];
-                            ++counter;
-                        }
+                        pbuf[((j*Npz+k)*outNxLocal+ix)*outNyLocal+iy]=data2D(j,k);
                     }
                 }
             }
         }
-       
-
-       if (PE.RANK() == 0) expo.Export_h5("pypz", p2axis, p3axis, xaxis, yaxis, dataGlobal, tout, time, dt, s);
 
-   }
+        slabdump("pypz", axes, 2, pbuf, tout, time, dt, s, PE);
+    }
 
 }
 //--------------------------------------------------------------
@@ -3599,213 +3769,82 @@ void Output_Data::Output_Preprocessor::pypz(const State2D& Y, const Grid_Info& g
  */
 //--------------------------------------------------------------
 void Output_Data::Output_Preprocessor::pxpz(const State1D& Y, const Grid_Info& grid, const size_t tout, const double time, const double dt,
-  const Parallel_Environment_1D& PE) {
+ const Parallel_Environment_1D& PE)
+{
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
 
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
-    size_t ind(0);
-    vector<double> xaxis(valtovec(grid.axis.x(0)));
-
-    for(int s(0); s < Y.Species(); ++s) {
-
-        int msg_sz(outNxLocal*grid.axis.Npx(s)*grid.axis.Npz(s));
-        Array3D<double> pxpzGlobal(grid.axis.Npx(s),grid.axis.Npz(s),outNxGlobal); 
-        double pbuf[grid.axis.Npx(s)*grid.axis.Npz(s)*outNxLocal];
-        vector<double> p1axis(valtovec(grid.axis.px(s)));
-        vector<double> p3axis(valtovec(grid.axis.pz(s)));
 
-        for (size_t i(0); i < outNxLocal; ++i) {
+    outwindow w("pxpz", grid.axis.xg(0));
+    size_t offset(PE.Slab_Offset(PE.RANK()));
+    size_t nsel(w.count(offset, outNxLocal)), i_first(w.first(offset) - offset);
 
-            Array2D<double> data2D = p_x.p1p2( Y.DF(s), i, s);
-            ind = 0;
+    for(int s(0); s < Y.Species(); ++s) 
+    {
+        size_t Npx(w.Np(grid.axis.Npx(s))), Npz(w.Np(grid.axis.Npz(s)));
+        valarray<double> pbuf(PE.Max_Slab_Cells()*Npx*Npz);
 
-            for (size_t j(0); j < grid.axis.Npx(s); ++j) {
-                for (size_t k(0); k < grid.axis.Npz(s); ++k) {
-                    pbuf[ind]=data2D(j,k);
-                    ++ind;
-                }
-            }
-           
-        }
+        vector< vector<double> > axes;
+        axes.push_back(w.p(grid.axis.px(s)));
+        axes.push_back(w.p(grid.axis.pz(s)));
+        axes.push_back(w.x(grid.axis.xg(0)));
 
-       if (PE.MPI_Processes() > 1) {
-           if (PE.RANK()!=0) {
-               MPI_Send(pbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-           }
-           else 
-           {
-               ind = 0;
-               // Fill data for rank = 0
-               for(size_t i(0); i < outNxLocal; i++) 
-               {
-                    for (size_t j(0); j < grid.axis.Npx(s); ++j) 
-                    {
-                        for (size_t k(0); k < grid.axis.Npz(s); ++k) 
-                        {
-                            pxpzGlobal(j,k,i) = pbuf[ind];
-                            ++ind;
-                        }
-                    }
-                }
-               // Fill data for rank > 0
-                for (int rr(1); rr < PE.MPI_Processes(); ++rr){
-                    ind = 0;
-                    MPI_Recv(pbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                    for(size_t i(0); i < outNxLocal; i++) 
-                    {
-                        for (size_t j(0); j < grid.axis.Npx(s); ++j) 
-                        {
-                            for (size_t k(0); k < grid.axis.Npz(s); ++k) 
-                            {
-                                pxpzGlobal(j,k,i + outNxLocal*rr) = pbuf[ind];
-                                ++ind;
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        else 
+        #pragma omp parallel for num_threads(Input::List().ompthreads)
+        for (size_t i = 0; i < nsel; ++i) 
         {
-            ind = 0;
-            for(size_t i(0); i < outNxLocal; i++) 
+            Array2D<double> data2D = p_x.p1p3( Y.DF(s), i_first + i*w.sx, s);
+
+            for (size_t j(0); j < Npx; ++j) 
             {
-                for (size_t j(0); j < grid.axis.Npx(s); ++j) 
+                for (size_t k(0); k < Npz; ++k) 
                 {
-                    for (size_t k(0); k < grid.axis.Npz(s); ++k) 
-                    {
-                        pxpzGlobal(j,k,i) = pbuf[ind];
-                        ++ind;
-                    }
+                    pbuf[(j*Npz+k)*nsel+i]=data2D(j*w.sp,k*w.sp);
                 }
             }
         }
 
-       if (PE.RANK() == 0) expo.Export_h5("pxpz", p1axis, p3axis, xaxis, pxpzGlobal, tout, time, dt, s);
-
-   }
+        slabdump("pxpz", axes, 2, pbuf, w, tout, time, dt, s, PE);
+    }
 
 }
 //--------------------------------------------------------------
 void Output_Data::Output_Preprocessor::pxpz(const State2D& Y, const Grid_Info& grid, const size_t tout, const double time, const double dt,
-  const Parallel_Environment_2D& PE) {
+ const Parallel_Environment_2D& PE) {
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
 
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc), outNyLocal(grid.axis.Nx(1) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0)), outNyGlobal(grid.axis.Nxg(1));
-
-    int rankx,ranky;
-    vector<double> xaxis(valtovec(grid.axis.xg(0)));
-    vector<double> yaxis(valtovec(grid.axis.xg(1)));
-    size_t counter;
-
 
     for(int s(0); s < Y.Species(); ++s) 
     {
+        size_t Npx(grid.axis.Npx(s)), Npz(grid.axis.Npz(s));
+        valarray<double> pbuf(Npx*Npz*outNxLocal*outNyLocal);
 
-        int msg_sz(outNxLocal*outNyLocal*grid.axis.Npx(s)*grid.axis.Npy(s));
-        Array4D<double> dataGlobal(grid.axis.Npx(s),grid.axis.Npy(s),outNxGlobal,outNyGlobal); //, yglob_axis.dim());
-        double pbuf[grid.axis.Npx(s)*grid.axis.Npy(s)*outNxLocal*outNyLocal];
-        vector<double> p1axis(valtovec(grid.axis.px(s)));
-        vector<double> p3axis(valtovec(grid.axis.pz(s)));
+        vector< vector<double> > axes;
+        axes.push_back(valtovec(grid.axis.px(s)));
+        axes.push_back(valtovec(grid.axis.pz(s)));
+        axes.push_back(valtovec(grid.axis.xg(0)));
+        axes.push_back(valtovec(grid.axis.xg(1)));
 
-        counter = 0;
         for(size_t ix(0); ix < outNxLocal; ++ix) 
         {
             for(size_t iy(0); iy < outNyLocal; ++iy) 
             {
                 Array2D<double> data2D = p_x.p1p3( Y.DF(s), ix, iy, s);
 
-                for (size_t j(0); j < grid.axis.Npx(s); ++j) 
-                {
-                    for (size_t k(0); k < grid.axis.Npy(s); ++k) 
-                    {
-                        pbuf[counter]=data2D(j,k);
-                        ++counter;
-                    }
-                }
-            }
-        }
-
-        if (PE.MPI_Processes() > 1) 
-        {
-            if (PE.RANK()!=0) {
-                MPI_Send(pbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            }
-            else 
-            {
-                // Fill data for rank = 0
-                counter = 0;
-                for(size_t ix(0); ix < outNxLocal; ++ix) 
-                {
-                    for(size_t iy(0); iy < outNyLocal; ++iy) 
-                    {
-                        for (size_t j(0); j < grid.axis.Npx(s); ++j) 
-                        {
-                            for (size_t k(0); k < grid.axis.Npy(s); ++k) 
-                            {
-                                dataGlobal(j,k,ix,iy) = pbuf[counter];
-                                ++counter;
-                            }
-                        }
-                   }
-               }
-               // Fill data for rank > 0
-               for (int rr(1); rr < PE.MPI_Processes(); ++rr)
-               {
-                    rankx = rr % PE.MPI_X();
-                    ranky = rr / PE.MPI_X();
-
-                    counter = 0;
-
-                    MPI_Recv(pbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                    
-                    for(size_t ix(0); ix < outNxLocal; ++ix) 
-                    {
-                        for(size_t iy(0); iy < outNyLocal; ++iy)
-                        {
-                            for (size_t j(0); j < grid.axis.Npx(s); ++j) 
-                            {
-                                for (size_t k(0); k < grid.axis.Npy(s); ++k) 
-                                {
-                                    dataGlobal(j,k,ix + outNxLocal*rankx,iy + outNyLocal*ranky) = pbuf[counter];
-                                    ++counter;
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        else 
-        {
-            counter = 0;
-
-            for(size_t ix(0); ix < outNxLocal; ++ix) 
-            {
-                for(size_t iy(0); iy < outNyLocal; ++iy) 
+                for (size_t j(0); j < Npx; ++j) 
                 {
-                    for (size_t j(0); j < grid.axis.Npx(s); ++j) 
+                    for (size_t k(0); k < Npz; ++k) 
                     {
-                        for (size_t k(0); k < grid.axis.Npy(s); ++k) 
-                        {
-                            dataGlobal(j,k,ix,iy) = pbuf[counter];
-                            ++counter;
-                        }
+                        pbuf[((j*Npz+k)*outNxLocal+ix)*outNyLocal+iy]=data2D(j,k);
                     }
                 }
             }
         }
-       
 
-       if (PE.RANK() == 0) expo.Export_h5("pxpz", p1axis, p3axis, xaxis, yaxis, dataGlobal, tout, time, dt, s);
-
-   }
+        slabdump("pxpz", axes, 2, pbuf, tout, time, dt, s, PE);
+    }
 
 }
 //--------------------------------------------------------------
@@ -3820,111 +3859,45 @@ void Output_Data::Output_Preprocessor::pxpz(const State2D& Y, const Grid_Info& g
  */
 //--------------------------------------------------------------
 void Output_Data::Output_Preprocessor::pxpypz(const State1D& Y, const Grid_Info& grid, const size_t tout, const double time, const double dt,
-  const Parallel_Environment_1D& PE) {
+ const Parallel_Environment_1D& PE) {
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
 
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
-    size_t ind(0);
-    vector<double> xaxis(valtovec(grid.axis.xg(0)));
 
-    for(int s(0); s < Y.Species(); ++s) {
+    outwindow w("pxpypz", grid.axis.xg(0));
+    size_t offset(PE.Slab_Offset(PE.RANK()));
+    size_t nsel(w.count(offset, outNxLocal)), i_first(w.first(offset) - offset);
 
-        int msg_sz(outNxLocal*grid.axis.Npx(s)*grid.axis.Npy(s)*grid.axis.Npz(s));
-        Array4D<double> pxpypzGlobal(grid.axis.Npx(s),grid.axis.Npy(s),grid.axis.Npz(s),outNxGlobal); 
-        double pbuf[msg_sz];
-        vector<double> p1axis(valtovec(grid.axis.px(s)));
-        vector<double> p2axis(valtovec(grid.axis.py(s)));
-        vector<double> p3axis(valtovec(grid.axis.pz(s)));
+    for(int s(0); s < Y.Species(); ++s) {
 
-        ind = 0;
+        size_t Npx(w.Np(grid.axis.Npx(s))), Npy(w.Np(grid.axis.Npy(s))), Npz(w.Np(grid.axis.Npz(s)));
+        valarray<double> pbuf(PE.Max_Slab_Cells()*Npx*Npy*Npz);
 
-        for (size_t i(0); i < outNxLocal; ++i) {
+        vector< vector<double> > axes;
+        axes.push_back(w.p(grid.axis.px(s)));
+        axes.push_back(w.p(grid.axis.py(s)));
+        axes.push_back(w.p(grid.axis.pz(s)));
+        axes.push_back(w.x(grid.axis.xg(0)));
 
-            // Array3D<double> data3D = p_x.p1p2p3( Y.DF(s), i+Nbc, s);
+        #pragma omp parallel for num_threads(Input::List().ompthreads)
+        for (size_t i = 0; i < nsel; ++i) {
 
-            for (size_t ipx(0); ipx < grid.axis.Npx(s); ++ipx) 
-            {
-                for (size_t ipy(0); ipy < grid.axis.Npy(s); ++ipy) 
-                {
-                    for (size_t ipz(0); ipz < grid.axis.Npz(s); ++ipz) 
-                    {
-                        // pbuf[ind]=p_x.dist(s,i+Nbc)(ipx,ipy,ipz);
-                        ++ind;
-                    }
-                }
-            }
-        }
+            Array3D<double> data3D = p_x.p1p2p3( Y.DF(s), i_first + i*w.sx, s);
 
-        if (PE.MPI_Processes() > 1) 
-        {
-            if (PE.RANK()!=0) 
+            for (size_t ipx(0); ipx < Npx; ++ipx) 
             {
-                MPI_Send(pbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            }
-            else 
-            {
-                // Fill data for rank = 0
-                ind = 0;
-                for(size_t i(0); i < outNxLocal; i++) 
-                {
-                    
-                    for (size_t ipx(0); ipx < grid.axis.Npx(s); ++ipx) 
-                    {
-                        for (size_t ipy(0); ipy < grid.axis.Npy(s); ++ipy) 
-                        {
-                            for (size_t ipz(0); ipz < grid.axis.Npz(s); ++ipz) 
-                            {
-                                pxpypzGlobal(ipx,ipy,ipz,i) = pbuf[ind];
-                                ++ind;
-                            }
-                        }
-                    }
-                }
-               // Fill data for rank > 0
-                for (int rr(1); rr < PE.MPI_Processes(); ++rr)
-                {
-                    MPI_Recv(pbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                    ind = 0;
-                    for(size_t i(0); i < outNxLocal; i++) 
-                    {
-                        for (size_t ipx(0); ipx < grid.axis.Npx(s); ++ipx) 
-                        {
-                            for (size_t ipy(0); ipy < grid.axis.Npy(s); ++ipy) 
-                            {
-                                for (size_t ipz(0); ipz < grid.axis.Npz(s); ++ipz) 
-                                {
-                                    pxpypzGlobal(ipx,ipy,ipz,i + outNxLocal*rr) = pbuf[ind];
-                                    ++ind;
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        else 
-        {
-            ind = 0;
-            for(size_t i(0); i < outNxLocal; i++) 
-            {                
-                for (size_t ipx(0); ipx < grid.axis.Npx(s); ++ipx) 
+                for (size_t ipy(0); ipy < Npy; ++ipy) 
                 {
-                    for (size_t ipy(0); ipy < grid.axis.Npy(s); ++ipy) 
+                    for (size_t ipz(0); ipz < Npz; ++ipz) 
                     {
-                        for (size_t ipz(0); ipz < grid.axis.Npz(s); ++ipz) 
-                        {
-                            pxpypzGlobal(ipx,ipy,ipz,i) = pbuf[ind];
-                            ++ind;
-                        }
+                        pbuf[((ipx*Npy+ipy)*Npz+ipz)*nsel+i]=data3D(ipx*w.sp,ipy*w.sp,ipz*w.sp);
                     }
                 }
             }
         }
 
-        if (PE.RANK() == 0) expo.Export_h5("pxpypz", p1axis, p2axis, p3axis, xaxis, pxpypzGlobal, tout, time, dt, s);
+        slabdump("pxpypz", axes, 3, pbuf, w, tout, time, dt, s, PE);
     }
 
 }
@@ -3933,45 +3906,43 @@ void Output_Data::Output_Preprocessor::allfs(const State1D& Y, const Grid_Info&
  const Parallel_Environment_1D& PE) 
 {
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
     
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
+
+    outwindow w("allfs", grid.axis.xg(0));
+    size_t offset(PE.Slab_Offset(PE.RANK()));
+    size_t nsel(w.count(offset, outNxLocal)), i_first(w.first(offset) - offset);
 
     for(int s(0); s < Y.Species(); ++s) 
     {
         size_t Nl(grid.l0[s]);
-        size_t Np(grid.axis.Np(s));
+        if (Input::List().allfs_l_max >= 0) Nl = min(Nl, size_t(Input::List().allfs_l_max));
+        size_t Np(w.Np(grid.axis.Np(s)));
 
         vector<double> ell_axis;
-        vector<double> xaxis(valtovec(grid.axis.xg(0)));
-        vector<double> paxis(valtovec(grid.axis.p(s)));
-        
         for( int i = 0; i < Nl+1; i++ )  ell_axis.push_back( i );
 
-        vector<double> allfs_localarray(outNxLocal*(Nl+1)*Np,0.);
+        vector< vector<double> > axes;
+        axes.push_back(w.x(grid.axis.xg(0)));
+        axes.push_back(ell_axis);
+        axes.push_back(w.p(grid.axis.p(s)));
 
-        vector<vector< vector<double> > > allfs_xvec(outNxLocal);
+        valarray<double> allfsbuf(PE.Max_Slab_Cells()*(Nl+1)*Np);
 
         #pragma omp parallel for num_threads(Input::List().ompthreads)
-        for(size_t ix = 0; ix < outNxLocal; ++ix) 
+        for(size_t k = 0; k < nsel; ++k) 
         {
-            vector< vector<double> > allfs_lvec(Nl+1);
+            size_t ix(i_first + k*w.sx);
             for(size_t il = 0; il < Nl+1; ++il)    
             {   
-                vector<double> allfs_pvec(Np);
                 for(size_t ip(0); ip < Np; ++ip)
                 {
-                    // allfs_localarray[ix*(Nl+1)+il*Np+ip] = Y.DF(s)(il)(ip,ix).real();
-
-                    allfs_pvec[ip] = Y.DF(s)(il)(ip,ix).real();
+                    allfsbuf[(k*(Nl+1)+il)*Np+ip] = Y.DF(s)(il)(ip*w.sp,ix).real();
                 }
-                allfs_lvec[il] = allfs_pvec;   
             }
-            allfs_xvec[ix] = allfs_lvec;
         }
 
-        expo.Export_h5("allfs", xaxis, ell_axis, paxis, allfs_xvec, tout, time, dt, PE.RANK(), outNxLocal, s);
+        slabdump("allfs", axes, 0, allfsbuf, w, tout, time, dt, s, PE);
     }
 }
 //--------------------------------------------------------------     
@@ -4012,7 +3983,9 @@ void Output_Data::Output_Preprocessor::allfs_f2(const State1D& Y, const Grid_Inf
         }
     }
 
-    MPI_Gather( allfsbuf, msg_sz, MPI_DOUBLE, &allfs_Globalbuf[0], msg_sz, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    vector<int> counts, displs;
+    PE.Gather_Counts(Nl+1, counts, displs);
+    MPI_Gatherv( allfsbuf, msg_sz, MPI_DOUBLE, &allfs_Globalbuf[0], &counts[0], &displs[0], MPI_DOUBLE, 0, Time_Decomposition::Slice_Comm());
 
     #pragma omp parallel for collapse(2) num_threads(Input::List().ompthreads)
     for(size_t ix = 0; ix < outNxGlobal; ++ix) 
@@ -4064,7 +4037,9 @@ void Output_Data::Output_Preprocessor::allfs_flogf(const State1D& Y, const Grid_
         }
     }
 
-    MPI_Gather( allfsbuf, msg_sz, MPI_DOUBLE, &allfs_Globalbuf[0], msg_sz, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    vector<int> counts, displs;
+    PE.Gather_Counts(Nl+1, counts, displs);
+    MPI_Gatherv( allfsbuf, msg_sz, MPI_DOUBLE, &allfs_Globalbuf[0], &counts[0], &displs[0], MPI_DOUBLE, 0, Time_Decomposition::Slice_Comm());
 
     #pragma omp parallel for collapse(2) num_threads(Input::List().ompthreads)
     for(size_t ix = 0; ix < outNxGlobal; ++ix) 
@@ -4083,77 +4058,43 @@ void Output_Data::Output_Preprocessor::f0(const State1D& Y, const Grid_Info& gri
  const Parallel_Environment_1D& PE) {
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
 
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
 
     vector<double> re_im_axis;
     re_im_axis.push_back(0.);
     re_im_axis.push_back(1.);
 
-    vector<double> xaxis(valtovec(grid.axis.xg(0)));
+    outwindow w("f0", grid.axis.xg(0));
+    size_t offset(PE.Slab_Offset(PE.RANK()));
+    size_t nsel(w.count(offset, outNxLocal)), i_first(w.first(offset) - offset);
 
     for(int s(0); s < Y.Species(); ++s) 
     {
-        int msg_sz(2*outNxLocal*f_x.Np(s));
-        Array3D<double> f0x1Global(outNxGlobal,f_x.Np(s),2); 
-
-        vector<double> paxis(valtovec(grid.axis.p(s)));
-
-        double f0xbuf[msg_sz];
-
-        for (size_t i(0); i < outNxLocal; ++i) {
-
-            Array2D<double> data2D = f_x( Y.DF(s),0,0, i+Nbc, s);
-
-            for (size_t j(0); j < f_x.Np(s); ++j) {
-                // std::cout << "\n f0(" << i << "," << j << ") = (" << data2D(j,1) << "," << data2D(j,2) <<")";
-                f0xbuf[2*j+   2*i*f_x.Np(s)]=data2D(j,0);
-
-                f0xbuf[2*j+1+ 2*i*f_x.Np(s)]=data2D(j,1);
-            }
-        }
-
-        if (PE.MPI_Processes() > 1) {
-            if (PE.RANK()!=0) {
-                MPI_Send(f0xbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            }
-            else {
-                // Fill data for rank = 0
-                for(size_t i(0); i < outNxLocal; i++) {
+        size_t Np(w.Np(f_x.Np(s)));
+        valarray<double> f0xbuf(2*PE.Max_Slab_Cells()*Np);
 
-                    for (size_t j(0); j < f_x.Np(s); ++j) {
-                        f0x1Global(i,j,0) = f0xbuf[2*j+   2*i*f_x.Np(s)];
-                        f0x1Global(i,j,1) = f0xbuf[2*j+1+ 2*i*f_x.Np(s)];
-                    }
-                }
-                // Fill data for rank > 0
-                for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                    MPI_Recv(f0xbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
+        vector<double> paxis(w.p(grid.axis.p(s)));
 
-                    for(size_t i(0); i < outNxLocal; i++) {
-                        for (size_t j(0); j < f_x.Np(s); ++j) {
-                            f0x1Global(i + outNxLocal*rr,j,0) = f0xbuf[2*j+   2*i*f_x.Np(s)];
-                            f0x1Global(i + outNxLocal*rr,j,1) = f0xbuf[2*j+1+ 2*i*f_x.Np(s)];
-                        }
-                    }
-                }
-            }
-        }
-        else 
-        {
-            for(size_t i(0); i < outNxGlobal; i++) 
-            {
-                for (size_t j(0); j < f_x.Np(s); ++j) 
-                {
-                    f0x1Global(i,j,0) = f0xbuf[2*j+   2*i*f_x.Np(s)];
-                    f0x1Global(i,j,1) = f0xbuf[2*j+1+ 2*i*f_x.Np(s)];
-                }
+
+        for (size_t k(0); k < nsel; ++k) {
+
+            Array2D<double> data2D = f_x( Y.DF(s),0,0, i_first + k*w.sx + Nbc, s);
+
+            for (size_t j(0); j < Np; ++j) {
+                // std::cout << "\n f0(" << i << "," << j << ") = (" << data2D(j,1) << "," << data2D(j,2) <<")";
+                f0xbuf[2*j+   2*k*Np]=data2D(j*w.sp,0);
+
+                f0xbuf[2*j+1+ 2*k*Np]=data2D(j*w.sp,1);
             }
         }
 
-        if (PE.RANK() == 0) expo.Export_h5("f0", xaxis, paxis, re_im_axis, f0x1Global, tout, time, dt, s);
+        vector< vector<double> > axes;
+        axes.push_back(w.x(grid.axis.xg(0)));
+        axes.push_back(paxis);
+        axes.push_back(re_im_axis);
+
+        slabdump("f0", axes, 0, f0xbuf, w, tout, time, dt, s, PE);
 
     }
 
@@ -4164,74 +4105,42 @@ void Output_Data::Output_Preprocessor::f10(const State1D& Y, const Grid_Info& gr
   const Parallel_Environment_1D& PE) {
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
 
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
     
     vector<double> re_im_axis;
     re_im_axis.push_back(0.);
     re_im_axis.push_back(1.);
     
-    vector<double> xaxis(valtovec(grid.axis.xg(0)));
+    outwindow w("f10", grid.axis.xg(0));
+    size_t offset(PE.Slab_Offset(PE.RANK()));
+    size_t nsel(w.count(offset, outNxLocal)), i_first(w.first(offset) - offset);
 
     for(int s(0); s < Y.Species(); ++s) {
 
-        int msg_sz(2*outNxLocal*f_x.Np(s));
-        Array3D<double> f0x1Global(outNxGlobal,f_x.Np(s),2); //, yglob_axis.dim());
-        vector<double> paxis(valtovec(grid.axis.p(s)));
+        size_t Np(w.Np(f_x.Np(s)));
+        valarray<double> f0xbuf(2*PE.Max_Slab_Cells()*Np);
+        vector<double> paxis(w.p(grid.axis.p(s)));
 
-        double f0xbuf[msg_sz];
 
-        for (size_t i(0); i < outNxLocal; ++i) {
+        for (size_t k(0); k < nsel; ++k) {
 
-            Array2D<double> data2D = f_x( Y.DF(s), 1, 0, i+Nbc, s);
+            Array2D<double> data2D = f_x( Y.DF(s), 1, 0, i_first + k*w.sx + Nbc, s);
 
-            for (size_t j(0); j < f_x.Np(s); ++j) 
+            for (size_t j(0); j < Np; ++j) 
             {
-                f0xbuf[2*j+   2*i*f_x.Np(s)]=data2D(j,0);
+                f0xbuf[2*j+   2*k*Np]=data2D(j*w.sp,0);
 
-                f0xbuf[2*j+1+ 2*i*f_x.Np(s)]=data2D(j,1);
+                f0xbuf[2*j+1+ 2*k*Np]=data2D(j*w.sp,1);
             }
         }
 
-        if (PE.MPI_Processes() > 1) {
-            if (PE.RANK()!=0) {
-                MPI_Send(f0xbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            }
-            else {
-                // Fill data for rank = 0
-                for(size_t i(0); i < outNxLocal; i++) {
-
-                    for (size_t j(0); j < f_x.Np(s); ++j) {
-                        f0x1Global(i,j,0) = f0xbuf[2*j+   2*i*f_x.Np(s)];
-                        f0x1Global(i,j,1) = f0xbuf[2*j+1+ 2*i*f_x.Np(s)];
-                    }
-                }
-                // Fill data for rank > 0
-                for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                    MPI_Recv(f0xbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-
-                    for(size_t i(0); i < outNxLocal; i++) {
-                        for (size_t j(0); j < f_x.Np(s); ++j) {
-                            f0x1Global(i + outNxLocal*rr,j,0) = f0xbuf[2*j+   2*i*f_x.Np(s)];
-                            f0x1Global(i + outNxLocal*rr,j,1) = f0xbuf[2*j+1+ 2*i*f_x.Np(s)];
-                        }
-                    }
-                }
-            }
-        }
-        else {
-            for(size_t i(0); i < outNxGlobal; i++) 
-            {
-                for (size_t j(0); j < f_x.Np(s); ++j) {
-                    f0x1Global(i,j,0) = f0xbuf[2*j+   2*i*f_x.Np(s)];
-                    f0x1Global(i,j,1) = f0xbuf[2*j+1+ 2*i*f_x.Np(s)];
-                }
-            }
-        }
+        vector< vector<double> > axes;
+        axes.push_back(w.x(grid.axis.xg(0)));
+        axes.push_back(paxis);
+        axes.push_back(re_im_axis);
 
-        if (PE.RANK() == 0) expo.Export_h5("f10", xaxis, paxis, re_im_axis, f0x1Global, tout, time, dt, s);
+        slabdump("f10", axes, 0, f0xbuf, w, tout, time, dt, s, PE);
 
     }
 
@@ -4242,74 +4151,42 @@ void Output_Data::Output_Preprocessor::f11(const State1D& Y, const Grid_Info& gr
   const Parallel_Environment_1D& PE) {
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
 
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
 
     vector<double> re_im_axis;
     re_im_axis.push_back(0.);
     re_im_axis.push_back(1.);
 
-    vector<double> xaxis(valtovec(grid.axis.xg(0)));
+    outwindow w("f11", grid.axis.xg(0));
+    size_t offset(PE.Slab_Offset(PE.RANK()));
+    size_t nsel(w.count(offset, outNxLocal)), i_first(w.first(offset) - offset);
 
     for(int s(0); s < Y.Species(); ++s) {
 
-        int msg_sz(2*outNxLocal*f_x.Np(s));
-        Array3D<double> f0x1Global(outNxGlobal,f_x.Np(s),2); 
-        vector<double> paxis(valtovec(grid.axis.p(s)));
+        size_t Np(w.Np(f_x.Np(s)));
+        valarray<double> f0xbuf(2*PE.Max_Slab_Cells()*Np);
+        vector<double> paxis(w.p(grid.axis.p(s)));
 
-        double f0xbuf[msg_sz];
 
-        for (size_t i(0); i < outNxLocal; ++i) {
+        for (size_t k(0); k < nsel; ++k) {
 
-            Array2D<double> data2D = f_x( Y.DF(s),1,1, i+Nbc, s);
+            Array2D<double> data2D = f_x( Y.DF(s),1,1, i_first + k*w.sx + Nbc, s);
 
-            for (size_t j(0); j < f_x.Np(s); ++j) {
+            for (size_t j(0); j < Np; ++j) {
                 // std::cout << "\n f0(" << i << "," << j << ") = (" << data2D(j,1) << "," << data2D(j,2) <<")";
-                f0xbuf[2*j+   2*i*f_x.Np(s)]=data2D(j,0);
+                f0xbuf[2*j+   2*k*Np]=data2D(j*w.sp,0);
 
-                f0xbuf[2*j+1+ 2*i*f_x.Np(s)]=data2D(j,1);
+                f0xbuf[2*j+1+ 2*k*Np]=data2D(j*w.sp,1);
             }
         }
 
-        if (PE.MPI_Processes() > 1) {
-            if (PE.RANK()!=0) {
-                MPI_Send(f0xbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            }
-            else {
-                // Fill data for rank = 0
-                for(size_t i(0); i < outNxLocal; i++) {
-
-                    for (size_t j(0); j < f_x.Np(s); ++j) {
-                        f0x1Global(i,j,0) = f0xbuf[2*j+   2*i*f_x.Np(s)];
-                        f0x1Global(i,j,1) = f0xbuf[2*j+1+ 2*i*f_x.Np(s)];
-                    }
-                }
-                // Fill data for rank > 0
-                for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                    MPI_Recv(f0xbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-
-                    for(size_t i(0); i < outNxLocal; i++) {
-                        for (size_t j(0); j < f_x.Np(s); ++j) {
-                            f0x1Global(i + outNxLocal*rr,j,0) = f0xbuf[2*j+   2*i*f_x.Np(s)];
-                            f0x1Global(i + outNxLocal*rr,j,1) = f0xbuf[2*j+1+ 2*i*f_x.Np(s)];
-                        }
-                    }
-                }
-            }
-        }
-        else {
-            for(size_t i(0); i < outNxGlobal; i++) {
-                
-                for (size_t j(0); j < f_x.Np(s); ++j) {
-                    f0x1Global(i,j,0) = f0xbuf[2*j+   2*i*f_x.Np(s)];
-                    f0x1Global(i,j,1) = f0xbuf[2*j+1+ 2*i*f_x.Np(s)];
-                }
-            }
-        }
+        vector< vector<double> > axes;
+        axes.push_back(w.x(grid.axis.xg(0)));
+        axes.push_back(paxis);
+        axes.push_back(re_im_axis);
 
-        if (PE.RANK() == 0) expo.Export_h5("f11", xaxis, paxis, re_im_axis, f0x1Global, tout, time, dt, s);
+        slabdump("f11", axes, 0, f0xbuf, w, tout, time, dt, s, PE);
     }
 
 
@@ -4320,73 +4197,42 @@ void Output_Data::Output_Preprocessor::f20(const State1D& Y, const Grid_Info& gr
   const Parallel_Environment_1D& PE) {
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
 
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
 
     vector<double> re_im_axis;
     re_im_axis.push_back(0.);
     re_im_axis.push_back(1.);
 
-    vector<double> xaxis(valtovec(grid.axis.xg(0)));
+    outwindow w("f20", grid.axis.xg(0));
+    size_t offset(PE.Slab_Offset(PE.RANK()));
+    size_t nsel(w.count(offset, outNxLocal)), i_first(w.first(offset) - offset);
 
     for(int s(0); s < Y.Species(); ++s) 
     {
         if (Y.DF(s).l0() > 1)
         {
-            int msg_sz(2*outNxLocal*f_x.Np(s));
-            Array3D<double> f0x1Global(outNxGlobal,f_x.Np(s),2); //, yglob_axis.dim());
-            vector<double> paxis(valtovec(grid.axis.p(s)));
-            double f0xbuf[msg_sz];
+            size_t Np(w.Np(f_x.Np(s)));
+            valarray<double> f0xbuf(2*PE.Max_Slab_Cells()*Np);
+            vector<double> paxis(w.p(grid.axis.p(s)));
 
-            for (size_t i(0); i < outNxLocal; ++i) {
+            for (size_t k(0); k < nsel; ++k) {
 
-                Array2D<double> data2D = f_x( Y.DF(s), 2, 0, i+Nbc, s);
+                Array2D<double> data2D = f_x( Y.DF(s), 2, 0, i_first + k*w.sx + Nbc, s);
 
-                for (size_t j(0); j < f_x.Np(s); ++j) {
-                    f0xbuf[2*j+   2*i*f_x.Np(s)]=data2D(j,0);
-                    f0xbuf[2*j+1+ 2*i*f_x.Np(s)]=data2D(j,1);
+                for (size_t j(0); j < Np; ++j) {
+                    f0xbuf[2*j+   2*k*Np]=data2D(j*w.sp,0);
+                    f0xbuf[2*j+1+ 2*k*Np]=data2D(j*w.sp,1);
                 }
 
             }
 
-            if (PE.MPI_Processes() > 1) {
-                if (PE.RANK()!=0) {
-                    MPI_Send(f0xbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-                }
-                else {
-                    // Fill data for rank = 0
-                    for(size_t i(0); i < outNxLocal; i++) {
-
-                        for (size_t j(0); j < f_x.Np(s); ++j) {
-                            f0x1Global(i,j,0) = f0xbuf[2*j+   2*i*f_x.Np(s)];
-                            f0x1Global(i,j,1) = f0xbuf[2*j+1+ 2*i*f_x.Np(s)];
-                        }
-                    }
-                    // Fill data for rank > 0
-                    for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                        MPI_Recv(f0xbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-
-                        for(size_t i(0); i < outNxLocal; i++) {
-                            for (size_t j(0); j < f_x.Np(s); ++j) {
-                                f0x1Global(i + outNxLocal*rr,j,0) = f0xbuf[2*j+   2*i*f_x.Np(s)];
-                                f0x1Global(i + outNxLocal*rr,j,1) = f0xbuf[2*j+1+ 2*i*f_x.Np(s)];
-                            }
-                        }
-                    }
-                }
-            }
-            else {
-                for(size_t i(0); i < outNxGlobal; i++) {
-                    for (size_t j(0); j < f_x.Np(s); ++j) {
-                        f0x1Global(i,j,0) = f0xbuf[2*j+   2*i*f_x.Np(s)];
-                        f0x1Global(i,j,1) = f0xbuf[2*j+1+ 2*i*f_x.Np(s)];
-                    }
-                }
-            }
+            vector< vector<double> > axes;
+            axes.push_back(w.x(grid.axis.xg(0)));
+            axes.push_back(paxis);
+            axes.push_back(re_im_axis);
 
-            if (PE.RANK() == 0) expo.Export_h5("f20", xaxis, paxis, re_im_axis, f0x1Global, tout, time, dt, s);
+            slabdump("f20", axes, 0, f0xbuf, w, tout, time, dt, s, PE);
 
         }
     }
@@ -4399,72 +4245,41 @@ void Output_Data::Output_Preprocessor::fl0(const State1D& Y, const Grid_Info& gr
   const Parallel_Environment_1D& PE) {
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
 
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
 
     vector<double> re_im_axis;
     re_im_axis.push_back(0.);
     re_im_axis.push_back(1.);
 
-    vector<double> xaxis(valtovec(grid.axis.xg(0)));
+    outwindow w("fl0", grid.axis.xg(0));
+    size_t offset(PE.Slab_Offset(PE.RANK()));
+    size_t nsel(w.count(offset, outNxLocal)), i_first(w.first(offset) - offset);
 
     for(int s(0); s < Y.Species(); ++s) {
 
-        int msg_sz(2*outNxLocal*f_x.Np(s));
-        Array3D<double> f0x1Global(outNxGlobal,f_x.Np(s),2);
-        vector<double> paxis(valtovec(grid.axis.p(s)));
+        size_t Np(w.Np(f_x.Np(s)));
+        valarray<double> f0xbuf(2*PE.Max_Slab_Cells()*Np);
+        vector<double> paxis(w.p(grid.axis.p(s)));
 
-        double f0xbuf[msg_sz];
 
-        for (size_t i(0); i < outNxLocal; ++i) {
+        for (size_t k(0); k < nsel; ++k) {
 
-            Array2D<double> data2D = f_x( Y.DF(s), Y.DF(s).l0(),0, i+Nbc, s);
+            Array2D<double> data2D = f_x( Y.DF(s), Y.DF(s).l0(),0, i_first + k*w.sx + Nbc, s);
 
-            for (size_t j(0); j < f_x.Np(s); ++j) 
+            for (size_t j(0); j < Np; ++j) 
             {
-                f0xbuf[2*j+   2*i*f_x.Np(s)]=data2D(j,0);
-                f0xbuf[2*j+1+ 2*i*f_x.Np(s)]=data2D(j,1);
+                f0xbuf[2*j+   2*k*Np]=data2D(j*w.sp,0);
+                f0xbuf[2*j+1+ 2*k*Np]=data2D(j*w.sp,1);
             }
         }
 
-        if (PE.MPI_Processes() > 1) {
-            if (PE.RANK()!=0) {
-                MPI_Send(f0xbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            }
-            else {
-                // Fill data for rank = 0
-                for(size_t i(0); i < outNxLocal; i++) {
-
-                    for (size_t j(0); j < f_x.Np(s); ++j) {
-                        f0x1Global(i,j,0) = f0xbuf[2*j+   2*i*f_x.Np(s)];
-                        f0x1Global(i,j,1) = f0xbuf[2*j+1+ 2*i*f_x.Np(s)];
-                    }
-                }
-                // Fill data for rank > 0
-                for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                    MPI_Recv(f0xbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-
-                    for(size_t i(0); i < outNxLocal; i++) {
-                        for (size_t j(0); j < f_x.Np(s); ++j) {
-                            f0x1Global(i + outNxLocal*rr,j,0) = f0xbuf[2*j+   2*i*f_x.Np(s)];
-                            f0x1Global(i + outNxLocal*rr,j,1) = f0xbuf[2*j+1+ 2*i*f_x.Np(s)];
-                        }
-                    }
-                }
-            }
-        }
-        else {
-            for(size_t i(0); i < outNxGlobal; i++) {
-                for (size_t j(0); j < f_x.Np(s); ++j) {
-                    f0x1Global(i,j,0) = f0xbuf[2*j+   2*i*f_x.Np(s)];
-                    f0x1Global(i,j,1) = f0xbuf[2*j+1+ 2*i*f_x.Np(s)];
-                }
-            }
-        }
+        vector< vector<double> > axes;
+        axes.push_back(w.x(grid.axis.xg(0)));
+        axes.push_back(paxis);
+        axes.push_back(re_im_axis);
 
-        if (PE.RANK() == 0) expo.Export_h5("fl0", xaxis, paxis, re_im_axis, f0x1Global, tout, time, dt, s);
+        slabdump("fl0", axes, 0, f0xbuf, w, tout, time, dt, s, PE);
 
     }
 
@@ -4514,7 +4329,7 @@ void Output_Data::Output_Preprocessor::f0(const State2D& Y, const Grid_Info& gri
 
             if (PE.MPI_Processes() > 1) {
                 if (PE.RANK()!=0) {
-                    MPI_Send(buf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
+                    MPI_Send(buf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), Time_Decomposition::Slice_Comm());
                 }
                 else {
                     // Fill data for rank = 0
@@ -4530,7 +4345,7 @@ void Output_Data::Output_Preprocessor::f0(const State2D& Y, const Grid_Info& gri
                     }
                     // Fill data for rank > 0
                     for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                        MPI_Recv(buf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
+                        MPI_Recv(buf, msg_sz, MPI_DOUBLE, rr, rr, Time_Decomposition::Slice_Comm(), &status);
                         rankx = rr % PE.MPI_X();
                         ranky = rr / PE.MPI_X();
                         i=0;
@@ -4605,7 +4420,7 @@ void Output_Data::Output_Preprocessor::f0(const State2D& Y, const Grid_Info& gri
 
                 if (PE.MPI_Processes() > 1) {
                     if (PE.RANK()!=0) {
-                        MPI_Send(buf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
+                        MPI_Send(buf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), Time_Decomposition::Slice_Comm());
                     }
                     else {
                         // Fill data for rank = 0
@@ -4621,7 +4436,7 @@ void Output_Data::Output_Preprocessor::f0(const State2D& Y, const Grid_Info& gri
                         }
                         // Fill data for rank > 0
                         for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                            MPI_Recv(buf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
+                            MPI_Recv(buf, msg_sz, MPI_DOUBLE, rr, rr, Time_Decomposition::Slice_Comm(), &status);
                             rankx = rr % PE.MPI_X();
                             ranky = rr / PE.MPI_X();
                             i=0;
@@ -4698,7 +4513,7 @@ void Output_Data::Output_Preprocessor::f11(const State2D& Y, const Grid_Info& gr
 
             if (PE.MPI_Processes() > 1) {
                 if (PE.RANK()!=0) {
-                    MPI_Send(buf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
+                    MPI_Send(buf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), Time_Decomposition::Slice_Comm());
                 }
                 else {
                     // Fill data for rank = 0
@@ -4714,7 +4529,7 @@ void Output_Data::Output_Preprocessor::f11(const State2D& Y, const Grid_Info& gr
                     }
                     // Fill data for rank > 0
                     for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                        MPI_Recv(buf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
+                        MPI_Recv(buf, msg_sz, MPI_DOUBLE, rr, rr, Time_Decomposition::Slice_Comm(), &status);
                         rankx = rr % PE.MPI_X();
                         ranky = rr / PE.MPI_X();
                         i=0;
@@ -4795,7 +4610,7 @@ void Output_Data::Output_Preprocessor::f20(const State2D& Y, const Grid_Info& gr
 
             if (PE.MPI_Processes() > 1) {
                 if (PE.RANK()!=0) {
-                    MPI_Send(buf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
+                    MPI_Send(buf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), Time_Decomposition::Slice_Comm());
                 }
                 else {
                     // Fill data for rank = 0
@@ -4811,7 +4626,7 @@ void Output_Data::Output_Preprocessor::f20(const State2D& Y, const Grid_Info& gr
                     }
                     // Fill data for rank > 0
                     for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                        MPI_Recv(buf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
+                        MPI_Recv(buf, msg_sz, MPI_DOUBLE, rr, rr, Time_Decomposition::Slice_Comm(), &status);
                         rankx = rr % PE.MPI_X();
                         ranky = rr / PE.MPI_X();
                         i=0;
@@ -4891,7 +4706,7 @@ void Output_Data::Output_Preprocessor::fl0(const State2D& Y, const Grid_Info& gr
 
             if (PE.MPI_Processes() > 1) {
                 if (PE.RANK()!=0) {
-                    MPI_Send(buf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
+                    MPI_Send(buf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), Time_Decomposition::Slice_Comm());
                 }
                 else {
                     // Fill data for rank = 0
@@ -4907,7 +4722,7 @@ void Output_Data::Output_Preprocessor::fl0(const State2D& Y, const Grid_Info& gr
                     }
                     // Fill data for rank > 0
                     for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                        MPI_Recv(buf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
+                        MPI_Recv(buf, msg_sz, MPI_DOUBLE, rr, rr, Time_Decomposition::Slice_Comm(), &status);
                         rankx = rr % PE.MPI_X();
                         ranky = rr / PE.MPI_X();
                         i=0;
@@ -4949,48 +4764,18 @@ void Output_Data::Output_Preprocessor::n(const State1D& Y, const Grid_Info& grid
 
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
      
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
 
     int msg_sz(outNxLocal); //*szy);
-    double nbuf[msg_sz];
-    vector<double> nGlobal(outNxGlobal); 
-    vector<double> xaxis(valtovec(grid.axis.xg(0)));
+    valarray<double> nbuf(outNxLocal);
 
     for(int s(0); s < Y.Species(); ++s) {
-        valarray<double> pra( (grid.axis.p(s)));
         for(size_t i(0); i < msg_sz; ++i) {
-            nbuf[i] = 4.0*M_PI*Algorithms::moment(  vdouble_real( (Y.SH(s,0,0)).xVec(i+Nbc) ), pra, 2);
-        }
-
-        if (PE.MPI_Processes() > 1) {
-            if (PE.RANK()!=0) {
-                MPI_Send(nbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            }
-            else {
-                // Fill data for rank = 0
-                for(size_t i(0); i < outNxLocal; i++) {
-                    nGlobal[i] = nbuf[i];
-                }
-                // Fill data for rank > 0
-                for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                    MPI_Recv(nbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                    for(size_t i(0); i < outNxLocal; i++) {
-                        nGlobal[i + outNxLocal*rr] = nbuf[i];
-                    }
-                }
-            }
-        }
-            // Fill data for Nodes = 0
-        else {
-            for(size_t i(0); i < outNxGlobal; i++) {
-                nGlobal[i] = nbuf[i];
-            }
+            nbuf[i] = 4.0*M_PI*moments.f00(s,2,i);
         }
 
-        if (PE.RANK() == 0) expo.Export_h5("n", xaxis, nGlobal, tout, time, dt, s);
+        xdump("n", nbuf, grid, tout, time, dt, s, PE);
 
     }
 
@@ -5002,55 +4787,25 @@ void Output_Data::Output_Preprocessor::T(const State1D& Y, const Grid_Info& grid
 
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
     //  
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
 
     int msg_sz(outNxLocal);
     
-    double tbuf[msg_sz];
-    vector<double> tGlobal(outNxGlobal); 
-    vector<double> xaxis(valtovec(grid.axis.xg(0)));
+    valarray<double> tbuf(outNxLocal);
 
     double convert_factor = (2.99792458e8)*(2.99792458e8)*(9.1093829e-31)/(1.602176565e-19);
 
     for(int s(0); s < Y.Species(); ++s) {
-        valarray<double> pra( (grid.axis.p(s)) );
         
         for(size_t i(0); i < msg_sz; ++i) {
-            tbuf[i] = 4.0*M_PI*Algorithms::moment(  vdouble_real( (Y.SH(s,0,0)).xVec(i+Nbc) ), pra, 4);
-            tbuf[i] /= 3.0*4.0*M_PI*Algorithms::moment(  vdouble_real( (Y.SH(s,0,0)).xVec(i+Nbc) ), pra, 2);
+            tbuf[i] = 4.0*M_PI*moments.f00(s,4,i);
+            tbuf[i] /= 3.0*4.0*M_PI*moments.f00(s,2,i);
 
             tbuf[i] *= 1.0/Y.DF(s).mass();
         }
 
-        if (PE.MPI_Processes() > 1) {
-            if (PE.RANK()!=0) {
-                MPI_Send(tbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            }
-            else {
-                // Fill data for rank = 0
-                for(size_t i(0); i < outNxLocal; i++) {
-                    tGlobal[i] = tbuf[i];
-                }
-                // Fill data for rank > 0
-                for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                    MPI_Recv(tbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                    for(size_t i(0); i < outNxLocal; i++) {
-                        tGlobal[i + outNxLocal*rr] = tbuf[i];
-                    }
-                }
-            }
-        }
-            // Fill data for Nodes = 0
-        else {
-            for(size_t i(0); i < outNxGlobal; i++) {
-                tGlobal[i] = tbuf[i];
-            }
-        }
-
-        if (PE.RANK() == 0) expo.Export_h5("T", xaxis, tGlobal, tout, time, dt, s);
+        xdump("T", tbuf, grid, tout, time, dt, s, PE);
 
     }
 
@@ -5063,50 +4818,20 @@ void Output_Data::Output_Preprocessor::Jx(const State1D& Y, const Grid_Info& gri
 
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
     //  
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
 
     int msg_sz(outNxLocal);
-    double Jxbuf[msg_sz];
-    vector<double> JxGlobal(outNxGlobal); 
-    vector<double> xaxis(valtovec(grid.axis.xg(0)));
+    valarray<double> Jxbuf(outNxLocal);
 
     for(int s(0); s < Y.Species(); ++s) 
     {
-        valarray<double> pra( (grid.axis.p(s)) );
 
         for(size_t i(0); i < msg_sz; ++i) {
-            Jxbuf[i] = Y.DF(s).q()*4.0/3.0*M_PI*Algorithms::moment(  vdouble_real( (Y.SH(s,1,0)).xVec(i+Nbc) ), pra, 3);
-        }
-
-        if (PE.MPI_Processes() > 1) {
-            if (PE.RANK()!=0) {
-                MPI_Send(Jxbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            }
-            else {
-                // Fill data for rank = 0
-                for(size_t i(0); i < outNxLocal; i++) {
-                    JxGlobal[i] = Jxbuf[i];
-                }
-                // Fill data for rank > 0
-                for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                    MPI_Recv(Jxbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                    for(size_t i(0); i < outNxLocal; i++) {
-                        JxGlobal[i + outNxLocal*rr] = Jxbuf[i];
-                    }
-                }
-            }
-        }
-            // Fill data for Nodes = 0
-        else {
-            for(size_t i(0); i < outNxGlobal; i++) {
-                JxGlobal[i] = Jxbuf[i];
-            }
+            Jxbuf[i] = Y.DF(s).q()*4.0/3.0*M_PI*moments.f10(s,3,i);
         }
 
-        if (PE.RANK() == 0) expo.Export_h5("Jx", xaxis, JxGlobal, tout, time, dt, s);
+        xdump("Jx", Jxbuf, grid, tout, time, dt, s, PE);
 
     }
 
@@ -5120,50 +4845,20 @@ void Output_Data::Output_Preprocessor::Jy(const State1D& Y, const Grid_Info& gri
 
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
     //  
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
 
     int msg_sz(outNxLocal);
-    double Jybuf[msg_sz];
-    vector<double> JyGlobal(outNxGlobal); 
-    vector<double> xaxis(valtovec(grid.axis.xg(0)));
+    valarray<double> Jybuf(outNxLocal);
 
     for(int s(0); s < Y.Species(); ++s) 
     {
-        valarray<double> pra( (grid.axis.p(s)) );
 
         for(size_t i(0); i < msg_sz; ++i) {
-            Jybuf[i] = Y.DF(s).q()*8.0/3.0*M_PI*Algorithms::moment(  vdouble_real( (Y.SH(s,1,1)).xVec(i+Nbc) ), pra, 3);
-        }
-
-        if (PE.MPI_Processes() > 1) {
-            if (PE.RANK()!=0) {
-                MPI_Send(Jybuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            }
-            else {
-                // Fill data for rank = 0
-                for(size_t i(0); i < outNxLocal; i++) {
-                    JyGlobal[i] = Jybuf[i];
-                }
-                // Fill data for rank > 0
-                for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                    MPI_Recv(Jybuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                    for(size_t i(0); i < outNxLocal; i++) {
-                        JyGlobal[i + outNxLocal*rr] = Jybuf[i];
-                    }
-                }
-            }
-        }
-            // Fill data for Nodes = 0
-        else {
-            for(size_t i(0); i < outNxGlobal; i++) {
-                JyGlobal[i] = Jybuf[i];
-            }
+            Jybuf[i] = Y.DF(s).q()*8.0/3.0*M_PI*moments.f11re(s,3,i);
         }
 
-        if (PE.RANK() == 0) expo.Export_h5("Jy", xaxis, JyGlobal, tout, time, dt, s);
+        xdump("Jy", Jybuf, grid, tout, time, dt, s, PE);
 
     }
 
@@ -5176,49 +4871,19 @@ void Output_Data::Output_Preprocessor::Jz(const State1D& Y, const Grid_Info& gri
 
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
     //  
-    size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
-
-    int msg_sz(outNxLocal);
-    double Jzbuf[msg_sz];
-    vector<double> JzGlobal(outNxGlobal); 
-    vector<double> xaxis(valtovec(grid.axis.xg(0)));
-
-    for(int s(0); s < Y.Species(); ++s) 
-    {
-        valarray<double> pra( (grid.axis.p(s)) );
-        for(size_t i(0); i < msg_sz; ++i) {
-            Jzbuf[i] = Y.DF(s).q()*-8.0/3.0*M_PI*Algorithms::moment(  vdouble_imag( (Y.SH(s,1,1)).xVec(i+Nbc) ), pra, 3);
-        }
-
-        if (PE.MPI_Processes() > 1) {
-            if (PE.RANK()!=0) {
-                MPI_Send(Jzbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            }
-            else {
-                // Fill data for rank = 0
-                for(size_t i(0); i < outNxLocal; i++) {
-                    JzGlobal[i] = Jzbuf[i];
-                }
-                // Fill data for rank > 0
-                for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                    MPI_Recv(Jzbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                    for(size_t i(0); i < outNxLocal; i++) {
-                        JzGlobal[i + outNxLocal*rr] = Jzbuf[i];
-                    }
-                }
-            }
-        }
-            // Fill data for Nodes = 0
-        else {
-            for(size_t i(0); i < outNxGlobal; i++) {
-                JzGlobal[i] = Jzbuf[i];
-            }
+    size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
+
+    int msg_sz(outNxLocal);
+    valarray<double> Jzbuf(outNxLocal);
+
+    for(int s(0); s < Y.Species(); ++s) 
+    {
+        for(size_t i(0); i < msg_sz; ++i) {
+            Jzbuf[i] = Y.DF(s).q()*-8.0/3.0*M_PI*moments.f11im(s,3,i);
         }
 
-        if (PE.RANK() == 0) expo.Export_h5("Jz", xaxis, JzGlobal, tout, time, dt, s);
+        xdump("Jz", Jzbuf, grid, tout, time, dt, s, PE);
 
     }
 
@@ -5230,53 +4895,23 @@ void Output_Data::Output_Preprocessor::Qx(const State1D& Y, const Grid_Info& gri
 
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
 
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
 
     int msg_sz(outNxLocal); //*szy);
 
-    double Qxbuf[msg_sz];
+    valarray<double> Qxbuf(outNxLocal);
 
-    vector<double> QxGlobal(outNxGlobal); 
-    vector<double> xaxis(valtovec(grid.axis.xg(0)));
 
     for(int s(0); s < Y.Species(); ++s) {
 
-        valarray<double> pra( (grid.axis.p(s)) );
         for(size_t i(0); i < msg_sz; ++i) {
 
-            Qxbuf[i] = 4.0*M_PI/3.0*Y.DF(s).mass()*Algorithms::moment(  vdouble_real( (Y.SH(s,1,0)).xVec(i+Nbc) ), pra, 5);
+            Qxbuf[i] = 4.0*M_PI/3.0*Y.DF(s).mass()*moments.f10(s,5,i);
             Qxbuf[i] *= 0.5;
         }
 
-        if (PE.MPI_Processes() > 1) {
-            if (PE.RANK()!=0) {
-                MPI_Send(Qxbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            }
-            else {
-                // Fill data for rank = 0
-                for(size_t i(0); i < outNxLocal; i++) {
-                    QxGlobal[i] = Qxbuf[i];
-                }
-                // Fill data for rank > 0
-                for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                    MPI_Recv(Qxbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                    for(size_t i(0); i < outNxLocal; i++) {
-                        QxGlobal[i + outNxLocal*rr] = Qxbuf[i];
-                    }
-                }
-            }
-        }
-            // Fill data for Nodes = 0
-        else {
-            for(size_t i(0); i < outNxGlobal; i++) {
-                QxGlobal[i] = Qxbuf[i];
-            }
-        }
-
-        if (PE.RANK() == 0) expo.Export_h5("Qx", xaxis, QxGlobal, tout, time, dt, s);
+        xdump("Qx", Qxbuf, grid, tout, time, dt, s, PE);
 
     }
 
@@ -5289,52 +4924,22 @@ void Output_Data::Output_Preprocessor::Qy(const State1D& Y, const Grid_Info& gri
 
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
 
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
 
     int msg_sz(outNxLocal); //*szy);
 
-    double Qxbuf[msg_sz];
-    vector<double> QxGlobal(outNxGlobal); 
-    vector<double> xaxis(valtovec(grid.axis.xg(0)));
+    valarray<double> Qxbuf(outNxLocal);
 
     for(int s(0); s < Y.Species(); ++s) {
-        valarray<double> pra( (grid.axis.p(s)) );
         for(size_t i(0); i < msg_sz; ++i) {
 
-            Qxbuf[i] = 8.0*M_PI/3.0*Y.DF(s).mass()*Algorithms::moment(  vdouble_real( (Y.SH(s,1,1)).xVec(i+Nbc) ), pra, 5);
+            Qxbuf[i] = 8.0*M_PI/3.0*Y.DF(s).mass()*moments.f11re(s,5,i);
             Qxbuf[i] *= 0.5;
 
         }
 
-        if (PE.MPI_Processes() > 1) {
-            if (PE.RANK()!=0) {
-                MPI_Send(Qxbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            }
-            else {
-                // Fill data for rank = 0
-                for(size_t i(0); i < outNxLocal; i++) {
-                    QxGlobal[i] = Qxbuf[i];
-                }
-                // Fill data for rank > 0
-                for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                    MPI_Recv(Qxbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                    for(size_t i(0); i < outNxLocal; i++) {
-                        QxGlobal[i + outNxLocal*rr] = Qxbuf[i];
-                    }
-                }
-            }
-        }
-            // Fill data for Nodes = 0
-        else {
-            for(size_t i(0); i < outNxGlobal; i++) {
-                QxGlobal[i] = Qxbuf[i];
-            }
-        }
-
-        if (PE.RANK() == 0) expo.Export_h5("Qy", xaxis, QxGlobal, tout, time, dt, s);
+        xdump("Qy", Qxbuf, grid, tout, time, dt, s, PE);
 
     }
 
@@ -5347,54 +4952,24 @@ void Output_Data::Output_Preprocessor::Qz(const State1D& Y, const Grid_Info& gri
 
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
 
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
 
     int msg_sz(outNxLocal); //*szy);
 
-    double Qxbuf[msg_sz];
-    vector<double> QxGlobal(outNxGlobal);
-    vector<double> xaxis(valtovec(grid.axis.xg(0)));
+    valarray<double> Qxbuf(outNxLocal);
 
     for(int s(0); s < Y.Species(); ++s) 
     {
 
-        valarray<double> pra( (grid.axis.p(s)) );
         
         for(size_t i(0); i < msg_sz; ++i) 
         {
-            Qxbuf[i] = -8.0*M_PI/3.0*Y.DF(s).mass()*Algorithms::moment(  vdouble_imag( (Y.SH(s,1,1)).xVec(i+Nbc) ), pra, 5);
+            Qxbuf[i] = -8.0*M_PI/3.0*Y.DF(s).mass()*moments.f11im(s,5,i);
             Qxbuf[i] *= 0.5;
         }
 
-        if (PE.MPI_Processes() > 1) {
-            if (PE.RANK()!=0) {
-                MPI_Send(Qxbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            }
-            else {
-                // Fill data for rank = 0
-                for(size_t i(0); i < outNxLocal; i++) {
-                    QxGlobal[i] = Qxbuf[i];
-                }
-                // Fill data for rank > 0
-                for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                    MPI_Recv(Qxbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                    for(size_t i(0); i < outNxLocal; i++) {
-                        QxGlobal[i + outNxLocal*rr] = Qxbuf[i];
-                    }
-                }
-            }
-        }
-            // Fill data for Nodes = 0
-        else {
-            for(size_t i(0); i < outNxGlobal; i++) {
-                QxGlobal[i] = Qxbuf[i];
-            }
-        }
-
-        if (PE.RANK() == 0) expo.Export_h5("Qz", xaxis, QxGlobal, tout, time, dt, s);
+        xdump("Qz", Qxbuf, grid, tout, time, dt, s, PE);
 
     }
 
@@ -5408,53 +4983,21 @@ void Output_Data::Output_Preprocessor::vNx(const State1D& Y, const Grid_Info& gr
 
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
     //  
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
 
     int msg_sz(outNxLocal); //*szy);
-    double vNxbuf[msg_sz];
-    vector<double> vNxGlobal(outNxGlobal);
-    vector<double> xaxis(valtovec(grid.axis.xg(0)));
+    valarray<double> vNxbuf(outNxLocal);
 
     for(int s(0); s < Y.Species(); ++s) {
 
-//        valarray<double> pra( Algorithms::MakeAxis( f_x.Pmin(s), f_x.Pmax(s), f_x.Np(s) ) );
 
-        valarray<double> pra( (grid.axis.p(s)) );
 
         for(size_t i(0); i < msg_sz; ++i) {
-            vNxbuf[i] = static_cast<double>( (1.0 / 6.0 * (Algorithms::moment(vdouble_real((Y.SH(s, 1, 0)).xVec(i + Nbc) ), pra, 6)
-              / Algorithms::moment(  vdouble_real( (Y.SH(s,0,0)).xVec(i+Nbc) ), pra, 5))) );
-        }
-
-        if (PE.MPI_Processes() > 1) {
-            if (PE.RANK()!=0) {
-                MPI_Send(vNxbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            }
-            else {
-                // Fill data for rank = 0
-                for(size_t i(0); i < outNxLocal; i++) {
-                    vNxGlobal[i] = vNxbuf[i];
-                }
-                // Fill data for rank > 0
-                for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                    MPI_Recv(vNxbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                    for(size_t i(0); i < outNxLocal; i++) {
-                        vNxGlobal[i + outNxLocal*rr] = vNxbuf[i];
-                    }
-                }
-            }
-        }
-            // Fill data for Nodes = 0
-        else {
-            for(size_t i(0); i < outNxGlobal; i++) {
-                vNxGlobal[i] = vNxbuf[i];
-            }
+            vNxbuf[i] = 1.0 / 6.0 * moments.f10(s,6,i) / moments.f00(s,5,i);
         }
 
-        if (PE.RANK() == 0) expo.Export_h5("vNx", xaxis, vNxGlobal, tout, time, dt, 0);
+        xdump("vNx", vNxbuf, grid, tout, time, dt, 0, PE);
 
     }
 
@@ -5466,48 +5009,17 @@ void Output_Data::Output_Preprocessor::vNy(const State1D& Y, const Grid_Info& gr
 
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
 
     int msg_sz(outNxLocal); //*szy);
-    double vNxbuf[msg_sz];
-    vector<double> vNxGlobal(outNxGlobal);
-    vector<double> xaxis(valtovec(grid.axis.xg(0)));
+    valarray<double> vNxbuf(outNxLocal);
 
     for(int s(0); s < Y.Species(); ++s) {
-//        valarray<double> pra( Algorithms::MakeAxis( f_x.Pmin(s), f_x.Pmax(s), f_x.Np(s) ) );
-        valarray<double> pra( (grid.axis.p(s)) );
 
         for(size_t i(0); i < msg_sz; ++i) {
-            vNxbuf[i] = static_cast<double>( (2.0 / 6.0 * (Algorithms::moment(vdouble_real((Y.SH(s, 1, 1)).xVec(i + Nbc) ), pra, 6)
-              / Algorithms::moment(  vdouble_real( (Y.SH(s,0,0)).xVec(i+Nbc) ), pra, 5))) );
-        }
-        if (PE.MPI_Processes() > 1) {
-            if (PE.RANK()!=0) {
-                MPI_Send(vNxbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            }
-            else {
-                // Fill data for rank = 0
-                for(size_t i(0); i < outNxLocal; i++) {
-                    vNxGlobal[i] = vNxbuf[i];
-                }
-                // Fill data for rank > 0
-                for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                    MPI_Recv(vNxbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                    for(size_t i(0); i < outNxLocal; i++) {
-                        vNxGlobal[i + outNxLocal*rr] = vNxbuf[i];
-                    }
-                }
-            }
-        }
-            // Fill data for Nodes = 0
-        else {
-            for(size_t i(0); i < outNxGlobal; i++) {
-                vNxGlobal[i] = vNxbuf[i];
-            }
+            vNxbuf[i] = 2.0 / 6.0 * moments.f11re(s,6,i) / moments.f00(s,5,i);
         }
-        if (PE.RANK() == 0) expo.Export_h5("vNy", xaxis, vNxGlobal, tout, time, dt, 0);
+        xdump("vNy", vNxbuf, grid, tout, time, dt, 0, PE);
     }
 }
 // --------------------------------------------------------------
@@ -5518,49 +5030,18 @@ void Output_Data::Output_Preprocessor::vNz(const State1D& Y, const Grid_Info& gr
 
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
 
     int msg_sz(outNxLocal);
-    double vNxbuf[msg_sz];
-    vector<double> vNxGlobal(outNxGlobal);
-    vector<double> xaxis(valtovec(grid.axis.xg(0)));
+    valarray<double> vNxbuf(outNxLocal);
 
     for(int s(0); s < Y.Species(); ++s) {
-//        valarray<double> pra( Algorithms::MakeAxis( f_x.Pmin(s), f_x.Pmax(s), f_x.Np(s) ) );
 
-        valarray<double> pra( (grid.axis.p(s)) );
 
         for(size_t i(0); i < msg_sz; ++i) {
-            vNxbuf[i] = static_cast<double>( (-2.0 / 6.0 * (Algorithms::moment(vdouble_imag((Y.SH(s, 1, 1)).xVec(i + Nbc) ), pra, 6)
-               / Algorithms::moment(  vdouble_real( (Y.SH(s,0,0)).xVec(i+Nbc) ), pra, 5))));
-        }
-        if (PE.MPI_Processes() > 1) {
-            if (PE.RANK()!=0) {
-                MPI_Send(vNxbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-            }
-            else {
-                // Fill data for rank = 0
-                for(size_t i(0); i < outNxLocal; i++) {
-                    vNxGlobal[i] = vNxbuf[i];
-                }
-                // Fill data for rank > 0
-                for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                    MPI_Recv(vNxbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                    for(size_t i(0); i < outNxLocal; i++) {
-                        vNxGlobal[i + outNxLocal*rr] = vNxbuf[i];
-                    }
-                }
-            }
-        }
-            // Fill data for Nodes = 0
-        else {
-            for(size_t i(0); i < outNxGlobal; i++) {
-                vNxGlobal[i] = vNxbuf[i];
-            }
+            vNxbuf[i] = -2.0 / 6.0 * moments.f11im(s,6,i) / moments.f00(s,5,i);
         }
-        if (PE.RANK() == 0) expo.Export_h5("vNz", xaxis, vNxGlobal, tout, time, dt, 0);
+        xdump("vNz", vNxbuf, grid, tout, time, dt, 0, PE);
     }
     
 }
@@ -5599,7 +5080,7 @@ void Output_Data::Output_Preprocessor::n(const State2D& Y, const Grid_Info& grid
 
         if (PE.MPI_Processes() > 1) {
             if (PE.RANK()!=0) {
-                MPI_Send(nbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
+                MPI_Send(nbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), Time_Decomposition::Slice_Comm());
             }
             else {
                 // Fill data for rank = 0
@@ -5615,7 +5096,7 @@ void Output_Data::Output_Preprocessor::n(const State2D& Y, const Grid_Info& grid
                     ranky = rr / PE.MPI_X();
 
                     i=0;
-                    MPI_Recv(nbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
+                    MPI_Recv(nbuf, msg_sz, MPI_DOUBLE, rr, rr, Time_Decomposition::Slice_Comm(), &status);
                     for(size_t ix(0); ix < outNxLocal; ++ix) {
                         for(size_t iy(0); iy < outNyLocal; ++iy) {
                             nGlobal(ix + outNxLocal*rankx, iy + outNyLocal*ranky) = nbuf[i]; 
@@ -5690,7 +5171,7 @@ void Output_Data::Output_Preprocessor::T(const State2D& Y, const Grid_Info& grid
 
         if (PE.MPI_Processes() > 1) {
             if (PE.RANK()!=0) {
-                MPI_Send(tbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
+                MPI_Send(tbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), Time_Decomposition::Slice_Comm());
             }
             else {
                 // Fill data for rank = 0
@@ -5705,7 +5186,7 @@ void Output_Data::Output_Preprocessor::T(const State2D& Y, const Grid_Info& grid
                     rankx = rr % PE.MPI_X();
                     ranky = rr / PE.MPI_X();
 
-                    MPI_Recv(tbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
+                    MPI_Recv(tbuf, msg_sz, MPI_DOUBLE, rr, rr, Time_Decomposition::Slice_Comm(), &status);
 
                     i=0;
                     for(size_t ix(0); ix < outNxLocal; ++ix) {
@@ -5776,7 +5257,7 @@ void Output_Data::Output_Preprocessor::Jx(const State2D& Y, const Grid_Info& gri
 
         if (PE.MPI_Processes() > 1) {
             if (PE.RANK()!=0) {
-                MPI_Send(buf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
+                MPI_Send(buf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), Time_Decomposition::Slice_Comm());
             }
             else {
                 // Fill data for rank = 0
@@ -5792,7 +5273,7 @@ void Output_Data::Output_Preprocessor::Jx(const State2D& Y, const Grid_Info& gri
                     rankx = rr % PE.MPI_X();
                     ranky = rr / PE.MPI_X();
 
-                    MPI_Recv(buf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
+                    MPI_Recv(buf, msg_sz, MPI_DOUBLE, rr, rr, Time_Decomposition::Slice_Comm(), &status);
 
                     i=0;
                     for(size_t ix(0); ix < outNxLocal; ++ix) {
@@ -5861,7 +5342,7 @@ void Output_Data::Output_Preprocessor::Jy(const State2D& Y, const Grid_Info& gri
 
         if (PE.MPI_Processes() > 1) {
             if (PE.RANK()!=0) {
-                MPI_Send(buf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
+                MPI_Send(buf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), Time_Decomposition::Slice_Comm());
             }
             else {
                 // Fill data for rank = 0
@@ -5876,7 +5357,7 @@ void Output_Data::Output_Preprocessor::Jy(const State2D& Y, const Grid_Info& gri
                     rankx = rr % PE.MPI_X();
                     ranky = rr / PE.MPI_X();
 
-                    MPI_Recv(buf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
+                    MPI_Recv(buf, msg_sz, MPI_DOUBLE, rr, rr, Time_Decomposition::Slice_Comm(), &status);
 
                     i=0;
                     for(size_t ix(0); ix < outNxLocal; ++ix) {
@@ -5938,7 +5419,7 @@ void Output_Data::Output_Preprocessor::Jz(const State2D& Y, const Grid_Info& gri
 
         if (PE.MPI_Processes() > 1) {
             if (PE.RANK() != 0) {
-                MPI_Send(buf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
+                MPI_Send(buf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), Time_Decomposition::Slice_Comm());
             } else {
                 // Fill data for rank = 0
                 i = 0;
@@ -5953,7 +5434,7 @@ void Output_Data::Output_Preprocessor::Jz(const State2D& Y, const Grid_Info& gri
                     rankx = rr % PE.MPI_X();
                     ranky = rr / PE.MPI_X();
 
-                    MPI_Recv(buf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
+                    MPI_Recv(buf, msg_sz, MPI_DOUBLE, rr, rr, Time_Decomposition::Slice_Comm(), &status);
 
                     i = 0;
                     for (size_t ix(0); ix < outNxLocal; ++ix) {
@@ -6014,7 +5495,7 @@ void Output_Data::Output_Preprocessor::Qx(const State2D& Y, const Grid_Info& gri
 
         if (PE.MPI_Processes() > 1) {
             if (PE.RANK() != 0) {
-                MPI_Send(buf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
+                MPI_Send(buf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), Time_Decomposition::Slice_Comm());
             } else {
                 // Fill data for rank = 0
                 i = 0;
@@ -6029,7 +5510,7 @@ void Output_Data::Output_Preprocessor::Qx(const State2D& Y, const Grid_Info& gri
                     rankx = rr % PE.MPI_X();
                     ranky = rr / PE.MPI_X();
 
-                    MPI_Recv(buf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
+                    MPI_Recv(buf, msg_sz, MPI_DOUBLE, rr, rr, Time_Decomposition::Slice_Comm(), &status);
 
                     i = 0;
                     for (size_t ix(0); ix < outNxLocal; ++ix) {
@@ -6090,7 +5571,7 @@ void Output_Data::Output_Preprocessor::Qy(const State2D& Y, const Grid_Info& gri
 
         if (PE.MPI_Processes() > 1) {
             if (PE.RANK() != 0) {
-                MPI_Send(buf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
+                MPI_Send(buf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), Time_Decomposition::Slice_Comm());
             } else {
                 // Fill data for rank = 0
                 i = 0;
@@ -6105,7 +5586,7 @@ void Output_Data::Output_Preprocessor::Qy(const State2D& Y, const Grid_Info& gri
                     rankx = rr % PE.MPI_X();
                     ranky = rr / PE.MPI_X();
 
-                    MPI_Recv(buf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
+                    MPI_Recv(buf, msg_sz, MPI_DOUBLE, rr, rr, Time_Decomposition::Slice_Comm(), &status);
 
                     i = 0;
                     for (size_t ix(0); ix < outNxLocal; ++ix) {
@@ -6166,7 +5647,7 @@ void Output_Data::Output_Preprocessor::Qz(const State2D& Y, const Grid_Info& gri
 
         if (PE.MPI_Processes() > 1) {
             if (PE.RANK() != 0) {
-                MPI_Send(buf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
+                MPI_Send(buf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), Time_Decomposition::Slice_Comm());
             } else {
                 // Fill data for rank = 0
                 i = 0;
@@ -6181,7 +5662,7 @@ void Output_Data::Output_Preprocessor::Qz(const State2D& Y, const Grid_Info& gri
                     rankx = rr % PE.MPI_X();
                     ranky = rr / PE.MPI_X();
 
-                    MPI_Recv(buf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
+                    MPI_Recv(buf, msg_sz, MPI_DOUBLE, rr, rr, Time_Decomposition::Slice_Comm(), &status);
 
                     i = 0;
                     for (size_t ix(0); ix < outNxLocal; ++ix) {
@@ -6245,7 +5726,7 @@ void Output_Data::Output_Preprocessor::vNx(const State2D& Y, const Grid_Info& gr
 
         if (PE.MPI_Processes() > 1) {
             if (PE.RANK() != 0) {
-                MPI_Send(buf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
+                MPI_Send(buf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), Time_Decomposition::Slice_Comm());
             } else {
                 // Fill data for rank = 0
                 i = 0;
@@ -6260,7 +5741,7 @@ void Output_Data::Output_Preprocessor::vNx(const State2D& Y, const Grid_Info& gr
                     rankx = rr % PE.MPI_X();
                     ranky = rr / PE.MPI_X();
 
-                    MPI_Recv(buf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
+                    MPI_Recv(buf, msg_sz, MPI_DOUBLE, rr, rr, Time_Decomposition::Slice_Comm(), &status);
 
                     i = 0;
                     for (size_t ix(0); ix < outNxLocal; ++ix) {
@@ -6325,7 +5806,7 @@ void Output_Data::Output_Preprocessor::vNy(const State2D& Y, const Grid_Info& gr
 
         if (PE.MPI_Processes() > 1) {
             if (PE.RANK() != 0) {
-                MPI_Send(buf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
+                MPI_Send(buf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), Time_Decomposition::Slice_Comm());
             } else {
                 // Fill data for rank = 0
                 i = 0;
@@ -6340,7 +5821,7 @@ void Output_Data::Output_Preprocessor::vNy(const State2D& Y, const Grid_Info& gr
                     rankx = rr % PE.MPI_X();
                     ranky = rr / PE.MPI_X();
 
-                    MPI_Recv(buf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
+                    MPI_Recv(buf, msg_sz, MPI_DOUBLE, rr, rr, Time_Decomposition::Slice_Comm(), &status);
 
                     i = 0;
                     for (size_t ix(0); ix < outNxLocal; ++ix) {
@@ -6407,7 +5888,7 @@ void Output_Data::Output_Preprocessor::vNz(const State2D& Y, const Grid_Info& gr
 
         if (PE.MPI_Processes() > 1) {
             if (PE.RANK() != 0) {
-                MPI_Send(buf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
+                MPI_Send(buf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), Time_Decomposition::Slice_Comm());
             } else {
                 // Fill data for rank = 0
                 i = 0;
@@ -6422,7 +5903,7 @@ void Output_Data::Output_Preprocessor::vNz(const State2D& Y, const Grid_Info& gr
                     rankx = rr % PE.MPI_X();
                     ranky = rr / PE.MPI_X();
 
-                    MPI_Recv(buf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
+                    MPI_Recv(buf, msg_sz, MPI_DOUBLE, rr, rr, Time_Decomposition::Slice_Comm(), &status);
 
                     i = 0;
                     for (size_t ix(0); ix < outNxLocal; ++ix) {
@@ -6458,47 +5939,18 @@ void Output_Data::Output_Preprocessor::Ux(const State1D& Y, const Grid_Info& gri
 
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
     //  
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
 
     int msg_sz(outNxLocal); 
-    double Uxbuf[msg_sz];
-    vector<double> UxGlobal(outNxGlobal);
-    vector<double> xaxis(valtovec(grid.axis.xg(0)));
+    valarray<double> Uxbuf(outNxLocal);
 
     for(size_t i(0); i < msg_sz; ++i) 
     {
         Uxbuf[i] = static_cast<double>(Y.HYDRO().vx(i+Nbc));
     }
 
-    if (PE.MPI_Processes() > 1) {
-        if (PE.RANK()!=0) {
-            MPI_Send(Uxbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-        }
-        else {
-            // Fill data for rank = 0
-            for(size_t i(0); i < outNxLocal; i++) {
-                UxGlobal[i] = Uxbuf[i];
-            }
-            // Fill data for rank > 0
-            for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                MPI_Recv(Uxbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                for(size_t i(0); i < outNxLocal; i++) {
-                    UxGlobal[i + outNxLocal*rr] = Uxbuf[i];
-                }
-            }
-        }
-    }
-    // Fill data for Nodes = 0
-    else {
-        for(size_t i(0); i < outNxGlobal; i++) {
-            UxGlobal[i] = Uxbuf[i];
-        }
-    }
-
-    if (PE.RANK() == 0) expo.Export_h5("Ux", xaxis, UxGlobal, tout, time, dt, 0);
+    xdump("Ux", Uxbuf, grid, tout, time, dt, 0, PE);
 
 }
 //--------------------------------------------------------------
@@ -6508,46 +5960,17 @@ void Output_Data::Output_Preprocessor::Uy(const State1D& Y, const Grid_Info& gri
 
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
     //  
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
 
     int msg_sz(outNxLocal); 
-    double Uxbuf[msg_sz];
-    vector<double> UxGlobal(outNxGlobal); 
-    vector<double> xaxis(valtovec(grid.axis.xg(0)));  
+    valarray<double> Uxbuf(outNxLocal);
 
     for(size_t i(0); i < msg_sz; ++i) {
         Uxbuf[i] = static_cast<double>(Y.HYDRO().vy(i+Nbc));
     }
 
-    if (PE.MPI_Processes() > 1) {
-        if (PE.RANK()!=0) {
-            MPI_Send(Uxbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-        }
-        else {
-            // Fill data for rank = 0
-            for(size_t i(0); i < outNxLocal; i++) {
-                UxGlobal[i] = Uxbuf[i];
-            }
-            // Fill data for rank > 0
-            for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                MPI_Recv(Uxbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                for(size_t i(0); i < outNxLocal; i++) {
-                    UxGlobal[i + outNxLocal*rr] = Uxbuf[i];
-                }
-            }
-        }
-    }
-        // Fill data for Nodes = 0
-    else {
-        for(size_t i(0); i < outNxGlobal; i++) {
-            UxGlobal[i] = Uxbuf[i];
-        }
-    }
-
-    if (PE.RANK() == 0) expo.Export_h5("Uy", xaxis, UxGlobal, tout, time, dt, 0);
+    xdump("Uy", Uxbuf, grid, tout, time, dt, 0, PE);
 
 }
 //--------------------------------------------------------------
@@ -6557,47 +5980,18 @@ void Output_Data::Output_Preprocessor::Uz(const State1D& Y, const Grid_Info& gri
 
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
     //  
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
 
     int msg_sz(outNxLocal); //*szy);
-    double Uxbuf[msg_sz];
-    vector<double> UxGlobal(outNxGlobal);
-    vector<double> xaxis(valtovec(grid.axis.xg(0)));
+    valarray<double> Uxbuf(outNxLocal);
 
 
     for(size_t i(0); i < msg_sz; ++i) {
         Uxbuf[i] = static_cast<double>(Y.HYDRO().vz(i+Nbc));
     }
 
-    if (PE.MPI_Processes() > 1) {
-        if (PE.RANK()!=0) {
-            MPI_Send(Uxbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-        }
-        else {
-            // Fill data for rank = 0
-            for(size_t i(0); i < outNxLocal; i++) {
-                UxGlobal[i] = Uxbuf[i];
-            }
-            // Fill data for rank > 0
-            for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                MPI_Recv(Uxbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                for(size_t i(0); i < outNxLocal; i++) {
-                    UxGlobal[i + outNxLocal*rr] = Uxbuf[i];
-                }
-            }
-        }
-    }
-        // Fill data for Nodes = 0
-    else {
-        for(size_t i(0); i < outNxGlobal; i++) {
-            UxGlobal[i] = Uxbuf[i];
-        }
-    }
-
-    if (PE.RANK() == 0) expo.Export_h5("Uz", xaxis, UxGlobal, tout, time, dt, 0);
+    xdump("Uz", Uxbuf, grid, tout, time, dt, 0, PE);
 
 }
 //--------------------------------------------------------------
@@ -6607,47 +6001,18 @@ void Output_Data::Output_Preprocessor::Z(const State1D& Y, const Grid_Info& grid
 
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
     
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
 
     int msg_sz(outNxLocal); //*szy);
-    double Uxbuf[msg_sz];
-    vector<double> UxGlobal(outNxGlobal);
-    vector<double> xaxis(valtovec(grid.axis.xg(0)));
+    valarray<double> Uxbuf(outNxLocal);
 
 
     for(size_t i(0); i < msg_sz; ++i) {
         Uxbuf[i] = static_cast<double>(Y.HYDRO().Z(i+Nbc));
     }
 
-    if (PE.MPI_Processes() > 1) {
-        if (PE.RANK()!=0) {
-            MPI_Send(Uxbuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-        }
-        else {
-            // Fill data for rank = 0
-            for(size_t i(0); i < outNxLocal; i++) {
-                UxGlobal[i] = Uxbuf[i];
-            }
-            // Fill data for rank > 0
-            for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                MPI_Recv(Uxbuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                for(size_t i(0); i < outNxLocal; i++) {
-                    UxGlobal[i + outNxLocal*rr] = Uxbuf[i];
-                }
-            }
-        }
-    }
-        // Fill data for Nodes = 0
-    else {
-        for(size_t i(0); i < outNxGlobal; i++) {
-            UxGlobal[i] = Uxbuf[i];
-        }
-    }
-
-    if (PE.RANK() == 0) expo.Export_h5("Z", xaxis, UxGlobal, tout, time, dt, 0);
+    xdump("Z", Uxbuf, grid, tout, time, dt, 0, PE);
 
 }
 //--------------------------------------------------------------
@@ -6656,51 +6021,21 @@ void Output_Data::Output_Preprocessor::Z(const State1D& Y, const Grid_Info& grid
 //--------------------------------------------------------------
 //--------------------------------------------------------------
 void Output_Data::Output_Preprocessor::ni(const State1D& Y, const Grid_Info& grid, const size_t tout, const double time, const double dt,
- const Parallel_Environment_1D& PE) {
-
-
-    size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
-    //  
-    size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
-
-    int msg_sz(outNxLocal); //*szy);
-    double nibuf[msg_sz];
-    vector<double> niGlobal(outNxGlobal);
-    vector<double> xaxis(valtovec(grid.axis.xg(0)));
-
-    for(size_t i(0); i < msg_sz; ++i) {
-        nibuf[i] = static_cast<double>(Y.HYDRO().density(i+Nbc));
-    }
-
-    if (PE.MPI_Processes() > 1) {
-        if (PE.RANK()!=0) {
-            MPI_Send(nibuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-        }
-        else {
-            // Fill data for rank = 0
-            for(size_t i(0); i < outNxLocal; i++) {
-                niGlobal[i] = nibuf[i];
-            }
-            // Fill data for rank > 0
-            for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                MPI_Recv(nibuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                for(size_t i(0); i < outNxLocal; i++) {
-                    niGlobal[i + outNxLocal*rr] = nibuf[i];
-                }
-            }
-        }
-    }
-        // Fill data for Nodes = 0
-    else {
-        for(size_t i(0); i < outNxGlobal; i++) {
-            niGlobal[i] = nibuf[i];
+ const Parallel_Environment_1D& PE) {
 
-        }
+
+    size_t Nbc = Input::List().BoundaryCells;
+    //  
+    size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
+
+    int msg_sz(outNxLocal); //*szy);
+    valarray<double> nibuf(outNxLocal);
+
+    for(size_t i(0); i < msg_sz; ++i) {
+        nibuf[i] = static_cast<double>(Y.HYDRO().density(i+Nbc));
     }
 
-    if (PE.RANK() == 0) expo.Export_h5("ni",  xaxis, niGlobal, tout, time, dt, 0);
+    xdump("ni", nibuf, grid, tout, time, dt, 0, PE);
 
 }
 //--------------------------------------------------------------
@@ -6713,156 +6048,243 @@ void Output_Data::Output_Preprocessor::Ti(const State1D& Y, const Grid_Info& gri
 
 
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
     //  
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
 
     int msg_sz(outNxLocal); //*szy);
-    double Thydrobuf[msg_sz];
-    vector<double> ThydroGlobal(outNxGlobal);
-    vector<double> xaxis(valtovec(grid.axis.xg(0)));
+    valarray<double> Thydrobuf(outNxLocal);
 
     for(size_t i(0); i < msg_sz; ++i) {
         Thydrobuf[i] = static_cast<double>(511000.0/3.0*Y.HYDRO().temperature(i+Nbc));
     }
 
-    if (PE.MPI_Processes() > 1) {
-        if (PE.RANK()!=0) {
-            MPI_Send(Thydrobuf, msg_sz, MPI_DOUBLE, 0, PE.RANK(), MPI_COMM_WORLD);
-        }
-        else {
-            // Fill data for rank = 0
-            for(size_t i(0); i < outNxLocal; i++) {
-                ThydroGlobal[i] = Thydrobuf[i];
-            }
-            // Fill data for rank > 0
-            for (int rr = 1; rr < PE.MPI_Processes(); ++rr){
-                MPI_Recv(Thydrobuf, msg_sz, MPI_DOUBLE, rr, rr, MPI_COMM_WORLD, &status);
-                for(size_t i(0); i < outNxLocal; i++) {
-                    ThydroGlobal[i + outNxLocal*rr] = Thydrobuf[i];
-                }
-            }
-        }
+    xdump("Ti", Thydrobuf, grid, tout, time, dt, 0, PE);
+
+}
+//--------------------------------------------------------------
+//--------------------------------------------------------------
+Output_Data::historybuffer::historybuffer(size_t _width, size_t _capacity)
+    : w(_width), capacity(_capacity > 0 ? _capacity : 1), rows(0), nspilled(0), buf(0.0, _width*(_capacity > 0 ? _capacity : 1)) {
+    t_samples.reserve(capacity);
+}
+//--------------------------------------------------------------
+void Output_Data::historybuffer::push(const valarray<double>& sample, double t) {
+    for (size_t i(0); i < w; ++i) buf[rows*w+i] = sample[i];
+    t_samples.push_back(t);
+    ++rows;
+}
+//--------------------------------------------------------------
+//  Each chunk is the capacity times followed by the rows, a file
+//  left over from an earlier run is overwritten
+void Output_Data::historybuffer::spill(const std::string fname) {
+    ofstream out(fname.c_str(), ios::binary | ((nspilled > 0) ? ios::app : ios::trunc));
+    out.write(reinterpret_cast<const char*>(&t_samples[0]), capacity*sizeof(double));
+    if (w > 0) out.write(reinterpret_cast<const char*>(&buf[0]), w*capacity*sizeof(double));
+    if (!out) 
+    {
+        cout << "ERROR: could not spill the held history to " << fname << endl;
+        MPI_Finalize();
+        exit(1);
     }
-        // Fill data for Nodes = 0
-    else {
-        for(size_t i(0); i < outNxGlobal; i++) {
-            ThydroGlobal[i] = Thydrobuf[i];
-        }
+    ++nspilled;
+    clear();
+}
+//--------------------------------------------------------------
+void Output_Data::historybuffer::reload(const std::string fname, size_t chunk) {
+    ifstream in(fname.c_str(), ios::binary);
+    in.seekg(chunk*(w+1)*capacity*sizeof(double));
+    t_samples.resize(capacity);
+    in.read(reinterpret_cast<char*>(&t_samples[0]), capacity*sizeof(double));
+    if (w > 0) in.read(reinterpret_cast<char*>(&buf[0]), w*capacity*sizeof(double));
+    if (!in) 
+    {
+        cout << "ERROR: could not read the held history back from " << fname << endl;
+        MPI_Finalize();
+        exit(1);
     }
-
-    if (PE.RANK() == 0) expo.Export_h5("Ti", xaxis, ThydroGlobal, tout, time, dt, 0);
-
+    rows = capacity;
+}
+//--------------------------------------------------------------
+void Output_Data::historybuffer::drop(const std::string fname) {
+    if (nspilled > 0) remove(fname.c_str());
+    nspilled = 0;
 }
 //--------------------------------------------------------------
 //--------------------------------------------------------------
-void Output_Data::Output_Preprocessor::histdump(vector<valarray<complex<double> > >& fieldhistory, vector<double>& time_history, const Grid_Info& grid, const size_t tout, const double time, const double dt,
-   const Parallel_Environment_1D& PE, std::string tag) 
+//  True on every hist_t_stride-th call, i.e. once per step that
+//  should be recorded
+bool Output_Data::Output_Preprocessor::histsample() {
+    return ((hist_calls++) % Input::List().hist_t_stride) == 0;
+}
+//--------------------------------------------------------------
+//--------------------------------------------------------------
+//  Record the real part of a local field, keeping every 
+//  hist_x_stride-th global cell
+void Output_Data::Output_Preprocessor::histrecord(const std::string tag, const valarray<complex<double> >& field, const double time, const double dt,
+    const Grid_Info& grid, const Parallel_Environment_1D& PE)
 {
-
     size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
-    
+    size_t stride(Input::List().hist_x_stride);
+    size_t offset(PE.Slab_Offset(PE.RANK()));
     size_t outNxLocal(grid.axis.Nx(0) - 2*Nbc);
-    size_t outNxGlobal(grid.axis.Nxg(0));
-    size_t number_of_time_steps(time_history.size());
-    int msg_sz(number_of_time_steps*outNxLocal);
-    
-    valarray<double> ExtBuf(msg_sz);
-    valarray<double> ExtGlobalBuf(number_of_time_steps*outNxGlobal);
-    
-    vector<double> xaxis(valtovec(grid.axis.xg(0)));
-    vector<double> pxaxis(valtovec(grid.axis.px(0)));
-    Array2D<double> ExtGlobal(number_of_time_steps,outNxGlobal);
 
-    // std::cout << "fieldhsize = "  << fieldhistory[0].size();
-    // exit(1);
+    size_t nkept(0);
+    for (size_t ix(0); ix < outNxLocal; ++ix) if ((offset+ix) % stride == 0) ++nkept;
 
-    for(size_t it(0); it < number_of_time_steps; ++it) 
+    map< string, historybuffer >::iterator hb = histories.find(tag);
+    if (hb == histories.end()) 
     {
-        for(size_t ix(0); ix < outNxLocal; ++ix) 
-        {
-            ExtBuf[it*outNxLocal+ix] = fieldhistory[it][ix+Nbc].real();
-        }
+        hb = histories.insert(std::make_pair(tag, historybuffer(nkept, Input::List().hist_buffer_steps))).first;
+        hist_summed[tag] = false;
     }
 
-    MPI_Gather( &ExtBuf[0], msg_sz, MPI_DOUBLE, &ExtGlobalBuf[0], msg_sz, MPI_DOUBLE, 0, MPI_COMM_WORLD);
-
-    size_t offset(0);
-    for (int rr(0); rr < PE.MPI_Processes(); ++rr)
-    {            
-        offset = rr*msg_sz;
-
-        for(size_t it(0); it < number_of_time_steps; ++it) 
-        {
-            for(size_t ix(0); ix < outNxLocal; ++ix) 
-            {
-                ExtGlobal(it,ix+rr*outNxLocal) = ExtGlobalBuf[offset+ix];
-            }
-            offset += outNxLocal;
-        }
+    valarray<double> sample(nkept);
+    size_t ik(0);
+    for (size_t ix(0); ix < outNxLocal; ++ix) 
+    {
+        if ((offset+ix) % stride == 0) sample[ik++] = field[ix+Nbc].real();
     }
 
-    if (PE.RANK() == 0) 
+    hb->second.push(sample, time);
+    if (hb->second.full()) histflush(tag, grid, dt, PE);
+}
+//--------------------------------------------------------------
+//--------------------------------------------------------------
+//  Record a quantity whose global value is the sum over the ranks
+void Output_Data::Output_Preprocessor::histrecord(const std::string tag, const valarray<double>& rank_sum, const double time, const double dt,
+    const Grid_Info& grid, const Parallel_Environment_1D& PE)
+{
+    map< string, historybuffer >::iterator hb = histories.find(tag);
+    if (hb == histories.end()) 
     {
-        expo.Export_h5(tag, time_history, xaxis, ExtGlobal, tout, time, dt, 0);
+        hb = histories.insert(std::make_pair(tag, historybuffer(rank_sum.size(), Input::List().hist_buffer_steps))).first;
+        hist_summed[tag] = true;
     }
+
+    hb->second.push(rank_sum, time);
+    if (hb->second.full()) histflush(tag, grid, dt, PE);
 }
-// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 //--------------------------------------------------------------
-void Output_Data::Output_Preprocessor::histdump(vector<valarray<double> >& fieldhistory, vector<double>& time_history, const Grid_Info& grid, const size_t tout, const double time, const double dt,
-   const Parallel_Environment_1D& PE, std::string tag) 
+//--------------------------------------------------------------
+void Output_Data::Output_Preprocessor::histflush(const Grid_Info& grid, const double dt, const Parallel_Environment_1D& PE)
 {
+    if (hist_hold) return;
 
-    size_t Nbc = Input::List().BoundaryCells;
-    MPI_Status status;
-    
-    vector<double> pxaxis(valtovec(grid.axis.px(0)));
-    size_t Npx(pxaxis.size());
-
-    size_t number_of_time_steps(time_history.size());
-    int msg_sz(number_of_time_steps*Npx);
-    
-    valarray<double> fhat0Buf(msg_sz);
-    valarray<double> fhat0GlobalBuf(number_of_time_steps*Npx*PE.MPI_Processes());
-    
-    vector<double> xaxis(valtovec(grid.axis.xg(0)));
-    
-    Array2D<double> fhat0Global(number_of_time_steps,Npx);
-    fhat0Global = 0.;
+    for (map< string, historybuffer >::iterator hb = histories.begin(); hb != histories.end(); ++hb)
+    {
+        histflush(hb->first, grid, dt, PE);
+    }
+//  Rebuilt on the next sample, in case the slabs have been re-cut
+    histories.clear();
+}
+//--------------------------------------------------------------
+//--------------------------------------------------------------
+//  Collect the buffered rows on rank 0, append them to the file 
+//  and empty the buffer. Held buffers that fill up are spilled 
+//  to a scratch file of this rank instead.
+void Output_Data::Output_Preprocessor::histflush(const std::string tag, const Grid_Info& grid, const double dt, 
+    const Parallel_Environment_1D& PE)
+{
+    historybuffer& hb = histories.find(tag)->second;
 
-    // std::cout << "fieldhsize = "  << fieldhistory[0].size();
-    // exit(1);
+    if (hist_hold) 
+    {
+        if (hb.full()) hb.spill(histscratch(tag));
+        return;
+    }
 
-    for(size_t it(0); it < number_of_time_steps; ++it) 
+    if (hb.spilled() > 0)
     {
-        for(size_t ipx(0); ipx < Npx; ++ipx) 
+        historybuffer chunk(hb.width(), Input::List().hist_buffer_steps);
+        for (size_t ic(0); ic < hb.spilled(); ++ic)
         {
-            fhat0Buf[it*Npx+ipx] = fieldhistory[it][ipx];
+            chunk.reload(histscratch(tag), ic);
+            histappend(tag, chunk, grid, dt, PE);
         }
+        hb.drop(histscratch(tag));
     }
 
-    MPI_Gather( &fhat0Buf[0], msg_sz, MPI_DOUBLE, &fhat0GlobalBuf[0], msg_sz, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    histappend(tag, hb, grid, dt, PE);
+    hb.clear();
+}
+//--------------------------------------------------------------
+//--------------------------------------------------------------
+std::string Output_Data::Output_Preprocessor::histscratch(const std::string tag) const
+{
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    stringstream fname;
+    fname << "restart/" << tag << "_held_" << rank << ".bin";
+    return fname.str();
+}
+//--------------------------------------------------------------
+//--------------------------------------------------------------
+void Output_Data::Output_Preprocessor::histappend(const std::string tag, historybuffer& hb, const Grid_Info& grid, const double dt, 
+    const Parallel_Environment_1D& PE)
+{
+    size_t rows(hb.size());
+    if (rows == 0) return;
 
-    size_t offset(0);
-    for (int rr(0); rr < PE.MPI_Processes(); ++rr)
-    {            
-        offset = rr*msg_sz;
+    if (hist_summed[tag])
+    {
+        size_t Npx(hb.width());
+        valarray<double> GlobalBuf(rows*Npx);
 
-        for(size_t it(0); it < number_of_time_steps; ++it) 
+        MPI_Reduce(hb.data(), &GlobalBuf[0], rows*Npx, MPI_DOUBLE, MPI_SUM, 0, Time_Decomposition::Slice_Comm());
+
+        if (PE.RANK() == 0) 
         {
-            for(size_t ipx(0); ipx < Npx; ++ipx) 
+            vector<double> pxaxis(valtovec(grid.axis.px(0)));
+            if (pxaxis.size() != Npx)                   // Columns of scalars are numbered
             {
-                fhat0Global(it,ipx) += fhat0GlobalBuf[offset+ipx];
+                pxaxis.resize(Npx);
+                for (size_t ipx(0); ipx < Npx; ++ipx) pxaxis[ipx] = ipx;
             }
-            offset += Npx;
+            Array2D<double> Global(rows,Npx);
+            for (size_t it(0); it < rows; ++it)
+                for (size_t ipx(0); ipx < Npx; ++ipx)
+                    Global(it,ipx) = GlobalBuf[it*Npx+ipx];
+
+            expo.Append_h5(tag, hb.times(), pxaxis, Global, dt, 0);
         }
     }
-
-    if (PE.RANK() == 0) 
+    else 
     {
-        expo.Export_h5(tag, time_history, pxaxis, fhat0Global, tout, time, dt, 0);
+        size_t stride(Input::List().hist_x_stride);
+        vector<double> xaxis_full(valtovec(grid.axis.xg(0)));
+        vector<double> xaxis;
+        for (size_t ig(0); ig < xaxis_full.size(); ++ig) if (ig % stride == 0) xaxis.push_back(xaxis_full[ig]);
+
+//      Cells kept on each rank, same selection as in histrecord
+        vector<int> counts(PE.MPI_Processes()), displs(PE.MPI_Processes());
+        vector<size_t> first(PE.MPI_Processes());
+        size_t total(0);
+        for (int rr(0); rr < PE.MPI_Processes(); ++rr)
+        {
+            size_t nkept(0);
+            for (size_t ix(0); ix < PE.Slab_Cells(rr); ++ix) if ((PE.Slab_Offset(rr)+ix) % stride == 0) ++nkept;
+            first[rr]  = (PE.Slab_Offset(rr) + stride - 1) / stride;
+            counts[rr] = rows*nkept;
+            displs[rr] = total;
+            total     += rows*nkept;
+        }
+
+        valarray<double> GlobalBuf(total > 0 ? total : 1);
+        MPI_Gatherv( hb.data(), rows*hb.width(), MPI_DOUBLE, &GlobalBuf[0], &counts[0], &displs[0], MPI_DOUBLE, 0, Time_Decomposition::Slice_Comm());
+
+        if (PE.RANK() == 0) 
+        {
+            Array2D<double> Global(rows,xaxis.size());
+            for (int rr(0); rr < PE.MPI_Processes(); ++rr)
+            {
+                size_t nkept(counts[rr]/rows);
+                for (size_t it(0); it < rows; ++it)
+                    for (size_t ik(0); ik < nkept; ++ik)
+                        Global(it,first[rr]+ik) = GlobalBuf[displs[rr]+it*nkept+ik];
+            }
+
+            expo.Append_h5(tag, hb.times(), xaxis, Global, dt, 0);
+        }
     }
 }
 // ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -6902,7 +6324,7 @@ void Output_Data::Output_Preprocessor::histdump(vector<Array2D<complex<double> >
         }
     }
 
-    MPI_Gather( &ExtBuf[0], msg_sz, MPI_DOUBLE, &ExtGlobalBuf[0], msg_sz, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    MPI_Gather( &ExtBuf[0], msg_sz, MPI_DOUBLE, &ExtGlobalBuf[0], msg_sz, MPI_DOUBLE, 0, Time_Decomposition::Slice_Comm());
 
     size_t offset(0);
     for (int rr(0); rr < PE.MPI_Processes(); ++rr)
@@ -6965,6 +6387,77 @@ void Output_Data::Output_Preprocessor::histdump(vector<vector<double> >& fieldhi
 }
 //--------------------------------------------------------------
 //--------------------------------------------------------------
+//  Nearest multiple of the quantization step q (no-op for q = 0)
+static inline double quantized(const double x, const double q) {
+    return (q > 0.) ? q * nearbyint(x/q) : x;
+}
+//--------------------------------------------------------------
+//  Quantization step of a lossy dump. It is a power of two no 
+//  larger than twice the tolerance, so that the error stays 
+//  within the tolerance and the low mantissa bits of every 
+//  value are zero, which shuffle/deflate then squeeze out.
+double Export_Files::Xport::quantum(const std::string tag, const double max_abs) {
+
+    if (!Lossy[tag] || !(Input::List().h5_lossy_tolerance > 0.)) return 0.;
+
+    double tol(Input::List().h5_lossy_tolerance);
+    if (Input::List().h5_lossy_relative) tol *= max_abs;
+    if (!(tol > 0.)) return 0.;
+
+    return pow(2., floor(log2(2.*tol)));
+}
+//--------------------------------------------------------------
+//  Create the main dataset of a file, chunked and deflated if 
+//  the class of the tag asks for it. The step of a quantized 
+//  dataset and the resulting error bound go in its attributes.
+HighFive::DataSet Export_Files::Xport::create_dataset(HighFive::Group &dump, const std::string tag, 
+    const std::vector<size_t> &dims, const double q) {
+
+    size_t n(1);
+    for (size_t d(0); d < dims.size(); ++d) n *= dims[d];
+
+    if (Deflate[tag] > 0 && n > 0 && H5Zfilter_avail(H5Z_FILTER_DEFLATE) > 0)
+    {
+    //  Chunks of at most 2^16 doubles, so that one fits in the default chunk cache
+        vector<hsize_t> hdims(dims.begin(), dims.end()), chunk(hdims);
+        size_t d(0);
+        while (n > (1 << 16) && d < chunk.size())
+        {
+            if (chunk[d] > 1) 
+            {
+                n /= chunk[d];
+                chunk[d] = (chunk[d]+1)/2;
+                n *= chunk[d];
+            }
+            else ++d;
+        }
+
+        hid_t space(H5Screate_simple(hdims.size(), &hdims[0], NULL));
+        hid_t dcpl(H5Pcreate(H5P_DATASET_CREATE));
+        H5Pset_chunk(dcpl, chunk.size(), &chunk[0]);
+        if (Input::List().h5_shuffle) H5Pset_shuffle(dcpl);
+        H5Pset_deflate(dcpl, Deflate[tag]);
+        hid_t dset(H5Dcreate2(dump.getId(), tag.c_str(), H5T_NATIVE_DOUBLE, space, H5P_DEFAULT, dcpl, H5P_DEFAULT));
+        H5Dclose(dset);
+        H5Pclose(dcpl);
+        H5Sclose(space);
+    }
+    else dump.createDataSet<double>(tag, HighFive::DataSpace(dims));
+
+    HighFive::DataSet dataset = dump.getDataSet(tag);
+
+    if (q > 0.) 
+    {
+        double maxerr(0.5*q);
+        HighFive::Attribute aq = dataset.createAttribute<double>("quantum", HighFive::DataSpace::From(q));
+        aq.write(q);
+        HighFive::Attribute ae = dataset.createAttribute<double>("max_abs_error", HighFive::DataSpace::From(maxerr));
+        ae.write(maxerr);
+    }
+    return dataset;
+}
+//--------------------------------------------------------------
+//--------------------------------------------------------------
 void Export_Files::Xport:: Export_h5(const std::string tag,
  std::vector<double> &axis1, std::vector<double> &data,
  const size_t  step, const double  time, const double  dt,
@@ -6973,8 +6466,6 @@ void Export_Files::Xport:: Export_h5(const std::string tag,
 //  Export data to H5 file
 //--------------------------------------------------------------
 
-    string      filename(Hdr[tag].Directory());
-
     //  Check Header file correctness
     // if (Hdr[tag].dim() != 1) {
     //     cout << "ERROR "<< tag <<" : "  << Hdr[tag].dim() << " dimensions != 1D structure\n";
@@ -6982,22 +6473,30 @@ void Export_Files::Xport:: Export_h5(const std::string tag,
     // }
 
     //  Open File
-    filename.append(tag).append(oH5Fextension(step,spec));
-    // we create a new hdf5 file
-    HighFive::File file(filename, HighFive::File::ReadWrite | HighFive::File::Create | HighFive::File::Truncate);
+    HighFive::Group dump(dump_group(tag, step, spec, true));
 
     // lets create a dataset of native double with the size of the vector
     // 'data'
+    double max_abs(0.);
+    for (size_t i(0); i < data.size(); ++i) max_abs = max(max_abs, fabs(data[i]));
+    double q(quantum(tag, max_abs));
+
     HighFive::DataSet dataset =
-        file.createDataSet<double>(tag, HighFive::DataSpace::From(data));
+        create_dataset(dump, tag, std::vector<size_t>(1, data.size()), q);
 
     // lets write our vector of double to the HDF5 dataset
-    dataset.write(data);
+    if (q > 0.) 
+    {
+        vector<double> qdata(data);
+        for (size_t i(0); i < qdata.size(); ++i) qdata[i] = quantized(qdata[i], q);
+        dataset.write(qdata);
+    }
+    else dataset.write(data);
 
     add_time_attributes(dataset,tag,time,dt);
     add_fundamental_attributes(dataset,tag);
 
-    HighFive::Group Axes = file.createGroup("Axes");
+    HighFive::Group Axes = dump.createGroup("Axes");
 
     HighFive::DataSet dataset_axis1 =
         Axes.createDataSet<double>("Axis1", HighFive::DataSpace::From(axis1));
@@ -7016,33 +6515,27 @@ void Export_Files::Xport:: Export_h5(const std::string tag,
 //  Export data to H5 file
 //--------------------------------------------------------------
 
-    string      filename(Hdr[tag].Directory());
-
     //  Check Header file correctness
     // if (Hdr[tag].dim() != 2) {
     //     cout << "ERROR "<< tag <<" : "  << Hdr[tag].dim() << " dimensions != 2D structure\n";
     //     exit(1);
     // }
-    // std::cout << "\n filename = " << filename << "\n";
     //  Open File
-    filename.append(tag).append(oH5Fextension(step,spec));
-    // we create a new hdf5 file
-    HighFive::File file(filename, HighFive::File::ReadWrite | HighFive::File::Create | HighFive::File::Truncate);
+    HighFive::Group dump(dump_group(tag, step, spec, true));
 
     // lets create a dataset of native double with the size of the Array2D
     // 'data'
     vector<double> dummyvec(dataA.dim2());
     vector<vector<double> > data;
 
-
-    // exit(1);
+    double q(quantum(tag, (dataA.dim() > 0) ? abs(dataA.array()).max() : 0.));
     
     for (size_t i(0); i < dataA.dim1(); ++i)
     {
         for (size_t j(0); j < dataA.dim2(); ++j)
         {
             // std::cout << "(i,j) = " << i << "," << j << "\n";
-            dummyvec[j] = dataA(i,j);
+            dummyvec[j] = quantized(dataA(i,j), q);
         }
 
         data.push_back(dummyvec);
@@ -7055,8 +6548,7 @@ void Export_Files::Xport:: Export_h5(const std::string tag,
     dims[1] = dataA.dim2();
     
     
-    HighFive::DataSet dataset =
-        file.createDataSet<double>(tag, HighFive::DataSpace(dims));
+    HighFive::DataSet dataset = create_dataset(dump, tag, dims, q);
 
     // lets write our vector of double to the HDF5 dataset
     dataset.write(data);
@@ -7064,7 +6556,7 @@ void Export_Files::Xport:: Export_h5(const std::string tag,
     add_time_attributes(dataset,tag,time,dt);
     add_fundamental_attributes(dataset,tag);
 
-    HighFive::Group Axes = file.createGroup("Axes");
+    HighFive::Group Axes = dump.createGroup("Axes");
 
     HighFive::DataSet dataset_axis1 =
         Axes.createDataSet<double>("Axis1", HighFive::DataSpace::From(axis1));
@@ -7086,8 +6578,6 @@ void Export_Files::Xport:: Export_h5(const std::string tag,
 //  Export data to H5 file
 //--------------------------------------------------------------
 
-    string      filename(Hdr[tag].Directory());
-
     //  Check Header file correctness
     // if (Hdr[tag].dim() != 3) {
     //     cout << "ERROR "<< tag <<" : "  << Hdr[tag].dim() << " dimensions != 3D structure\n";
@@ -7095,9 +6585,7 @@ void Export_Files::Xport:: Export_h5(const std::string tag,
     // }
 
     //  Open File
-    filename.append(tag).append(oH5Fextension(step,spec));
-    // we create a new hdf5 file
-    HighFive::File file(filename, HighFive::File::ReadWrite | HighFive::File::Create | HighFive::File::Truncate);
+    HighFive::Group dump(dump_group(tag, step, spec, true));
 
     // lets create a dataset of native double with the size of the vector
     // 'data'
@@ -7106,13 +6594,15 @@ void Export_Files::Xport:: Export_h5(const std::string tag,
     vector<vector<double> > dummyvec2(dataA.dim2());
     vector<vector<vector<double> > > data;
 
+    double q(quantum(tag, (dataA.dim() > 0) ? abs(dataA.array()).max() : 0.));
+
     for (size_t i(0); i < dataA.dim1(); ++i)
     {
         for (size_t j(0); j < dataA.dim2(); ++j)
         {
             for (size_t k(0); k < dataA.dim3(); ++k)
             {
-                dummyvec[k] = dataA(i,j,k);
+                dummyvec[k] = quantized(dataA(i,j,k), q);
             }
             dummyvec2[j] = dummyvec;
         }
@@ -7124,8 +6614,7 @@ void Export_Files::Xport:: Export_h5(const std::string tag,
     dims[1] = dataA.dim2();
     dims[2] = dataA.dim3();
     
-    HighFive::DataSet dataset =
-        file.createDataSet<double>(tag, HighFive::DataSpace(dims));
+    HighFive::DataSet dataset = create_dataset(dump, tag, dims, q);
 
     // lets write our vector of double to the HDF5 dataset
     dataset.write(data);
@@ -7136,7 +6625,7 @@ void Export_Files::Xport:: Export_h5(const std::string tag,
     add_time_attributes(dataset,tag,time,dt);
     add_fundamental_attributes(dataset,tag);
 
-    HighFive::Group Axes = file.createGroup("Axes");
+    HighFive::Group Axes = dump.createGroup("Axes");
 
     HighFive::DataSet dataset_axis1 =
         Axes.createDataSet<double>("Axis1", HighFive::DataSpace::From(axis1));
@@ -7163,8 +6652,6 @@ void Export_Files::Xport:: Export_h5(const std::string tag,
 //  Export data to H5 file
 //--------------------------------------------------------------
 
-    string      filename(Hdr[tag].Directory());
-
     //  Check Header file correctness
     // if (Hdr[tag].dim() != 3) {
     //     cout << "ERROR "<< tag <<" : "  << Hdr[tag].dim() << " dimensions != 3D structure\n";
@@ -7172,9 +6659,7 @@ void Export_Files::Xport:: Export_h5(const std::string tag,
     // }
 
     //  Open File
-    filename.append(tag).append(oH5Fextension(step,spec));
-    // we create a new hdf5 file
-    HighFive::File file(filename, HighFive::File::ReadWrite | HighFive::File::Create | HighFive::File::Truncate);
+    HighFive::Group dump(dump_group(tag, step, spec, true));
 
     // lets create a dataset of native double with the size of the vector
     // 'data'
@@ -7184,15 +6669,17 @@ void Export_Files::Xport:: Export_h5(const std::string tag,
     vector<vector<vector<double> > > dummyvec3(dataA.dim2());
     vector<vector<vector<vector<double> > > > data;
 
+    double q(quantum(tag, (dataA.dim() > 0) ? abs(dataA.array()).max() : 0.));
+
     for (size_t i(0); i < dataA.dim1(); ++i)
     {
         for (size_t j(0); j < dataA.dim2(); ++j)
         {
             for (size_t k(0); k < dataA.dim3(); ++k)
             {
-                for (size_t l(0); k < dataA.dim4(); ++l)
+                for (size_t l(0); l < dataA.dim4(); ++l)
                 {
-                    dummyvec[l] = dataA(i,j,k,l);
+                    dummyvec[l] = quantized(dataA(i,j,k,l), q);
                 }
                 dummyvec2[k] = dummyvec;
             }
@@ -7207,8 +6694,7 @@ void Export_Files::Xport:: Export_h5(const std::string tag,
     dims[2] = dataA.dim3();
     dims[3] = dataA.dim4();
     
-    HighFive::DataSet dataset =
-        file.createDataSet<double>(tag, HighFive::DataSpace(dims));
+    HighFive::DataSet dataset = create_dataset(dump, tag, dims, q);
 
     // lets write our vector of double to the HDF5 dataset
     dataset.write(data);
@@ -7219,7 +6705,7 @@ void Export_Files::Xport:: Export_h5(const std::string tag,
     add_time_attributes(dataset,tag,time,dt);
     add_fundamental_attributes(dataset,tag);
 
-    HighFive::Group Axes = file.createGroup("Axes");
+    HighFive::Group Axes = dump.createGroup("Axes");
 
     HighFive::DataSet dataset_axis1 =
         Axes.createDataSet<double>("Axis1", HighFive::DataSpace::From(axis1));
@@ -7240,70 +6726,187 @@ void Export_Files::Xport:: Export_h5(const std::string tag,
 }
 //--------------------------------------------------------------
 //--------------------------------------------------------------
-//--------------------------------------------------------------
-void Export_Files::Xport:: Export_h5(const std::string tag,
- std::vector<double> &axis1, std::vector<double> &axis2, std::vector<double> &axis3, vector<vector<vector<double> > >  &container_of_data_for_all_local_x,
+void Export_Files::Xport:: Create_h5(const std::string tag,
+ vector< vector<double> > &axes,
  const size_t  step, const double  time, const double  dt,
- const int rank, const int NxLocal, const int spec)
-{
+ const int spec, const double max_abs){
 //--------------------------------------------------------------
-//  Export data to H5 file
+//  Same layout as Export_h5, but the dataset is left for 
+//  Write_h5 to fill so that no rank holds the global array
 //--------------------------------------------------------------
 
-    string      filename(Hdr[tag].Directory());
-
-    //  Open File
-    filename.append(tag).append(oH5Fextension(step,spec));
-    // we create a new hdf5 file
-    HighFive::File file(filename, HighFive::File::ReadWrite | HighFive::File::Create | HighFive::File::Truncate,
-            HighFive::MPIOFileDriver(MPI_COMM_WORLD, MPI_INFO_NULL));
+    HighFive::Group dump(dump_group(tag, step, spec, true));
 
-    // lets create a dataset of native double with the size of the vector
-    // 'data'
-    std::vector<size_t> dims(3);
+    std::vector<size_t> dims(axes.size());
+    for (size_t d(0); d < axes.size(); ++d) dims[d] = axes[d].size();
 
-    dims[0] = axis1.size();
-    dims[1] = axis2.size();
-    dims[2] = axis3.size();
-    
-    vector<size_t> offset;
-    offset.push_back(size_t(rank*NxLocal));
-    offset.push_back(0);
-    offset.push_back(0);
+    Quantum[tag] = quantum(tag, max_abs);
+    HighFive::DataSet dataset = create_dataset(dump, tag, dims, Quantum[tag]);
 
-    
-    HighFive::DataSet dataset =
-        file.createDataSet<double>(tag, HighFive::DataSpace(dims));
-
-    // Each node want to write its own rank two time in
-    // its associated row
-    vector<size_t> writedomain;
-    writedomain.push_back(NxLocal);
-    writedomain.push_back(dims[1]);
-    writedomain.push_back(dims[2]);
-    
-    dataset.select(offset, writedomain).write(container_of_data_for_all_local_x);
-    
-    /// Attributes
-    /// Only a few defined for now
-    /// dt, time
     add_time_attributes(dataset,tag,time,dt);
     add_fundamental_attributes(dataset,tag);
 
-    HighFive::Group Axes = file.createGroup("Axes");
+    HighFive::Group Axes = dump.createGroup("Axes");
 
-    HighFive::DataSet dataset_axis1 =
-        Axes.createDataSet<double>("Axis1", HighFive::DataSpace::From(axis1));
-    dataset_axis1.write(axis1);
+    for (size_t d(0); d < axes.size(); ++d)
+    {
+        stringstream axisname;
+        axisname << "Axis" << d+1;
+        HighFive::DataSet dataset_axis =
+            Axes.createDataSet<double>(axisname.str(), HighFive::DataSpace::From(axes[d]));
+        dataset_axis.write(axes[d]);
+    }
+}
+//--------------------------------------------------------------
+void Export_Files::Xport:: Write_h5(const std::string tag,
+ const vector<size_t> &start, const vector<size_t> &count, double* data,
+ const size_t  step, const int spec){
 
-    HighFive::DataSet dataset_axis2 =
+    HighFive::Group dump(dump_group(tag, step, spec, false));
+
+    vector<hsize_t> hstart(start.begin(), start.end());
+    vector<hsize_t> hcount(count.begin(), count.end());
+
+    if (Quantum[tag] > 0.)
+    {
+        size_t n(1);
+        for (size_t d(0); d < count.size(); ++d) n *= count[d];
+        for (size_t i(0); i < n; ++i) data[i] = quantized(data[i], Quantum[tag]);
+    }
+
+    hid_t dset(H5Dopen2(dump.getId(), tag.c_str(), H5P_DEFAULT));
+    hid_t fspace(H5Dget_space(dset));
+    H5Sselect_hyperslab(fspace, H5S_SELECT_SET, &hstart[0], NULL, &hcount[0], NULL);
+    hid_t mspace(H5Screate_simple(hcount.size(), &hcount[0], NULL));
+    H5Dwrite(dset, H5T_NATIVE_DOUBLE, mspace, fspace, H5P_DEFAULT, data);
+
+    H5Sclose(mspace);
+    H5Sclose(fspace);
+    H5Dclose(dset);
+}
+//--------------------------------------------------------------
+//--------------------------------------------------------------
+//  Grow the first dimension of an extendible dataset and write
+//  the new rows, given in row-major order, at its end
+static void extend_h5(hid_t loc, const std::string name, const double* rows_data, 
+    const hsize_t nrows, const hsize_t ncols, const int rank) {
+
+    hid_t dset(H5Dopen2(loc, name.c_str(), H5P_DEFAULT));
+    hid_t fspace(H5Dget_space(dset));
+    hsize_t dims[2];
+    H5Sget_simple_extent_dims(fspace, dims, NULL);
+    H5Sclose(fspace);
+
+    hsize_t start[2] = {dims[0], 0};
+    hsize_t count[2] = {nrows, ncols};
+    dims[0] += nrows;
+    H5Dset_extent(dset, dims);
+
+    fspace = H5Dget_space(dset);
+    H5Sselect_hyperslab(fspace, H5S_SELECT_SET, start, NULL, count, NULL);
+    hid_t mspace(H5Screate_simple(rank, count, NULL));
+    H5Dwrite(dset, H5T_NATIVE_DOUBLE, mspace, fspace, H5P_DEFAULT, rows_data);
+
+    H5Sclose(mspace);
+    H5Sclose(fspace);
+    H5Dclose(dset);
+}
+//--------------------------------------------------------------
+static void create_extendible_h5(hid_t loc, const std::string name, const hsize_t ncols, const int rank,
+    const int deflate = 0) {
+
+    hsize_t dims[2]    = {0, ncols};
+    hsize_t maxdims[2] = {H5S_UNLIMITED, ncols};
+    hsize_t chunk[2]   = {Input::List().hist_buffer_steps, ncols};
+
+    hid_t space(H5Screate_simple(rank, dims, maxdims));
+    hid_t dcpl(H5Pcreate(H5P_DATASET_CREATE));
+    H5Pset_chunk(dcpl, rank, chunk);
+    if (deflate > 0 && H5Zfilter_avail(H5Z_FILTER_DEFLATE) > 0)
+    {
+        if (Input::List().h5_shuffle) H5Pset_shuffle(dcpl);
+        H5Pset_deflate(dcpl, deflate);
+    }
+    hid_t dset(H5Dcreate2(loc, name.c_str(), H5T_NATIVE_DOUBLE, space, H5P_DEFAULT, dcpl, H5P_DEFAULT));
+
+    H5Dclose(dset);
+    H5Pclose(dcpl);
+    H5Sclose(space);
+}
+//--------------------------------------------------------------
+//--------------------------------------------------------------
+void Export_Files::Xport:: Append_h5(const std::string tag,
+ std::vector<double> &axis1, std::vector<double> &axis2, Array2D<double> &dataA,
+ const double  dt, const int spec){
+//--------------------------------------------------------------
+//  Append rows to a single time-history file. The file is 
+//  created on the first call of a fresh run; a restarted run 
+//  reopens it and drops the rows it is about to recompute, and
+//  so does a later parareal time slice.
+//--------------------------------------------------------------
+
+    string      filename(Hdr[tag].Directory());
+    stringstream sFilename;
+    if(spec >= 0) sFilename << "_s" << spec;
+    sFilename << ofconventions::h5file_extension;
+    filename.append(tag).append(sFilename.str());
+
+    struct stat buf;
+    bool reopen(Appending[tag] || ((Input::List().isthisarestart || (Time_Decomposition::Slice() > 0)) && stat(filename.c_str(), &buf) == 0));
+
+    if (!reopen)
+    {
+        HighFive::File file(filename, HighFive::File::ReadWrite | HighFive::File::Create | HighFive::File::Truncate);
+
+        create_extendible_h5(file.getId(), tag, axis2.size(), 2, Deflate[tag]);
+
+        HighFive::Group Axes = file.createGroup("Axes");
+        create_extendible_h5(Axes.getId(), "Axis1", 1, 1);
+
+        HighFive::DataSet dataset_axis2 =
         Axes.createDataSet<double>("Axis2", HighFive::DataSpace::From(axis2));
-    dataset_axis2.write(axis2);
+        dataset_axis2.write(axis2);
 
-    HighFive::DataSet dataset_axis3 =
-        Axes.createDataSet<double>("Axis3", HighFive::DataSpace::From(axis3));
-    dataset_axis3.write(axis3);
-    
+        HighFive::DataSet dataset = file.getDataSet(tag);
+        HighFive::Attribute adt = dataset.createAttribute<double>("dt", HighFive::DataSpace::From(dt));
+        adt.write(dt);
+        add_fundamental_attributes(dataset,tag);
+    }
+
+    HighFive::File file(filename, HighFive::File::ReadWrite);
+    HighFive::Group Axes = file.getGroup("Axes");
+
+//  Discard samples from a previous run that lie past the restart point
+    if (!Appending[tag] && !axis1.empty())
+    {
+        vector<double> told;
+        Axes.getDataSet("Axis1").read(told);
+
+        size_t keep(0);
+        while (keep < told.size() && told[keep] < axis1[0] - 0.5*dt) ++keep;
+
+        if (keep < told.size())
+        {
+            hsize_t tdims[1] = {keep};
+            hid_t tset(H5Dopen2(Axes.getId(), "Axis1", H5P_DEFAULT));
+            H5Dset_extent(tset, tdims);
+            H5Dclose(tset);
+
+            hsize_t ddims[2] = {keep, axis2.size()};
+            hid_t dset(H5Dopen2(file.getId(), tag.c_str(), H5P_DEFAULT));
+            H5Dset_extent(dset, ddims);
+            H5Dclose(dset);
+        }
+    }
+    Appending[tag] = true;
+
+    vector<double> rows(dataA.dim1()*dataA.dim2());
+    for (size_t i(0); i < dataA.dim1(); ++i)
+        for (size_t j(0); j < dataA.dim2(); ++j)
+            rows[i*dataA.dim2()+j] = dataA(i,j);
+
+    extend_h5(file.getId(), tag, &rows[0], dataA.dim1(), dataA.dim2(), 2);
+    extend_h5(Axes.getId(), "Axis1", &axis1[0], axis1.size(), 1, 1);
 }
 //--------------------------------------------------------------------------------------------------------------------------
 //--------------------------------------------------------------------------------------------------------------------------
@@ -157,10 +157,10 @@ ofstream& operator<<(ofstream& s, const Array4D<T>& array4D) {
               const vector< string > oTags,
               string homedir=""); 
 
+//          Grow the (time, axis2) dataset of a single file by the rows in dataA
             void Append_h5(const std::string tag, std::vector<double> &axis1, 
-                std::vector<double> &data, 
-                const size_t step, const double time, const double dt,
-                const int spec = -1);
+                std::vector<double> &axis2, Array2D<double> &dataA,
+                const double dt, const int spec = -1);
 
             void Export_h5(const std::string tag, std::vector<double> &axis1, 
                 std::vector<double> &data, 
@@ -179,17 +179,23 @@ ofstream& operator<<(ofstream& s, const Array4D<T>& array4D) {
                 const size_t  step, const double time, const double dt,
                 const int spec = -1);
 
-            void Export_h5(const std::string tag, 
-                std::vector<double> &axis1, std::vector<double> &axis2, std::vector<double> &axis3, 
-                vector<vector<vector<double> > > &data_for_all_local_x,
-                const size_t step, const double time, const double dt, const int rank, const int n_ranks,
-                const int spec = -1);
-
             void Export_h5(const std::string tag, 
                 std::vector<double> &axis1, std::vector<double> &axis2, std::vector<double> &axis3, std::vector<double> &axis4, 
                 Array4D<double> &dataA, 
                 const size_t  step, const double time, const double dt,
                 const int spec = -1);
+
+//          Lay out a file whose dataset is written afterwards, block by block;
+//          max_abs is the largest |value| to be written, for lossy output
+            void Create_h5(const std::string tag, vector< vector<double> > &axes, 
+                const size_t step, const double time, const double dt,
+                const int spec = -1, const double max_abs = 0.);
+
+//          Write a block, given in file order, into a dataset made by Create_h5.
+//          Lossy output quantizes data in place.
+            void Write_h5(const std::string tag, const vector<size_t> &start, 
+                const vector<size_t> &count, double* data, 
+                const size_t step, const int spec = -1);
             
             void add_time_attributes(HighFive::DataSet &dataset, const std::string tag, 
                 const double time, const double dt);
@@ -198,7 +204,18 @@ ofstream& operator<<(ofstream& s, const Array4D<T>& array4D) {
 
         private:
             map< string, Header > Hdr; // Dictionary of headers
+            map< string, bool >   Appending; // Files already opened for appending by this run
+            map< string, int >    Deflate;   // Deflate level of the class of each tag
+            map< string, bool >   Lossy;     // Distribution dumps may be quantized
+            map< string, double > Quantum;   // Quantization step of the file Write_h5 fills
+            map< string, bool >   Opened;    // Consolidated files already opened by this run
             string oH5Fextension(size_t step, int species = -1);
+            HighFive::Group dump_group(const std::string tag, const size_t step, const int spec, 
+                const bool create);
+
+            double quantum(const std::string tag, const double max_abs);
+            HighFive::DataSet create_dataset(HighFive::Group &dump, const std::string tag, 
+                const std::vector<size_t> &dims, const double q);
 
         };
 //--------------------------------------------------------------
@@ -215,9 +232,30 @@ ofstream& operator<<(ofstream& s, const Array4D<T>& array4D) {
             void Read(const int rank, const size_t re_step, State2D& Y, double time_start);
             void Write(const int rank, const size_t re_step, State2D& Y, double time_dump);
 
+//          In-memory checkpoints, collective over the spatial ranks. Each rank keeps 
+//          its last copy and that of the rank before it in the ring of buddy_ring(),
+//          mirrored in buddy_dir.
+//          With to_disk the own copy is also kept in the restart folder.
+            void Write_Buddy(const size_t re_step, State1D& Y, const double time_dump, const bool to_disk);
+            void Read_Buddy(size_t& re_step, State1D& Y, double& time_start);
+
         private:
             string hdir;
-            string rFextension(const int rank, const size_t rstep);
+            valarray< complex<double> > own_copy, held_copy;     ///< (time, step), then f and fields
+            vector<int> buddy_next;                               ///< Rank that holds the copy of each rank
+            void buddy_ring(MPI_Comm comm, vector<int>& next);
+            string buddy_file(const string dir, const int owner, const int holder);
+            string rFextension(const int rank, const size_t rstep, 
+                const string extension = ofconventions::rfile_extension);
+
+//          Read files written with different x-slabs
+            void Read_Remapped(const int rank, const size_t re_step, State1D& Y, const vector<size_t>& old_slabs);
+
+//          Deflated h5 restart files, one flat dataset per harmonic and field
+            void Write_h5(const string filename, State1D& Y, double time_dump);
+            void Write_h5(const string filename, State2D& Y, double time_dump);
+            void Read_h5(const string filename, State1D& Y);
+            void Read_h5(const string filename, State2D& Y);
         }; 
 //--------------------------------------------------------------
     }
@@ -274,7 +312,9 @@ ofstream& operator<<(ofstream& s, const Array4D<T>& array4D) {
             Array2D<double> p1p2(DistFunc1D& df, size_t x0, size_t s) ;
             Array2D<double> p2p3(DistFunc1D& df, size_t x0, size_t s) ;
             Array2D<double> p1p3(DistFunc1D& df, size_t x0, size_t s) ;
-            void p1p2p3(DistFunc1D& df, size_t x0, size_t s) ;
+
+            // 3P at a single point
+            Array3D<double> p1p2p3(DistFunc1D& df, size_t x0, size_t s) ;
 
             // 1P, integrate over x or y
             // valarray<double> p1(size_t integrationdimension, DistFunc2D& df, size_t x0, size_t s) ;
@@ -309,6 +349,21 @@ ofstream& operator<<(ofstream& s, const Array4D<T>& array4D) {
             vector<Array2D<double> >    p_cylindrical_polar_radius_squared;
             vector<Array2D<double> >    px_over_p;
 
+            // Tables for p1, P_l(px/p) at (l, p, px)
+            vector<Array3D<double> >    p1_legendre;
+            vector<valarray<size_t> >   p1_first;           ///< First |p| cell with p >= |px|
+
+            // Tables for the (px,py,pz) reconstruction
+            bool                        cartesian;
+            void cartesian_tables(size_t s);
+            vector<Array3D<double> >    cart_legendre;      ///< P_l^m(px/p) at (lm, p, px), px/p clipped to [-1,1]
+            vector<Array3D<double> >    cart_cosm, cart_sinm; ///< cos/sin(m phi) at (m, py, pz)
+
+            // G_m(px,p) = sum_l f_lm(p) P_l^m(px/p) at one position
+            void cylindrical(DistFunc1D& df, size_t x0, size_t s, vector<Array2D<complex<double> > >& G);
+            // f(px,py) at a single pz, interpolated in |p| from G_m
+            void pzplane(const vector<Array2D<complex<double> > >& G, size_t s, size_t ipz, Array2D<double>& f);
+
             // vector< PLegendre2D     >  PL2D;
             // vector< valarray<double>  >  pout1D_p1, pout1D_p2, pout1D_p3;
             // vector< Array2D<double>  >  pout2D_p1p2, pout2D_p1p3, pout2D_p2p3;
@@ -360,6 +415,93 @@ ofstream& operator<<(ofstream& s, const Array4D<T>& array4D) {
        };
 //--------------------------------------------------------------
 
+//--------------------------------------------------------------
+//  Velocity moments of f00, f10 and f11 for every local cell,
+//  integrated in one pass over (x,p) with trapezoidal p^k*dp
+//  weights that are built once per species
+//--------------------------------------------------------------
+        class momentengine {
+//--------------------------------------------------------------        
+        public:
+//      Constructor/Destructor
+            momentengine(const Grid_Info& _G);
+            ~momentengine(){}
+
+//      Integrate the requested harmonics of Y
+            void operator()(const State1D& Y, bool use_f00, bool use_f10, bool use_f11);
+
+//      Access, k is the power of p and ix the local cell without guards
+            double f00(size_t s, size_t k, size_t ix)    const { return m00[s](k,ix); }
+            double f10(size_t s, size_t k, size_t ix)    const { return m10[s](k,ix); }
+            double f11re(size_t s, size_t k, size_t ix)  const { return m11re[s](k,ix); }
+            double f11im(size_t s, size_t k, size_t ix)  const { return m11im[s](k,ix); }
+
+        private:
+            static const size_t kmax = 7;
+
+            vector<Array2D<double> >    weights;        ///< (ip,k) p^k*dp
+            vector<Array2D<double> >    m00, m10, m11re, m11im;
+        };
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+//  Fixed number of samples of a time history. The buffer is
+//  emptied into the h5 file whenever it fills up, so the
+//  memory does not depend on the output interval. While the
+//  histories are held, full buffers go to a scratch file and
+//  are read back in order once they are released.
+//--------------------------------------------------------------
+        class historybuffer {
+//--------------------------------------------------------------        
+        public:
+            historybuffer(size_t _width, size_t _capacity);
+
+            void push(const valarray<double>& sample, double t);
+            void clear()                        { rows = 0; t_samples.clear(); }
+
+            void spill(const std::string fname);                ///< Append the full buffer to fname and empty it
+            void reload(const std::string fname, size_t chunk); ///< Read back the chunk-th spilled buffer
+            void drop(const std::string fname);                 ///< Remove the scratch file
+            size_t spilled()              const { return nspilled; }
+
+            bool   full()                 const { return rows == capacity; }
+            size_t size()                 const { return rows; }
+            size_t width()                const { return w; }
+            double* data()                      { return (buf.size() > 0) ? &(buf[0]) : NULL; }
+            vector<double>& times()             { return t_samples; }
+
+        private:
+            size_t              w, capacity, rows, nspilled;
+            valarray<double>    buf;            ///< rows x w, row-major
+            vector<double>      t_samples;
+        };
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+//  Output selection of a tag from the deck: every sx-th of the
+//  global cells [i0, i1) and every sp-th momentum. Ranks pack
+//  only the selected values before anything is communicated.
+//--------------------------------------------------------------
+        class outwindow {
+//--------------------------------------------------------------        
+        public:
+            outwindow(const std::string tag, const valarray<double>& xglobal);
+
+            size_t first(size_t offset)           const;  ///< First selected cell >= offset
+            size_t count(size_t offset, size_t n) const;  ///< Selected cells in [offset, offset+n)
+            size_t start(size_t offset)           const { return (first(offset) - i0)/sx; }
+            size_t Np(size_t n)                   const { return (n + sp - 1)/sp; }
+
+            vector<double> x(const valarray<double>& xglobal) const;
+            vector<double> p(const valarray<double>& paxis)   const;
+
+            size_t sx, sp;
+
+        private:
+            size_t i0, i1;
+        };
+//--------------------------------------------------------------
+
 //--------------------------------------------------------------
 //  Output Functor
        class Output_Preprocessor {
@@ -369,7 +511,8 @@ ofstream& operator<<(ofstream& s, const Array4D<T>& array4D) {
         Output_Preprocessor(const Grid_Info& _grid, 
          const vector< string > _oTags, 
          string homedir="")  
-        : expo( _grid.axis, _oTags, homedir), p_x( _grid),f_x( _grid),oTags(_oTags) { }
+        : expo( _grid.axis, _oTags, homedir), p_x( _grid),f_x( _grid),moments( _grid),oTags(_oTags),
+          hist_calls(0), hist_hold(false) { }
 
 //      Functor
         void operator()(const State1D& Y, const Grid_Info& grid, const size_t tout, const double time, const double dt,
@@ -386,11 +529,15 @@ ofstream& operator<<(ofstream& s, const Array4D<T>& array4D) {
         void bigdistdump(const State2D& Y, const Grid_Info& grid, const size_t tout, const double time, const double dt,
             const Parallel_Environment_2D& PE);
 
-        void histdump(vector<valarray<double> >& fieldhistory, vector<double>& time_history, const Grid_Info& grid, const size_t tout, const double time, const double dt,
-            const Parallel_Environment_1D& PE, std::string tag);
-
-        void histdump(vector<valarray<complex<double> > >& fieldhistory, vector<double>& time_history, const Grid_Info& grid, const size_t tout, const double time, const double dt,
-            const Parallel_Environment_1D& PE, std::string tag);
+//      Streaming 1D time histories
+        bool histsample();
+        void histrecord(const std::string tag, const valarray<complex<double> >& field, const double time, const double dt,
+            const Grid_Info& grid, const Parallel_Environment_1D& PE);
+        void histrecord(const std::string tag, const valarray<double>& rank_sum, const double time, const double dt,
+            const Grid_Info& grid, const Parallel_Environment_1D& PE);
+        void histflush(const Grid_Info& grid, const double dt, const Parallel_Environment_1D& PE);
+//      Keep the histories in memory, e.g. until the earlier time slices have appended theirs
+        void histhold(const bool hold) { hist_hold = hold; }
 
         void histdump(vector<Array2D<complex<double> > >& fieldhistory, vector<double>& time_history, const Grid_Info& grid, const size_t tout, const double time, const double dt,
             const Parallel_Environment_2D& PE, std::string tag);
@@ -410,7 +557,27 @@ ofstream& operator<<(ofstream& s, const Array4D<T>& array4D) {
         Export_Files::Xport             expo;
         fulldist                        p_x;
         harmonicvsposition              f_x;
+        momentengine                    moments;
         vector< string >                oTags;
+
+        size_t                          hist_calls;
+        bool                            hist_hold;
+        map< string, historybuffer >    histories;
+        map< string, bool >             hist_summed;    ///< Partial sums over the ranks, e.g. fhat0
+
+        void histflush(const std::string tag, const Grid_Info& grid, const double dt, const Parallel_Environment_1D& PE);
+        void histappend(const std::string tag, historybuffer& hb, const Grid_Info& grid, const double dt, const Parallel_Environment_1D& PE);
+        std::string histscratch(const std::string tag) const;
+
+        // Stream the x-slab (1D) or tile (2D) of every rank through buf into the file
+        void slabdump(const std::string tag, vector< vector<double> >& axes, const size_t xdim, valarray<double>& buf,
+            const outwindow& w, const size_t tout, const double time, const double dt, const int s, 
+            const Parallel_Environment_1D& PE);
+        void slabdump(const std::string tag, vector< vector<double> >& axes, const size_t xdim, valarray<double>& buf,
+            const size_t tout, const double time, const double dt, const int s, const Parallel_Environment_2D& PE);
+        // Same for one value per interior cell of the 1D slab
+        void xdump(const std::string tag, const valarray<double>& xbuf, const Grid_Info& grid,
+            const size_t tout, const double time, const double dt, const int s, const Parallel_Environment_1D& PE);
         
         // Fields
         void Ex(const State1D& Y, const Grid_Info& grid, const size_t tout, const double time, const double dt,
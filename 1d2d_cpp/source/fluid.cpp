@@ -34,15 +34,13 @@
 /// Constructor for hydro equations
 //-------------------------------------------------------------------------------------------------------------------------------------------------------
 Hydro_Functor::Hydro_Functor(double xmin, double xmax, size_t numx):
-    idx(numx/(xmax-xmin)), szx(numx), FEQ(xmin,xmax,numx) {}
+    idx(numx/(xmax-xmin)), szx(numx), FEQ(xmin,xmax,numx),
+    electrondensity(0.0,numx), electronpressure(0.0,numx), electroncurrent(3,numx) {}
 //-------------------------------------------------------------------------------------------------------------------------------------------------------
 //-------------------------------------------------------------------------------------------------------------------------------------------------------
 void Hydro_Functor::operator()(const State1D& Yin, State1D& Yslope){
     Yslope = 0.0;
 
-    valarray<double> electronpressure(0.0,szx), electrondensity(0.0, szx);
-    Array2D<double> electroncurrent(3,szx);
-
     electrondensity = Yin.DF(0).getdensity();
     electronpressure = Yin.DF(0).getpressure();
 
@@ -63,7 +61,8 @@ void Hydro_Functor::operator()(const State1D& Yin, State1D& Yslope, double time,
 //  Fluid Equation Class Constructor
 
 Fluid_Equation_1D::Fluid_Equation_1D(double xmin, double xmax, size_t Nx)
-  : idx(Nx/(xmax-xmin)), szx(Nx), dummy(0.0,Nx)
+  : idx(Nx/(xmax-xmin)), szx(Nx), dummy(0.0,Nx),
+    Povern(0.0,Nx), chargeseparation(0.0,Nx), netcurrent(3,Nx)
     {
         Nbc = Input::List().BoundaryCells;
 
@@ -72,143 +71,87 @@ Fluid_Equation_1D::Fluid_Equation_1D(double xmin, double xmax, size_t Nx)
 //------------------------------------------------------------------------------------------
 //------------------------------------------------------------------------------------------
 void Fluid_Equation_1D::density(const Hydro1D& Hin, Hydro1D& Hslope){
-    valarray<double> d_nvx(Hin.densityarray());
-    for (size_t ix(0);ix<szx;++ix)
-        d_nvx[ix] = d_nvx[ix] * Hin.vx(ix);
 
     // d_nvx = df_4thorder(d_nvx);
 
-    Hslope.density(0)       -= idx * d_nvx[0];
-
-    for (size_t ix(1);ix<szx-1;++ix)
+    #pragma omp parallel for num_threads(Input::List().ompthreads)
+    for (size_t ix = 0; ix < szx; ++ix)
     {
-        Hslope.density(ix)  -= idx * d_nvx[ix];
+        Hslope.density(ix)  -= idx * (Hin.density(ix) * Hin.vx(ix));
     }
 
-    Hslope.density(szx - 1) -= idx * d_nvx[szx-1];
-
 }
 //---------------------------------------------------------------------------------------------
 //---------------------------------------------------------------------------------------------
 void Fluid_Equation_1D::chargefraction(const Hydro1D& Hin, Hydro1D& Hslope){
-    valarray<double> d_nZx(Hin.densityarray());
-    for (size_t ix(0);ix<szx;++ix)
-        d_nZx[ix] = d_nZx[ix] * Hin.Z(ix);
 
     // d_nZx = df_4thorder(d_nZx);    
 
-    Hslope.Z(0)       -= idx * d_nZx[0];
-
-    for (size_t ix(1);ix<szx-1;++ix)
+    #pragma omp parallel for num_threads(Input::List().ompthreads)
+    for (size_t ix = 0; ix < szx; ++ix)
     {
-        Hslope.Z(ix)  -= idx * d_nZx[ix];
+        Hslope.Z(ix)  -= idx * (Hin.density(ix) * Hin.Z(ix));
     }
 
-    Hslope.Z(szx - 1) -= idx *  d_nZx[szx-1];
-
 }
 //---------------------------------------------------------------------------------------------
 //---------------------------------------------------------------------------------------------
+//  One pass over the cells for the net pressure, current and charge
+//  separation, and one for the three components of the momentum equation
 void Fluid_Equation_1D::velocity(const State1D& Yin , Hydro1D& Hslope, 
     valarray<double>& electrondensity, valarray<double>& electronpressure, Array2D<double>& electroncurrent){
 
-    double Zeovermi = Yin.HYDRO().charge()/Yin.HYDRO().mass();
-    valarray<double> eventuallynetPovern(Yin.HYDRO().densityarray()), d_vx(Yin.HYDRO().vxarray()), d_vy(Yin.HYDRO().vxarray()), d_vz(Yin.HYDRO().vxarray());
-    valarray<double> eventuallychargeseparation(electronpressure);
-    Array2D<double> netcurrent(3,szx);
-
-
-    for (size_t ix(0);ix<szx;++ix){
-        eventuallynetPovern[ix] = eventuallynetPovern[ix] * Yin.HYDRO().temperature(ix);
-    }
+    const Hydro1D& hydro(Yin.HYDRO());
+    double Zeovermi = hydro.charge()/hydro.mass();
 
     // eventuallynetPovern = df_4thorder(eventuallynetPovern);
     // eventuallychargeseparation = df_4thorder(eventuallychargeseparation);
 
-    for (size_t ix(0);ix<szx;++ix){
+    #pragma omp parallel for num_threads(Input::List().ompthreads)
+    for (size_t ix = 0; ix < szx; ++ix){
 
         // Net pressure
-        eventuallynetPovern[ix] = eventuallynetPovern[ix] / Yin.HYDRO().density(ix) + eventuallychargeseparation[ix] / electrondensity[ix];
+        Povern[ix] = (hydro.density(ix) * hydro.temperature(ix)) / hydro.density(ix) + electronpressure[ix] / electrondensity[ix];
 
         // Net current
-        netcurrent(0,ix) = Yin.HYDRO().Z(ix)*Yin.HYDRO().charge()*Yin.HYDRO().density(ix)*Yin.HYDRO().vx(ix) - electroncurrent(0,ix);
-        netcurrent(1,ix) = Yin.HYDRO().Z(ix)*Yin.HYDRO().charge()*Yin.HYDRO().density(ix)*Yin.HYDRO().vy(ix) - electroncurrent(1,ix);
-        netcurrent(2,ix) = Yin.HYDRO().Z(ix)*Yin.HYDRO().charge()*Yin.HYDRO().density(ix)*Yin.HYDRO().vz(ix) - electroncurrent(2,ix);
+        netcurrent(0,ix) = hydro.Z(ix)*hydro.charge()*hydro.density(ix)*hydro.vx(ix) - electroncurrent(0,ix);
+        netcurrent(1,ix) = hydro.Z(ix)*hydro.charge()*hydro.density(ix)*hydro.vy(ix) - electroncurrent(1,ix);
+        netcurrent(2,ix) = hydro.Z(ix)*hydro.charge()*hydro.density(ix)*hydro.vz(ix) - electroncurrent(2,ix);
 
         // Net charge separation
-        eventuallychargeseparation[ix] = Yin.HYDRO().Z(ix)*Yin.HYDRO().charge()*Yin.HYDRO().density(ix)-electrondensity[ix];
+        chargeseparation[ix] = hydro.Z(ix)*hydro.charge()*hydro.density(ix)-electrondensity[ix];
     }
-    
-    // d_vx = df_4thorder(d_vx);
-    // d_vy = df_4thorder(d_vy);
-    // d_vz = df_4thorder(d_vz);
-
-
-    Hslope.vx(0)  += - idx * eventuallynetPovern[0] / Yin.HYDRO().mass()
-                                    +   Zeovermi * eventuallychargeseparation[0] * (Yin.EMF().Ex()(0).real()
-                                    +   netcurrent(1,0) * Yin.EMF().Bz()(0).real()
-                                    -   netcurrent(2,0) * Yin.EMF().By()(0).real()); //+ Rie/ni;
 
-    Hslope.vx(0) -= netcurrent(0,0) * (idx * d_vx[0]);
-
-    for (size_t ix(1);ix<szx-1;++ix)
+    #pragma omp parallel for num_threads(Input::List().ompthreads)
+    for (size_t ix = 0; ix < szx; ++ix)
     {
+        /// ----------------------------------------------------------------------
+        /// Momentum equation - x direction, one-sided at the edges
+        /// ----------------------------------------------------------------------
+        double half((ix == 0 || ix == szx-1) ? 1.0 : 0.5);
 
-        Hslope.vx(ix)  += -0.5 * idx * eventuallynetPovern[ix] / Yin.HYDRO().mass()
-                                    +   Zeovermi * eventuallychargeseparation[ix] * (Yin.EMF().Ex()(ix).real()
+        Hslope.vx(ix)  += -half * idx * Povern[ix] / hydro.mass()
+                                    +   Zeovermi * chargeseparation[ix] * (Yin.EMF().Ex()(ix).real()
                                     +   netcurrent(1,ix) * Yin.EMF().Bz()(ix).real()
                                     -   netcurrent(2,ix) * Yin.EMF().By()(ix).real()); //+ Rie/ni;
-        Hslope.vx(ix) -= netcurrent(0,ix) * (idx * d_vx[ix]);
-    }
+        Hslope.vx(ix) -= netcurrent(0,ix) * (idx * hydro.vx(ix));
 
-    Hslope.vx(szx - 1) += -idx * eventuallynetPovern[szx - 1] / Yin.HYDRO().mass()
-                                    +   Zeovermi * eventuallychargeseparation[szx - 1] * (Yin.EMF().Ex()(szx - 1).real()
-                                    +   netcurrent(1,szx - 1) * Yin.EMF().Bz()(szx - 1).real()
-                                    -   netcurrent(2,szx - 1) * Yin.EMF().By()(szx - 1).real()); //+ Rie/ni
-    Hslope.vx(szx - 1) -= netcurrent(0,szx - 1) * (idx * d_vx[szx - 1]);
-
-    /// ----------------------------------------------------------------------
-    /// Momentum equation - y direction
-    /// ----------------------------------------------------------------------
-    Hslope.vy(0) +=  Zeovermi *
-                            (   netcurrent(2,0) * Yin.EMF().Bx()(0).real()
-                            -   netcurrent(0,0) * Yin.EMF().Bz()(0).real()
-                            +   eventuallychargeseparation[0] * Yin.EMF().Ey()(0).real());
-
-    for (size_t ix(1);ix<szx-1;++ix)
-    {
+        /// ----------------------------------------------------------------------
+        /// Momentum equation - y direction
+        /// ----------------------------------------------------------------------
         Hslope.vy(ix) +=  Zeovermi *
                             (   netcurrent(2,ix) * Yin.EMF().Bx()(ix).real()
                             -   netcurrent(0,ix) * Yin.EMF().Bz()(ix).real()
-                            +   eventuallychargeseparation[ix] * Yin.EMF().Ey()(ix).real());
-    }
-
-    Hslope.vy(szx - 1) +=  Zeovermi *
-                            (   netcurrent(2,szx - 1) * Yin.EMF().Bx()(szx - 1).real()
-                            -   netcurrent(0,szx - 1) * Yin.EMF().Bz()(szx - 1).real()
-                            +   eventuallychargeseparation[szx - 1] * Yin.EMF().Ey()(szx - 1).real());
-
-
-    /// ----------------------------------------------------------------------
-    /// Momentum equation - z direction
-    /// ----------------------------------------------------------------------
-    Hslope.vz(0) +=  Zeovermi *
-                            (   netcurrent(0,0) * Yin.EMF().By()(0).real()
-                            -   netcurrent(1,0) * Yin.EMF().Bx()(0).real()
-                            +   eventuallychargeseparation[0] * Yin.EMF().Ez()(0).real());
+                            +   chargeseparation[ix] * Yin.EMF().Ey()(ix).real());
 
-    for (size_t ix(1);ix<szx-1;++ix)
-    {
+        /// ----------------------------------------------------------------------
+        /// Momentum equation - z direction
+        /// ----------------------------------------------------------------------
         Hslope.vz(ix) +=  Zeovermi *
                             (   netcurrent(0,ix) * Yin.EMF().By()(ix).real()
                             -   netcurrent(1,ix) * Yin.EMF().Bx()(ix).real()
-                            +   eventuallychargeseparation[ix] * Yin.EMF().Ez()(ix).real());
+                            +   chargeseparation[ix] * Yin.EMF().Ez()(ix).real());
     }
-
-    Hslope.vz(szx - 1) +=  Zeovermi *
-                            (   netcurrent(0,szx - 1) * Yin.EMF().By()(szx - 1).real()
-                            -   netcurrent(1,szx - 1) * Yin.EMF().Bx()(szx - 1).real()
-                            +   eventuallychargeseparation[szx - 1] * Yin.EMF().Ez()(szx - 1).real());
 }
 //------------------------------------------------------------------------------------------
 //------------------------------------------------------------------------------------------
@@ -266,13 +209,13 @@ Hydro_Advection_1D::Hydro_Advection_1D(size_t Nl, size_t Nm,
    : XX1(Nl+1,Nm+1), XX2(Nl+1,Nm+1), XX3(Nl+1,Nm+1), XX4(Nl+1,Nm+1),
      A1(Nl+1,Nm+1), A2(Nl+1,Nm+1), fd1(Nl+1,Nm+1), fd2(Nl+1,Nm+1),
      // Hp0(Nl+1), H(Np,Nx), G(Np,Nx), TMP(Np,Nx),
-     Hp0(Nl+1), H(dp.size(),Nx), G(dp.size(),Nx), TMP(dp.size(),Nx),
+     Hp0(Nl+1), H(dp.size(),Nx), G(dp.size(),Nx),
      pr(Algorithms::MakeCAxis(static_cast<complex<double> >(0.),
                              static_cast<complex<double> >(1.0),
                              dp.size())),
     // pr(Algorithms::MakeCAxis_cmplx((0.),dp)),
     invdp(pr),
-     invpr(pr), szx(Nx)
+     invpr(pr), vt(pr), tempv(pr), invpax(pr), Ux(0.0,Nx), dUxdx(0.0,Nx), szx(Nx)
      {
 //      - - - - - - - - - - - - - - - - - - - - - - - - - - -
          complex<double> lc, mc;
@@ -331,13 +274,7 @@ Hydro_Advection_1D::Hydro_Advection_1D(size_t Nl, size_t Nm,
 void Hydro_Advection_1D::operator()(const DistFunc1D& Din, const Hydro1D& hydro, DistFunc1D& Dh) {
 //--------------------------------------------------------------
 
-        valarray<complex<double> > vt(pr); vt *= 1.0/Din.mass();
-        valarray<complex<double> > tempv(vt);
-
-
-        valarray<complex<double> > Ux(0.0,(hydro.vxarray()).size());
-        valarray<complex<double> > dUxdx(0.0,(hydro.vxarray()).size());
-
+        vt = pr; vt *= 1.0/Din.mass();
 
         Ux[0] = hydro.vx(0);
         dUxdx[0] = idx*(hydro.vx(1)-hydro.vx(0));
@@ -357,132 +294,169 @@ void Hydro_Advection_1D::operator()(const DistFunc1D& Din, const Hydro1D& hydro,
         size_t l0(Din.l0());
         size_t m0(Din.m0());
 
-        SHarmonic1D tG(G), tH(H);
-        
+        //  The harmonic G and H are built from; the high-l passes
+        //  reuse whichever harmonic was last picked up
+        const SHarmonic1D* f(&Din(0,0));
+
         // dCdx df/dv term
-        TMP = Din(0,0);     //fd1 = fd1.Dx();
-        MakeGH(TMP, 0);            MakeG00(TMP);     tH=H;tG=G;
-        
-        tempv = vt *  XX1(0,0);    tH.mpaxis(tempv); tH.mxaxis(dUxdx);   Dh(0,0) += tH; tH = H;  
-        tempv = vt *  XX2(0,0);    tG.mpaxis(tempv); tG.mxaxis(dUxdx);   Dh(0,0) += tG; tG = G; 
-        tempv = vt *  XX3(0,0);    tG.mpaxis(tempv); tG.mxaxis(dUxdx);   Dh(2,0) += tG;
+        MakeGH(*f, 0);             MakeG00(*f);
+
+        add_shifted(H, XX1(0,0), Dh(0,0));
+        add_shifted(G, XX2(0,0), Dh(0,0));
+        add_shifted(G, XX3(0,0), Dh(2,0));
 
         // Dh.checknan();
 
-        TMP = Din(1,0);     //fd1 = fd1.Dx();
-        MakeGH(TMP,1);             tH=H;tG=G;
-        tempv = vt *  XX1(1,0);    tH.mpaxis(tempv); tH.mxaxis(dUxdx);   Dh(1,0) += tH; tH = H;  
-        tempv = vt *  XX2(1,0);    tG.mpaxis(tempv); tG.mxaxis(dUxdx);   Dh(1,0) += tG; tG = G; 
-        tempv = vt *  XX3(1,0);    tG.mpaxis(tempv); tG.mxaxis(dUxdx);   Dh(3,0) += tG; 
+        f = &Din(1,0);
+        MakeGH(*f,1);
+        add_shifted(H, XX1(1,0), Dh(1,0));
+        add_shifted(G, XX2(1,0), Dh(1,0));
+        add_shifted(G, XX3(1,0), Dh(3,0));
     
         // Dh.checknan();
 
-        TMP = Din(1,1);    
-        MakeGH(TMP,1);              tH=H;tG=G;
-        tempv = vt *  XX1(1,1);     tH.mpaxis(tempv); tH.mxaxis(dUxdx);   Dh(1,1) += tH; tH = H;  
-        tempv = vt *  XX2(1,1);     tG.mpaxis(tempv); tG.mxaxis(dUxdx);   Dh(1,1) += tG; tG = G; 
-        tempv = vt *  XX3(1,1);     tG.mpaxis(tempv); tG.mxaxis(dUxdx);   Dh(3,1) += tG; tG = G; 
-        // tempv = vt *  1.0;
+        f = &Din(1,1);
+        MakeGH(*f,1);
+        add_shifted(H, XX1(1,1), Dh(1,1));
+        add_shifted(G, XX2(1,1), Dh(1,1));
+        add_shifted(G, XX3(1,1), Dh(3,1));
         
-        MakeGH(TMP,l0);             tH=H;tG=G;
+        MakeGH(*f,l0);
         for (size_t m(0); m<((m0<l0-1)?(m0+1):(l0-1)); ++m){
-            TMP = Din(l0,m);  
-            tempv = vt *  XX1(l0,m);   tH.mpaxis(tempv); tH.mxaxis(dUxdx);   Dh(l0,m) += tH; tH = H; 
-            tempv = vt *  XX2(l0,m);   tG.mpaxis(tempv); tG.mxaxis(dUxdx);   Dh(l0,m) += tG; tG = G; 
-            tempv = vt *  XX4(l0,m);   tG.mpaxis(tempv); tG.mxaxis(dUxdx);   Dh(l0-2,m) += tG; tG = G; 
-            // tempv = vt *  1.0);            
+            f = &Din(l0,m);
+            add_shifted(H, XX1(l0,m), Dh(l0,m));
+            add_shifted(G, XX2(l0,m), Dh(l0,m));
+            add_shifted(G, XX4(l0,m), Dh(l0-2,m));
         }
         for (size_t m(l0-2); m<((m0<l0)?(m0):(l0+1)); ++m){
-            // TMP = Din(l0,m);     //fd1 = fd1.Dx();
-            tempv = vt *  XX1(l0,m);   tH.mpaxis(tempv); tH.mxaxis(dUxdx);   Dh(l0,m) += tH; tH = H; 
-            tempv = vt *  XX2(l0,m);   tG.mpaxis(tempv); tG.mxaxis(dUxdx);   Dh(l0,m) += tG; tG = G; 
-            // tempv = vt *  XX4(l0,m));      TMP =  H.mpaxis(tempv);            Dh(l0-2,m) += TMP;
-            // tempv = vt *  1.0);            
+            add_shifted(H, XX1(l0,m), Dh(l0,m));
+            add_shifted(G, XX2(l0,m), Dh(l0,m));
         }
         
 
-        MakeGH(TMP,l0-1);       tH=H;tG=G;
+        MakeGH(*f,l0-1);
         for (size_t m(0); m<((m0<l0-2)?(m0+1):(l0-2)); ++m){
-            // TMP = Din(l0-1,m);     //fd1 = fd1.Dx();
-            tempv = vt *  XX1(l0-1,m);  tH.mpaxis(tempv); tH.mxaxis(dUxdx);  Dh(l0-1,m) += tH; tH = H; 
-            tempv = vt *  XX2(l0-1,m);  tG.mpaxis(tempv); tG.mxaxis(dUxdx);  Dh(l0-1,m) += tG; tG = G;         
-            tempv = vt *  XX4(l0-1,m);  tH.mpaxis(tempv); tH.mxaxis(dUxdx);  Dh(l0-3,m) += tH; tH = H; 
-            // tempv = vt *  1.0;                        
+            add_shifted(H, XX1(l0-1,m), Dh(l0-1,m));
+            add_shifted(G, XX2(l0-1,m), Dh(l0-1,m));
+            add_shifted(H, XX4(l0-1,m), Dh(l0-3,m));
         }
 
         for (size_t m(l0-3); m<((m0<l0)?(m0+1):(l0+1)); ++m){
-            // TMP = Din(l0-1,m);     //fd1 = fd1.Dx();            
-            tempv = vt *  XX1(l0-1,m);  tH.mpaxis(tempv); tH.mxaxis(dUxdx);  Dh(l0-1,m) += tH; tH = H;             
-            tempv = vt *  XX2(l0-1,m);  tG.mpaxis(tempv); tG.mxaxis(dUxdx);  Dh(l0-1,m) += tG; tG = G; 
-            // tempv = vt *  1.0,m);                        
+            add_shifted(H, XX1(l0-1,m), Dh(l0-1,m));
+            add_shifted(G, XX2(l0-1,m), Dh(l0-1,m));
         }
     
         for (size_t l(2); l<l0-1; ++l){
-            MakeGH(TMP,l);      tH=H;tG=G;
+            MakeGH(*f,l);
             for (size_t m(0); m < ((m0<l+1)?(m0+1):(l+1)); ++m){
-                tempv = vt *  XX1(l,m);  tH.mpaxis(tempv); tH.mxaxis(dUxdx);  Dh(l,m) += tH; tH = H; 
-                tempv = vt *  XX2(l,m);  tG.mpaxis(tempv); tG.mxaxis(dUxdx);  Dh(l,m) += tG; tG = G; 
-                // tempv = vt *  1.0;               
+                add_shifted(H, XX1(l,m), Dh(l,m));
+                add_shifted(G, XX2(l,m), Dh(l,m));
             }
 
             for (size_t m(0); m < ((m0<l-1)?(m0+1):(l-1)); ++m){
-                tempv = vt *  XX4(l,m);  tH.mpaxis(tempv); tH.mxaxis(dUxdx);  Dh(l-2,m) += tH; tH = H;
+                add_shifted(H, XX4(l,m), Dh(l-2,m));
             }
 
             for (size_t m(0); m < ((m0<l+3)?(m0+1):(l+3)); ++m){                
-                tempv = vt *  XX3(l,m);  tH.mpaxis(tempv); tH.mxaxis(dUxdx);  Dh(l+2,m) += tH; tH = H; 
-                // tempv = vt *  1.0;               
+                add_shifted(H, XX3(l,m), Dh(l+2,m));
             }
         }
 
         // C df/dr term
         for (size_t m(0); m < ((m0<l0)?(m0+1):m0); ++m){
             
-            tH = Din(m,m);                             tH = tH.Dx(Input::List().dbydx_order);
-            for (int ip(0); ip<tH.nump(); ++ip) tH(ip,Din(0,0).numx()-1)  = 0.0; 
-            Dh(m,m) += tH.mxaxis(Ux);
+            add_advected(Din(m,m), Dh(m,m));
 
             for (size_t l(m+1); l < l0; ++l) {
-               tH = Din(l,m);                          tH = tH.Dx(Input::List().dbydx_order);  
-               for (int ip(0); ip<tH.nump(); ++ip) tH(ip,Din(0,0).numx()-1)  = 0.0;  
-               
-               Dh(l,m) += tH.mxaxis(Ux);
-
+               add_advected(Din(l,m), Dh(l,m));
             }
             
-            tH = Din(l0,m);                            tH = tH.Dx(Input::List().dbydx_order);
-            for (int ip(0); ip<tH.nump(); ++ip) tH(ip,Din(0,0).numx()-1)  = 0.0; 
-
-            Dh(l0,m) += tH.mxaxis(Ux);
-        
-        
+            add_advected(Din(l0,m), Dh(l0,m));
         }
 }
+//--------------------------------------------------------------
+//--------------------------------------------------------------
+//  dh += (coeff * p/m) * f * dUx/dx
+    void Hydro_Advection_1D::add_shifted(const SHarmonic1D& f, const complex<double> coeff, SHarmonic1D& dh){
+//--------------------------------------------------------------
+        for (size_t ip(0); ip < tempv.size(); ++ip) tempv[ip] = vt[ip] * coeff;
+
+        #pragma omp parallel for num_threads(Input::List().ompthreads)
+        for (size_t ix = 0; ix < f.numx(); ++ix)
+        {
+            for (size_t ip(0); ip < f.nump(); ++ip)
+            {
+                dh(ip,ix) += (f(ip,ix) * tempv[ip]) * dUxdx[ix];
+            }
+        }
+    }
+//--------------------------------------------------------------
+//  dh += Ux * df/dx, with the stencil of SHarmonic1D::Dx and
+//  nothing added in the last cell
+    void Hydro_Advection_1D::add_advected(const SHarmonic1D& f, SHarmonic1D& dh){
+//--------------------------------------------------------------
+        const long order(Input::List().dbydx_order);
+        const long nx(f.numx());
 
+        #pragma omp parallel for num_threads(Input::List().ompthreads)
+        for (long ix = 0; ix < nx-1; ++ix)
+        {
+            for (size_t ip(0); ip < f.nump(); ++ip)
+            {
+                complex<double> t;
+                if (order == 2 && ix > 0 && ix < nx-1) {
+                    t  = f(ip,ix-1);
+                    t -= f(ip,ix+1);
+                }
+                else if (order == 4 && ix > 1 && ix < nx-2) {
+                    t  = 0.5*(f(ip,ix+2)-f(ip,ix-2));
+                    t += 4.0*(f(ip,ix-1)-f(ip,ix+1));
+                    t /= 3.0;
+                }
+                else if (order == 6 && ix > 2 && ix < nx-3) {
+                    t  = -1./30.*(f(ip,ix+3)-f(ip,ix-3));
+                    t += 0.3*(f(ip,ix+2)-f(ip,ix-2));
+                    t -= 1.5*(f(ip,ix+1)-f(ip,ix-1));
+                }
+                else t = f(ip,ix);
+
+                dh(ip,ix) += t * Ux[ix];
+            }
+        }
+    }
 //--------------------------------------------------------------
 //--------------------------------------------------------------
 //  Make derivatives 2*Dp*(l+1/l)*G and -2*Dp*H for a given f
-    void Hydro_Advection_1D::MakeGH(SHarmonic1D& f, size_t el){
+    void Hydro_Advection_1D::MakeGH(const SHarmonic1D& f, size_t el){
 //--------------------------------------------------------------
-        valarray<complex<double> > invpax(invpr); 
         complex<double> ld(el); 
 
         // invpax *= (-2.0)*(ld+1.0) * (pr[1]-pr[0]);
-        invpax *= (-2.0)*(ld+1.0);// * (pr[1]-pr[0]);
+        for (size_t i(0); i < invpax.size(); ++i) invpax[i] = invpr[i] * ((-2.0)*(ld+1.0));
        
-        G = f;                   H = f;
+        G = f;
         G = G.Dp();              G = G.mpaxis(invdp);
-                                 H  = H.mpaxis(invpax);
-                                 H += G;
-        G *= -(2.0*ld+1.0)/ld;
-        G += H;
+
+        complex<double> Gcoeff(-(2.0*ld+1.0)/ld);
+
+        #pragma omp parallel for num_threads(Input::List().ompthreads)
+        for (size_t ix = 0; ix < f.numx(); ++ix)
+        {
+            for (size_t ip(0); ip < f.nump(); ++ip)
+            {
+                H(ip,ix)  = f(ip,ix) * invpax[ip];
+                H(ip,ix) += G(ip,ix);
+                G(ip,ix) *= Gcoeff;
+                G(ip,ix) += H(ip,ix);
+            }
+        }
 
         for (size_t i(0); i < G.numx(); ++i) G(0,i) = 0.0;
         for (size_t i(0); i < H.numx(); ++i) H(0,i) = f(1,i) * Hp0[el];
     }
 //--------------------------------------------------------------
 //  Calculation of G00 = -2*Dp* df/dp(p0)
-    void Hydro_Advection_1D::MakeG00(SHarmonic1D& f) {
+    void Hydro_Advection_1D::MakeG00(const SHarmonic1D& f) {
 //--------------------------------------------------------------
         G = f; G = G.Dp(); G = G.mpaxis(invdp);
 
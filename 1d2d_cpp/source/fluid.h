@@ -31,6 +31,10 @@
             size_t                          szx, Nbc;
 
             valarray<double>                dummy;
+
+            //  Scratch of the momentum equation, reused every call
+            valarray<double>                Povern, chargeseparation;
+            Array2D<double>                 netcurrent;
             
             
     };
@@ -53,6 +57,9 @@
             double idx;
             size_t szx;
             Fluid_Equation_1D FEQ;
+
+            valarray<double> electrondensity, electronpressure;
+            Array2D<double>  electroncurrent;
     };
 //--------------------------------------------------------------  
 //--------------------------------------------------------------
@@ -70,14 +77,19 @@
             void operator()(const DistFunc1D& Din, const Hydro1D& hydro, DistFunc1D& Dh);
 
         private:
-            void MakeGH( SHarmonic1D& f, size_t l);
-            void MakeG00( SHarmonic1D& f);
+            void MakeGH(const SHarmonic1D& f, size_t l);
+            void MakeG00(const SHarmonic1D& f);
+
+    //          Threaded passes that add straight into Dh, without a copy of the source
+            void add_shifted(const SHarmonic1D& f, const complex<double> coeff, SHarmonic1D& dh);
+            void add_advected(const SHarmonic1D& f, SHarmonic1D& dh);
 
-            SHarmonic1D H, G, TMP;
+            SHarmonic1D H, G;
             SHarmonic1D                     fd1, fd2;
             Array2D< complex<double> >      XX1, XX2, XX3, XX4;
             Array2D< complex<double> >      A1, A2;
             valarray< complex<double> >     pr, invdp, invpr, Hp0;
+            valarray< complex<double> >     vt, tempv, invpax, Ux, dUxdx;
             size_t                          szx, Nbc;
             double                          idp, idx;
     };
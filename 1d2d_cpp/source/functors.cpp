@@ -17,6 +17,7 @@
 #include <omp.h>
 #include <math.h>
 #include <map>
+#include <mpi.h>
 
 //  My libraries
 #include "lib-array.h"
@@ -59,9 +60,16 @@ VlasovFunctor1D_explicitE::VlasovFunctor1D_explicitE(vector<size_t> Nl,vector<si
 
     FA.push_back( Faraday(xmin, xmax, Nx, 0., 1., 1) );
 
+    IM.push_back( Implicit_Maxwell(xmin, xmax, Nx, 0., 1., 1) );
     
 }
 //--------------------------------------------------------------
+//  Crank-Nicolson curl update. The current is not part of it,
+//  -4 pi J still enters E with the RK stages.
+void VlasovFunctor1D_explicitE::maxwell(State1D& Y, double h){
+    IM[0](Y.EMF(), h);
+}
+//--------------------------------------------------------------
 
 
 //--------------------------------------------------------------
@@ -166,8 +174,11 @@ void VlasovFunctor1D_explicitE::operator()(const State1D& Yin, State1D& Yslope){
         }
     }
     
-    AM[0](Yin.EMF(),Yslope.EMF());
-    FA[0](Yin.EMF(),Yslope.EMF());
+    if (!Input::List().implicit_maxwell)
+    {
+        AM[0](Yin.EMF(),Yslope.EMF());
+        FA[0](Yin.EMF(),Yslope.EMF());
+    }
             
 }
 
@@ -350,8 +361,11 @@ void VlasovFunctor1D_explicitE::operator()(const State1D& Yin, State1D& Yslope,
                 JX[s](Yin.DF(s),Yslope.EMF().Ex(),Yslope.EMF().Ey(),Yslope.EMF().Ez());
             }
 
-            AM[0](Yin.EMF(),Yslope.EMF());
-            FA[0](Yin.EMF(),Yslope.EMF());
+            if (!Input::List().implicit_maxwell)
+            {
+                AM[0](Yin.EMF(),Yslope.EMF());
+                FA[0](Yin.EMF(),Yslope.EMF());
+            }
         }
         
         if (Input::List().filterdistribution)  Yslope.DF(s).Filterp();
@@ -557,6 +571,12 @@ VlasovFunctor2D_explicitE::VlasovFunctor2D_explicitE(vector<size_t> Nl,vector<si
     AM.push_back( Ampere(xmin, xmax, Nx, ymin, ymax, Ny) );
 
     FA.push_back( Faraday(xmin, xmax, Nx, ymin, ymax, Ny) );
+
+    IM.push_back( Implicit_Maxwell(xmin, xmax, Nx, ymin, ymax, Ny) );
+}
+//--------------------------------------------------------------
+void VlasovFunctor2D_explicitE::maxwell(State2D& Y, double h){
+    IM[0](Y.EMF(), h);
 }
 //--------------------------------------------------------------
 
@@ -602,9 +622,11 @@ void VlasovFunctor2D_explicitE::operator()(const State2D& Yin, State2D& Yslope){
 
     }
 
-    AM[0](Yin.EMF(),Yslope.EMF());
-
-    FA[0](Yin.EMF(),Yslope.EMF());
+    if (!Input::List().implicit_maxwell)
+    {
+        AM[0](Yin.EMF(),Yslope.EMF());
+        FA[0](Yin.EMF(),Yslope.EMF());
+    }
 
 }
 
@@ -649,9 +671,11 @@ void VlasovFunctor2D_explicitE::operator()(const State2D& Yin, State2D& Yslope,
 
     }
 
-    AM[0](Yin.EMF(),Yslope.EMF());
-
-    FA[0](Yin.EMF(),Yslope.EMF());
+    if (!Input::List().implicit_maxwell)
+    {
+        AM[0](Yin.EMF(),Yslope.EMF());
+        FA[0](Yin.EMF(),Yslope.EMF());
+    }
 
     if (Input::List().filterdistribution)  Yslope.DF(0).Filterp();
 
@@ -27,6 +27,9 @@ public:
     // void advance(const State1D& Yin, State1D& Yslope, double time, double dt);
     void operator()(const State1D& Yin, State1D& Yslope, size_t dir);
 
+//          Curl terms of Maxwell's equations over h, when they are left out of the slope
+    void maxwell(State1D& Y, double h);
+
 private:
     vector<Spatial_Advection> SA;
     vector<Electric_Field>    EF;
@@ -35,6 +38,7 @@ private:
 
     vector<Ampere>    		 AM;
     vector<Faraday>    		 FA;
+    vector<Implicit_Maxwell>  IM;
 
     WaveDriver               WD;
 //            vector<Hydro_Advection>   HA;
@@ -118,6 +122,9 @@ public:
     void operator()(const State2D& Yin, State2D& Yslope, double time, double dt);
     void operator()(const State2D& Yin, State2D& Yslope, size_t dir);
 
+//          Curl terms of Maxwell's equations over h, when they are left out of the slope
+    void maxwell(State2D& Y, double h);
+
 private:
     vector<Spatial_Advection>   SA;
     vector<Electric_Field>      EF;
@@ -126,6 +133,7 @@ private:
     vector<Ampere>              AM;
     vector<Magnetic_Field>      BF;
     vector<Faraday>             FA;
+    vector<Implicit_Maxwell>    IM;
 
     WaveDriver               WD;
  // vector<Hydro_Advection>   HA;
@@ -0,0 +1,150 @@
+/*! \brief Merge per-step output into consolidated h5 files
+ * \author PICKSC
+ * \file   h5merge.cpp
+ *
+ * Walks an output directory and collects every series of
+ * <tag>[_s<species>]_<step>.h5 files of a folder into
+ * <tag>[_s<species>].h5, with a group named <step> that holds
+ * what the per-step file held. This is the layout written
+ * directly by a run with h5_consolidate = true. The restart/
+ * folder and any re_1D_* / re_2D_* checkpoint files are skipped.
+ *
+ * Usage: h5merge.e <output directory> [--remove]
+ *        --remove deletes the per-step files once merged
+ */
+
+//  Standard libraries
+#include <iostream>
+#include <vector>
+#include <string>
+#include <map>
+#include <cstdio>
+#include <cstring>
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <hdf5.h>
+
+using namespace std;
+
+//--------------------------------------------------------------
+//  Split <prefix>_<step>.h5, the step being all digits
+static bool stepfile(const string name, string& prefix, string& step) {
+
+    const string ext(".h5");
+    if (name.size() <= ext.size() || name.compare(name.size()-ext.size(), ext.size(), ext) != 0) return false;
+
+    string stem(name.substr(0, name.size()-ext.size()));
+    size_t us(stem.rfind('_'));
+    if (us == string::npos || us == 0 || us+1 == stem.size()) return false;
+
+    step = stem.substr(us+1);
+    for (size_t i(0); i < step.size(); ++i) if (step[i] < '0' || step[i] > '9') return false;
+
+    prefix = stem.substr(0, us);
+    return true;
+}
+//--------------------------------------------------------------
+//  re_1D_* and re_2D_* are restarts and in-memory checkpoint copies
+static bool restartfile(const string name) {
+    return (name.compare(0, 6, "re_1D_") == 0) || (name.compare(0, 6, "re_2D_") == 0);
+}
+//--------------------------------------------------------------
+static herr_t copy_link(hid_t src, const char* name, const H5L_info_t*, void* dst) {
+    return H5Ocopy(src, name, *static_cast<hid_t*>(dst), name, H5P_DEFAULT, H5P_DEFAULT);
+}
+//--------------------------------------------------------------
+//  Copy everything in the root of each step file into its group
+//  of the consolidated file; steps already there are replaced
+static void merge(const string dir, const string prefix, map<string, string>& steps, const bool remove_steps) {
+
+    string target(dir + "/" + prefix + ".h5");
+
+    struct stat buf;
+    hid_t fout((stat(target.c_str(), &buf) == 0) ? H5Fopen(target.c_str(), H5F_ACC_RDWR, H5P_DEFAULT)
+                                                 : H5Fcreate(target.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT));
+    if (fout < 0) {
+        cout << "Error opening " << target << endl;
+        exit(1);
+    }
+
+    for (map<string, string>::iterator it = steps.begin(); it != steps.end(); ++it)
+    {
+        hid_t fin(H5Fopen(it->second.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT));
+        if (fin < 0) {
+            cout << "Error opening " << it->second << endl;
+            exit(1);
+        }
+
+        if (H5Lexists(fout, it->first.c_str(), H5P_DEFAULT) > 0) H5Ldelete(fout, it->first.c_str(), H5P_DEFAULT);
+        hid_t group(H5Gcreate2(fout, it->first.c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT));
+
+        if (H5Literate(fin, H5_INDEX_NAME, H5_ITER_INC, NULL, copy_link, &group) < 0) {
+            cout << "Error copying " << it->second << endl;
+            exit(1);
+        }
+
+        H5Gclose(group);
+        H5Fclose(fin);
+    }
+    H5Fclose(fout);
+
+    if (remove_steps)
+    {
+        for (map<string, string>::iterator it = steps.begin(); it != steps.end(); ++it) std::remove(it->second.c_str());
+    }
+
+    cout << target << " : " << steps.size() << " steps\n";
+}
+//--------------------------------------------------------------
+static void walk(const string dir, const bool remove_steps) {
+
+    DIR* d(opendir(dir.c_str()));
+    if (d == NULL) {
+        cout << "Error reading directory " << dir << endl;
+        exit(1);
+    }
+
+    vector<string> subdirs;
+    map<string, map<string, string> > series;     // prefix -> step -> file
+
+    struct dirent* entry;
+    while ((entry = readdir(d)) != NULL)
+    {
+        string name(entry->d_name);
+        if (name == "." || name == "..") continue;
+
+        string path(dir + "/" + name), prefix, step;
+        struct stat buf;
+        if (stat(path.c_str(), &buf) != 0) continue;
+
+        //  Restart and buddy checkpoint files are never merged, nor removed
+        if (S_ISDIR(buf.st_mode)) {
+            if (name != "restart") subdirs.push_back(path);
+        }
+        else if (restartfile(name)) continue;
+        else if (stepfile(name, prefix, step)) series[prefix][step] = path;
+    }
+    closedir(d);
+
+    for (map<string, map<string, string> >::iterator it = series.begin(); it != series.end(); ++it)
+    {
+        merge(dir, it->first, it->second, remove_steps);
+    }
+    for (size_t i(0); i < subdirs.size(); ++i) walk(subdirs[i], remove_steps);
+}
+//--------------------------------------------------------------
+int main(int argc, char** argv) {
+
+    if (argc < 2 || (argc == 3 && strcmp(argv[2], "--remove") != 0) || argc > 3) {
+        cout << "Usage: " << argv[0] << " <output directory> [--remove]\n";
+        return 1;
+    }
+
+    walk(argv[1], argc == 3);
+
+    return 0;
+}
+//--------------------------------------------------------------
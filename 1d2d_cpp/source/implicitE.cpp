@@ -20,6 +20,7 @@
     #include <math.h>
     #include <map>
     #include <limits>
+    #include <mpi.h>
 
 //  My libraries
     #include "lib-array.h"
@@ -347,7 +348,15 @@
    
          
          idx(static_cast< complex<double> >(0.5/axes.dx(0))),
-         idy(static_cast< complex<double> >(0.5/axes.dx(1)))
+         idy(static_cast< complex<double> >(0.5/axes.dx(1))),
+
+         JW(),
+         sigma(9*szx), En(3*szx), Rn(3*szx), Rp(3*szx), dE(3*szx), z(3*szx),
+         V(Input::List().implicit_E_krylov_iters+1, valarray< complex<double> >(3*szx)),
+         Hk(Input::List().implicit_E_krylov_iters+1, Input::List().implicit_E_krylov_iters),
+         gk(Input::List().implicit_E_krylov_iters+1), sn(Input::List().implicit_E_krylov_iters),
+         cs(Input::List().implicit_E_krylov_iters),
+         steps_since_precond(Input::List().implicit_E_precond_every)
          {}
 //--------------------------------------------------------------
 
@@ -358,10 +367,20 @@
 //  Calculate the implicit electric field
 //--------------------------------------------------------------
 
+        if (Yw.empty()) {
+            Yw.push_back(Yin);
+            Yw.push_back(Yin);
+            Yw[1] = 0.0;
+        }
+
+        if (Input::List().implicit_E_newton_krylov) {
+            advance_newton_krylov(rk, Yin, coll, rkF, step_size);
+            return;
+        }
+
         int zeros_in_det(1);      // This counts the number of zeros in the determinant 
         int execution_attempt(0); // This counts the number of attempts to find invert the E-field
-        State1D Yh(Yin);
-        Yh = 0.0;
+        State1D& Yh(Yw[1]);       // Only f10, f11 are written by advancef1, the rest stays 0
         
         FindDE(Yin.EMF());                           //  Reset DE
 
@@ -491,6 +510,241 @@
 //--------------------------------------------------------------
 
 
+//--------------------------------------------------------------
+    static double l2norm(const valarray< complex<double> >& v) {
+        double sum(0.0);
+        for (size_t i(0); i < v.size(); ++i) sum += norm(v[i]);
+        return sqrt(sum);
+    }
+    static complex<double> dotc(const valarray< complex<double> >& u, const valarray< complex<double> >& v) {
+        complex<double> sum(0.0);
+        for (size_t i(0); i < v.size(); ++i) sum += conj(u[i]) * v[i];
+        return sum;
+    }
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+    void Electric_Field_Methods::Implicit_E_Field::
+    advance_newton_krylov(Algorithms::RK2<State1D>* rk, State1D& Yin, collisions_1D& coll, VlasovFunctor1D_implicitE_p2* rkF, const double step_size){
+//--------------------------------------------------------------
+//  Newton iterations on R(E) = J(E) - JN, each solving R'(E) dE = -R
+//  with GMRES. R'(E) v is a difference of two residuals and the 
+//  per-cell conductivity of Conductivity() right-preconditions it.
+//  The conductivity is rebuilt every implicit_E_precond_every steps
+//  or when GMRES stalls; a rebuild also gives the starting E. 
+//--------------------------------------------------------------
+        const double tol(Input::List().implicit_E_newton_tol);
+        const size_t max_newton(Input::List().implicit_E_newton_iters);
+        const size_t max_krylov(Input::List().implicit_E_krylov_iters);
+
+        FindDE(Yin.EMF());                           //  Perturbation for the conductivity
+        Ampere(Yin.EMF());                           //  Calculate JN
+
+        if (steps_since_precond >= Input::List().implicit_E_precond_every) {
+            Conductivity(rk, Yin, coll, rkF, step_size, Rn);
+            dE = Rn; Precondition(dE);
+            En = -dE;                                //  Linear response from E = 0
+        }
+        else {
+            for (size_t ix(0); ix < szx; ++ix) {     //  Previous E
+                En[3*ix  ] = Yin.EMF().Ex()(ix);
+                En[3*ix+1] = Yin.EMF().Ey()(ix);
+                En[3*ix+2] = Yin.EMF().Ez()(ix);
+            }
+        }
+        ++steps_since_precond;
+
+        Residual(rk, Yin, coll, rkF, step_size, En, Rn);
+        double rnorm(l2norm(Rn));
+
+        //  The residual is measured against the size of the currents
+        double scale(0.0);
+        for (size_t ix(0); ix < szx; ++ix) {
+            scale += norm(JN.Jx_1D()(ix)) + norm(JN.Jy_1D()(ix)) + norm(JN.Jz_1D()(ix));
+        }
+        scale = sqrt(scale);
+        dE = Rn;
+        for (size_t ix(0); ix < szx; ++ix) {
+            dE[3*ix  ] += JN.Jx_1D()(ix);
+            dE[3*ix+1] += JN.Jy_1D()(ix);
+            dE[3*ix+2] += JN.Jz_1D()(ix);
+        }
+        scale += l2norm(dE);
+
+        size_t newton(0);
+        while ( rnorm > tol*scale && newton < max_newton ) {
+            ++newton;
+// - - - - - - - - - - - - - - - - - - - - - -
+//          GMRES with right preconditioning
+            double beta(rnorm), enorm(l2norm(En));
+            double krylov_tol(max(1e-3*beta, 0.5*tol*scale));
+
+            V[0] = Rn; V[0] *= complex<double>(-1.0/beta);
+            gk = 0.0; gk[0] = beta;
+
+            size_t k(0);
+            while (k < max_krylov) {
+                //  V[k+1] = R'(E) P^-1 V[k]
+                z = V[k]; Precondition(z);
+                double eps(sqrt(DBL_EPSILON) * (1.0+enorm) / max(l2norm(z), DBL_MIN));
+                dE = z; dE *= complex<double>(eps); dE += En;
+                Residual(rk, Yin, coll, rkF, step_size, dE, Rp);
+                V[k+1] = Rp; V[k+1] -= Rn; V[k+1] *= complex<double>(1.0/eps);
+
+                //  Modified Gram-Schmidt
+                for (size_t i(0); i < k+1; ++i) {
+                    Hk(i,k) = dotc(V[i],V[k+1]);
+                    dE = V[i]; dE *= Hk(i,k); V[k+1] -= dE;
+                }
+                Hk(k+1,k) = l2norm(V[k+1]);
+                bool breakdown(abs(Hk(k+1,k)) <= DBL_MIN);
+                if (!breakdown) V[k+1] *= 1.0/Hk(k+1,k);
+
+                //  Givens rotations
+                for (size_t i(0); i < k; ++i) {
+                    complex<double> tmp( cs[i]*Hk(i,k) + sn[i]*Hk(i+1,k) );
+                    Hk(i+1,k) = -conj(sn[i])*Hk(i,k) + cs[i]*Hk(i+1,k);
+                    Hk(i,k)   = tmp;
+                }
+                double hd(sqrt(norm(Hk(k,k)) + norm(Hk(k+1,k))));
+                if (abs(Hk(k,k)) > 0.0) {
+                    cs[k] = abs(Hk(k,k)) / hd;
+                    sn[k] = Hk(k,k) / abs(Hk(k,k)) * conj(Hk(k+1,k)) / hd;
+                }
+                else {
+                    cs[k] = 0.0; sn[k] = 1.0;
+                }
+                Hk(k,k)   = cs[k]*Hk(k,k) + sn[k]*Hk(k+1,k);
+                Hk(k+1,k) = 0.0;
+                gk[k+1]   = -conj(sn[k])*gk[k];
+                gk[k]     = cs[k]*gk[k];
+
+                ++k;
+                if (breakdown || abs(gk[k]) <= krylov_tol) break;
+            }
+            bool stalled(abs(gk[k]) > 0.5*beta);
+
+            //  dE = P^-1 V y, H y = g
+            for (size_t i(k); i-- > 0; ) {
+                for (size_t j(i+1); j < k; ++j) gk[i] -= Hk(i,j)*gk[j];
+                gk[i] = (abs(Hk(i,i)) > 0.0) ? gk[i]/Hk(i,i) : 0.0;
+            }
+            dE = 0.0;
+            for (size_t i(0); i < k; ++i) {
+                z = V[i]; z *= gk[i]; dE += z;
+            }
+            Precondition(dE);
+            En += dE;
+// - - - - - - - - - - - - - - - - - - - - - -
+
+            Residual(rk, Yin, coll, rkF, step_size, En, Rn);
+            rnorm = l2norm(Rn);
+
+            //  The conductivity has drifted too far from R'(E), dE is free
+            //  here and Rp is taken by Conductivity() itself
+            if (stalled) {
+                Conductivity(rk, Yin, coll, rkF, step_size, dE);
+                steps_since_precond = 1;
+            }
+        }
+
+        if ( rnorm > tol*scale ) {
+            cout << "WARNING, implicit E Newton-Krylov stopped at |J-JN|/|J| = " << rnorm/scale 
+                 << " after " << newton << " iterations" << endl;
+        }
+
+        for (size_t ix(0); ix < szx; ++ix) {
+            Yin.EMF().Ex()(ix) = En[3*ix  ];
+            Yin.EMF().Ey()(ix) = En[3*ix+1];
+            Yin.EMF().Ez()(ix) = En[3*ix+2];
+        }
+    }
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+    void Electric_Field_Methods::Implicit_E_Field::
+    Residual(Algorithms::RK2<State1D>* rk, State1D& Yin, collisions_1D& coll, VlasovFunctor1D_implicitE_p2* rkF, const double step_size,
+             const valarray< complex<double> >& E, valarray< complex<double> >& R){
+//--------------------------------------------------------------
+//  R = J(E) - JN, with J the current of the collisional f1 after
+//  E has acted on a copy of Y. Components that are zero are skipped.
+//--------------------------------------------------------------
+        bool nonzero[3] = {false, false, false};
+
+        Yw[0] = Yin;
+        for (size_t ix(0); ix < szx; ++ix) {
+            Yw[0].EMF().Ex()(ix) = E[3*ix  ];
+            Yw[0].EMF().Ey()(ix) = E[3*ix+1];
+            Yw[0].EMF().Ez()(ix) = E[3*ix+2];
+            for (size_t c(0); c < 3; ++c) nonzero[c] = nonzero[c] || (E[3*ix+c] != 0.0);
+        }
+
+        for (size_t c(0); c < 3; ++c) {
+            if (nonzero[c]) (*rk)(Yw[0], step_size, rkF, c+1);
+        }
+        coll.advancef1(Yw[0],Yw[1],step_size);       // Collisions for f10, f11
+        JW.calculate_J_1D(Yw[1]);
+
+        for (size_t ix(0); ix < szx; ++ix) {
+            R[3*ix  ] = JW.Jx_1D()(ix) - JN.Jx_1D()(ix);
+            R[3*ix+1] = JW.Jy_1D()(ix) - JN.Jy_1D()(ix);
+            R[3*ix+2] = JW.Jz_1D()(ix) - JN.Jz_1D()(ix);
+        }
+    }
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+    void Electric_Field_Methods::Implicit_E_Field::
+    Conductivity(Algorithms::RK2<State1D>* rk, State1D& Yin, collisions_1D& coll, VlasovFunctor1D_implicitE_p2* rkF, const double step_size,
+                 valarray< complex<double> >& R0){
+//--------------------------------------------------------------
+//  sigma_ij = dJ_i/dE_j in each cell from perturbations DE about 
+//  E = 0, as in advance(); R0 returns the residual at E = 0
+//--------------------------------------------------------------
+        z = 0.0;
+        Residual(rk, Yin, coll, rkF, step_size, z, R0);
+
+        for (size_t c(0); c < 3; ++c) {
+            z = 0.0;
+            for (size_t ix(0); ix < szx; ++ix) z[3*ix+c] = DE.E_1D(c+1)(ix);
+            Residual(rk, Yin, coll, rkF, step_size, z, Rp);
+
+            for (size_t ix(0); ix < szx; ++ix) {
+                for (size_t r(0); r < 3; ++r) {
+                    sigma[9*ix+3*r+c] = (Rp[3*ix+r] - R0[3*ix+r]) / z[3*ix+c];
+                }
+            }
+        }
+        steps_since_precond = 0;
+    }
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+    void Electric_Field_Methods::Implicit_E_Field::Precondition(valarray< complex<double> >& v){
+//--------------------------------------------------------------
+//  v = sigma^-1 v cell by cell; singular cells are left as they are
+//--------------------------------------------------------------
+        Array2D< complex<double> > sgm(3,3);     
+        valarray< complex<double> > clm(3);
+
+        for (size_t ix(0); ix < szx; ++ix)
+        {
+            for (size_t r(0); r < 3; ++r) {
+                for (size_t c(0); c < 3; ++c) sgm(r,c) = sigma[9*ix+3*r+c];
+                clm[r] = v[3*ix+r];
+            }
+
+            complex<double> D_sgm( Det33(sgm) );
+            if ( abs( D_sgm.real() ) > 6.0*DBL_MIN ) 
+            {
+                v[3*ix  ] = Detx33(clm, sgm) / D_sgm;
+                v[3*ix+1] = Dety33(clm, sgm) / D_sgm;
+                v[3*ix+2] = Detz33(clm, sgm) / D_sgm;
+            }
+        }
+    }
+//--------------------------------------------------------------
+
 // //--------------------------------------------------------------
 //     bool Electric_Field_Methods::Implicit_E_Field::
 //     implicitE() const { 
@@ -174,6 +174,27 @@
             void Ampere(EMF1D& emf);
             void FindDE(EMF1D& emf);
 
+//          Matrix-free Newton-Krylov solve of J(E) = JN
+            void advance_newton_krylov(Algorithms::RK2<State1D>* rk, State1D& Y, collisions_1D& coll, VlasovFunctor1D_implicitE_p2* rkF, const double step_size);
+            void Residual(Algorithms::RK2<State1D>* rk, State1D& Y, collisions_1D& coll, VlasovFunctor1D_implicitE_p2* rkF, const double step_size,
+                          const valarray< complex<double> >& E, valarray< complex<double> >& R);
+            void Conductivity(Algorithms::RK2<State1D>* rk, State1D& Y, collisions_1D& coll, VlasovFunctor1D_implicitE_p2* rkF, const double step_size,
+                          valarray< complex<double> >& R0);
+            void Precondition(valarray< complex<double> >& v);
+
+//          Work states (copy of Y under a trial E, collisional f1), made on first use
+            vector<State1D> Yw;
+            Current_xyz JW;
+
+//          Per-cell 3x3 conductivity, E stored as (Ex,Ey,Ez) per cell
+            valarray< complex<double> > sigma;
+            valarray< complex<double> > En, Rn, Rp, dE, z;
+            vector< valarray< complex<double> > > V;
+            Array2D< complex<double> > Hk;
+            valarray< complex<double> > gk, sn;
+            valarray<double> cs;
+            size_t steps_since_precond;
+
             void Ampere(EMF2D& emf);
             void FindDE(EMF2D& emf);
 
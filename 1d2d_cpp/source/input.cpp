@@ -9,6 +9,7 @@
  */
 //  Standard libraries
 #include <omp.h>
+#include <mpi.h>
 #include <iostream>
 #include <valarray>
 #include <vector>
@@ -17,6 +18,7 @@
 #include <cstdlib>
 #include <cfloat>
 #include <fstream>
+#include <sstream>
 #include <cstring>
 #include <math.h>
 #include <map>
@@ -29,14 +31,53 @@
 #include "parser.h"
 
 void Parser::checkparse(parser_t& parser, std::string& expression_str, expression_t& expression);
-void Parser::parseprofile(const std::valarray<double>& grid, std::string& str_profile, std::valarray<double>& profile);
+void Parser::parseprofile(const std::valarray<double>& grid, std::string& str_profile, std::valarray<double>& profile, const size_t threads);
 //**************************************************************
 //--------------------------------------------------------------
+//--------------------------------------------------------------
+//  Rank 0 reads the deck and broadcasts it, so that a large job
+//  does not open the same file from every rank. Before MPI is
+//  initialized the file is read directly.
+static bool read_deck(const std::string filename, std::string& text) {
+
+    int mpi_on(0), rank(0);
+    MPI_Initialized(&mpi_on);
+    if (mpi_on) MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+    long length(-1);
+    if (rank == 0)
+    {
+        std::ifstream fin(filename.c_str());
+        if (fin.is_open()) {
+            std::ostringstream contents;
+            contents << fin.rdbuf();
+            text = contents.str();
+            length = text.size();
+        }
+    }
+
+    if (mpi_on)
+    {
+        MPI_Bcast(&length, 1, MPI_LONG, 0, MPI_COMM_WORLD);
+        if (length > 0) 
+        {
+            text.resize(length);
+            MPI_Bcast(&text[0], length, MPI_CHAR, 0, MPI_COMM_WORLD);
+        }
+    }
+
+    return (length >= 0);
+}
+//--------------------------------------------------------------
 Input::Input_List::Input_List():
     version("default"),
     isthisarestart(0),
     dim(1),
     ompthreads(1),
+    load_balance(0), load_balance_tolerance(1.2),
+    MPI_time(1),
+    parareal_iterations(4), parareal_coarse_ratio(10), parareal_coarse_l0(0),
+    parareal_tolerance(1e-8),
     numsp(1),
     l0(6),
     m0(4),
@@ -48,12 +89,19 @@ Input::Input_List::Input_List():
     ymax(1000.0),
     dt(1.0),
     filterdistribution(0),filter_dp(0.0001),filter_pmax(0.0002), filter_Nl(0),
+    adaptive_lmax(0), adaptive_lmax_threshold(1e-6), adaptive_lmax_hysteresis(0.1),
     if_tridiagonal(1),
     implicit_E(1),
+    implicit_E_newton_krylov(0), implicit_E_newton_tol(1e-6),
+    implicit_E_newton_iters(4), implicit_E_krylov_iters(8), implicit_E_precond_every(10),
+    steady_state(0), steady_state_tol(1e-6),
+    steady_state_newton_iters(20), steady_state_krylov_iters(20), steady_state_steps(20),
     dbydx_order(2),dbydy_order(2),dbydv_order(2),
+    spectral_dbydx(0),
     adaptive_dt(false),adaptive_tmin(1000.),abs_tol(1e-16),rel_tol(1e-6),max_fails(20),
     relativity(0),
     implicit_B(0),
+    implicit_maxwell(0),
     collisions(1),
     f00_implicitorexplicit(2),
     flm_collisions(0),flm_acc(0),ee_bool(1),ei_bool(1), coll_op(0),
@@ -68,10 +116,17 @@ Input::Input_List::Input_List():
     t_stop(8000),
     restart_time(10000.0),
     n_restarts(100),
+    restart_deflate(0),
+    n_buddy_checkpoints(0), buddy_disk_every(0), buddy_dir("/dev/shm/oshun_buddy"), restart_from_buddy(0),
 
 //          Output
     o_Exhist(0), o_Eyhist(0), o_Ezhist(0), o_Bxhist(0), o_Byhist(0), o_Bzhist(0), 
     o_fhat0hist(0),
+    hist_buffer_steps(64), hist_x_stride(1), hist_t_stride(1),
+    health_check(0),
+    h5_deflate_fields(0), h5_deflate_moments(0), h5_deflate_distributions(0),
+    h5_shuffle(1), h5_lossy_relative(1), h5_lossy_tolerance(0.0), h5_consolidate(0),
+    out_window(4, 0.0), allfs_l_max(-1),
     o_Ex(0), o_Ey(0), o_Ez(0), o_Bx(0), o_By(0), o_Bz(0), o_x1x2(0), o_pth(0), 
     o_p1x1(0), o_p2x1(0), o_p3x1(0), o_p1p2x1(0), o_p1p3x1(0), o_p2p3x1(0), o_p1p2p3x1(0), 
     o_p1x1_th0(0),
@@ -101,6 +156,8 @@ Input::Input_List::Input_List():
 //          Electron-electron collisions
     RB_D_itmax(100),
     RB_D_tolerance(1e-12),
+    coll_coeff_tolerance(0.0),
+    coll_coeff_max_age(1),
     small_dt(1e-1),
     smaller_dt(1e-5),
     NB_algorithms(4),
@@ -156,13 +213,17 @@ Input::Input_List::Input_List():
 //  The constructor for the input_list structure
 //--------------------------------------------------------------
 
-    std::ifstream deckfile("inputdeck");
+//  Only rank 0 reads the file, the others tokenize the copy it broadcasts
+    std::string decktext;
+    bool deckfound(read_deck("inputdeck", decktext));
+
+    std::istringstream deckfile(decktext);
     std::string deckstring, deckequalssign, deckstringbool;
     double deckreal;
     size_t tempint;
 
 
-    if (deckfile.is_open()) {
+    if (deckfound) {
 
         while (deckfile >> deckstring) {
 
@@ -206,6 +267,47 @@ Input::Input_List::Input_List():
                 }
                 deckfile >> n_restarts;
             }
+            if (deckstring == "restart_deflate") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> restart_deflate;
+            }
+            if (deckstring == "n_buddy_checkpoints") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> n_buddy_checkpoints;
+            }
+            if (deckstring == "buddy_disk_every") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> buddy_disk_every;
+            }
+            if (deckstring == "buddy_dir") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> buddy_dir;
+            }
+            if (deckstring == "restart_from_buddy") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> deckstringbool;
+                restart_from_buddy = (deckstringbool[0] == 't' || deckstringbool[0] == 'T');
+            }
 
             if (deckstring == "restart_time") {
                 deckfile >> deckequalssign;
@@ -246,6 +348,70 @@ Input::Input_List::Input_List():
                 MPI_X.push_back(tempint);
             }
 
+            if (deckstring == "load_balance") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> deckstringbool;
+                load_balance = (deckstringbool[0] == 't' || deckstringbool[0] == 'T');
+            }
+
+            if (deckstring == "load_balance_tolerance") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> load_balance_tolerance;
+            }
+
+            if (deckstring == "MPI_Processes_time") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> MPI_time;
+            }
+
+            if (deckstring == "parareal_iterations") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> parareal_iterations;
+            }
+
+            if (deckstring == "parareal_tolerance") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> parareal_tolerance;
+            }
+
+            if (deckstring == "parareal_coarse_ratio") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> parareal_coarse_ratio;
+            }
+
+            if (deckstring == "parareal_coarse_l0") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> parareal_coarse_l0;
+            }
+
             if (deckstring == "OpenMP_Threads") {
                 deckfile >> deckequalssign;
                 if(deckequalssign != "=") {
@@ -458,6 +624,31 @@ Input::Input_List::Input_List():
                 deckfile >> deckstringbool;
                 filter_Nl = (deckstringbool[0] == 't' || deckstringbool[0] == 'T');
             }
+            if (deckstring == "adaptive_lmax") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> deckstringbool;
+                adaptive_lmax = (deckstringbool[0] == 't' || deckstringbool[0] == 'T');
+            }
+            if (deckstring == "adaptive_lmax_threshold") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> adaptive_lmax_threshold;
+            }
+            if (deckstring == "adaptive_lmax_hysteresis") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> adaptive_lmax_hysteresis;
+            }
 
             //// ---- //////// ---- //////// ---- //////// ---- //////// ---- //////// ---- ////
             //// ---- //////// ---- //////// ---- //////// ---- //////// ---- //////// ---- ////
@@ -630,6 +821,22 @@ Input::Input_List::Input_List():
                 }
                 deckfile >> RB_D_itmax;
             }
+            if (deckstring == "collision_coefficients_tolerance") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> coll_coeff_tolerance;
+            }
+            if (deckstring == "collision_coefficients_max_age") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> coll_coeff_max_age;
+            }
             if (deckstring == "f00_exp_parabolic_approximation") {
                 deckfile >> deckequalssign;
                 if(deckequalssign != "=") {
@@ -647,6 +854,88 @@ Input::Input_List::Input_List():
                 deckfile >> deckstringbool;
                 implicit_E = (deckstringbool[0] == 't' || deckstringbool[0] == 'T');
             }
+            if (deckstring == "implicit_E_newton_krylov") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> deckstringbool;
+                implicit_E_newton_krylov = (deckstringbool[0] == 't' || deckstringbool[0] == 'T');
+            }
+            if (deckstring == "implicit_E_newton_tol") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> implicit_E_newton_tol;
+            }
+            if (deckstring == "implicit_E_newton_iters") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> implicit_E_newton_iters;
+            }
+            if (deckstring == "implicit_E_krylov_iters") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> implicit_E_krylov_iters;
+            }
+            if (deckstring == "implicit_E_precond_every") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> implicit_E_precond_every;
+            }
+            if (deckstring == "steady_state") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> deckstringbool;
+                steady_state = (deckstringbool[0] == 't' || deckstringbool[0] == 'T');
+            }
+            if (deckstring == "steady_state_tol") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> steady_state_tol;
+            }
+            if (deckstring == "steady_state_newton_iters") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> steady_state_newton_iters;
+            }
+            if (deckstring == "steady_state_krylov_iters") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> steady_state_krylov_iters;
+            }
+            if (deckstring == "steady_state_steps") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> steady_state_steps;
+            }
             if (deckstring == "dbydv_order") {
                 deckfile >> deckequalssign;
                 if(deckequalssign != "=") {
@@ -663,6 +952,15 @@ Input::Input_List::Input_List():
                 }
                 deckfile >> dbydx_order;
             }
+            if (deckstring == "spectral_dbydx") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> deckstringbool;
+                spectral_dbydx = (deckstringbool[0] == 't' || deckstringbool[0] == 'T');
+            }
             if (deckstring == "dbydy_order") {
                 deckfile >> deckequalssign;
                 if(deckequalssign != "=") {
@@ -731,6 +1029,15 @@ Input::Input_List::Input_List():
                 deckfile >> deckstringbool;
                 implicit_B = (deckstringbool[0] == 't' || deckstringbool[0] == 'T');
             }
+            if (deckstring == "implicit_maxwell") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> deckstringbool;
+                implicit_maxwell = (deckstringbool[0] == 't' || deckstringbool[0] == 'T');
+            }
             if (deckstring == "vgradf") {
                 deckfile >> deckequalssign;
                 if(deckequalssign != "=") {
@@ -992,6 +1299,136 @@ Input::Input_List::Input_List():
                 deckfile >> deckstringbool;
                 o_Bzhist = (deckstringbool[0] == 't' || deckstringbool[0] == 'T');
             }
+            if (deckstring == "hist_buffer_steps") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> hist_buffer_steps;
+                if(hist_buffer_steps < 1) {
+                    std::cout << "Error reading " << deckstring << " , it must be at least 1" << std::endl;
+                    exit(1);
+                }
+            }
+            if (deckstring == "hist_x_stride") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> hist_x_stride;
+                if(hist_x_stride < 1) {
+                    std::cout << "Error reading " << deckstring << " , it must be at least 1" << std::endl;
+                    exit(1);
+                }
+            }
+            if (deckstring == "hist_t_stride") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> hist_t_stride;
+                if(hist_t_stride < 1) {
+                    std::cout << "Error reading " << deckstring << " , it must be at least 1" << std::endl;
+                    exit(1);
+                }
+            }
+            if (deckstring == "health_check") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> deckstringbool;
+                health_check = (deckstringbool[0] == 't' || deckstringbool[0] == 'T');
+            }
+            if (deckstring == "h5_deflate_fields") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> h5_deflate_fields;
+            }
+            if (deckstring == "h5_deflate_moments") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> h5_deflate_moments;
+            }
+            if (deckstring == "h5_deflate_distributions") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> h5_deflate_distributions;
+            }
+            if (deckstring == "h5_shuffle") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> deckstringbool;
+                h5_shuffle = (deckstringbool[0] == 't' || deckstringbool[0] == 'T');
+            }
+            if (deckstring == "h5_lossy_tolerance") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> h5_lossy_tolerance;
+            }
+            if (deckstring == "h5_lossy_relative") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> deckstringbool;
+                h5_lossy_relative = (deckstringbool[0] == 't' || deckstringbool[0] == 'T');
+            }
+            if (deckstring == "h5_consolidate") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> deckstringbool;
+                h5_consolidate = (deckstringbool[0] == 't' || deckstringbool[0] == 'T');
+            }
+            if (deckstring == "out_window") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                for (size_t i(0); i < 4; ++i) deckfile >> out_window[i];
+            }
+            if (deckstring.compare(0, 11, "out_window(") == 0) {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=" || deckstring[deckstring.size()-1] != ')') {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                out_window_tags.push_back(deckstring.substr(11, deckstring.size()-12));
+                out_window_values.push_back(std::vector<double>(4));
+                for (size_t i(0); i < 4; ++i) deckfile >> out_window_values.back()[i];
+            }
+            if (deckstring == "allfs_l_max") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> allfs_l_max;
+            }
 
 
             if (deckstring == "o_Ex") {
@@ -1381,6 +1818,15 @@ Input::Input_List::Input_List():
                 deckfile >> deckstringbool;
                 o_p2x1 = (deckstringbool[0] == 't' || deckstringbool[0] == 'T');
             }
+            if (deckstring == "o_p3x1") {
+                deckfile >> deckequalssign;
+                if(deckequalssign != "=") {
+                    std::cout << "Error reading " << deckstring << std::endl;
+                    exit(1);
+                }
+                deckfile >> deckstringbool;
+                o_p3x1 = (deckstringbool[0] == 't' || deckstringbool[0] == 'T');
+            }
             if (deckstring == "o_f0x1") {
                 deckfile >> deckequalssign;
                 if(deckequalssign != "=") {
@@ -2147,8 +2593,6 @@ Input::Input_List::Input_List():
 
         }
 
-        deckfile.close();
-
         for (size_t i(0); i < MPI_X.size(); ++i)
         {
             if (((MPI_X[i]%2)!=0) && (MPI_X[i] > 1) )
@@ -2180,7 +2624,11 @@ Input::Input_List::Input_List():
         oTags.push_back("allfs");
         oTags.push_back("allfs_f2");
         oTags.push_back("allfs_flogf");
+        oTags.push_back("pz");
         oTags.push_back("pxpy");
+        oTags.push_back("pxpz");
+        oTags.push_back("pypz");
+        oTags.push_back("pxpypz");
 
         oTags.push_back("fhat0hist");
         oTags.push_back("Exhist");
@@ -2217,6 +2665,7 @@ Input::Input_List::Input_List():
         
 
         oTags.push_back("Timings");
+        if (health_check) oTags.push_back("Health");
 
         for (size_t i(0); i<numps.size();++i)
         {
@@ -2275,6 +2724,13 @@ Input::Input_List::Input_List():
             dpz.push_back(temp);
         }
 
+        //  The implicit E-field solver advances the fields on its own
+        if (implicit_E && implicit_maxwell)
+        {
+            std::cout << "Error reading implicit_maxwell , it cannot be combined with implicit_E" << std::endl;
+            exit(1);
+        }
+
         // Determination of the local computational domain (i.e. the x-axis and the y-axis)
         if (implicit_E)
         {
@@ -40,6 +40,11 @@ namespace Input{
         size_t ompthreads;
         
         vector<size_t> MPI_X;
+        bool load_balance;
+        double load_balance_tolerance;
+        size_t MPI_time;
+        size_t parareal_iterations, parareal_coarse_ratio, parareal_coarse_l0;
+        double parareal_tolerance;
 
         size_t numsp;
 
@@ -53,15 +58,26 @@ namespace Input{
         bool filterdistribution, filter_Nl;
         double filter_dp, filter_pmax;
 
+        bool adaptive_lmax;
+        double adaptive_lmax_threshold, adaptive_lmax_hysteresis;
+
 //          Algorithms
         bool if_tridiagonal;
         bool implicit_E;
+        bool implicit_E_newton_krylov;
+        double implicit_E_newton_tol;
+        size_t implicit_E_newton_iters, implicit_E_krylov_iters, implicit_E_precond_every;
+        bool steady_state;
+        double steady_state_tol;
+        size_t steady_state_newton_iters, steady_state_krylov_iters, steady_state_steps;
         size_t dbydx_order, dbydy_order, dbydv_order;
+        bool spectral_dbydx;
         bool adaptive_dt;
         double adaptive_tmin, abs_tol, rel_tol;
         size_t max_fails;
         bool relativity;
         bool implicit_B;
+        bool implicit_maxwell;
         bool collisions;
         int f00_implicitorexplicit;
         int flm_collisions;
@@ -77,10 +93,24 @@ namespace Input{
         size_t n_outsteps, n_distoutsteps, n_bigdistoutsteps;
         double t_stop;
         int restart_time;  int n_restarts;
+        int restart_deflate;
+        int n_buddy_checkpoints, buddy_disk_every;
+        std::string buddy_dir;
+        bool restart_from_buddy;
 
 //          Output
         bool o_fhat0hist;
         bool o_Exhist, o_Eyhist, o_Ezhist, o_Bxhist, o_Byhist, o_Bzhist;
+        size_t hist_buffer_steps, hist_x_stride, hist_t_stride;
+        bool health_check;
+        int h5_deflate_fields, h5_deflate_moments, h5_deflate_distributions;
+        bool h5_shuffle, h5_lossy_relative;
+        double h5_lossy_tolerance;
+        bool h5_consolidate;
+        std::vector<double> out_window;                         // xmin xmax x_stride p_stride
+        std::vector< std::string > out_window_tags;             // Tags with their own window
+        std::vector< std::vector<double> > out_window_values;
+        int allfs_l_max;
         bool o_Ex, o_Ey, o_Ez, o_Bx, o_By, o_Bz, o_x1x2, o_pth;
         
         bool o_p1x1, o_p2x1, o_p3x1, o_p1p2x1, o_p1p3x1, o_p2p3x1, o_p1p2p3x1;
@@ -112,6 +142,8 @@ namespace Input{
 //          Electron-electron collisions
         size_t RB_D_itmax;
         double RB_D_tolerance;
+        double coll_coeff_tolerance;
+        size_t coll_coeff_max_age;
         double small_dt;
         double smaller_dt;
         int NB_algorithms;
@@ -211,6 +243,7 @@ namespace Input{
         std::vector<size_t> NxGlobal;
         std::vector<size_t> NxLocalnobnd;
         std::vector<size_t> NxLocal;
+        std::vector<size_t> NxSlabs;            // Interior x-cells of each spatial rank
 
         std::vector<double> xminGlobal;
         std::vector<double> xmaxGlobal;
@@ -132,30 +132,19 @@
     }
 
 //**************************************************************
-int main(int argc, char** argv) {
+//  One pass of the 1D code. Returns true when the x-slabs were re-cut from
+//  measured costs, and the run must go on from the restart just written.
+    bool run_1D(const bool reentry){
 
-    MPI_Init(&argc,&argv);
-    time_t tstart, tend;
-    tstart = omp_get_wtime();
-
-    omp_set_num_threads(Input::List().ompthreads);
-    
+        bool rebalanced(false);
 
-    ///////////////////////////////////////////////////////////////////////////////////
-    ///////////////////////////////////////////////////////////////////////////////////
-    /////////     MAIN LOOP                                                      ///////
-    /////////       CONTAINS AN IF STATEMENT FOR EXPLICIT OR IMPLICIT E SOLVER  ///////
-    ///////////////////////////////////////////////////////////////////////////////////
-    ///////////////////////////////////////////////////////////////////////////////////
-    if (Input::List().dim == 1)   /// 1-D
-    {
         ///  Initiate the Parallel Environment and decompose the Computational Domain
         std::cout << "\nInitializing parallel environment ...";
         Parallel_Environment_1D PE;
 
         std::cout << "     done \n\n";
-        
-        if (PE.RANK() == 0) {
+    
+        if ((PE.RANK() == 0) && (Time_Decomposition::Slice() == 0) && !reentry) {
             Export_Files::Folders();
         }
     // --------------------------------------------------------------------------------------------------------------------------------
@@ -174,7 +163,7 @@ int main(int argc, char** argv) {
                         Input::List().dpx,Input::List().dpy,Input::List().dpz);
                         // Input::List().Npx, Input::List().Npy, Input::List().Npz);
         if (!PE.RANK()) std::cout << "     done \n";
-        
+    
     // --------------------------------------------------------------------------------------------------------------------------------
     // --------------------------------------------------------------------------------------------------------------------------------
     ///  CLOCK
@@ -190,12 +179,12 @@ int main(int argc, char** argv) {
             tout_start = 0;
         }
         size_t t_out(tout_start+1);
-        
+    
         double dt_out(Input::List().t_stop / (Input::List().n_outsteps));
         double dt_dist_out(Input::List().t_stop / (Input::List().n_distoutsteps));
         double dt_big_dist_out(Input::List().t_stop / (Input::List().n_bigdistoutsteps));
         double dt_restart(Input::List().t_stop / (Input::List().n_restarts));
-        
+    
         double next_out(t_out*dt_out);
         double next_dist_out((tout_start*dt_out)+dt_dist_out);
         double next_big_dist_out((tout_start*dt_out)+dt_big_dist_out);
@@ -209,11 +198,11 @@ int main(int argc, char** argv) {
     ///  INITIALIZATION
     // --------------------------------------------------------------------------------------------------------------------------------
     // --------------------------------------------------------------------------------------------------------------------------------
-    
+
         if (!PE.RANK()) std::cout << "Initializing restart environment ...";
         Export_Files::Restart_Facility Re(PE.RANK());
         if (!PE.RANK()) std::cout << "     done \n";
-    
+
         if (!PE.RANK()) std::cout << "Initializing state variable ...";
         State1D Y( grid.axis.Nx(0), Input::List().ls, Input::List().ms, 
             Input::List().dp, 
@@ -221,44 +210,62 @@ int main(int argc, char** argv) {
             Input::List().hydromass, Input::List().hydrocharge);
 
         if (!PE.RANK()) std::cout << "     done \n";
-    
+
         if (!PE.RANK()) std::cout << "Initializing plasma profile ...";
         Setup_Y::initialize(Y, grid);
         if (!PE.RANK()) std::cout << "     done \n";
-        
+    
 
         if (!PE.RANK()) std::cout << "Initializing collision module ...";
         collisions_1D collide(Y);
         if (!PE.RANK()) std::cout << "     done \n";    
-        
+    
         if (!PE.RANK()) std::cout << "Initializing hydro module ...";
         Hydro_Functor         HydroFunc(grid.axis.xmin(0), grid.axis.xmax(0), grid.axis.Nx(0));
         if (!PE.RANK()) std::cout << "     done \n";
-    
-        if (Input::List().isthisarestart){
+
+        //  The in-memory checkpoints are taken between outputs, so the run 
+        //  continues from the time of the checkpoint and the last output
+        bool buddy_restart(Input::List().isthisarestart && Input::List().restart_from_buddy && !reentry);
+        if (buddy_restart){
+            if (Input::List().implicit_E) {
+                if (!PE.RANK()) std::cout << "\n\n ERROR :: In-memory checkpoints are only taken by the explicit 1D loop \n\n";
+                exit(1);
+            }
+            if (!PE.RANK()) std::cout << "Reading in-memory checkpoints ...";
+            size_t re_step;
+            Re.Read_Buddy(re_step,Y,start_time);
+            tout_start = re_step;
+            Input::List().restart_time = re_step;
+            if (!PE.RANK()) std::cout << "     done \n";
+        }
+        else if (Input::List().isthisarestart){
             if (!PE.RANK()) std::cout << "Reading restart files ...";
             Re.Read(PE.RANK(),tout_start,Y,start_time);
             if (!PE.RANK()) std::cout << "     done \n";
         }
-        
+    
         if (!PE.RANK()) std::cout << "Initializing output module ...";
         Output_Data::Output_Preprocessor  output( grid, Input::List().oTags);
         if (!PE.RANK()) std::cout << "     done \n";
-        
-        if (!PE.RANK()) std::cout << "Output #0 ...";    
-        output( Y, grid, tout_start, start_time, Input::List().dt, PE );
-        if (!PE.RANK()) std::cout << "     done \n";
     
-        if (!PE.RANK()) std::cout << "Distribution function output #0 ...";    
-        output.distdump(Y, grid, tout_start, start_time, Input::List().dt, PE );
-        output.bigdistdump(Y, grid, tout_start, start_time, Input::List().dt, PE );
-        if (!PE.RANK()) std::cout << "     done \n";
+        //  A rebalanced run continues from its own last output, a later time slice from the first of its window
+        if (!reentry && !buddy_restart && (Time_Decomposition::Slice() == 0)) {
+            if (!PE.RANK()) std::cout << "Output #0 ...";    
+            output( Y, grid, tout_start, start_time, Input::List().dt, PE );
+            if (!PE.RANK()) std::cout << "     done \n";
     
+            if (!PE.RANK()) std::cout << "Distribution function output #0 ...";    
+            output.distdump(Y, grid, tout_start, start_time, Input::List().dt, PE );
+            output.bigdistdump(Y, grid, tout_start, start_time, Input::List().dt, PE );
+            if (!PE.RANK()) std::cout << "     done \n";
+        }
+
         double plasmaperiod;
-        if (!(PE.RANK())){
+        if (!(PE.RANK()) && !reentry){
             plasmaperiod = startmessages();
         }
-    
+
     // --------------------------------------------------------------------------------------------------------------------------------
     // --------------------------------------------------------------------------------------------------------------------------------
     // --------------------------------------------------------------------------------------------------------------------------------
@@ -271,9 +278,15 @@ int main(int argc, char** argv) {
             { 
                 std::cout << "Starting Semi-Implicit, 1D OSHUN\n";
             }
-            
+            if (Input::List().steady_state)
+            {
+                if (!PE.RANK()) std::cout << "\n\n ERROR :: steady_state requires the explicit E-field solver \n\n";
+                MPI_Finalize();
+                exit(1);
+            }
+        
             Algorithms::RK2<State1D> RK(Y);
-            
+        
             // --------------------------------------------------------------------------------------------------------------------------------
             // --------------------------------------------------------------------------------------------------------------------------------
             // --------------------------------------------------------------------------------------------------------------------------------
@@ -285,7 +298,7 @@ int main(int argc, char** argv) {
             VlasovFunctor1D_implicitE_p2 impE_p2_Functor(Input::List().ls, Input::List().ms,                                                         
                                                             Input::List().dp,
                                                          grid.axis.xmin(0), grid.axis.xmax(0), grid.axis.Nx(0));
-            
+        
             // --------------------------------------------------------------------------------------------------------------------------------
             using Electric_Field_Methods::Efield_Method;
             Electric_Field_Methods::Implicit_E_Field eim(grid.axis);
@@ -313,7 +326,7 @@ int main(int argc, char** argv) {
                 //     RK54(Y_star,Y,theclock.dt(),&impE_p1_Functor);
                 //     success = theclock.update_dt(Y_old,Y_star, Y);
                 // }
-                
+            
                 Y = RK(Y, theclock.dt(), &impE_p1_Functor);                                                             /// Vlasov - Updates the distribution function: Spatial Advection and B Field "action".
                 PE.Neighbor_ImplicitE_Communications(Y);                                                            /// Boundaries
                 eim.advance(&RK, Y, collide,&impE_p2_Functor, theclock.dt());                                           /// Finds new electric field
@@ -328,6 +341,8 @@ int main(int argc, char** argv) {
                 if (Input::List().trav_wave) Setup_Y::applytravelingwave(grid, Y, theclock.time(), theclock.dt());
 
                 PE.Neighbor_Communications(Y);                                         ///  Boundaries      //
+
+                theclock.health_check(Y, collide, grid, output, PE);
                 // --------------------------------------------------------------------------------------------------------------------------------
                 // --------------------------------------------------------------------------------------------------------------------------------
                 /// Output
@@ -338,7 +353,7 @@ int main(int argc, char** argv) {
                     output.distdump(Y, grid, t_out, theclock.time(), theclock.dt(), PE);
                     next_dist_out += dt_dist_out;
                 }
-                
+            
                 if (theclock.time() > next_big_dist_out)
                 {
                     if (!(PE.RANK())) cout << " \n Big Dist Output #" << t_out << "\n";
@@ -359,11 +374,12 @@ int main(int argc, char** argv) {
                     {
                         cout << "\n dt = " << theclock.dt();
                         cout << " , Output #" << t_out;
-                        
+                    
                     }
 
+                    output.histflush(grid, theclock.dt(), PE);
                     output(Y, grid, t_out, theclock.time(), theclock.dt(), PE);
-                    Y.checknan();
+                    if (!Input::List().health_check) Y.checknan();
 
                     next_out += dt_out;
                     ++t_out;
@@ -386,6 +402,21 @@ int main(int argc, char** argv) {
                                           grid.axis.xmin(0), grid.axis.xmax(0), grid.axis.Nx(0));
             // --------------------------------------------------------------------------------------------------------------------------------
 
+            //  Time slices of the run advance concurrently
+            if (Time_Decomposition::Slices() > 1)
+            {
+                Parareal parareal(Y, grid);
+                parareal.run(Y, grid, output, Re, rkF, collide, PE);
+                return false;
+            }
+            //  Solve directly for the state the run settles into
+            if (Input::List().steady_state)
+            {
+                Steady_State steady(Y);
+                steady.run(Y, grid, output, Re, rkF, collide, PE);
+                return false;
+            }
+
             // Algorithms::RK4<State1D> RK(Y);
             State1D Y_star, Y_old;
             // Y_old = static_cast<complex<double> >(0.0);
@@ -395,7 +426,7 @@ int main(int argc, char** argv) {
                 Y);
             
             // for(theclock; theclock.time() < Input::List().t_stop; ++theclock)
-            for(theclock; theclock.time() < Input::List().t_stop; theclock.advance(Y, grid, output, Re, PE))                
+            for(theclock; (theclock.time() < Input::List().t_stop) && !theclock.rebalance(); theclock.advance(Y, grid, output, Re, PE))                
             {
 
 
@@ -407,9 +438,48 @@ int main(int argc, char** argv) {
                 //     Y = RK(Y, theclock.dt(), &HydroFunc);                                                   /// Hydro Motion
                 // PE.Neighbor_Communications(Y);                                         ///  Boundaries      //                
             }
+
+            //  Start again from the restart just written, with new slabs
+            rebalanced = theclock.rebalance();
+            if (rebalanced)
+            {
+                Input::List().isthisarestart = true;
+                Input::List().restart_time   = theclock.rebalance_restart();
+                Input::List().restart_from_buddy = false;
+                MPI_Barrier(MPI_COMM_WORLD);
+                if (!PE.RANK()) std::cout << "\n Rebalancing x-slabs from restart #" << Input::List().restart_time << "\n";
+            }
         }
+        return rebalanced;
+    }
+
+//**************************************************************
+int main(int argc, char** argv) {
+
+    MPI_Init(&argc,&argv);
+    time_t tstart, tend;
+    tstart = omp_get_wtime();
+
+    omp_set_num_threads(Input::List().ompthreads);
+    
+
+    ///////////////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////////////
+    /////////     MAIN LOOP                                                      ///////
+    /////////       CONTAINS AN IF STATEMENT FOR EXPLICIT OR IMPLICIT E SOLVER  ///////
+    ///////////////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////////////
+    if (Input::List().dim == 1)   /// 1-D
+    {
+        bool rebalanced(false);             // Re-entry after the x-slabs were re-cut from measured costs
+        do {
+            rebalanced = run_1D(rebalanced);
+        } while (rebalanced);
+
+        int rank;
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
         tend = omp_get_wtime();
-        if (!(PE.RANK())){
+        if (!rank){
             cout << "Simulation took "<< difftime(tend, tstart) <<" second(s)."<< endl;
         }
     }
@@ -23,6 +23,7 @@
 //  My libraries
     #include "lib-array.h"
     #include "input.h"
+    #include "nmethods.h"
 
 
 //-------------------------------------------------------------------
@@ -503,6 +504,122 @@ bool Thomas_Tridiagonal(Array2D<double>& A,
 //-------------------------------------------------------------------
 
 
+//-------------------------------------------------------------------
+    FFT::FFT(size_t _n) : n(_n), maxradix(1), w(n) {
+
+        size_t rest(n);
+        while (rest % 4 == 0) { radix.push_back(4); rest /= 4; }
+        while (rest % 2 == 0) { radix.push_back(2); rest /= 2; }
+        for (size_t p(3); p*p <= rest; p += 2) {
+            while (rest % p == 0) { radix.push_back(p); rest /= p; }
+        }
+        if (rest > 1) radix.push_back(rest);
+
+        for (size_t i(0); i < radix.size(); ++i) maxradix = max(maxradix, radix[i]);
+
+        for (size_t k(0); k < n; ++k) w[k] = polar(1.0, -2.0*M_PI*double(k)/double(n));
+    }
+//-------------------------------------------------------------------
+//  Transform len values, stride apart in "in", into "out"; t holds
+//  one butterfly
+    void FFT::pass(const complex<double>* in, complex<double>* out, size_t len, size_t stride, 
+                   size_t level, bool inv, complex<double>* t) const {
+
+        if (len == 1) { out[0] = in[0]; return; }
+
+        const size_t p(radix[level]), m(len/p), step(n/len);
+
+        for (size_t r(0); r < p; ++r) pass(in + r*stride, out + r*m, m, stride*p, level+1, inv, t);
+
+        for (size_t k(0); k < m; ++k) {
+            t[0] = out[k];
+            for (size_t r(1); r < p; ++r) {
+                complex<double> tw(w[(r*k*step) % n]);
+                t[r] = out[r*m+k] * (inv ? conj(tw) : tw);
+            }
+
+            if (p == 2) {
+                out[k]   = t[0] + t[1];
+                out[m+k] = t[0] - t[1];
+            }
+            else if (p == 4) {
+                complex<double> a(t[0] + t[2]), b(t[0] - t[2]), c(t[1] + t[3]), 
+                                d(inv ? complex<double>(-(t[1]-t[3]).imag(), (t[1]-t[3]).real()) 
+                                      : complex<double>( (t[1]-t[3]).imag(),-(t[1]-t[3]).real()));
+                out[k]     = a + c;
+                out[m+k]   = b + d;
+                out[2*m+k] = a - c;
+                out[3*m+k] = b - d;
+            }
+            else {
+                for (size_t q(0); q < p; ++q) {
+                    complex<double> sum(t[0]);
+                    for (size_t r(1); r < p; ++r) {
+                        complex<double> tw(w[((r*q) % p)*(n/p)]);
+                        sum += t[r] * (inv ? conj(tw) : tw);
+                    }
+                    out[q*m+k] = sum;
+                }
+            }
+        }
+    }
+//-------------------------------------------------------------------
+    void FFT::forward(valarray<complex<double> >& x, valarray<complex<double> >& work) const {
+        valarray<complex<double> > t(maxradix);
+        pass(&x[0], &work[0], n, 1, 0, false, &t[0]);
+        x = work;
+    }
+//-------------------------------------------------------------------
+    void FFT::inverse(valarray<complex<double> >& x, valarray<complex<double> >& work) const {
+        valarray<complex<double> > t(maxradix);
+        pass(&x[0], &work[0], n, 1, 0, true, &t[0]);
+        x = work;
+    }
+//-------------------------------------------------------------------
+
+//-------------------------------------------------------------------
+//  One plan per length, shared by all threads
+    static const FFT& fft_plan(size_t n) {
+        static map<size_t, FFT> plans;
+        const FFT* plan;
+        #pragma omp critical(fft_plans)
+        {
+            map<size_t, FFT>::iterator it(plans.find(n));
+            if (it == plans.end()) it = plans.insert(make_pair(n, FFT(n))).first;
+            plan = &(it->second);
+        }
+        return *plan;
+    }
+//-------------------------------------------------------------------
+    void Spectral_Dx(complex<double>* f, size_t n, size_t stride, size_t nlines, size_t line_stride) {
+
+        const size_t Nbc(Input::List().BoundaryCells);
+        const size_t N(n - 2*Nbc);
+        const FFT& plan(fft_plan(N));
+
+//      -2 dx * i k, normalization included; the Nyquist mode has no derivative
+        valarray<complex<double> > ik(N);
+        for (size_t m(0); m < N; ++m) {
+            double km((m <= N/2) ? double(m) : double(m) - double(N));
+            if (2*m == N) km = 0.0;
+            ik[m] = complex<double>(0.0, -4.0*M_PI*km/double(N))/double(N);
+        }
+
+        valarray<complex<double> > x(N), work(N);
+        for (size_t l(0); l < nlines; ++l) {
+            complex<double>* line(f + l*line_stride);
+
+            for (size_t i(0); i < N; ++i) x[i] = line[(i+Nbc)*stride];
+            plan.forward(x, work);
+            x *= ik;
+            plan.inverse(x, work);
+
+            for (size_t i(0); i < n; ++i) line[i*stride] = x[(i + N*Nbc - Nbc) % N];
+        }
+    }
+//-------------------------------------------------------------------
+
+
 /**
  * @brief      Convert data structure to float structure
  *
@@ -110,6 +110,46 @@ complex<double> Detz33(valarray<complex <double> >& D,
 //-------------------------------------------------------------------
 
 
+//-------------------------------------------------------------------
+/// @brief      Self-contained mixed-radix FFT of a fixed length
+///
+///  Recursive Cooley-Tukey over the factors 4, 2, 3, 5 and any
+///  remaining primes, with the twiddles computed once. Neither
+///  direction is normalized.
+class FFT {
+public:
+    FFT(size_t n);
+    size_t size() const {return n;}
+
+    void forward(valarray<complex<double> >& x, valarray<complex<double> >& work) const;
+    void inverse(valarray<complex<double> >& x, valarray<complex<double> >& work) const;
+
+private:
+    size_t n, maxradix;
+    vector<size_t> radix;
+    valarray<complex<double> > w;       // exp(-2 pi i k/n)
+
+    void pass(const complex<double>* in, complex<double>* out, size_t len, size_t stride, 
+              size_t level, bool inv, complex<double>* t) const;
+};
+//-------------------------------------------------------------------
+
+//-------------------------------------------------------------------
+/// @brief      Spectral counterpart of the Dx stencils
+///
+/// @param      f            First element of the first line
+/// @param[in]  n            Cells along a line, guard cells included
+/// @param[in]  stride       Distance between neighbouring cells of a line
+/// @param[in]  nlines       Number of lines
+/// @param[in]  line_stride  Distance between the first cells of two lines
+///
+///  Replaces each line by -2 dx df/dx, i.e. what the centered 
+///  difference f_i-1 - f_i+1 approximates, taking the interior
+///  cells as one period; the guard cells get the periodic images.
+void Spectral_Dx(complex<double>* f, size_t n, size_t stride, size_t nlines, size_t line_stride);
+//-------------------------------------------------------------------
+
+
 // Convert double to double
 vector<double>    valtovec(const valarray<double>& vDouble);
 vector<double>    vdouble_real(const vector<complex<double> >& vDouble);
@@ -24,6 +24,7 @@
 #include <string>
 #include <iomanip>
 #include <fstream>
+#include <sstream>
 #include <map>
 
 //  My libraries
@@ -98,7 +99,7 @@ void Node_ImplicitE_Communications_1D::Send_right_X(State1D& Y, int dest) {
         bufind += step_f;
     }
 
-    MPI_Send(&msg_bufX[0], msg_sizeX, MPI_DOUBLE_COMPLEX, dest, 0, MPI_COMM_WORLD);
+    MPI_Send(&msg_bufX[0], msg_sizeX, MPI_DOUBLE_COMPLEX, dest, 0, Time_Decomposition::Slice_Comm());
 }
 //--------------------------------------------------------------
 
@@ -114,7 +115,7 @@ void Node_ImplicitE_Communications_1D::Recv_from_left_X(State1D& Y, int origin)
     MPI_Status status;
 
     // Receive Data
-    MPI_Recv(&msg_bufX[0], msg_sizeX, MPI_DOUBLE_COMPLEX, origin, 0, MPI_COMM_WORLD, &status);
+    MPI_Recv(&msg_bufX[0], msg_sizeX, MPI_DOUBLE_COMPLEX, origin, 0, Time_Decomposition::Slice_Comm(), &status);
 
     // Fields:   x0-"---> Left-Guard"
     for(size_t i(3); i < Y.EMF().dim(); ++i){ // "3" as opposed to "0"
@@ -144,7 +145,7 @@ void Node_ImplicitE_Communications_1D::Send_left_X(State1D& Y, int dest) {
         bufind += step_f;
     }
 
-    MPI_Send(&msg_bufX[0], msg_sizeX, MPI_DOUBLE_COMPLEX, dest, 1, MPI_COMM_WORLD);
+    MPI_Send(&msg_bufX[0], msg_sizeX, MPI_DOUBLE_COMPLEX, dest, 1, Time_Decomposition::Slice_Comm());
 }
 //--------------------------------------------------------------
 
@@ -160,7 +161,7 @@ void Node_ImplicitE_Communications_1D::Recv_from_right_X(State1D& Y, int origin)
     MPI_Status status;
 
     // Receive Data
-    MPI_Recv(&msg_bufX[0], msg_sizeX, MPI_DOUBLE_COMPLEX, origin, 1, MPI_COMM_WORLD, &status);
+    MPI_Recv(&msg_bufX[0], msg_sizeX, MPI_DOUBLE_COMPLEX, origin, 1, Time_Decomposition::Slice_Comm(), &status);
 
     // Fields:   x0-"Right-Guard <--- "
     for(size_t i(3); i < Y.EMF().dim(); ++i){ // "3" as opposed to "0"
@@ -437,7 +438,7 @@ void Node_Communications_1D::Send_right_X(State1D& Y, int dest) {
     
 
         
-    MPI_Send(&msg_bufX[0], msg_sizeX, MPI_DOUBLE_COMPLEX, dest, 0, MPI_COMM_WORLD);
+    MPI_Send(&msg_bufX[0], msg_sizeX, MPI_DOUBLE_COMPLEX, dest, 0, Time_Decomposition::Slice_Comm());
 
 
 }
@@ -456,7 +457,7 @@ void Node_Communications_1D::Recv_from_left_X(State1D& Y, int origin) {
     MPI_Status status;
 
     // Receive Data
-    MPI_Recv(&msg_bufX[0], msg_sizeX, MPI_DOUBLE_COMPLEX, origin, 0, MPI_COMM_WORLD, &status);
+    MPI_Recv(&msg_bufX[0], msg_sizeX, MPI_DOUBLE_COMPLEX, origin, 0, Time_Decomposition::Slice_Comm(), &status);
 
     // Harmonics:x0-"---> Left-Guard"
     for(size_t s(0); s < Y.Species(); ++s) 
@@ -610,7 +611,7 @@ void Node_Communications_1D::Send_left_X(State1D& Y, int dest) {
         bufind += step_f;
     }
 
-    MPI_Send(&msg_bufX[0], msg_sizeX, MPI_DOUBLE_COMPLEX, dest, 1, MPI_COMM_WORLD);
+    MPI_Send(&msg_bufX[0], msg_sizeX, MPI_DOUBLE_COMPLEX, dest, 1, Time_Decomposition::Slice_Comm());
 }
 
 //--------------------------------------------------------------
@@ -627,7 +628,7 @@ void Node_Communications_1D::Recv_from_right_X(State1D& Y, int origin) {
     MPI_Status status;
 
     // Receive Data
-    MPI_Recv(&msg_bufX[0], msg_sizeX, MPI_DOUBLE_COMPLEX, origin, 1, MPI_COMM_WORLD, &status);
+    MPI_Recv(&msg_bufX[0], msg_sizeX, MPI_DOUBLE_COMPLEX, origin, 1, Time_Decomposition::Slice_Comm(), &status);
 
     // Harmonics:x0-"Right-Guard <--- "
     for(size_t s(0); s < Y.Species(); ++s) 
@@ -1029,8 +1030,21 @@ Parallel_Environment_1D:: Parallel_Environment_1D() :
         MPI_Procs(Input::List().MPI_X[0])   // Number of nodes in X-direction
 {
     // Determination of the rank and size of the run
-    MPI_Comm_size(MPI_COMM_WORLD, &MPI_Procs);
-    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    Time_Decomposition::Setup();
+    MPI_Comm_size(Time_Decomposition::Slice_Comm(), &MPI_Procs);
+    MPI_Comm_rank(Time_Decomposition::Slice_Comm(), &rank);
+
+    // Slab widths in x, from the cost profile stored with the restart if there is one
+    bool buddy(Input::List().isthisarestart && Input::List().restart_from_buddy);
+    if (buddy) Load_Balance::Read_Buddy_Profile("");
+    else if (Input::List().isthisarestart) Load_Balance::Read_Profile("", Input::List().restart_time);
+    Load_Balance::Partition(MPI_Procs, Input::List().NxSlabs);
+
+    // The in-memory checkpoints can only be read with the slabs they were taken with
+    if (buddy && (Load_Balance::Restart_Slabs().size() == size_t(MPI_Procs))) Input::List().NxSlabs = Load_Balance::Restart_Slabs();
+
+    Input::List().NxLocalnobnd[0] = Input::List().NxSlabs[rank];
+    Input::List().NxLocal[0]      = Input::List().NxLocalnobnd[0] + 2 * Input::List().BoundaryCells;
 
     if (error_check()) 
     {
@@ -1038,11 +1052,15 @@ Parallel_Environment_1D:: Parallel_Environment_1D() :
         MPI_Finalize(); exit(1);
     }
 
+    Load_Balance::Reset();
+
     // Determination of the local computational domain (i.e. the x-axis and the y-axis)
     for(size_t i(0); i < Input::List().xminLocal.size(); ++i) {
 
+        size_t first_cell((i == 0) ? Slab_Offset(rank) : rank * Input::List().NxLocalnobnd[i]);
+
         Input::List().xminLocal[i] = Input::List().xminGlobal[i]
-                                     + rank * Input::List().NxLocalnobnd[i] * Input::List().globdx[i]
+                                     + first_cell * Input::List().globdx[i]
                                      - Input::List().BoundaryCells * Input::List().globdx[i];
         Input::List().xmaxLocal[i] = Input::List().xminLocal[i]
                                      + (Input::List().NxLocal[i]) * Input::List().globdx[i];
@@ -1082,7 +1100,12 @@ bool Parallel_Environment_1D:: error_check() {
 
     // Test the number of cells
     if (rank == 0){
-        if (Input::List().NxLocal[0] < 2*Input::List().BoundaryCells+2){
+        if (Input::List().NxSlabs.size() != size_t(MPI_Procs)) {
+            std::cout << "The slab decomposition does not match the number of processors" << endl;
+            return true;
+        }
+        size_t min_cells(*min_element(Input::List().NxSlabs.begin(), Input::List().NxSlabs.end()));
+        if (min_cells < 2 || min_cells < size_t(Input::List().BoundaryCells)){
             std::cout << "Not enough cells per processor" << endl;
             return true;
         }
@@ -1091,6 +1114,10 @@ bool Parallel_Environment_1D:: error_check() {
                        << (Input::List().MPI_X[0]) << ", terminating ..." << endl;
             return true;
         }
+        if (Input::List().spectral_dbydx && (MPI_Procs > 1 || bndX != 0)) {
+            std::cout << "spectral_dbydx needs a single periodic slab in x" << endl;
+            return true;
+        }
     }
     return false;
 }
@@ -1106,6 +1133,30 @@ int Parallel_Environment_1D:: MPI_Processes() const {return MPI_Procs;}
 int Parallel_Environment_1D:: BNDX()  const {return bndX;}
 //--------------------------------------------------------------
 
+//--------------------------------------------------------------
+//  Slab decomposition
+//--------------------------------------------------------------
+size_t Parallel_Environment_1D:: Slab_Cells(const int r) const {return Input::List().NxSlabs[r];}
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+size_t Parallel_Environment_1D:: Slab_Offset(const int r) const {
+    size_t offset(0);
+    for (int q(0); q < r; ++q) offset += Input::List().NxSlabs[q];
+    return offset;
+}
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+size_t Parallel_Environment_1D:: Max_Slab_Cells() const {
+    return *max_element(Input::List().NxSlabs.begin(), Input::List().NxSlabs.end());
+}
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+void Parallel_Environment_1D:: Gather_Counts(const size_t values_per_cell, vector<int>& counts, vector<int>& displs) const {
+    counts.resize(MPI_Procs); displs.resize(MPI_Procs);
+    for (int q(0); q < MPI_Procs; ++q) {
+        counts[q] = static_cast<int>(values_per_cell * Slab_Cells(q));
+        displs[q] = static_cast<int>(values_per_cell * Slab_Offset(q));
+    }
+}
+//--------------------------------------------------------------
+
 
 //--------------------------------------------------------------
 void Parallel_Environment_1D::Neighbor_ImplicitE_Communications(State1D& Y){
@@ -1358,7 +1409,7 @@ void Parallel_Environment_1D::Neighbor_Communications(State1D& Y) {
             }
         } 
 
-        MPI_Send(msg_bufX, msg_sizeX, MPI_DOUBLE_COMPLEX, dest, 0, MPI_COMM_WORLD);
+        MPI_Send(msg_bufX, msg_sizeX, MPI_DOUBLE_COMPLEX, dest, 0, Time_Decomposition::Slice_Comm());
     }
 //--------------------------------------------------------------
 
@@ -1374,7 +1425,7 @@ void Parallel_Environment_1D::Neighbor_Communications(State1D& Y) {
         MPI_Status status; 
 
         // Receive Data
-        MPI_Recv(msg_bufX, msg_sizeX, MPI_DOUBLE_COMPLEX, origin, 0, MPI_COMM_WORLD, &status);
+        MPI_Recv(msg_bufX, msg_sizeX, MPI_DOUBLE_COMPLEX, origin, 0, Time_Decomposition::Slice_Comm(), &status);
 
         // Fields:   x0-"---> Left-Guard"
         for(size_t i(3); i < Y.EMF().dim(); ++i){  // "3" as opposed to "0"
@@ -1409,7 +1460,7 @@ void Parallel_Environment_1D::Neighbor_Communications(State1D& Y) {
             }
         }
 
-        MPI_Send(msg_bufX, msg_sizeX, MPI_DOUBLE_COMPLEX, dest, 1, MPI_COMM_WORLD);
+        MPI_Send(msg_bufX, msg_sizeX, MPI_DOUBLE_COMPLEX, dest, 1, Time_Decomposition::Slice_Comm());
     }
 //--------------------------------------------------------------
 
@@ -1425,7 +1476,7 @@ void Parallel_Environment_1D::Neighbor_Communications(State1D& Y) {
         MPI_Status status; 
 
         // Receive Data
-        MPI_Recv(msg_bufX, msg_sizeX, MPI_DOUBLE_COMPLEX, origin, 1, MPI_COMM_WORLD, &status);
+        MPI_Recv(msg_bufX, msg_sizeX, MPI_DOUBLE_COMPLEX, origin, 1, Time_Decomposition::Slice_Comm(), &status);
 
         // Fields:   x0-"Right-Guard <--- "
         for(size_t i(3); i < Y.EMF().dim(); ++i){  // "3" as opposed to "0"
@@ -1463,7 +1514,7 @@ void Parallel_Environment_1D::Neighbor_Communications(State1D& Y) {
             }
         } 
 
-        MPI_Send(msg_bufY, msg_sizeY, MPI_DOUBLE_COMPLEX, dest, 0, MPI_COMM_WORLD);
+        MPI_Send(msg_bufY, msg_sizeY, MPI_DOUBLE_COMPLEX, dest, 0, Time_Decomposition::Slice_Comm());
     }
 //--------------------------------------------------------------
 
@@ -1479,7 +1530,7 @@ void Parallel_Environment_1D::Neighbor_Communications(State1D& Y) {
         MPI_Status status; 
 
         // Receive Data
-        MPI_Recv(msg_bufY, msg_sizeY, MPI_DOUBLE_COMPLEX, origin, 0, MPI_COMM_WORLD, &status);
+        MPI_Recv(msg_bufY, msg_sizeY, MPI_DOUBLE_COMPLEX, origin, 0, Time_Decomposition::Slice_Comm(), &status);
 
         // Fields:   x0-"---> Left-Guard"
         for(size_t i(3); i < Y.EMF().dim(); ++i){  // "3" as opposed to "0"
@@ -1514,7 +1565,7 @@ void Parallel_Environment_1D::Neighbor_Communications(State1D& Y) {
             }
         }
 
-        MPI_Send(msg_bufY, msg_sizeY, MPI_DOUBLE_COMPLEX, dest, 1, MPI_COMM_WORLD);
+        MPI_Send(msg_bufY, msg_sizeY, MPI_DOUBLE_COMPLEX, dest, 1, Time_Decomposition::Slice_Comm());
     }
 //--------------------------------------------------------------
 
@@ -1530,7 +1581,7 @@ void Parallel_Environment_1D::Neighbor_Communications(State1D& Y) {
         MPI_Status status; 
 
         // Receive Data
-        MPI_Recv(msg_bufY, msg_sizeY, MPI_DOUBLE_COMPLEX, origin, 1, MPI_COMM_WORLD, &status);
+        MPI_Recv(msg_bufY, msg_sizeY, MPI_DOUBLE_COMPLEX, origin, 1, Time_Decomposition::Slice_Comm(), &status);
 
         // Fields:   x0-"Right-Guard <--- "
         for(size_t i(3); i < Y.EMF().dim(); ++i){  // "3" as opposed to "0"
@@ -1949,7 +2000,7 @@ void Parallel_Environment_1D::Neighbor_Communications(State1D& Y) {
             // } 
             // bufind += step_f;
         // }
-        MPI_Send(msg_bufX, msg_sizeX, MPI_DOUBLE_COMPLEX, dest, 0, MPI_COMM_WORLD);
+        MPI_Send(msg_bufX, msg_sizeX, MPI_DOUBLE_COMPLEX, dest, 0, Time_Decomposition::Slice_Comm());
     }
 //--------------------------------------------------------------
 
@@ -1966,7 +2017,7 @@ void Parallel_Environment_1D::Neighbor_Communications(State1D& Y) {
         MPI_Status status; 
 
         // Receive Data
-        MPI_Recv(msg_bufX, msg_sizeX, MPI_DOUBLE_COMPLEX, origin, 0, MPI_COMM_WORLD, &status);
+        MPI_Recv(msg_bufX, msg_sizeX, MPI_DOUBLE_COMPLEX, origin, 0, Time_Decomposition::Slice_Comm(), &status);
 
         // Harmonics:x0-"---> Left-Guard" 
         for (size_t s(0); s < Y.Species(); ++s) {
@@ -2082,7 +2133,7 @@ void Parallel_Environment_1D::Neighbor_Communications(State1D& Y) {
         //     bufind += step_f;
         // }
 
-        MPI_Send(msg_bufX, msg_sizeX, MPI_DOUBLE_COMPLEX, dest, 1, MPI_COMM_WORLD);
+        MPI_Send(msg_bufX, msg_sizeX, MPI_DOUBLE_COMPLEX, dest, 1, Time_Decomposition::Slice_Comm());
     }
 //--------------------------------------------------------------
 
@@ -2099,7 +2150,7 @@ void Parallel_Environment_1D::Neighbor_Communications(State1D& Y) {
         MPI_Status status; 
 
         // Receive Data
-        MPI_Recv(msg_bufX, msg_sizeX, MPI_DOUBLE_COMPLEX, origin, 1, MPI_COMM_WORLD, &status);
+        MPI_Recv(msg_bufX, msg_sizeX, MPI_DOUBLE_COMPLEX, origin, 1, Time_Decomposition::Slice_Comm(), &status);
 
         // Harmonics:x0-"Right-Guard <--- " 
         for(size_t s(0); s < Y.Species(); ++s) {
@@ -2215,7 +2266,7 @@ void Parallel_Environment_1D::Neighbor_Communications(State1D& Y) {
             // } 
             // bufind += step_f;
         // }
-        MPI_Send(msg_bufY, msg_sizeY, MPI_DOUBLE_COMPLEX, dest, 0, MPI_COMM_WORLD);
+        MPI_Send(msg_bufY, msg_sizeY, MPI_DOUBLE_COMPLEX, dest, 0, Time_Decomposition::Slice_Comm());
     }
 //--------------------------------------------------------------
 
@@ -2232,7 +2283,7 @@ void Parallel_Environment_1D::Neighbor_Communications(State1D& Y) {
         MPI_Status status; 
 
         // Receive Data
-        MPI_Recv(msg_bufY, msg_sizeY, MPI_DOUBLE_COMPLEX, origin, 0, MPI_COMM_WORLD, &status);
+        MPI_Recv(msg_bufY, msg_sizeY, MPI_DOUBLE_COMPLEX, origin, 0, Time_Decomposition::Slice_Comm(), &status);
 
         // Harmonics:x0-"---> Left-Guard" 
         for(size_t s(0); s < Y.Species(); ++s) {
@@ -2347,7 +2398,7 @@ void Parallel_Environment_1D::Neighbor_Communications(State1D& Y) {
         //     bufind += step_f;
         // }
 
-        MPI_Send(msg_bufY, msg_sizeY, MPI_DOUBLE_COMPLEX, dest, 1, MPI_COMM_WORLD);
+        MPI_Send(msg_bufY, msg_sizeY, MPI_DOUBLE_COMPLEX, dest, 1, Time_Decomposition::Slice_Comm());
     }
 //--------------------------------------------------------------
 
@@ -2364,7 +2415,7 @@ void Parallel_Environment_1D::Neighbor_Communications(State1D& Y) {
         MPI_Status status; 
 
         // Receive Data
-        MPI_Recv(msg_bufY, msg_sizeY, MPI_DOUBLE_COMPLEX, origin, 1, MPI_COMM_WORLD, &status);
+        MPI_Recv(msg_bufY, msg_sizeY, MPI_DOUBLE_COMPLEX, origin, 1, Time_Decomposition::Slice_Comm(), &status);
 
         // Harmonics:x0-"Right-Guard <--- " 
         for(size_t s(0); s < Y.Species(); ++s) {
@@ -3130,8 +3181,9 @@ void Parallel_Environment_1D::Neighbor_Communications(State1D& Y) {
         MPI_Procs(MPI_Processes_X*MPI_Processes_Y)
     {
         // Determination of the rank and size of the run
-        MPI_Comm_size(MPI_COMM_WORLD, &MPI_Procs);
-        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+        Time_Decomposition::Setup();
+        MPI_Comm_size(Time_Decomposition::Slice_Comm(), &MPI_Procs);
+        MPI_Comm_rank(Time_Decomposition::Slice_Comm(), &rank);
 
         rankx.push_back(rank % MPI_Processes_X);
         rankx.push_back(rank / MPI_Processes_X);
@@ -3187,6 +3239,10 @@ void Parallel_Environment_1D::Neighbor_Communications(State1D& Y) {
                 std::cout<<"Not enough cells per processor in the y direction" << endl;
                 return true;
             }
+            if (Input::List().spectral_dbydx && (MPI_Processes_X > 1 || bndX != 0)){
+                std::cout<<"spectral_dbydx needs a single periodic slab in x" << endl;
+                return true;
+            }
          } 
          return false;
     }
@@ -3410,3 +3466,348 @@ void Parallel_Environment_1D::Neighbor_Communications(State1D& Y) {
 
 
 //**************************************************************
+//**************************************************************
+//   Definition of the time decomposition
+//**************************************************************
+//**************************************************************
+namespace Time_Decomposition {
+
+    MPI_Comm slice_comm(MPI_COMM_WORLD);
+    MPI_Comm time_comm(MPI_COMM_SELF);
+    int slice(0), slices(1);
+    bool initialized(false);
+
+//--------------------------------------------------------------
+    void Setup() {
+//--------------------------------------------------------------
+//  World rank = slice * (ranks per slice) + rank in the slice
+//--------------------------------------------------------------
+        if (initialized) return;
+
+        int world_rank, world_size;
+        MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+        MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+
+        slices = static_cast<int>(Input::List().MPI_time);
+
+        if ((slices < 1) || (world_size % slices != 0))
+        {
+            if (world_rank == 0) std::cout << "The number of processes " << world_size
+                                           << " is not a multiple of MPI_Processes_time = "
+                                           << slices << ", terminating ..." << endl;
+            MPI_Finalize(); exit(1);
+        }
+
+        if (slices > 1)
+        {
+            bool error(false);
+            if ((Input::List().dim != 1) || Input::List().implicit_E)
+            {
+                if (world_rank == 0) std::cout << "MPI_Processes_time > 1 requires the 1D explicit E-field solver" << endl;
+                error = true;
+            }
+            if (Input::List().adaptive_dt || Input::List().load_balance || (Input::List().n_buddy_checkpoints > 0) || Input::List().restart_from_buddy)
+            {
+                if (world_rank == 0) std::cout << "MPI_Processes_time > 1 requires a fixed time step, fixed slabs and no in-memory checkpoints" << endl;
+                error = true;
+            }
+            //  The explicit curl terms hold the coarse step below dt
+            if (!Input::List().implicit_maxwell)
+            {
+                if (world_rank == 0) std::cout << "MPI_Processes_time > 1 requires implicit_maxwell = true" << endl;
+                error = true;
+            }
+            if (Input::List().steady_state)
+            {
+                if (world_rank == 0) std::cout << "MPI_Processes_time > 1 cannot be combined with steady_state" << endl;
+                error = true;
+            }
+            if (Input::List().h5_consolidate)
+            {
+                if (world_rank == 0) std::cout << "MPI_Processes_time > 1 writes one file per output, set h5_consolidate = false" << endl;
+                error = true;
+            }
+            //  The slices begin at outputs
+            int first_out(Input::List().isthisarestart ? Input::List().restart_time : 0);
+            if (int(Input::List().n_outsteps) - first_out < slices)
+            {
+                if (world_rank == 0) std::cout << "MPI_Processes_time = " << slices << " needs as many outputs left in the run" << endl;
+                error = true;
+            }
+            if (error) {MPI_Finalize(); exit(1);}
+        }
+
+        int slice_size(world_size / slices);
+        slice = world_rank / slice_size;
+
+        MPI_Comm_split(MPI_COMM_WORLD, slice, world_rank, &slice_comm);
+        MPI_Comm_split(MPI_COMM_WORLD, world_rank % slice_size, world_rank, &time_comm);
+        initialized = true;
+    }
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+    MPI_Comm Slice_Comm()   {return slice_comm;}
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+    MPI_Comm Time_Comm()    {return time_comm;}
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+    int Slice()             {return slice;}
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+    int Slices()            {return slices;}
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+    void Send(const State1D& Y, const int dest_slice) {
+//--------------------------------------------------------------
+        for (size_t s(0); s < Y.Species(); ++s)
+        {
+            for (size_t i(0); i < Y.DF(s).dim(); ++i)
+            {
+                MPI_Send(&(Y.DF(s)(i)(0)), Y.DF(s)(i).dim(), MPI_DOUBLE_COMPLEX, dest_slice, 0, time_comm);
+            }
+        }
+        for (size_t i(0); i < Y.Fields(); ++i)
+        {
+            MPI_Send(&(Y.FLD(i)(0)), Y.FLD(i).numx(), MPI_DOUBLE_COMPLEX, dest_slice, 0, time_comm);
+        }
+        MPI_Send(&(Y.HYDRO().densityarray()[0]),     Y.HYDRO().numx(), MPI_DOUBLE, dest_slice, 0, time_comm);
+        MPI_Send(&(Y.HYDRO().vxarray()[0]),          Y.HYDRO().numx(), MPI_DOUBLE, dest_slice, 0, time_comm);
+        MPI_Send(&(Y.HYDRO().vyarray()[0]),          Y.HYDRO().numx(), MPI_DOUBLE, dest_slice, 0, time_comm);
+        MPI_Send(&(Y.HYDRO().vzarray()[0]),          Y.HYDRO().numx(), MPI_DOUBLE, dest_slice, 0, time_comm);
+        MPI_Send(&(Y.HYDRO().temperaturearray()[0]), Y.HYDRO().numx(), MPI_DOUBLE, dest_slice, 0, time_comm);
+        MPI_Send(&(Y.HYDRO().Zarray()[0]),           Y.HYDRO().numx(), MPI_DOUBLE, dest_slice, 0, time_comm);
+    }
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+    void Recv(State1D& Y, const int origin_slice) {
+//--------------------------------------------------------------
+        MPI_Status status;
+        for (size_t s(0); s < Y.Species(); ++s)
+        {
+            for (size_t i(0); i < Y.DF(s).dim(); ++i)
+            {
+                MPI_Recv(&(Y.DF(s)(i)(0)), Y.DF(s)(i).dim(), MPI_DOUBLE_COMPLEX, origin_slice, 0, time_comm, &status);
+            }
+        }
+        for (size_t i(0); i < Y.Fields(); ++i)
+        {
+            MPI_Recv(&(Y.FLD(i)(0)), Y.FLD(i).numx(), MPI_DOUBLE_COMPLEX, origin_slice, 0, time_comm, &status);
+        }
+        MPI_Recv(&(Y.HYDRO().densityarray()[0]),     Y.HYDRO().numx(), MPI_DOUBLE, origin_slice, 0, time_comm, &status);
+        MPI_Recv(&(Y.HYDRO().vxarray()[0]),          Y.HYDRO().numx(), MPI_DOUBLE, origin_slice, 0, time_comm, &status);
+        MPI_Recv(&(Y.HYDRO().vyarray()[0]),          Y.HYDRO().numx(), MPI_DOUBLE, origin_slice, 0, time_comm, &status);
+        MPI_Recv(&(Y.HYDRO().vzarray()[0]),          Y.HYDRO().numx(), MPI_DOUBLE, origin_slice, 0, time_comm, &status);
+        MPI_Recv(&(Y.HYDRO().temperaturearray()[0]), Y.HYDRO().numx(), MPI_DOUBLE, origin_slice, 0, time_comm, &status);
+        MPI_Recv(&(Y.HYDRO().Zarray()[0]),           Y.HYDRO().numx(), MPI_DOUBLE, origin_slice, 0, time_comm, &status);
+    }
+//--------------------------------------------------------------
+}
+//**************************************************************
+
+
+//**************************************************************
+//**************************************************************
+//   Definition of the x-slab load balancing
+//**************************************************************
+//**************************************************************
+namespace Load_Balance {
+
+    vector<double> cell_cost;           // Cost per global cell, empty until measured
+    vector<size_t> restart_slabs;       // Slabs of the last restart files read
+    valarray<double> local_cost;        // f00 collision time per interior cell of this rank
+    double local_step_time(0.0);        // Vlasov + Fokker-Planck time of this rank
+
+//--------------------------------------------------------------
+    void Partition(const int num_ranks, vector<size_t>& slabs) {
+//--------------------------------------------------------------
+//  Cut the prefix sum of the cost at multiples of the mean load,
+//  keeping at least max(Nbc,2) cells per rank for the halos
+//--------------------------------------------------------------
+        size_t N(Input::List().NxGlobal[0]);
+        size_t P(num_ranks);
+
+        slabs.assign(P, 0);
+
+        if (!Input::List().load_balance || cell_cost.size() != N)
+        {
+            for (size_t r(0); r < P; ++r) slabs[r] = N / P + ((r < N % P) ? 1 : 0);
+            return;
+        }
+
+        size_t min_cells(max(size_t(Input::List().BoundaryCells), size_t(2)));
+
+        vector<double> prefix(N+1, 0.0);
+        for (size_t i(0); i < N; ++i) prefix[i+1] = prefix[i] + cell_cost[i];
+
+        size_t begin(0);
+        for (size_t r(0); r < P-1; ++r)
+        {
+            double target(prefix[N] * double(r+1) / double(P));
+
+            size_t end(begin + min_cells);
+            while ((end < N) && (prefix[end+1] <= target)) ++end;
+            //  Round to the closer of the two candidate cuts
+            if ((end < N) && (target - prefix[end] > prefix[end+1] - target)) ++end;
+
+            end = max(end, begin + min_cells);
+            end = min(end, N - (P-1-r) * min_cells);
+
+            slabs[r] = end - begin;
+            begin = end;
+        }
+        slabs[P-1] = N - begin;
+    }
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+    void Reset() {
+//--------------------------------------------------------------
+        local_cost.resize(Input::List().NxLocalnobnd[0]);
+        local_cost = 0.0;
+        local_step_time = 0.0;
+    }
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+    void Add_Cost(const size_t ix, const double seconds) {
+//--------------------------------------------------------------
+//  ix includes the guard cells, which are not charged
+//--------------------------------------------------------------
+        size_t Nbc(Input::List().BoundaryCells);
+        if ((ix >= Nbc) && (ix - Nbc < local_cost.size())) local_cost[ix - Nbc] += seconds;
+    }
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+    void Add_Step(const double seconds) {local_step_time += seconds;}
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+    bool Rebalance(const Parallel_Environment_1D& PE) {
+//--------------------------------------------------------------
+        size_t N(Input::List().NxGlobal[0]);
+        int    rank(PE.RANK());
+
+        vector<int> counts, displs;
+        PE.Gather_Counts(1, counts, displs);
+
+        vector<double> profile(N, 0.0);
+        MPI_Allgatherv(&(local_cost[0]), counts[rank], MPI_DOUBLE,
+                       &(profile[0]), &(counts[0]), &(displs[0]), MPI_DOUBLE, Time_Decomposition::Slice_Comm());
+
+        //  Per-cell share of the rest of the step; the least loaded rank waited the least
+        double uniform(max(0.0, local_step_time - local_cost.sum()) / double(PE.Slab_Cells(rank)));
+        MPI_Allreduce(MPI_IN_PLACE, &uniform, 1, MPI_DOUBLE, MPI_MIN, Time_Decomposition::Slice_Comm());
+
+        for (size_t i(0); i < N; ++i) profile[i] += uniform;
+
+        //  Take the copy of world rank 0, so that every rank computes the same slabs
+        MPI_Bcast(&(profile[0]), N, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+
+        cell_cost = profile;
+        Reset();
+
+        //  Imbalance of the current slabs
+        double max_load(0.0), total_load(0.0);
+        for (int q(0); q < PE.MPI_Processes(); ++q)
+        {
+            double load(0.0);
+            for (size_t i(PE.Slab_Offset(q)); i < PE.Slab_Offset(q) + PE.Slab_Cells(q); ++i) load += cell_cost[i];
+            max_load = max(max_load, load);
+            total_load += load;
+        }
+        if (total_load <= 0.0) return false;
+
+        double imbalance(max_load * double(PE.MPI_Processes()) / total_load);
+
+        if (!rank)
+            std::cout << "\n Load imbalance = " << imbalance << "\n";
+
+        return (imbalance > Input::List().load_balance_tolerance);
+    }
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+    string Profile_Filename(const string& hdir, const size_t re_step) {
+//--------------------------------------------------------------
+        stringstream sFilename;
+        sFilename << hdir << "restart/re_1D_slabs_" << setfill('0') << setw(3) << re_step << ".txt";
+        return sFilename.str();
+    }
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+    string Buddy_Profile_Filename(const string& hdir) {
+//--------------------------------------------------------------
+        return hdir + "restart/re_1D_slabs_buddy.txt";
+    }
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+    void write_profile(const string& filename) {
+//--------------------------------------------------------------
+        ofstream fout(filename.c_str());
+
+        fout << Input::List().NxSlabs.size() << "\n";
+        for (size_t r(0); r < Input::List().NxSlabs.size(); ++r) fout << Input::List().NxSlabs[r] << "\n";
+
+        fout << cell_cost.size() << "\n";
+        fout << setprecision(17);
+        for (size_t i(0); i < cell_cost.size(); ++i) fout << cell_cost[i] << "\n";
+
+        fout.close();
+    }
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+    void read_profile(const string& filename) {
+//--------------------------------------------------------------
+//  Restarts written before load balancing have no profile,
+//  their slabs are uniform
+//--------------------------------------------------------------
+        restart_slabs.clear();
+
+        ifstream fin(filename.c_str());
+        if (!fin) return;
+
+        size_t num;
+        fin >> num;
+        restart_slabs.resize(num);
+        for (size_t r(0); r < num; ++r) fin >> restart_slabs[r];
+
+        fin >> num;
+        cell_cost.resize(num);
+        for (size_t i(0); i < num; ++i) fin >> cell_cost[i];
+
+        fin.close();
+    }
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+    void Write_Profile(const string& hdir, const size_t re_step) {write_profile(Profile_Filename(hdir, re_step));}
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+    void Read_Profile(const string& hdir, const size_t re_step)  {read_profile(Profile_Filename(hdir, re_step));}
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+    void Write_Buddy_Profile(const string& hdir) {
+//--------------------------------------------------------------
+//  Replaced in one go, like the copies themselves
+//--------------------------------------------------------------
+        string filename(Buddy_Profile_Filename(hdir));
+        write_profile(filename + ".tmp");
+        if (rename((filename + ".tmp").c_str(), filename.c_str()) != 0) {
+            std::cout << "\n\n ERROR :: Cannot write " << filename << "\n\n";
+            exit(1);
+        }
+    }
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+    void Read_Buddy_Profile(const string& hdir) {read_profile(Buddy_Profile_Filename(hdir));}
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+    const vector<size_t>& Restart_Slabs() {return restart_slabs;}
+//--------------------------------------------------------------
+}
+//**************************************************************
@@ -133,6 +133,12 @@
             int RANK()  const;
             int MPI_Processes() const;
             int BNDX()  const;
+
+//          Slab decomposition in x
+            size_t Slab_Cells(const int r) const;       // Interior cells of rank r
+            size_t Slab_Offset(const int r) const;      // Global index of the first interior cell of rank r
+            size_t Max_Slab_Cells() const;
+            void Gather_Counts(const size_t values_per_cell, vector<int>& counts, vector<int>& displs) const;
           
 //          Information exchange
             void Neighbor_ImplicitE_Communications(State1D& Y);
@@ -342,6 +348,64 @@
 //             int restart_step;
         };
 //--------------------------------------------------------------
+//**************************************************************
+
+//**************************************************************
+//--------------------------------------------------------------
+        namespace Time_Decomposition {
+//--------------------------------------------------------------
+//      Outermost decomposition axis for the parareal driver.
+//      Every time slice holds a full copy of the x-slab
+//      layout, so a single slice is the plain run.
+//--------------------------------------------------------------
+//          Split MPI_COMM_WORLD into time slices
+            void Setup();
+
+            MPI_Comm Slice_Comm();          // Ranks of the same time slice
+            MPI_Comm Time_Comm();           // Ranks with the same place in their slice
+            int  Slice();
+            int  Slices();
+
+//          Whole states between neighboring slices
+            void Send(const State1D& Y, const int dest_slice);
+            void Recv(State1D& Y, const int origin_slice);
+        }
+//--------------------------------------------------------------
+//**************************************************************
+
+//**************************************************************
+//--------------------------------------------------------------
+        namespace Load_Balance {
+//--------------------------------------------------------------
+//      Cost-based x-slab widths for the 1D code. The cost of a
+//      cell is its measured f00 collision time plus an even
+//      share of the remaining step time; slabs are cut so that
+//      every rank carries the same total cost.
+//--------------------------------------------------------------
+//          Slab widths for num_ranks, uniform when no cost profile is known
+            void Partition(const int num_ranks, vector<size_t>& slabs);
+
+//          Accumulators of the local measurements
+            void Reset();
+            void Add_Cost(const size_t ix, const double seconds);
+            void Add_Step(const double seconds);
+
+//          Collective: update the cost profile from the measurements and 
+//          return true if the current slabs are out of balance
+            bool Rebalance(const Parallel_Environment_1D& PE);
+
+//          Profile stored with each restart: slab widths and cost per cell
+            void Write_Profile(const string& hdir, const size_t re_step);
+            void Read_Profile(const string& hdir, const size_t re_step);
+
+//          Same for the in-memory checkpoints, which are not numbered like the restarts
+            void Write_Buddy_Profile(const string& hdir);
+            void Read_Buddy_Profile(const string& hdir);
+
+//          Slab widths of the restart files or checkpoints that were last read
+            const vector<size_t>& Restart_Slabs();
+        }
+//--------------------------------------------------------------
 //**************************************************************
 
     #endif
@@ -59,9 +59,10 @@ void Parser::checkparse(parser_t& parser, std::string& expression_str, expressio
  *
  * @param      str_profile  The string profile
  * @param      profile      The profile
+ * @param      threads      OpenMP threads for the evaluation
  */
 //----------------------------------------------------------------------------------------------------------------------------
-void Parser::parseprofile( const valarray<double>& grid, std::string& str_profile, valarray<double>& profile){
+void Parser::parseprofile( const valarray<double>& grid, std::string& str_profile, valarray<double>& profile, const size_t threads){
 
     /// Find curly brackets
     std::size_t posL = str_profile.find("{");
@@ -101,9 +102,26 @@ void Parser::parseprofile( const valarray<double>& grid, std::string& str_profil
 
         checkparse(parser, expression_str, expression);
 
-        for (size_t i(0); i < profile.size(); ++i) {
-            xstr = grid[i];
-            profile[i] = expression.value();
+        /// An expression is bound to its variables, so every thread compiles 
+        /// its own copy once and evaluates its share of the cells
+        #pragma omp parallel num_threads(threads)
+        {
+            symbol_table_t thread_table;
+            thread_table.add_constants();
+            double xthread;
+            thread_table.add_variable("x",xthread);
+
+            expression_t thread_expression;
+            thread_expression.register_symbol_table(thread_table);
+
+            parser_t thread_parser;
+            thread_parser.compile(expression_str,thread_expression);
+
+            #pragma omp for
+            for (size_t i = 0; i < profile.size(); ++i) {
+                xthread = grid[i];
+                profile[i] = thread_expression.value();
+            }
         }
     }
 
@@ -179,9 +197,10 @@ void Parser::parseprofile( const valarray<double>& grid, std::string& str_profil
  *
  * @param      str_profile  The string profile
  * @param      profile      The profile
+ * @param      threads      OpenMP threads for the evaluation
  */
 //----------------------------------------------------------------------------------------------------------------------------
-void Parser::parseprofile( const valarray<double>& grid1, const valarray<double>& grid2, std::string& str_profile, Array2D<double>& profile){
+void Parser::parseprofile( const valarray<double>& grid1, const valarray<double>& grid2, std::string& str_profile, Array2D<double>& profile, const size_t threads){
 
     /// Find curly brackets
     std::size_t posL = str_profile.find("{");
@@ -220,17 +239,31 @@ void Parser::parseprofile( const valarray<double>& grid1, const valarray<double>
 
         checkparse(parser, expression_str, expression);
 
-        for (size_t i1(0); i1 < grid1.size(); ++i1) 
+        /// Every thread compiles its own copy, as in the 1D profile
+        #pragma omp parallel num_threads(threads)
         {
-            xstr = grid1[i1];
-            
-            for (size_t i2(0); i2 < grid2.size(); ++i2) 
+            symbol_table_t thread_table;
+            thread_table.add_constants();
+            double xthread, ythread;
+            thread_table.add_variable("x",xthread);
+            thread_table.add_variable("y",ythread);
+
+            expression_t thread_expression;
+            thread_expression.register_symbol_table(thread_table);
+
+            parser_t thread_parser;
+            thread_parser.compile(expression_str,thread_expression);
+
+            #pragma omp for
+            for (size_t i1 = 0; i1 < grid1.size(); ++i1) 
             {
-                ystr = grid2[i2];
+                xthread = grid1[i1];
                 
-                profile(i1,i2) = expression.value();
-                // std::cout << "val = " << expression.value() << "\n";
-
+                for (size_t i2(0); i2 < grid2.size(); ++i2) 
+                {
+                    ythread = grid2[i2];
+                    profile(i1,i2) = thread_expression.value();
+                }
             }
         }
     }
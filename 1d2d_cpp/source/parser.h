@@ -24,8 +24,10 @@ namespace Parser{
 
     void checkparse(parser_t& parser, std::string& expression_str, expression_t& expression);
     
-    void parseprofile(const std::valarray<double>& grid, std::string& str_profile, std::valarray<double>& profile);
-    void parseprofile(const std::valarray<double>& gridx, const std::valarray<double>& gridy, std::string& str_profile, Array2D<double>& profile);
+//  Spatial profiles are evaluated by up to threads OpenMP threads. The deck reader
+//  keeps the default, since it runs before Input::List() exists.
+    void parseprofile(const std::valarray<double>& grid, std::string& str_profile, std::valarray<double>& profile, const size_t threads = 1);
+    void parseprofile(const std::valarray<double>& gridx, const std::valarray<double>& gridy, std::string& str_profile, Array2D<double>& profile, const size_t threads = 1);
 
     void parseprofile(const double& input, std::string& str_profile, double& ouput);
 	void parseprofile(const std::valarray<double>& grid, const double& input, std::string& str_profile, std::valarray<double>& ouput);
@@ -31,6 +31,7 @@
 #include "formulary.h"
 #include "parser.h"
 #include "setup.h"
+#include "parallel.h"
 
 //**************************************************************
 //**************************************************************
@@ -70,12 +71,12 @@ WaveDriver::~WaveDriver(){}
 /// ------------------------------------------------
 void WaveDriver::applyexternalfields(State1D& Y, double time)
 {
-    Parser::parseprofile(xaxis, Input::List().ex_profile_str, Ex_profile_ext);
-    Parser::parseprofile(xaxis, Input::List().ey_profile_str, Ey_profile_ext);
-    Parser::parseprofile(xaxis, Input::List().ez_profile_str, Ez_profile_ext);
-    Parser::parseprofile(xaxis, Input::List().bx_profile_str, Bx_profile_ext);
-    Parser::parseprofile(xaxis, Input::List().by_profile_str, By_profile_ext);
-    Parser::parseprofile(xaxis, Input::List().bz_profile_str, Bz_profile_ext);
+    Parser::parseprofile(xaxis, Input::List().ex_profile_str, Ex_profile_ext, Input::List().ompthreads);
+    Parser::parseprofile(xaxis, Input::List().ey_profile_str, Ey_profile_ext, Input::List().ompthreads);
+    Parser::parseprofile(xaxis, Input::List().ez_profile_str, Ez_profile_ext, Input::List().ompthreads);
+    Parser::parseprofile(xaxis, Input::List().bx_profile_str, Bx_profile_ext, Input::List().ompthreads);
+    Parser::parseprofile(xaxis, Input::List().by_profile_str, By_profile_ext, Input::List().ompthreads);
+    Parser::parseprofile(xaxis, Input::List().bz_profile_str, Bz_profile_ext, Input::List().ompthreads);
 
     Parser::parseprofile(time, Input::List().ex_time_profile_str, ex_time_coeff);
     Parser::parseprofile(time, Input::List().ey_time_profile_str, ey_time_coeff);
@@ -98,12 +99,12 @@ void WaveDriver::applyexternalfields(State1D& Y, double time)
 /// ------------------------------------------------
 void WaveDriver::applyexternalfields(State2D& Y, double time)
 {
-    Parser::parseprofile(xaxis, yaxis, Input::List().ex_profile_str, Ex_profile_ext_2D);
-    Parser::parseprofile(xaxis, yaxis, Input::List().ey_profile_str, Ey_profile_ext_2D);
-    Parser::parseprofile(xaxis, yaxis, Input::List().ez_profile_str, Ez_profile_ext_2D);
-    Parser::parseprofile(xaxis, yaxis, Input::List().bx_profile_str, Bx_profile_ext_2D);
-    Parser::parseprofile(xaxis, yaxis, Input::List().by_profile_str, By_profile_ext_2D);
-    Parser::parseprofile(xaxis, yaxis, Input::List().bz_profile_str, Bz_profile_ext_2D);
+    Parser::parseprofile(xaxis, yaxis, Input::List().ex_profile_str, Ex_profile_ext_2D, Input::List().ompthreads);
+    Parser::parseprofile(xaxis, yaxis, Input::List().ey_profile_str, Ey_profile_ext_2D, Input::List().ompthreads);
+    Parser::parseprofile(xaxis, yaxis, Input::List().ez_profile_str, Ez_profile_ext_2D, Input::List().ompthreads);
+    Parser::parseprofile(xaxis, yaxis, Input::List().bx_profile_str, Bx_profile_ext_2D, Input::List().ompthreads);
+    Parser::parseprofile(xaxis, yaxis, Input::List().by_profile_str, By_profile_ext_2D, Input::List().ompthreads);
+    Parser::parseprofile(xaxis, yaxis, Input::List().bz_profile_str, Bz_profile_ext_2D, Input::List().ompthreads);
 
     Parser::parseprofile(time, Input::List().ex_time_profile_str, ex_time_coeff);
     Parser::parseprofile(time, Input::List().ey_time_profile_str, ey_time_coeff);
@@ -278,12 +279,12 @@ void Setup_Y::applyexternalfields(Grid_Info &grid, State1D& Y, double time)
     double by_time_coeff(0.0);
     double bz_time_coeff(0.0);
 
-    Parser::parseprofile(grid.axis.x(0), Input::List().ex_profile_str, Ex_profile);
-    Parser::parseprofile(grid.axis.x(0), Input::List().ey_profile_str, Ey_profile);
-    Parser::parseprofile(grid.axis.x(0), Input::List().ez_profile_str, Ez_profile);
-    Parser::parseprofile(grid.axis.x(0), Input::List().bx_profile_str, Bx_profile);
-    Parser::parseprofile(grid.axis.x(0), Input::List().by_profile_str, By_profile);
-    Parser::parseprofile(grid.axis.x(0), Input::List().bz_profile_str, Bz_profile);
+    Parser::parseprofile(grid.axis.x(0), Input::List().ex_profile_str, Ex_profile, Input::List().ompthreads);
+    Parser::parseprofile(grid.axis.x(0), Input::List().ey_profile_str, Ey_profile, Input::List().ompthreads);
+    Parser::parseprofile(grid.axis.x(0), Input::List().ez_profile_str, Ez_profile, Input::List().ompthreads);
+    Parser::parseprofile(grid.axis.x(0), Input::List().bx_profile_str, Bx_profile, Input::List().ompthreads);
+    Parser::parseprofile(grid.axis.x(0), Input::List().by_profile_str, By_profile, Input::List().ompthreads);
+    Parser::parseprofile(grid.axis.x(0), Input::List().bz_profile_str, Bz_profile, Input::List().ompthreads);
 
     Parser::parseprofile(time, Input::List().ex_time_profile_str, ex_time_coeff);
     Parser::parseprofile(time, Input::List().ey_time_profile_str, ey_time_coeff);
@@ -322,12 +323,12 @@ void Setup_Y::applyexternalfields(Grid_Info &grid, State2D& Y, double time)
     double by_time_coeff(0.0);
     double bz_time_coeff(0.0);
 
-    Parser::parseprofile(grid.axis.x(0), grid.axis.x(1), Input::List().ex_profile_str, Ex_profile);
-    Parser::parseprofile(grid.axis.x(0), grid.axis.x(1), Input::List().ey_profile_str, Ey_profile);
-    Parser::parseprofile(grid.axis.x(0), grid.axis.x(1), Input::List().ez_profile_str, Ez_profile);
-    Parser::parseprofile(grid.axis.x(0), grid.axis.x(1), Input::List().bx_profile_str, Bx_profile);
-    Parser::parseprofile(grid.axis.x(0), grid.axis.x(1), Input::List().by_profile_str, By_profile);
-    Parser::parseprofile(grid.axis.x(0), grid.axis.x(1), Input::List().bz_profile_str, Bz_profile);
+    Parser::parseprofile(grid.axis.x(0), grid.axis.x(1), Input::List().ex_profile_str, Ex_profile, Input::List().ompthreads);
+    Parser::parseprofile(grid.axis.x(0), grid.axis.x(1), Input::List().ey_profile_str, Ey_profile, Input::List().ompthreads);
+    Parser::parseprofile(grid.axis.x(0), grid.axis.x(1), Input::List().ez_profile_str, Ez_profile, Input::List().ompthreads);
+    Parser::parseprofile(grid.axis.x(0), grid.axis.x(1), Input::List().bx_profile_str, Bx_profile, Input::List().ompthreads);
+    Parser::parseprofile(grid.axis.x(0), grid.axis.x(1), Input::List().by_profile_str, By_profile, Input::List().ompthreads);
+    Parser::parseprofile(grid.axis.x(0), grid.axis.x(1), Input::List().bz_profile_str, Bz_profile, Input::List().ompthreads);
 
     Parser::parseprofile(time, Input::List().ex_time_profile_str, ex_time_coeff);
     Parser::parseprofile(time, Input::List().ey_time_profile_str, ey_time_coeff);
@@ -528,11 +529,11 @@ void Setup_Y::initialize(State1D &Y, Grid_Info &grid){
 
         temp_profile = 0.0;
         
-        Parser::parseprofile(grid.axis.x(0), Input::List().dens_profile_str[s], dens_profile);
+        Parser::parseprofile(grid.axis.x(0), Input::List().dens_profile_str[s], dens_profile, Input::List().ompthreads);
         // std::cout << "\n11\n";
-        Parser::parseprofile(grid.axis.x(0), Input::List().temp_profile_str[s], temp_profile);
+        Parser::parseprofile(grid.axis.x(0), Input::List().temp_profile_str[s], temp_profile, Input::List().ompthreads);
         // std::cout << "\n12\n";
-        Parser::parseprofile(grid.axis.x(0), Input::List().f10x_profile_str[s], f10x_profile);
+        Parser::parseprofile(grid.axis.x(0), Input::List().f10x_profile_str[s], f10x_profile, Input::List().ompthreads);
         // std::cout << "\n13\n";
         // Parser::parseprofile(grid.axis.x(0), Input::List().f20x_profile_str[s], f20x_profile);
         // Parser::parseprofile(grid.axis.x(0), Input::List().f_pedestal[s], pedestal_profile);
@@ -559,10 +560,10 @@ void Setup_Y::initialize(State1D &Y, Grid_Info &grid){
     Y.EMF() = static_cast<complex<double> >(0.0);
 
     
-    Parser::parseprofile(grid.axis.x(0), Input::List().hydro_dens_profile_str, hydro_dens_profile);
-    Parser::parseprofile(grid.axis.x(0), Input::List().hydro_temp_profile_str, hydro_temp_profile);
-    Parser::parseprofile(grid.axis.x(0), Input::List().hydro_vel_profile_str, hydro_vel_profile);
-    Parser::parseprofile(grid.axis.x(0), Input::List().hydro_Z_profile_str, hydro_Z_profile);
+    Parser::parseprofile(grid.axis.x(0), Input::List().hydro_dens_profile_str, hydro_dens_profile, Input::List().ompthreads);
+    Parser::parseprofile(grid.axis.x(0), Input::List().hydro_temp_profile_str, hydro_temp_profile, Input::List().ompthreads);
+    Parser::parseprofile(grid.axis.x(0), Input::List().hydro_vel_profile_str, hydro_vel_profile, Input::List().ompthreads);
+    Parser::parseprofile(grid.axis.x(0), Input::List().hydro_Z_profile_str, hydro_Z_profile, Input::List().ompthreads);
 
     
     Y.HYDRO().vxarray()             = 0.0;
@@ -613,9 +614,9 @@ void Setup_Y::initialize(State2D &Y, Grid_Info &grid){
 
         temp_profile = 0.0;
         
-        Parser::parseprofile(grid.axis.x(0), grid.axis.x(1), Input::List().dens_profile_str[s], dens_profile);
-        Parser::parseprofile(grid.axis.x(0), grid.axis.x(1), Input::List().temp_profile_str[s], temp_profile);
-        Parser::parseprofile(grid.axis.x(0), grid.axis.x(1), Input::List().f10x_profile_str[s], f10x_profile);
+        Parser::parseprofile(grid.axis.x(0), grid.axis.x(1), Input::List().dens_profile_str[s], dens_profile, Input::List().ompthreads);
+        Parser::parseprofile(grid.axis.x(0), grid.axis.x(1), Input::List().temp_profile_str[s], temp_profile, Input::List().ompthreads);
+        Parser::parseprofile(grid.axis.x(0), grid.axis.x(1), Input::List().f10x_profile_str[s], f10x_profile, Input::List().ompthreads);
         // Parser::parseprofile(grid.axis.x(0), grid.axis.x(1), Input::List().f_pedestal[s], pedestal_profile);
         
         init_f0(s, Y.SH(s,0,0), grid.axis.p(s), grid.axis.x(0), grid.axis.x(1), dens_profile, temp_profile, Y.DF(s).mass(), pedestal_profile);
@@ -636,10 +637,10 @@ void Setup_Y::initialize(State2D &Y, Grid_Info &grid){
     Y.EMF() = static_cast<complex<double> >(0.0);
 
     
-    Parser::parseprofile(grid.axis.x(0), grid.axis.x(1), Input::List().hydro_dens_profile_str, hydro_dens_profile);
-    Parser::parseprofile(grid.axis.x(0), grid.axis.x(1), Input::List().hydro_temp_profile_str, hydro_temp_profile);
-    Parser::parseprofile(grid.axis.x(0), grid.axis.x(1), Input::List().hydro_vel_profile_str, hydro_vel_profile);
-    Parser::parseprofile(grid.axis.x(0), grid.axis.x(1), Input::List().hydro_Z_profile_str, hydro_Z_profile);
+    Parser::parseprofile(grid.axis.x(0), grid.axis.x(1), Input::List().hydro_dens_profile_str, hydro_dens_profile, Input::List().ompthreads);
+    Parser::parseprofile(grid.axis.x(0), grid.axis.x(1), Input::List().hydro_temp_profile_str, hydro_temp_profile, Input::List().ompthreads);
+    Parser::parseprofile(grid.axis.x(0), grid.axis.x(1), Input::List().hydro_vel_profile_str, hydro_vel_profile, Input::List().ompthreads);
+    Parser::parseprofile(grid.axis.x(0), grid.axis.x(1), Input::List().hydro_Z_profile_str, hydro_Z_profile, Input::List().ompthreads);
 
     
     Y.HYDRO().vxarray()             = 0.0;
@@ -672,7 +673,7 @@ void Setup_Y:: init_f0(size_t s, SHarmonic1D& h, const valarray<double>& p, cons
                        valarray<double>& density, valarray<double>& temperature, const double mass, const valarray<double>& pedestal){
 //-----------------------------------------------------------------------------
 //-----------------------------------------------------------------------------
-    double alpha, coeff, coefftemp, coefftemp_relativistic;
+    double alpha, coeff, coefftemp_relativistic;
     double m = Input::List().super_gaussian_m;
 
     alpha = sqrt(3.0*tgamma(3.0/m)/2.0/tgamma(5.0/m));
@@ -680,11 +681,12 @@ void Setup_Y:: init_f0(size_t s, SHarmonic1D& h, const valarray<double>& p, cons
     coeff *= sqrt(M_PI)/4.0;
 
 
-    for (int j(0); j < h.numx(); ++j)
+    #pragma omp parallel for num_threads(Input::List().ompthreads)
+    for (int j = 0; j < h.numx(); ++j)
     {
         // std::cout << "\n";
 
-        coefftemp = coeff*density[j]/pow(2.0*M_PI*temperature[j]*mass,1.5);
+        double coefftemp = coeff*density[j]/pow(2.0*M_PI*temperature[j]*mass,1.5);
 
         // coefftemp_relativistic = density[j]/(4.0*M_PI*temperature[j]*pow(mass,3.)*boost::math::cyl_bessel_k(2.,1./temperature[j]));
 
@@ -712,22 +714,26 @@ void Setup_Y:: init_f0(size_t s, SHarmonic1D& h, const valarray<double>& p, cons
         double rand_phase(0.);
 
         int rank;
-        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+        MPI_Comm_rank(Time_Decomposition::Slice_Comm(), &rank);
         srand(42);
 
         size_t first_local_ix = rank*(h.numx()-Input::List().BoundaryCells);
 
-        for (size_t ik(0); ik < maxwavenumber; ++ik)
-        {
-            double wavenumber(double(ik+1)/double(Input::List().NxGlobal[0]));
-
-            double rand_phase(double(rand())/double(RAND_MAX));
+        //  The phases are drawn in sequence, the cells are then independent
+        valarray<double> rand_phases(maxwavenumber);
+        for (size_t ik(0); ik < maxwavenumber; ++ik) rand_phases[ik] = double(rand())/double(RAND_MAX);
 
-            for (int ix(0); ix < h.numx(); ++ix)
+        #pragma omp parallel for num_threads(Input::List().ompthreads)
+        for (int ix = 0; ix < h.numx(); ++ix)
+        {
+            for (size_t ik(0); ik < maxwavenumber; ++ik)
             {
+                double wavenumber(double(ik+1)/double(Input::List().NxGlobal[0]));
+                double modulation(1.+(Input::List().f0_x_noise_window*sin(2.*M_PI*(wavenumber*(double(ix + first_local_ix)+0.5)+rand_phases[ik]))));
+
                 for (int ip(0); ip < h.nump(); ++ip)
                 {
-                    h(ip,ix) *= (1.+(Input::List().f0_x_noise_window*sin(2.*M_PI*(wavenumber*(double(ix + first_local_ix)+0.5)+rand_phase))));
+                    h(ip,ix) *= modulation;
                     // h(ip,ix) += (Input::List().f0_x_noise_window*sin(2.*M_PI*(wavenumber*(double(ix)+0.5)+rand_phase)));
 
                 }
@@ -743,21 +749,22 @@ void Setup_Y:: init_f0(size_t s, SHarmonic2D& h, const valarray<double>& p, cons
                        Array2D<double>& density, Array2D<double>& temperature, const double mass, const Array2D<double>& pedestal){
 //-----------------------------------------------------------------------------
 //-----------------------------------------------------------------------------
-    double alpha, coeff, coefftemp, coefftemp_relativistic;
+    double alpha, coeff, coefftemp_relativistic;
     double m = Input::List().super_gaussian_m;
 
     alpha = sqrt(3.0*tgamma(3.0/m)/2.0/tgamma(5.0/m));
     coeff = m/alpha/alpha/alpha/tgamma(3.0/m);
     coeff *= sqrt(M_PI)/4.0;
 
-    for (int ix(0); ix < h.numx(); ++ix)
+    #pragma omp parallel for num_threads(Input::List().ompthreads)
+    for (int ix = 0; ix < h.numx(); ++ix)
     {
         for (int iy(0); iy < h.numy(); ++iy)
         {
 
             // std::cout << "\n";
 
-            coefftemp = coeff*density(ix,iy)/pow(2.0*M_PI*temperature(ix,iy)*mass,1.5);
+            double coefftemp = coeff*density(ix,iy)/pow(2.0*M_PI*temperature(ix,iy)*mass,1.5);
             
             // coefftemp_relativistic = density(ix,iy)/(4.0*M_PI*temperature(ix,iy)*pow(mass,3.)*boost::math::cyl_bessel_k(2.,1./temperature(ix,iy)));
 
@@ -833,7 +840,7 @@ void Setup_Y:: init_flm(SHarmonic1D& h)
 //----------------------------------------------------------------------------------------------------------------------
 //----------------------------------------------------------------------------------------------------------------------
     int rank;
-    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_rank(Time_Decomposition::Slice_Comm(), &rank);
     srand(rank);
 
     for (int j(0); j < h.numx(); ++j)
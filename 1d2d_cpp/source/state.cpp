@@ -301,6 +301,10 @@ SHarmonic1D& SHarmonic1D::Dp()
 //  X-difference
 SHarmonic1D& SHarmonic1D::Dx(size_t order){
 
+    if (Input::List().spectral_dbydx) {
+        Spectral_Dx(&(*sh)(0,0), numx(), nump(), nump(), 1);
+        return *this;
+    }
     //--------------------------------------------------------//
     //--------------------------------------------------------//
     /// 2nd order
@@ -627,6 +631,10 @@ void SHarmonic1D::checknan(){
 //  X-difference 
     SHarmonic2D& SHarmonic2D::Dx(size_t order){
 
+    if (Input::List().spectral_dbydx) {
+        for (size_t iy(0); iy < numy(); ++iy) Spectral_Dx(&(*sh)(0,0,iy), numx(), nump(), nump(), 1);
+        return *this;
+    }
     if (order == 2) *sh = (*sh).Dd2_2nd_order();                          // Worry about boundaries elsewhere
     if (order == 4) *sh = (*sh).Dd2_4th_order();                          // Worry about boundaries elsewhere
         // *sh = (*sh).Dd2();                          // Worry about boundaries elsewhere
@@ -773,6 +781,10 @@ Field1D& Field1D::Re(){
 //--------------------------------------------------------------
 Field1D& Field1D::Dx(size_t order){
 //--------------------------------------------------------------
+    if (Input::List().spectral_dbydx) {
+        Spectral_Dx(&(*fi)[0], numx(), 1, 1, 0);
+        return *this;
+    }
     //--------------------------------------------------------//
     //--------------------------------------------------------//
     /// 4th order
@@ -880,6 +892,10 @@ Field1D& Field1D::Dx(size_t order){
 //--------------------------------------------------------------
     Field2D& Field2D::Dx(size_t order){
 //--------------------------------------------------------------
+        if (Input::List().spectral_dbydx) {
+            Spectral_Dx(&(*fi)(0,0), numx(), 1, numy(), numx());
+            return *this;
+        }
         // *fi = (*fi).Dd1();
         if (order == 2) *fi = (*fi).Dd1_2nd_order();                          // Worry about boundaries elsewhere
         if (order == 4) *fi = (*fi).Dd1_4th_order();                          // Worry about boundaries elsewhere
@@ -1085,7 +1101,8 @@ DistFunc1D:: DistFunc1D(size_t l, size_t m,
                         double q, double _ma)
         : lmax(l), mmax(m), sz(((m+1)*(2*l-m+2))/2),
         dp(_dp), 
-        charge(q), ma(_ma), ind(l+1,m+1), first_resolved_cell(l+1), filterf0(_dp.size()) {
+        charge(q), ma(_ma), ind(l+1,m+1), first_resolved_cell(l+1), filterf0(_dp.size()),
+        active_l(l,nx), active_tile(l) {
 
 //      Initialize the array of the harmonics
     if (lmax < 1) {
@@ -1139,7 +1156,8 @@ DistFunc1D:: DistFunc1D(const DistFunc1D& other)
         sz(((other.m0()+1)*(2*other.l0()-other.m0()+2))/2),
             dp(other.getdp()),
           charge(other.q()), ma(other.mass()), 
-          ind(other.l0()+1,other.m0()+1),first_resolved_cell(other.l0()+1), filterf0(other.getf0())
+          ind(other.l0()+1,other.m0()+1),first_resolved_cell(other.l0()+1), filterf0(other.getf0()),
+          active_l(other.getactive()), active_tile(other.l_active())
           {
 
 //      Generate container for the harmonics
@@ -1242,6 +1260,8 @@ DistFunc1D& DistFunc1D::operator=(const DistFunc1D& other){
         for(size_t i = 0; i < dim() ; ++i) {
             (*df)[i] = other(i);
         }
+        active_l = other.getactive();
+        active_tile = other.l_active();
     }
     return *this;
 }
@@ -1313,6 +1333,55 @@ DistFunc1D& DistFunc1D::operator-=(const DistFunc1D& other){
     }
     return *this;
 }
+//  += and = with the health tallies, so that the check needs no pass of its own.
+//  Trapezoidal weights as in the moment engine, on the cell centers of the grid.
+DistFunc1D& DistFunc1D::add_checked(const DistFunc1D& other, const size_t Nbc, double* tally){
+    return update_checked(other, true, Nbc, tally);
+}
+DistFunc1D& DistFunc1D::assign_checked(const DistFunc1D& other, const size_t Nbc, double* tally){
+    return update_checked(other, false, Nbc, tally);
+}
+DistFunc1D& DistFunc1D::update_checked(const DistFunc1D& other, const bool add, const size_t Nbc, double* tally){
+
+    size_t np((*df)[0].nump()), nx((*df)[0].numx());
+
+    valarray<double> p(Algorithms::MakeCAxis(0., dp)), w2(np), w4(np);
+    for (size_t ip(0); ip < np; ++ip) {
+        double span( ((ip+1 < np)? p[ip+1]:p[ip]) - ((ip > 0)? p[ip-1]:p[ip]) );
+        w2[ip] = 0.5*p[ip]*p[ip]*span;
+        w4[ip] = w2[ip]*p[ip]*p[ip];
+    }
+
+    double bad(0.), neg(0.), m2(0.), m4(0.);
+
+    #pragma omp parallel for num_threads(Input::List().ompthreads) reduction(+:bad,neg,m2,m4)
+    for(size_t i = 0; i < dim() ; ++i) {
+        Array2D<complex<double> >& a((*df)[i].array());
+        const Array2D<complex<double> >& b(other(i).array());
+
+        for (size_t ix(0); ix < nx; ++ix) {
+            bool inside((ix >= Nbc) && (ix < nx-Nbc));
+            for (size_t ip(0); ip < np; ++ip) {
+                complex<double>& f(a(ip,ix));
+                if (add) f += b(ip,ix);
+                else f = b(ip,ix);
+                if (!inside) continue;
+
+                if (!(std::isfinite(f.real()) && std::isfinite(f.imag()))) bad += 1.;
+                if (i == 0) {
+                    if (f.real() < 0.) neg += 1.;
+                    m2 += w2[ip]*f.real();
+                    m4 += w4[ip]*f.real();
+                }
+            }
+        }
+    }
+
+    tally[0] = bad;                 tally[1] = neg;
+    tally[2] = 4.0*M_PI*m2;         tally[3] = 4.0*M_PI*m4*0.5/ma;
+
+    return *this;
+}
 
 void DistFunc1D::Filterp()
 {
@@ -1379,6 +1448,44 @@ void DistFunc1D::Filterp()
         // (*df)[i].Filterp(i);
 }
 //--------------------------------------------------------------------------------------------------------------------------
+void DistFunc1D::Truncate()
+{
+//  Move the highest resolved harmonic of every cell by at most one.
+//  The top harmonic is measured against f00 in the max-norm: it grows
+//  above the threshold and shrinks below threshold*hysteresis.
+//  Everything above the new limit is zeroed, l = 1 always survives.
+    double grow(Input::List().adaptive_lmax_threshold);
+    double shrink(grow*Input::List().adaptive_lmax_hysteresis);
+    size_t tile(1);
+
+    #pragma omp parallel for reduction(max:tile) num_threads(Input::List().ompthreads)
+    for(size_t ix = 0; ix < (*df)[0].numx(); ++ix) 
+    {
+        double norm0(0.), top(0.);
+        size_t l(active_l[ix]);
+
+        for(size_t ip = 0; ip < dp.size(); ++ip) 
+            norm0 = std::max(norm0, abs((*df)[0](ip,ix)));
+
+        for(size_t m = 0; m < ((mmax < l)? mmax:l)+1; ++m) 
+            for(size_t ip = 0; ip < dp.size(); ++ip) 
+                top = std::max(top, abs((*df)[ind(l,m)](ip,ix)));
+
+        if (l < lmax && top > grow*norm0)         ++l;
+        else if (l > 1 && top < shrink*norm0)     --l;
+
+        for(size_t il = l+1; il < lmax+1; ++il) 
+            for(size_t m = 0; m < ((mmax < il)? mmax:il)+1; ++m) 
+                for(size_t ip = 0; ip < dp.size(); ++ip) 
+                    (*df)[ind(il,m)](ip,ix) = 0.0;
+
+        active_l[ix] = l;
+        tile = std::max(tile,l);
+    }
+
+    active_tile = tile;
+}
+//--------------------------------------------------------------------------------------------------------------------------
 void DistFunc1D::setf0_filter(const SHarmonic1D& f0)
 {
     for (size_t ip(0); ip < dp.size(); ++ip)
@@ -2971,6 +3078,28 @@ State1D& State1D::operator-=(const complex<double> & d){
 
     return *this;
 }
+//  += with health tallies
+State1D& State1D::add_checked(const State1D& other, const size_t Nbc, valarray<double>& tally){
+
+    tally.resize(4*ns);
+    for(size_t s(0); s < ns; ++s){
+        (*sp)[s].add_checked(other.DF(s), Nbc, &tally[4*s]);
+    }
+    *flds  += other.EMF();
+    *hydro += other.HYDRO();
+    return *this;
+}
+//  Field tallies
+void State1D::field_health(const size_t Nbc, double* tally) const {
+
+    for(size_t i(0); i < Fields(); ++i){
+        const valarray<complex<double> >& F(FLD(i).array());
+        for(size_t ix(Nbc); ix < F.size()-Nbc; ++ix){
+            if (!(std::isfinite(F[ix].real()) && std::isfinite(F[ix].imag()))) tally[0] += 1.;
+            tally[1] += 0.5*std::norm(F[ix]);
+        }
+    }
+}
 //   //  Debug
 void State1D::checknan(){
 
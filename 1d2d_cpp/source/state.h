@@ -371,6 +371,8 @@ private:
     
     valarray<double> dp;
     double charge, ma;
+
+    DistFunc1D& update_checked(const DistFunc1D& other, const bool add, const size_t Nbc, double* tally);
     
 
     Array2D<int> ind;
@@ -378,6 +380,9 @@ private:
     valarray<size_t> first_resolved_cell;
     valarray<double> filterf0;
 
+    valarray<size_t> active_l;      ///< Highest resolved harmonic in each cell
+    size_t active_tile;             ///< Highest resolved harmonic in this slab
+
 public:
 
 //      Constructors/Destructors
@@ -394,6 +399,9 @@ public:
     double q()                      const {return charge;}
     double mass()                   const {return ma;    }
     valarray<double> getf0()        const {return filterf0;}
+    size_t l_active(size_t ix)      const {return active_l[ix];}
+    size_t l_active()               const {return active_tile;}
+    valarray<size_t> getactive()    const {return active_l;}
     
 
     Array2D<int> indx() const {return ind;}
@@ -429,9 +437,17 @@ public:
     DistFunc1D& operator-=(const complex<double> & d);
     DistFunc1D& operator-=(const DistFunc1D& other);
 
+//      += and = fused with the health tallies of the result outside the guard cells:
+//      non-finite values, negative f00 cells, density and kinetic energy per unit length
+    DistFunc1D& add_checked(const DistFunc1D& other, const size_t Nbc, double* tally);
+    DistFunc1D& assign_checked(const DistFunc1D& other, const size_t Nbc, double* tally);
+
 //      Filter
     void Filterp();
 
+//      Adaptive harmonic truncation
+    void Truncate();
+
 //      Debug
     void checknan();
     void checknan() const;
@@ -725,6 +741,11 @@ public:
     State1D& operator-=(const State1D& other);
     State1D& operator-=(const complex<double> & d);
 
+//      += fused with the health tallies of DistFunc1D::add_checked, four for each species
+    State1D& add_checked(const State1D& other, const size_t Nbc, valarray<double>& tally);
+//      Non-finite values and energy of the fields outside the guard cells, added to tally[0] and tally[1]
+    void field_health(const size_t Nbc, double* tally) const;
+
 };
 //--------------------------------------------------------------
 /** @} */
@@ -574,6 +574,9 @@ void RK4C::take_step(State1D& Ystar, State1D& Y, double time, double h, VlasovFu
 {
 //  Take a step using RKCK
 
+    //  Curl terms for h/2 on either side when they are implicit
+        if (Input::List().implicit_maxwell) vF.maxwell(Y, 0.5*h);
+
     // Initialization
         Y0 = Y; Y1 = Y;
 //      ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -600,7 +603,11 @@ void RK4C::take_step(State1D& Ystar, State1D& Y, double time, double h, VlasovFu
 //      Step 4
         vF(Y0,Yh,time,h);                    // slope at the end
         PE.Neighbor_Communications(Yh);
-        Yh *= (h/6.0);    Y += Yh;      // Y  = Y  + (h/6)*Yh
+        Yh *= (h/6.0);                  // Y  = Y  + (h/6)*Yh, tallied on the way
+        if (Input::List().health_check) Y.add_checked(Yh, Input::List().BoundaryCells, tally);
+        else Y += Yh;
+
+        if (Input::List().implicit_maxwell) vF.maxwell(Y, 0.5*h);
 //      ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 //      ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 }
@@ -609,6 +616,9 @@ void RK4C::take_step(State2D& Ystar, State2D& Y, double time, double h, VlasovFu
 {
 //  Take a step using RKCK
 
+    //  Curl terms for h/2 on either side when they are implicit
+        if (Input::List().implicit_maxwell) vF.maxwell(Y, 0.5*h);
+
     // Initialization
         Y0_2D = Y; Y1_2D = Y;
 
@@ -637,10 +647,55 @@ void RK4C::take_step(State2D& Ystar, State2D& Y, double time, double h, VlasovFu
         vF(Y0_2D,Yh_2D,time,h);                    // slope at the end
         // PE.Neighbor_Communications(Yh_2D);
         Yh_2D *= (h/6.0);    Y += Yh_2D;      // Y  = Y  + (h/6)*Yh
+
+        if (Input::List().implicit_maxwell) vF.maxwell(Y, 0.5*h);
 //      ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 //      ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 }
 //--------------------------------------------------------------
+RK3SSP::RK3SSP(State1D& Yin): Y0(Yin), Y1(Yin), Yh(Yin),
+                            onethird(complex<double>(1./3.,0.)), twothird(complex<double>(2./3.,0.)),
+                            onequarter(complex<double>(0.25,0.)), threequarter(complex<double>(0.75,0.))
+    {}
+//--------------------------------------------------------------
+RK3SSP:: ~RK3SSP(){
+//--------------------------------------------------------------
+//  Destructor
+//--------------------------------------------------------------
+}
+//--------------------------------------------------------------
+void RK3SSP::take_step(State1D&, State1D& Y, double time, double h, VlasovFunctor1D_explicitE& vF, collisions_1D&, Parallel_Environment_1D& PE) 
+{
+//  Take a step using the Shu-Osher form of SSP-RK3
+
+    //  Curl terms for h/2 on either side when they are implicit
+        if (Input::List().implicit_maxwell) vF.maxwell(Y, 0.5*h);
+
+        Y0 = Y; Y1 = Y;
+//      ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//      Stage 1
+        vF(Y1,Yh,time,h);
+        PE.Neighbor_Communications(Yh);
+        Yh *= h;            Y1 += Yh;       // Y1 = Y + h*Yh
+//      ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//      Stage 2
+        vF(Y1,Yh,time,h);
+        PE.Neighbor_Communications(Yh);
+        Yh *= h;            Y1 += Yh;
+        Y1 *= onequarter;   Y0 *= threequarter;
+        Y1 += Y0;                           // Y1 = 3/4 Y + 1/4 (Y1 + h*Yh)
+//      ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//      Stage 3
+        vF(Y1,Yh,time,h);
+        PE.Neighbor_Communications(Yh);
+        Yh *= h;            Y1 += Yh;
+        Y1 *= twothird;     Y  *= onethird;
+        Y  += Y1;                           // Y  = 1/3 Y + 2/3 (Y1 + h*Yh)
+
+        if (Input::List().implicit_maxwell) vF.maxwell(Y, 0.5*h);
+//      ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+}
+//--------------------------------------------------------------
 /*RKT54::RKT54(State1D& Yin): Yh1(Yin), Yh2(Yin), Yh3(Yin), Yh4(Yin), Yh5(Yin), Yh6(Yin), Yh7(Yin), Yt(Yin),
         
         a21(0.161),
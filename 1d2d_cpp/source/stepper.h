@@ -132,15 +132,36 @@ public:
 
     void take_step(State2D& Y5, State2D& Y4, double time, double h, 
         VlasovFunctor2D_explicitE& vF, collisions_2D& cF, Parallel_Environment_2D& PE);
+
+//      Health tallies from the last update of the 1D step, see State1D::add_checked
+    const valarray<double>& health() const {return tally;}
 private:
 
     State1D  Y0, Y1, Y2, Yh;
+    valarray<double> tally;
 
     State2D  Y0_2D, Y1_2D, Y2_2D, Yh_2D;
 
     complex<double> onethird, twothird;
 };
 //--------------------------------------------------------------
+//  Third order strong-stability-preserving RK, the coarse
+//  propagator of the parareal driver
+class RK3SSP {
+public:
+//      Constructor
+    RK3SSP(State1D& Yin);
+    ~RK3SSP();
+
+    void take_step(State1D& Ystar, State1D& Y, double time, double h, 
+        VlasovFunctor1D_explicitE& vF, collisions_1D& cF, Parallel_Environment_1D& PE);
+private:
+
+    State1D  Y0, Y1, Yh;
+
+    complex<double> onethird, twothird, onequarter, threequarter;
+};
+//--------------------------------------------------------------
 class RKDP85 {
 public:
 //      Constructor
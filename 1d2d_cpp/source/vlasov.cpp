@@ -21,7 +21,7 @@
 //  My libraries
 #include "lib-array.h"
 #include "lib-algorithms.h"
-// #include "nmethods.h"
+#include "nmethods.h"
 
 //  Declerations
 #include "state.h"
@@ -30,6 +30,7 @@
 #include "fluid.h"
 #include "gpu.h"
 #include "vlasov.h"
+#include "parallel.h"
 
 
 //**************************************************************
@@ -831,6 +832,7 @@ void Electric_Field::es1d(const DistFunc1D& Din,
 
         /// Local variables for each thread
         size_t l0(Din.l0());
+        size_t l_top(Din.l_active());   ///< Harmonics above this are zero in the whole slab
         valarray<complex<double> > Ex(FEx.array());
         Ex *= Din.q();
 
@@ -855,10 +857,13 @@ void Electric_Field::es1d(const DistFunc1D& Din,
         // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
         //      m = 0,  l = l0
         // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-            MakeGH(Din(l0,0),G,H,l0);
-            Ex *= A2(l0,0);  Dh(l0-1,0) += H.mxaxis(Ex);
+            if (l0 <= l_top)
+            {
+                MakeGH(Din(l0,0),G,H,l0);
+                Ex *= A2(l0,0);  Dh(l0-1,0) += H.mxaxis(Ex);
         // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-            Ex /= A2(l0,0);             // Reset Ex
+                Ex /= A2(l0,0);             // Reset Ex
+            }
                                         // 
             f_end_thread -= 1;
         }
@@ -872,7 +877,7 @@ void Electric_Field::es1d(const DistFunc1D& Din,
         // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
         //      m = 0, f_start < l < f_end
         // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-        for (size_t l = f_start_thread; l < f_end_thread; ++l)
+        for (size_t l = f_start_thread; l < ((f_end_thread < l_top+1)? f_end_thread:l_top+1); ++l)
         {
             MakeGH(Din(l,0),G,H,l);
 
@@ -890,11 +895,12 @@ void Electric_Field::es1d(const DistFunc1D& Din,
         SHarmonic1D G(pr.size(),FEx.numx()),H(pr.size(),FEx.numx());
         valarray<complex<double> > Ex(FEx.array());
         Ex *= Din.q();
+        size_t l_top(Din.l_active());
 
     //  Initialize Ex so that it its ready for loop iteration l
         Ex *= A1(f_end[threadboundaries]-1,0);
 
-        for (size_t l = f_end[threadboundaries]; l < f_start[threadboundaries+1]; ++l)
+        for (size_t l = f_end[threadboundaries]; l < ((f_start[threadboundaries+1] < l_top+1)? f_start[threadboundaries+1]:l_top+1); ++l)
         {
             MakeGH(Din(l,0),G,H,l);
 
@@ -3469,6 +3475,7 @@ void Spatial_Advection::operator()(const DistFunc1D& Din, DistFunc1D& Dh)
 //--------------------------------------------------------------
     size_t l0(Din.l0());
     size_t m0(Din.m0());
+    size_t l_top(Din.l_active());   ///< Harmonics above this are zero in the whole slab
 
     #pragma omp parallel num_threads(Input::List().ompthreads)
     {
@@ -3496,6 +3503,7 @@ void Spatial_Advection::operator()(const DistFunc1D& Din, DistFunc1D& Dh)
         for (size_t id = f_start_thread; id < f_end_thread; ++id)
         {   
             l = dist_il[id];    m = dist_im[id];
+            if (l > l_top) continue;
             
             fd1 = Din(l,m);     fd1 = fd1.Dx(Input::List().dbydx_order);
 
@@ -3532,6 +3540,7 @@ void Spatial_Advection::operator()(const DistFunc1D& Din, DistFunc1D& Dh)
         for (size_t id = f_end[threadboundaries]; id < f_start[threadboundaries+1]; ++id)
         {   
             l = dist_il[id];    m = dist_im[id];
+            if (l > l_top) continue;
 
             fd1 = Din(l,m);     fd1 = fd1.Dx(Input::List().dbydx_order);
 
@@ -3705,6 +3714,7 @@ void Spatial_Advection::es1d(const DistFunc1D& Din, DistFunc1D& Dh) {
     // valarray<complex<double> > vtemp(vr);
 
     size_t l0(Din.l0());
+    size_t l_top(Din.l_active());   ///< Harmonics above this are zero in the whole slab
 
     #pragma omp parallel num_threads(Input::List().ompthreads)
     {   
@@ -3757,9 +3767,12 @@ void Spatial_Advection::es1d(const DistFunc1D& Din, DistFunc1D& Dh) {
 
         if (this_thread == Input::List().ompthreads - 1)    
         {    
-            fd1 = Din(l0,0);                        fd1.Dx(Input::List().dbydx_order);
-            vtemp *= A2(l0,0);                      Dh(l0-1,0) += fd1.mpaxis(vtemp);
-            vtemp /= A2(l0,0);
+            if (l0 <= l_top)
+            {
+                fd1 = Din(l0,0);                        fd1.Dx(Input::List().dbydx_order);
+                vtemp *= A2(l0,0);                      Dh(l0-1,0) += fd1.mpaxis(vtemp);
+                vtemp /= A2(l0,0);
+            }
 
             f_end_thread -= 1;
         }
@@ -3770,7 +3783,7 @@ void Spatial_Advection::es1d(const DistFunc1D& Din, DistFunc1D& Dh) {
         //  -------------------------------------------------------- //
         vtemp *= A1(f_start_thread-1,0);
 
-        for (size_t l = f_start_thread; l < f_end_thread; ++l)
+        for (size_t l = f_start_thread; l < ((f_end_thread < l_top+1)? f_end_thread:l_top+1); ++l)
         {
             // std::cout << "\n l = " << l ;
 
@@ -3806,7 +3819,7 @@ void Spatial_Advection::es1d(const DistFunc1D& Din, DistFunc1D& Dh) {
         
         vtemp *= A1(f_end[threadboundaries]-1,0);
 
-        for (size_t l = f_end[threadboundaries]; l < f_start[threadboundaries+1]; ++l)
+        for (size_t l = f_end[threadboundaries]; l < ((f_start[threadboundaries+1] < l_top+1)? f_start[threadboundaries+1]:l_top+1); ++l)
         {   
             fd1 = Din(l,0);  //std::cout << "\n \n before dx, l = " << l << " \n";          
             fd1 = fd1.Dx(Input::List().dbydx_order); //std::cout << " \n after dx\n";
@@ -4006,3 +4019,228 @@ void Ampere::operator()(EMF2D& EMFin, EMF2D& EMFh) {
 }
 //--------------------------------------------------------------
 //**************************************************************
+
+//**************************************************************
+//--------------------------------------------------------------
+//  Crank-Nicolson update of E and B by the curl terms alone
+//--------------------------------------------------------------
+Implicit_Maxwell::Implicit_Maxwell(double xmin, double xmax, size_t Nx,
+    double ymin, double ymax, size_t Ny)
+//--------------------------------------------------------------
+// Constructor
+//--------------------------------------------------------------
+    : dx((xmax-xmin)/double(Nx)), dy((ymax-ymin)/double(Ny)),
+      comm_x(Time_Decomposition::Slice_Comm()), comm_y(MPI_COMM_SELF) {
+
+//  Rows and columns of the x-y decomposition in 2D
+    if (Ny > 1) {
+        int rank;
+        MPI_Comm_rank(Time_Decomposition::Slice_Comm(), &rank);
+        int rx(rank % int(Input::List().MPI_X[0])), ry(rank / int(Input::List().MPI_X[0]));
+        MPI_Comm_split(Time_Decomposition::Slice_Comm(), ry, rx, &comm_x);
+        MPI_Comm_split(Time_Decomposition::Slice_Comm(), rx, ry, &comm_y);
+    }
+}
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+//  (1+2k) x_j - k (x_j-1 + x_j+1) = r_j on a ring of m unknowns,
+//  Sherman-Morrison on top of the tridiagonal solve
+static void cyclic_solve(const double k, valarray<complex<double> >& r, valarray<complex<double> >& x) {
+//--------------------------------------------------------------
+    const size_t m(r.size());
+    const double b(1.0+2.0*k);
+
+    if (m == 1) { x = r; return; }
+    if (m == 2) {
+        double det(b*b - 4.0*k*k);
+        x[0] = (b*r[0] + 2.0*k*r[1])/det;
+        x[1] = (b*r[1] + 2.0*k*r[0])/det;
+        return;
+    }
+
+    const double gamma(-b);
+    valarray<double> a(-k, m), d(b, m), c(-k, m);
+    d[0]   -= gamma;
+    d[m-1] -= k*k/gamma;
+
+    valarray<double> a2(a), d2(d), c2(c);
+    valarray<complex<double> > u(complex<double>(0.0), m), z(m);
+    u[0]   = gamma;
+    u[m-1] = -k;
+
+    TridiagonalSolve(a, d, c, r, x);
+    TridiagonalSolve(a2, d2, c2, u, z);
+
+    complex<double> fact((x[0] - k*x[m-1]/gamma)/(1.0 + z[0] - k*z[m-1]/gamma));
+    x -= fact*z;
+}
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+//  E' = s dB/dl, B' = s dE/dl over a periodic line of L cells 
+//  with centered differences. Eliminating B^n+1 leaves
+//  (1 - k D2) E^n+1 = (1 + k D2) E^n + 2 c (B_i+1 - B_i-1), with
+//  D2 over i-2, i, i+2, i.e. a ring for the even and one for 
+//  the odd cells (a single ring if L is odd)
+static void cn_ring(valarray<complex<double> >& E, valarray<complex<double> >& B,
+                    const double s, const double h, const double dl) {
+//--------------------------------------------------------------
+    const size_t L(E.size());
+    const double theta(0.5*h);
+    const double k(theta*theta/(4.0*dl*dl));
+    const double c(theta*s/(2.0*dl));
+
+    valarray<complex<double> > E0(E);
+
+    const size_t rings((L % 2 == 0) ? 2 : 1);
+    const size_t m(L / rings);
+    valarray<complex<double> > r(m), x(m);
+
+    for (size_t p(0); p < rings; ++p) {
+        for (size_t j(0), i(p); j < m; ++j, i = (i+2) % L) {
+            size_t ip1((i+1)%L), im1((i+L-1)%L), ip2((i+2)%L), im2((i+L-2)%L);
+            r[j] = E0[i] + k*(E0[ip2] - 2.0*E0[i] + E0[im2]) + 2.0*c*(B[ip1] - B[im1]);
+        }
+        cyclic_solve(k, r, x);
+        for (size_t j(0), i(p); j < m; ++j, i = (i+2) % L) E[i] = x[j];
+    }
+
+    E0 += E;
+    for (size_t i(0); i < L; ++i) {
+        B[i] += c*(E0[(i+1)%L] - E0[(i+L-1)%L]);
+    }
+}
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+//  Solve the lines E[q], B[q] (n local cells, stride apart) over
+//  the whole domain: the interior cells of the ranks of comm are 
+//  gathered, each rank solves every line in full and keeps its 
+//  own cells and guard cells. A mirror boundary is folded into
+//  a periodic line of twice the length, E with parity sE and B
+//  with the opposite parity.
+void Implicit_Maxwell::lines(vector<complex<double>*>& E, vector<complex<double>*>& B, 
+                             const vector<double>& s, const vector<double>& sE,
+                             const size_t n, const size_t stride, MPI_Comm comm, 
+                             const vector<size_t>& cells, const int bnd, const double h, const double dl) {
+//--------------------------------------------------------------
+    const size_t Nbc(Input::List().BoundaryCells);
+    const size_t nl(n - 2*Nbc), nq(E.size());
+
+    int rank, nranks;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &nranks);
+
+    vector<size_t> offset(nranks+1, 0);
+    for (int r(0); r < nranks; ++r) offset[r+1] = offset[r] + cells[r];
+    const size_t N(offset[nranks]);
+
+//  Pack [line][E, B][cell] and gather
+    valarray<complex<double> > send(2*nq*nl), all(2*nq*N);
+    for (size_t q(0); q < nq; ++q) {
+        for (size_t i(0); i < nl; ++i) {
+            send[(2*q  )*nl + i] = E[q][(i+Nbc)*stride];
+            send[(2*q+1)*nl + i] = B[q][(i+Nbc)*stride];
+        }
+    }
+
+    if (nranks == 1) all = send;
+    else {
+        vector<int> counts(nranks), displs(nranks);
+        for (int r(0); r < nranks; ++r) {
+            counts[r] = static_cast<int>(4*nq*cells[r]);     // two fields of complex doubles
+            displs[r] = static_cast<int>(4*nq*offset[r]);
+        }
+        MPI_Allgatherv(reinterpret_cast<double*>(&send[0]), counts[rank], MPI_DOUBLE,
+                       reinterpret_cast<double*>(&all[0]), &counts[0], &displs[0], MPI_DOUBLE, comm);
+    }
+
+    const size_t L((bnd == 1) ? 2*N : N);
+
+    #pragma omp parallel for num_threads(Input::List().ompthreads)
+    for (size_t q = 0; q < nq; ++q)
+    {
+        valarray<complex<double> > El(L), Bl(L);
+        for (int r(0); r < nranks; ++r) {
+            const complex<double>* blk(&all[2*nq*offset[r]]);
+            for (size_t i(0); i < cells[r]; ++i) {
+                El[offset[r]+i] = blk[(2*q  )*cells[r] + i];
+                Bl[offset[r]+i] = blk[(2*q+1)*cells[r] + i];
+            }
+        }
+        if (bnd == 1) {
+            for (size_t i(0); i < N; ++i) {
+                El[L-1-i] =  sE[q]*El[i];
+                Bl[L-1-i] = -sE[q]*Bl[i];
+            }
+        }
+
+        cn_ring(El, Bl, s[q], h, dl);
+
+        for (size_t j(0); j < n; ++j) {
+            size_t g((offset[rank] + L + j - Nbc) % L);
+            E[q][j*stride] = El[g];
+            B[q][j*stride] = Bl[g];
+        }
+    }
+}
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+void Implicit_Maxwell::operator()(EMF1D& EMF, double h) {
+//--------------------------------------------------------------
+    vector<complex<double>*> E, B;
+    vector<double> s, sE;
+
+//      dEy/dt = - dBz/dx, dBz/dt = - dEy/dx
+    E.push_back(&(EMF.Ey()(0))); B.push_back(&(EMF.Bz()(0))); s.push_back(-1.0); sE.push_back(-1.0);
+//      dEz/dt =   dBy/dx, dBy/dt =   dEz/dx
+    E.push_back(&(EMF.Ez()(0))); B.push_back(&(EMF.By()(0))); s.push_back( 1.0); sE.push_back(-1.0);
+
+    lines(E, B, s, sE, EMF.Ey().numx(), 1, comm_x, Input::List().NxSlabs, Input::List().bndX, h, dx);
+}
+//--------------------------------------------------------------
+//  x for h/2, y for h, x for h/2; each is unconditionally stable
+void Implicit_Maxwell::operator()(EMF2D& EMF, double h) {
+//--------------------------------------------------------------
+    sweep_x(EMF, 0.5*h);
+    sweep_y(EMF, h);
+    sweep_x(EMF, 0.5*h);
+}
+//--------------------------------------------------------------
+void Implicit_Maxwell::sweep_x(EMF2D& EMF, double h) {
+//--------------------------------------------------------------
+    size_t nx(EMF.Ex().numx()), ny(EMF.Ex().numy());
+    vector<complex<double>*> E, B;
+    vector<double> s, sE;
+
+    for (size_t iy(0); iy < ny; ++iy) {
+//          dEy/dt = - dBz/dx, dBz/dt = - dEy/dx
+        E.push_back(&(EMF.Ey()(0,iy))); B.push_back(&(EMF.Bz()(0,iy))); s.push_back(-1.0); sE.push_back(-1.0);
+//          dEz/dt =   dBy/dx, dBy/dt =   dEz/dx
+        E.push_back(&(EMF.Ez()(0,iy))); B.push_back(&(EMF.By()(0,iy))); s.push_back( 1.0); sE.push_back(-1.0);
+    }
+
+    vector<size_t> cells(Input::List().MPI_X[0], Input::List().NxLocalnobnd[0]);
+    lines(E, B, s, sE, nx, 1, comm_x, cells, Input::List().bndX, h, dx);
+}
+//--------------------------------------------------------------
+void Implicit_Maxwell::sweep_y(EMF2D& EMF, double h) {
+//--------------------------------------------------------------
+    size_t nx(EMF.Ex().numx()), ny(EMF.Ex().numy());
+    vector<complex<double>*> E, B;
+    vector<double> s, sE;
+
+    for (size_t ix(0); ix < nx; ++ix) {
+//          dEx/dt =   dBz/dy, dBz/dt =   dEx/dy
+        E.push_back(&(EMF.Ex()(ix,0))); B.push_back(&(EMF.Bz()(ix,0))); s.push_back( 1.0); sE.push_back( 1.0);
+//          dEz/dt = - dBx/dy, dBx/dt = - dEz/dy
+        E.push_back(&(EMF.Ez()(ix,0))); B.push_back(&(EMF.Bx()(ix,0))); s.push_back(-1.0); sE.push_back(-1.0);
+    }
+
+    vector<size_t> cells(Input::List().MPI_X[1], Input::List().NxLocalnobnd[1]);
+    lines(E, B, s, sE, ny, nx, comm_y, cells, Input::List().bndY, h, dy);
+}
+//--------------------------------------------------------------
+//**************************************************************
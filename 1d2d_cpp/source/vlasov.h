@@ -237,4 +237,32 @@ private:
 };
 //--------------------------------------------------------------
 
+//--------------------------------------------------------------
+//  Crank-Nicolson update of E and B by the curl terms alone,
+//  solved along whole x-lines in 1D and alternating x-y-x lines 
+//  in 2D, so that the step is not limited by the light wave
+class Implicit_Maxwell {
+//--------------------------------------------------------------
+public:
+//      Constructors/Destructors
+    Implicit_Maxwell(double xmin, double xmax, size_t Nx,
+            double ymin, double ymax, size_t Ny);
+//          Advance over h
+    void operator()(EMF1D& EMF, double h);
+    void operator()(EMF2D& EMF, double h);
+
+private:
+    void sweep_x(EMF2D& EMF, double h);
+    void sweep_y(EMF2D& EMF, double h);
+    void lines(vector<complex<double>*>& E, vector<complex<double>*>& B, 
+               const vector<double>& s, const vector<double>& sE,
+               const size_t n, const size_t stride, MPI_Comm comm, 
+               const vector<size_t>& cells, const int bnd, const double h, const double dl);
+
+    double              dx, dy;
+    MPI_Comm            comm_x, comm_y;     // Ranks along a line in x, in y
+
+};
+//--------------------------------------------------------------
+
 #endif
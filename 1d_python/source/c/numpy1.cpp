@@ -45,8 +45,12 @@ for(int y=0;y<shape[0];y++) {
 #include <stdlib.h> 
 #include <cstring>			// for memcpy
 #include <vector>
+#include <algorithm>		// for min/max
 #include <math.h>
 #include <float.h>
+#ifdef _OPENMP
+	#include <omp.h>
+#endif
 
 #ifdef USE_EIGEN
 	#include <Eigen/Dense>
@@ -424,6 +428,79 @@ int tridiag__c( double* RESTRICT a, double* RESTRICT b, double* RESTRICT c, doub
 	return 0;
 }
 
+// Banded LU (bandec/banbks), 0 based. 'a' holds the n x (m1+m2+1) compact form of a matrix
+//	with m1 sub- and m2 super-diagonals: a[i][j] = A(i, i-m1+j). On return 'a' is U and 'al'
+//	(n x m1) is L. Returns -(row+1) for a zero pivot.
+int bandec(	double * RESTRICT a, int n, int m1, int m2, double * RESTRICT al, int * RESTRICT indx) {
+	const int mm = m1+m2+1;
+	int l = m1;
+	double dum;
+
+	for(int i=0;i<m1;i++) {
+		for(int j=m1-i;j<mm;j++) a[i*mm+j-l] = a[i*mm+j];
+		l--;
+		for(int j=mm-l-1;j<mm;j++) a[i*mm+j] = 0.0;
+	}
+	l = m1;
+	for(int k=0;k<n;k++) {
+		dum = a[k*mm];
+		int i = k;
+		if(l < n) l++;
+		for(int j=k+1;j<l;j++) {
+			if( fabs(a[j*mm]) > fabs(dum) ) { dum = a[j*mm]; i = j; }
+		}
+		indx[k] = i;
+		if(dum == 0.0) return -1*(k+1);
+		if(i != k) {
+			for(int j=0;j<mm;j++) { double t = a[k*mm+j]; a[k*mm+j] = a[i*mm+j]; a[i*mm+j] = t; }
+		}
+		for(i=k+1;i<l;i++) {
+			dum = a[i*mm]/a[k*mm];
+			al[k*m1+i-k-1] = dum;
+			for(int j=1;j<mm;j++) a[i*mm+j-1] = a[i*mm+j] - dum*a[k*mm+j];
+			a[i*mm+mm-1] = 0.0;
+		}
+	}
+	return 0;
+}
+
+int banbks(	double * RESTRICT a, int n, int m1, int m2, double * RESTRICT al, int * RESTRICT indx, double * RESTRICT b) {
+	const int mm = m1+m2+1;
+	int l = m1;
+	double dum;
+
+	for(int k=0;k<n;k++) {
+		int j = indx[k];
+		if(j != k) { dum = b[k]; b[k] = b[j]; b[j] = dum; }
+		if(l < n) l++;
+		for(j=k+1;j<l;j++) b[j] -= al[k*m1+j-k-1]*b[k];
+	}
+	l = 1;
+	for(int i=n-1;i>=0;i--) {
+		dum = b[i];
+		for(int k=1;k<l;k++) dum -= a[i*mm+k]*b[k+i];
+		b[i] = dum/a[i*mm];
+		if(l < mm) l++;
+	}
+	return 0;
+}
+
+// Banded LU solve of an n x n row-major matrix with m sub- and m super-diagonals (the
+//	tridiagonal, m=1, and pentadiagonal, m=2, collision options). 'band' (n*(2m+1)) and 'lower' (n*m)
+//	are scratch, the solution is written into 'b'. Returns < 0 for a singular matrix.
+int banded_solve( const double * RESTRICT a, int stride, int n, int m, double * RESTRICT band, double * RESTRICT lower,
+						int * RESTRICT indx, double * RESTRICT b) {
+	const int mm = 2*m+1;
+	for(int i=0;i<n;i++) {
+		for(int j=0;j<mm;j++) {
+			const int col = i-m+j;
+			band[i*mm+j] = ( col >= 0 && col < n ) ? a[i*stride+col] : 0.0;
+		}
+	}
+	int err = bandec( band, n, m, m, lower, indx );
+	if( err < 0 ) return err;
+	return banbks( band, n, m, m, lower, indx, b );
+}
 
 // Copied (only slightly modified) from the 2D C++ versin of the code
 bool Gauss_Seidel(	double* RESTRICT a, double* RESTRICT b, double* RESTRICT xk, 
@@ -1025,7 +1102,9 @@ struct fokker_plank_implicit_advance {
 	
 	// full C++ solver....
 	bool use_C_matrix_solvers;
+	bool use_lu_solver;			// banded LU for is_tridiagonal = 1 or 2, the full matrix always uses Gauss-Seidel
 	int* solver_indx; double* solver_temp;
+	double* solver_band; double* solver_band_lower;
 	double* solver_tridiag__a; double* solver_tridiag__b; double* solver_tridiag__c; double *solver_tridiag__solution;
 	double *solver_scratch;
 	#ifdef USE_EIGEN
@@ -1036,6 +1115,12 @@ struct fokker_plank_implicit_advance {
 	// TODO PASS THIS IN TAKE OUT HARD CODING.
 	int species_index; species my_species; DistributionFunction F; double* F_data;	
 	
+	// copies used by the batched 'advance_cells', one per thread. Each shares the 
+	//	read-only coefficients but owns every array that the reset and advance write into.
+	//	When I2_work is set it replaces the explicit code's I2 as scratch.
+	vector<fokker_plank_implicit_advance*> thread_copies;
+	numpy_array I2_work;
+	
 	double kpre;
 	#define  four_pi 4.0*3.141592654
 	#define eight_pi 8.0*3.141592654
@@ -1121,6 +1206,17 @@ struct fokker_plank_implicit_advance {
 		#else
 			this->use_C_matrix_solvers = false;
 		#endif
+		// the banded solves replace the tridiagonal one, unless the solvers are being compared with scipy
+		#ifndef USE_C_MATRIX_SOLVERS_AND_PYTHON_AND_COMPARE
+			this->use_lu_solver = this->use_C_matrix_solvers;
+		#else
+			this->use_lu_solver = false;
+		#endif
+		
+		// any copies made for the batched calls are stale now
+		for(size_t i=0;i < thread_copies.size();i++) free_thread_copy( thread_copies[i] );
+		thread_copies.clear();
+		I2_work.data = 0;
 
 		if(this->use_C_matrix_solvers) {
 			printf("USING C-ONLY Solvers...\n\n");
@@ -1129,6 +1225,8 @@ struct fokker_plank_implicit_advance {
 				solver_indx = new int[num_pr_cells];
 				solver_temp = new double[num_pr_cells];
 				solver_scratch = new double[num_pr_cells];
+				solver_band = new double[num_pr_cells*5];
+				solver_band_lower = new double[num_pr_cells*2];
 			//} else {
 				solver_temp = new double[num_pr_cells];
 				solver_tridiag__a = new double[num_pr_cells];
@@ -1152,7 +1250,7 @@ struct fokker_plank_implicit_advance {
 		// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
 		// Temperature integral I2 = 4*pi / (v^2) * int_0^v f(u)*u^4du]
 		
-		numpy_array& I2 = explict_code->I2; I2.data[0] = 0.0;
+		numpy_array& I2 = (I2_work.data != 0) ? I2_work : explict_code->I2; I2.data[0] = 0.0;
 		numpy_array& U1 = explict_code->U1;
 		numpy_array& U1m1 = explict_code->U1m1;
 		numpy_array& U2 = explict_code->U2;
@@ -1322,7 +1420,11 @@ if(print_output1 && debug__current_sim_timestep < 10 ) {
 		if(LL > 1) Alpha.data[0] = 0.0;
 		
 		
-		if( is_tridiagonal == 0) {
+		// is_tridiagonal = 2 keeps the Rosenbluth terms within two cells of the diagonal. Like the
+		//	tridiagonal option it is a truncation: the couplings it drops fall off only as a power of
+		//	v_j/v_i, so they are not small, and it has not been checked against the full operator.
+		if( is_tridiagonal != 1) {
+			const int band = ( is_tridiagonal == 2 ) ? 2 : num_pr_cells;
 			double A1 = (LL+1.0)*(LL+2.0) / ((2.0*LL+1.0)*(2.0*LL+3.0));
 			double A2 = (-1.0) *(LL-1.0)* LL      / ((2.0*LL+1.0)*(2.0*LL-1.0));
 			double B1 = (-1.0) *( 0.5 *LL*(LL+1.0) +(LL+1.0) ) / ((2.0*LL+1.0)*(2.0*LL+3.0));
@@ -1340,10 +1442,12 @@ if(print_output1 && debug__current_sim_timestep < 10 ) {
 				double t4 = A2*ddf0.data[i] + B4*df0.data[i];
 				t4 *= factor1;
 				
-				Alpha.data[i*alpha_stride] += t1 * ( 2.0*PI* pow(vr.data[0]/vr.data[i],LL+2)*vr.data[0]*vr.data[0]*(vr.data[1]-vr.data[0]) );
-				Alpha.data[i*alpha_stride] += t3 * ( 2.0*PI*pow(vr.data[0]/vr.data[i],LL)  *vr.data[0]* vr.data[0]*(vr.data[1]-vr.data[0]) );
+				if( i <= band ) {
+					Alpha.data[i*alpha_stride] += t1 * ( 2.0*PI* pow(vr.data[0]/vr.data[i],LL+2)*vr.data[0]*vr.data[0]*(vr.data[1]-vr.data[0]) );
+					Alpha.data[i*alpha_stride] += t3 * ( 2.0*PI*pow(vr.data[0]/vr.data[i],LL)  *vr.data[0]* vr.data[0]*(vr.data[1]-vr.data[0]) );
+				}
 
-				for(int j=1;j<i;j++) {
+				for(int j=max(1,i-band);j<i;j++) {
 					Alpha.data[i*alpha_stride+j] += t1 * ( 2.0*PI*pow(vr.data[j]/vr.data[i],LL+2)*vr.data[j]*vr.data[j]*(vr.data[j+1]-vr.data[j-1]) );
 					Alpha.data[i*alpha_stride+j] += t3 * ( 2.0*PI*pow(vr.data[j]/vr.data[i],LL)  *vr.data[j]*vr.data[j]*(vr.data[j+1]-vr.data[j-1]) );
 
@@ -1355,7 +1459,7 @@ if(print_output1 && debug__current_sim_timestep < 10 ) {
 				Alpha.data[i*alpha_stride+i] += t2 * ( 2.0*PI*vr.data[i]*vr.data[i]*(vr.data[i+1]-vr.data[i]) );
 				Alpha.data[i*alpha_stride+i] += t4 * ( 2.0*PI*vr.data[i]*vr.data[i]*(vr.data[i+1]-vr.data[i]) );
 
-				for(int j=i+1; j< num_pr_cellsm1; j++) {
+				for(int j=i+1; j< min(num_pr_cellsm1,i+band+1); j++) {
 					Alpha.data[i*alpha_stride+j] += t2 * ( 2.0*PI*pow(vr.data[j]/vr.data[i],-LL-1)*vr.data[j]*vr.data[j]*(vr.data[j+1]-vr.data[j-1]) );
 					Alpha.data[i*alpha_stride+j] += t4 * ( 2.0*PI*pow(vr.data[j]/vr.data[i],-LL+1)*vr.data[j]*vr.data[j]*(vr.data[j+1]-vr.data[j-1]) ); 
 				}
@@ -1403,6 +1507,19 @@ if(print_output1 && debug__current_sim_timestep < 10 ) {
 		
 		//printf("I am c++ and i say tridiagonal is %d", is_tridiagonal);
 		
+		// banded LU solve for the tridiagonal and pentadiagonal options, the solution is written into 'fin'.
+		//	The full matrix stays with Gauss-Seidel below, a dense LU costs O(n^3) per cell.
+		//	Every cell and L has its own matrix (AlphaTri comes from the f00 of the cell, the 
+		//	diagonal from L), so there is no factorization to reuse.
+		if( use_lu_solver && is_tridiagonal != 0 ) {
+			int err = banded_solve(Alpha.data, alpha_stride, num_pr_cells, is_tridiagonal, solver_band, solver_band_lower, solver_indx, fin);
+			if( err < 0) {
+				printf("ERROR in C LU SOLVER, singular matrix at spatial cell %d, L=%d. QUITTING!!!!! \n\n\n", current_x, LL);
+				exit(-1);
+			}
+			return;
+		}
+		
 		if(this->use_C_matrix_solvers) {
 			int err;
 			if( is_tridiagonal == 1) {
@@ -1567,6 +1684,74 @@ if(print_output1 && debug__current_sim_timestep < 10 ) {
 		}
 	}
 	
+	// A copy of this object that owns its scratch arrays (see 'thread_copies')
+	fokker_plank_implicit_advance* make_thread_copy() {
+		fokker_plank_implicit_advance* fp = new fokker_plank_implicit_advance(*this);
+		const int n = num_pr_cells;
+		
+		fp->thread_copies.clear();
+		fp->I2_work = explict_code->I2; fp->I2_work.data = new double[n];
+		fp->I0.data = new double[n]; fp->J1m.data = new double[n];
+		fp->TriI1.data = new double[n]; fp->TriI2.data = new double[n];
+		fp->Scattering_Term.data = new double[n];
+		fp->df0.data = new double[n]; fp->ddf0.data = new double[n];
+		fp->Alpha.data = new double[n*n]; fp->AlphaTri.data = new double[n*n];
+		
+		fp->solver_indx = new int[n];
+		fp->solver_temp = new double[n]; fp->solver_scratch = new double[n];
+		fp->solver_band = new double[n*5]; fp->solver_band_lower = new double[n*2];
+		fp->solver_tridiag__a = new double[n]; fp->solver_tridiag__b = new double[n];
+		fp->solver_tridiag__c = new double[n]; fp->solver_tridiag__solution = new double[n];
+		
+		// never call back into python from a thread
+		fp->use_C_matrix_solvers = true;
+		fp->use_lu_solver = true;
+		return fp;
+	}
+	
+	void free_thread_copy(fokker_plank_implicit_advance* fp) {
+		delete [] fp->I2_work.data;
+		delete [] fp->I0.data; delete [] fp->J1m.data;
+		delete [] fp->TriI1.data; delete [] fp->TriI2.data;
+		delete [] fp->Scattering_Term.data;
+		delete [] fp->df0.data; delete [] fp->ddf0.data;
+		delete [] fp->Alpha.data; delete [] fp->AlphaTri.data;
+		delete [] fp->solver_indx;
+		delete [] fp->solver_temp; delete [] fp->solver_scratch;
+		delete [] fp->solver_band; delete [] fp->solver_band_lower;
+		delete [] fp->solver_tridiag__a; delete [] fp->solver_tridiag__b;
+		delete [] fp->solver_tridiag__c; delete [] fp->solver_tridiag__solution;
+		delete fp;
+	}
+	
+	// Batched version of 'reset_coeff__cpp' followed by 'implicit_advance' for L = l_begin..l_end-1,
+	//	over 'num_cells' consecutive spatial cells of a [x, l, p] buffer (so harmonic index == L, i.e. num_m = 1).
+	//	The cells are independent and are spread over the OpenMP threads.
+	void advance_cells(double* F_cells, int num_cells, int num_l, int l_begin, int l_end, double dt) {
+		int num_threads = 1;
+		#ifdef _OPENMP
+			num_threads = omp_get_max_threads();
+		#endif
+		while( (int) thread_copies.size() < num_threads) thread_copies.push_back( make_thread_copy() );
+		
+		const int F_data__cell_stride = num_l * num_pr_cells;
+		
+		#pragma omp parallel for schedule(dynamic)
+		for(int x=0; x < num_cells; x++) {
+			int thread = 0;
+			#ifdef _OPENMP
+				thread = omp_get_thread_num();
+			#endif
+			fokker_plank_implicit_advance* fp = thread_copies[thread];
+			
+			double * cell = &( F_cells[x*F_data__cell_stride] );
+			fp->reset_coeff__cpp( cell, dt );
+			for(int L=l_begin; L < l_end; L++) {
+				fp->implicit_advance( &( cell[L*num_pr_cells] ), L, -1.0, dt, x );
+			}
+		}
+	}
+	
 	void printDebuggingTridiag(double *fin, int i) {
 		double diff = fin[i] - solver_tridiag__solution[i];
 		double percentError = diff/fin[i];
@@ -1822,6 +2007,124 @@ struct HarmonicCentricView {
 	}
 };
 
+/*
+=====================================================================
+Whole-array kernels for the harmonic centric ([x, p]) buffers used by the python
+	code. These replace the per-cell python loops of HarmonicCentricView.Dx/Dp,
+	Field1d.Dx, ElectricFieldOnDistribution1d.G00/MakeGH and SpatialAdvection1d.calc
+	and give the same numbers (up to round-off).
+=====================================================================
+*/
+std::vector<double> hcv_scratch;
+
+// In place x-derivative of 'nx' rows of length 'n':  d(x) = f(x-1) - f(x+1), i.e. -2*dx*df/dx
+//	(the caller normalizes). As in the python loops, row 0 gets f(0) - f(2) and the
+//	last row is left alone; these are guard cells anyway.
+//	order = 4 uses  ( 8*(f(x-1) - f(x+1)) - (f(x-2) - f(x+2)) )/6  where there are two neighbours.
+void hcv__dx( double * RESTRICT data, const int nx, const int n, const int order ) {
+	if( nx < 3 ) return;
+	const size_t size = (size_t) nx * n;
+	if( hcv_scratch.size() < size ) hcv_scratch.resize( size );
+	double * RESTRICT f = &(hcv_scratch[0]);
+	memcpy( f, data, size*sizeof(double) );
+
+	for(int i=0; i < n; i++) data[i] = f[i] - f[2*n+i];
+	for(int x=1; x < nx-1; x++) {
+		const double * RESTRICT fm = &( f[(x-1)*n] );
+		const double * RESTRICT fp = &( f[(x+1)*n] );
+		double * RESTRICT d = &( data[x*n] );
+
+		if( order == 4 && x > 1 && x < nx-2 ) {
+			const double * RESTRICT fmm = &( f[(x-2)*n] );
+			const double * RESTRICT fpp = &( f[(x+2)*n] );
+			for(int i=0; i < n; i++) d[i] = ( 8.0*(fm[i] - fp[i]) - (fmm[i] - fpp[i]) ) / 6.0;
+		} else {
+			for(int i=0; i < n; i++) d[i] = fm[i] - fp[i];
+		}
+	}
+}
+
+// In place |p| derivative of one row:  d(i) = f(i-1) - f(i+1), d(0) = 0 and
+//	d(n-1) = f(n-2) - f(n-1)   (the same as HarmonicCentricView.Dp)
+inline void hcv__dp_row( double * RESTRICT r, const int n ) {
+	const double last = r[n-2] - r[n-1];
+	double prev = r[0];
+	for(int i=1; i < n-1; i++) {
+		const double cur = r[i];
+		r[i] = prev - r[i+1];
+		prev = cur;
+	}
+	r[0] = 0.0;
+	r[n-1] = last;
+}
+
+void hcv__dp( double * RESTRICT data, const int nx, const int n ) {
+	for(int x=0; x < nx; x++) hcv__dp_row( &( data[x*n] ), n );
+}
+
+// G = Dp(f00) with the first |p| cell fixed up from the extrapolated f(p=0), in place on G
+//	(G holds f00 on entry).
+void efield__g00( double * RESTRICT G, const int nx, const int n, const double * RESTRICT pr, const double dp ) {
+	const double p0p1_sq = pr[0]*pr[0]/(pr[1]*pr[1]);
+	const double inv_mp0p1_sq = 1.0/(1.0 - p0p1_sq);
+	const double g_r = -4.0*dp*pr[0]/(pr[1]*pr[1]);
+
+	for(int x=0; x < nx; x++) {
+		double * RESTRICT r = &( G[x*n] );
+		const double p0 = r[0];
+		const double p1 = r[1];
+		hcv__dp_row( r, n );
+		const double f00 = ( p0 - p1*p0p1_sq )*inv_mp0p1_sq;
+		r[0] = (p1 - f00)*g_r;
+	}
+}
+
+// G and H of harmonic 'l' (stored at index 'harmonic_index' of the [x, harmonic, p] buffer F)
+void efield__make_gh( double * RESTRICT G, double * RESTRICT H, const double * RESTRICT F,
+						const int nx, const int num_harmonics, const int n, const int l, const int harmonic_index,
+						const double * RESTRICT invpr, const double dp, const double Hp0_l ) {
+	const double h_scale = -2.0*(l + 1.0)*dp;
+	const double g_scale = (-2.0*l - 1.0) / l;
+
+	for(int x=0; x < nx; x++) {
+		const double * RESTRICT f = &( F[((size_t) x*num_harmonics + harmonic_index)*n] );
+		double * RESTRICT g = &( G[x*n] );
+		double * RESTRICT h = &( H[x*n] );
+
+		memcpy( g, f, n*sizeof(double) );
+		hcv__dp_row( g, n );
+		for(int i=0; i < n; i++) {
+			h[i] = f[i]*invpr[i]*h_scale + g[i];
+			g[i] = g[i]*g_scale + h[i];
+		}
+		g[0] = 0.0;
+		h[0] = f[1]*Hp0_l;
+	}
+}
+
+// Fh(l+1) += A1(l) v Dx(F(l)) and Fh(l-1) += A2(l) v Dx(F(l)) for all l, with F and Fh [x, l, p] buffers.
+void spatial_advection__calc( const double * RESTRICT F, double * RESTRICT Fh, const int nx, const int num_l, const int n,
+								const double * RESTRICT vr, const double * RESTRICT A1, const double * RESTRICT A2, const int order ) {
+	std::vector<double> d( (size_t) nx * n );
+
+	for(int l=0; l < num_l; l++) {
+		for(int x=0; x < nx; x++) memcpy( &(d[x*n]), &( F[((size_t) x*num_l + l)*n] ), n*sizeof(double) );
+		hcv__dx( &(d[0]), nx, n, order );
+
+		for(int x=0; x < nx; x++) {
+			const double * RESTRICT dx = &( d[x*n] );
+			if( l > 0 ) {
+				double * RESTRICT fh = &( Fh[((size_t) x*num_l + l - 1)*n] );
+				for(int i=0; i < n; i++) fh[i] += A2[l]*vr[i]*dx[i];
+			}
+			if( l < num_l-1 ) {
+				double * RESTRICT fh = &( Fh[((size_t) x*num_l + l + 1)*n] );
+				for(int i=0; i < n; i++) fh[i] += A1[l]*vr[i]*dx[i];
+			}
+		}
+	}
+}
+
 struct effect_of_E_on_distribution {
 
 	int num_l;
@@ -1963,8 +2266,64 @@ extern "C" {
 	}
 	
 	extern NUMPY1_API void effect_of_E_on_distribution_calc( ) {
-		
-	}  
+
+	}
+
+	extern NUMPY1_API void efield__g00( double* G, long long* G_shape, double* pr, double dp ) {
+		efield__g00( G, (int) G_shape[0], (int) G_shape[1], pr, dp );
+	}
+
+	extern NUMPY1_API void efield__make_gh( 	double* G, double* H, double* F, long long* F_shape, int l, int harmonic_index,
+														double* invpr, double dp, double Hp0_l ) {
+		efield__make_gh( 	G, H, F, (int) F_shape[0], (int) F_shape[1], (int) F_shape[2], l, harmonic_index,
+								invpr, dp, Hp0_l );
+	}
+
+/*
+---------------------------- Spatial/momentum derivatives ---------------------------
+*/
+	extern NUMPY1_API void hcv__dx( double* data, long long* shape, int order ) {
+		hcv__dx( data, (int) shape[0], (int) shape[1], order );
+	}
+
+	extern NUMPY1_API void hcv__dp( double* data, long long* shape ) {
+		hcv__dp( data, (int) shape[0], (int) shape[1] );
+	}
+
+	// derivative of a 1D field component, including the 1/(2 dx) normalization
+	extern NUMPY1_API void field__dx( double* data, long long num_cells, int order, double dx ) {
+		hcv__dx( data, (int) num_cells, 1, order );
+		const double norm = 1.0/(2.0*dx);
+		for(long long x=0; x < num_cells; x++) data[x] *= norm;
+	}
+
+/*
+---------------------------- MPI guard cells ---------------------------
+*/
+	// Copy cells [first_cell, first_cell+num_cells) of each [x, ...] array into one contiguous
+	//	buffer, array after array (cell_sizes[i] doubles per x cell of array i).
+	extern NUMPY1_API void guard_cells__pack( double** arrays, long long* cell_sizes, int num_arrays,
+													int first_cell, int num_cells, double* buffer ) {
+		for(int i=0; i < num_arrays; i++) {
+			const size_t count = (size_t) num_cells * cell_sizes[i];
+			memcpy( buffer, &( arrays[i][(size_t) first_cell * cell_sizes[i]] ), count*sizeof(double) );
+			buffer += count;
+		}
+	}
+
+	extern NUMPY1_API void guard_cells__unpack( double** arrays, long long* cell_sizes, int num_arrays,
+													int first_cell, int num_cells, double* buffer ) {
+		for(int i=0; i < num_arrays; i++) {
+			const size_t count = (size_t) num_cells * cell_sizes[i];
+			memcpy( &( arrays[i][(size_t) first_cell * cell_sizes[i]] ), buffer, count*sizeof(double) );
+			buffer += count;
+		}
+	}
+
+	extern NUMPY1_API void spatial_advection__calc(double* F, long long* F_shape, double* Fh,
+																double* vr, double* A1, double* A2, int order ) {
+		spatial_advection__calc( F, Fh, (int) F_shape[0], (int) F_shape[1], (int) F_shape[2], vr, A1, A2, order );
+	}
 		
 /* 
 ------------------------------- Collsions------------------------------
@@ -2026,6 +2385,23 @@ extern "C" {
 		DEBUG("\t  Leaving fokker_plank__implicit__advance \n");
 	}
 	
+	// Coefficient reset and implicit advance of L = l_begin..l_end-1 for every plain cell of 'F'
+	//	in one call. 'F' is the whole local [x, l, p] distribution buffer, boundry cells included.
+	extern  NUMPY1_API void fokker_plank__implicit__advance_cells( double* F, long long* F_shape, int num_boundry_cells, 
+																	int l_begin, int l_end, double dt) {
+		DEBUG("\t Entering fokker_plank__implicit__advance_cells \n");
+		fokker_plank_implicit_advance& fp = OSHUN_CALCS._fokker_plank_implicit_advance;
+		if( (int) F_shape[2] != fp.num_pr_cells || l_end > (int) F_shape[1]) {
+			printf("ERROR in fokker_plank__implicit__advance_cells: buffer shape [%lld,%lld,%lld] does not match. QUITTING!!!!! \n\n\n", 
+					F_shape[0], F_shape[1], F_shape[2]);
+			exit(-1);
+		}
+		const int num_cells = (int) F_shape[0] - 2*num_boundry_cells;
+		const int num_l = (int) F_shape[1];
+		fp.advance_cells( &( F[num_boundry_cells*num_l*fp.num_pr_cells] ), num_cells, num_l, l_begin, l_end, dt );
+		DEBUG("\t  Leaving fokker_plank__implicit__advance_cells \n");
+	}
+	
 	extern  NUMPY1_API void fokker_plank__implicit__calc_flm( int n_step, double time, double dt) {
 		DEBUG("\t Entering fokker_plank__implicit__calc_flm \n");
 		OSHUN_CALCS._fokker_plank_implicit_advance.calc_flm( n_step, time, dt );
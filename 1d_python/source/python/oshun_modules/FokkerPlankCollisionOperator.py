@@ -60,6 +60,8 @@ class FokkerPlankExplicit:
 			PRINT("")
 			PRINT("Fokker Planck Execution ")
 			PRINT("Implict Solve Mode Uses Tridiagonal Approximation: %s" %( str( CFG.if_tridiagonal ) ))
+			if CFG.if_tridiagonal == 2:
+				PRINT("\t (if_tridiagonal = 2 is the pentadiagonal approximation)")
 			PRINT("----------------------------------------------------------")
 			
 		if self.explicit__execution_config__python:
@@ -128,6 +130,12 @@ class FokkerPlankExplicit:
 		self.density_np = species.species_config.density_np
 		self.zeta = species.species_config.zeta
 		self.is_tridiagonal = CFG.if_tridiagonal
+		# 0/False is the full matrix, 1/True tridiagonal and 2 pentadiagonal (C++ only). The 
+		# pentadiagonal option drops the Rosenbluth couplings beyond two cells, which are not 
+		# small, and has not been checked against the full matrix; use 0 when they matter.
+		if self.is_tridiagonal == 2 and not use_c_version:
+			PRINT("The pentadiagonal collision matrix (if_tridiagonal = 2) needs the C++ Fokker-Planck code")
+			exit(-1)
 		self.is_implicit1D = CFG.if_implicit1D
 		self.num_l = species.num_l
 		self.num_m = species.num_m
@@ -946,8 +954,17 @@ class FokkerPlankExplicit:
 			pass
 		return 0
 
+	# the C code can take every spatial cell in one call (threaded over x) when
+	# both the coefficient reset and the advance are on the C side.
+	def advance_cells__cpp(self):
+		return (self.implicit_reset_coeff__execution_config__cpp and self.implicit_advance__execution_config__cpp 
+					and not self.test_cpp_vs_python_marix)
+
 	# result put inplace into Yin
 	def f1_loop(self, Yin, dt, max_m):
+		if self.advance_cells__cpp():
+			fokker_plank__implicit__advance_cells__cpp(Yin.distribution_function_data, self.NB, 1, 2, dt)
+			return
 		# loop over spaitial cells....
 		#f00 = self.F0;  fc = self.F1;
 		for x in xrange(0, self.num_plain_cells[0]):
@@ -970,6 +987,9 @@ class FokkerPlankExplicit:
 			#PRINT("For PYTHON annoying 'x=%d+%d,L=1' %e, %e, %e, %e" %(x, self.NB, temp_1, temp_12, temp_2, temp_3))
 	
 	def flm_loop(self, Yin, dt, max_m):
+		if self.advance_cells__cpp():
+			fokker_plank__implicit__advance_cells__cpp(Yin.distribution_function_data, self.NB, 2, self.num_l, dt)
+			return
 		
 		for x in xrange(0, self.num_plain_cells[0]):
 			#PRINT("Starting cell x=%d (flm_loop) dt=%e" % (x, dt))
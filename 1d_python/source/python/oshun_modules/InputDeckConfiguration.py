@@ -39,6 +39,9 @@ class Config:
 		self.dt 						= 0.0
 		self.t_end 					= 0.0
 		
+		# order of the x derivatives in the C kernels (2 or 4); the python fallbacks are 2nd order
+		self.dbydx_order = 2
+		
 		self.E_num_guard_cells = np.array((3,2))
 		self.B_num_guard_cells = np.array((3,2))
 		self.J_num_guard_cells = np.array((3,2))
@@ -221,6 +221,9 @@ class Field1d:
 	def Dx(self, component):
 		
 		data = self.components[component]
+		if USE_C_VERSION_GLOBAL:
+			field__dx__cpp(data, STATE.config.dbydx_order, STATE.spatial_axes[component].dx())
+			return
 		if False:
 			self.temp_data[0,:] = 0.0
 			self.temp_data1[-1:0] = 0.0
@@ -558,6 +561,9 @@ class HarmonicCentricView:
 		self.data *= val
 	
 	def Dp(self):
+		if USE_C_VERSION_GLOBAL:
+			hcv__dp__cpp(self.data)
+			return
 		abs_p_num_points = self.momentum_axis.num_points
 		"""
 		# This routine is a faster version using numpy broadcasting rather then 'for' loops
@@ -612,6 +618,9 @@ class HarmonicCentricView:
 	
 	#TODO: this can be done better using numpy magic...
 	def Dx(self):
+		if USE_C_VERSION_GLOBAL:
+			hcv__dx__cpp(self.data, STATE.config.dbydx_order)
+			return
 		if False:
 			# faster version..
 			# TODO: tme this and validate that it works..
@@ -1141,6 +1150,9 @@ class ElectricFieldOnDistribution1d:
 		
 		pr = self.momentum_axis.values
 		dx = self.momentum_axis.dx()
+		if USE_C_VERSION_GLOBAL:
+			efield__g00__cpp(G, pr, dx)
+			return
 		
 		p0p1_sq = pr[0]*pr[0]/(pr[1]*pr[1])
 		inv_mp0p1_sq = 1.0/(1.0-p0p1_sq)
@@ -1169,6 +1181,10 @@ class ElectricFieldOnDistribution1d:
 	
 	def MakeGH(self, l0, Y, tester=None):
 		harmonic_linear_index = Y.linear_index_for_harmonic(l0)
+		if USE_C_VERSION_GLOBAL:
+			efield__make_gh__cpp(	self.G, self.H, Y.distribution_function_data, l0, harmonic_linear_index, 
+											self.invpr.values, self.momentum_axis.dx(), self.Hp0[l0])
+			return
 		inxpax = Axis(axis = self.invpr)
 		inxpax.values *= (-2.0*(l0+1.0)*self.momentum_axis.dx())
 		
@@ -1443,6 +1459,9 @@ class VlasovMovingFrameCalculation:
 		
 		pr = self.momentum_axis.values
 		dx = self.momentum_axis.dx()
+		if USE_C_VERSION_GLOBAL:
+			efield__g00__cpp(G, pr, dx)
+			return
 		
 		p0p1_sq = pr[0]*pr[0]/(pr[1]*pr[1])
 		inv_mp0p1_sq = 1.0/(1.0-p0p1_sq)
@@ -1466,6 +1485,10 @@ class VlasovMovingFrameCalculation:
 	
 	def MakeGH(self, l0, Y, tester=None):
 		harmonic_linear_index = Y.linear_index_for_harmonic(l0)
+		if USE_C_VERSION_GLOBAL:
+			efield__make_gh__cpp(	self.G, self.H, Y.distribution_function_data, l0, harmonic_linear_index, 
+											self.invpr.values, self.momentum_axis.dx(), self.Hp0[l0])
+			return
 		inxpax = Axis(axis = self.invpr)
 		inxpax.values *= (-2.0*(l0+1.0)*self.momentum_axis.dx())
 		
@@ -1593,6 +1616,10 @@ class SpatialAdvection1d:
 		
 				
 		# Do the X advection!!!!!!
+		if USE_C_VERSION_GLOBAL and not debug:
+			spatial_advection__calc__cpp(	Yin.distribution_function_data, Yh.distribution_function_data,
+													self.vr.values, self.A1, self.A2, CFG.dbydx_order)
+			return
 		self.vt = Axis(axis=self.vr)
 		if debug:
 			PRINT("~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~AVECT THIS MUTHA FUCKA~~~~~~~~~~~~~~~~~~~")
@@ -89,6 +89,40 @@ _oshun_lib.init_effect_of_E_on_distribution.argtypes = [	np__c.c_int, np__c.c_in
 																			np__c.POINTER(np__c.c_double),np__c.POINTER(np__c.c_double),
 																			np__c.POINTER(np__c.c_double),np__c.POINTER(np__c.c_double),
 																			np__c.POINTER(np__c.c_double),np__c.POINTER(np__c.c_double)]
+
+_oshun_lib.efield__g00.restype = None
+_oshun_lib.efield__g00.argtypes = [ np__c.POINTER(np__c.c_double), np__c.POINTER(np__c.c_longlong), np__c.POINTER(np__c.c_double), np__c.c_double ]
+
+_oshun_lib.efield__make_gh.restype = None
+_oshun_lib.efield__make_gh.argtypes = [	np__c.POINTER(np__c.c_double), np__c.POINTER(np__c.c_double),
+														np__c.POINTER(np__c.c_double), np__c.POINTER(np__c.c_longlong),
+														np__c.c_int, np__c.c_int,
+														np__c.POINTER(np__c.c_double), np__c.c_double, np__c.c_double ]
+
+#---------------------
+#----- spatial/momentum derivatives on whole harmonic centric buffers
+#---------------------
+_oshun_lib.hcv__dx.restype = None
+_oshun_lib.hcv__dx.argtypes = [ np__c.POINTER(np__c.c_double), np__c.POINTER(np__c.c_longlong), np__c.c_int ]
+
+_oshun_lib.hcv__dp.restype = None
+_oshun_lib.hcv__dp.argtypes = [ np__c.POINTER(np__c.c_double), np__c.POINTER(np__c.c_longlong) ]
+
+_oshun_lib.field__dx.restype = None
+_oshun_lib.field__dx.argtypes = [ np__c.POINTER(np__c.c_double), np__c.c_longlong, np__c.c_int, np__c.c_double ]
+
+_oshun_lib.guard_cells__pack.restype = None
+_oshun_lib.guard_cells__pack.argtypes = [	np__c.POINTER(np__c.POINTER(np__c.c_double)), np__c.POINTER(np__c.c_longlong), np__c.c_int,
+														np__c.c_int, np__c.c_int, np__c.POINTER(np__c.c_double) ]
+_oshun_lib.guard_cells__unpack.restype = None
+_oshun_lib.guard_cells__unpack.argtypes = _oshun_lib.guard_cells__pack.argtypes
+
+_oshun_lib.spatial_advection__calc.restype = None
+_oshun_lib.spatial_advection__calc.argtypes = [	np__c.POINTER(np__c.c_double), np__c.POINTER(np__c.c_longlong),
+																np__c.POINTER(np__c.c_double),
+																np__c.POINTER(np__c.c_double), np__c.POINTER(np__c.c_double),
+																np__c.POINTER(np__c.c_double), np__c.c_int ]
+
 #---------------------																	
 #----- collisons.....
 #---------------------
@@ -133,6 +167,11 @@ _oshun_lib.fokker_plank__implicit__advance_1.argtypes = [ np__c.c_int,  np__c.c_
 _oshun_lib.fokker_plank__implicit__advance_flm.restype = None
 _oshun_lib.fokker_plank__implicit__advance_flm.argtypes = [ np__c.c_int,  np__c.c_double,  np__c.c_double]
 
+# all spatial cells of l_begin <= l < l_end in one call; F is the full [cells, l, p] buffer
+_oshun_lib.fokker_plank__implicit__advance_cells.restype = None
+_oshun_lib.fokker_plank__implicit__advance_cells.argtypes = [ 	np__c.POINTER(np__c.c_double), np__c.POINTER(np__c.c_longlong),
+																			np__c.c_int, np__c.c_int, np__c.c_int, np__c.c_double]
+
 
 _oshun_lib.fokker_plank__implicit__advance.restype = None
 _oshun_lib.fokker_plank__implicit__advance.argtypes = [ 	np__c.POINTER(np__c.c_double), 
@@ -207,6 +246,49 @@ def init_effect_of_E_on_distribution( species_index, num_l, num_m, A1, A2, B1, B
 def effect_of_E_on_distribution_calc():
 	pass 
 
+# G = Dp(f00) with the p=0 fix up, in place (G.data holds f00 on entry)
+def efield__g00__cpp( G, pr, dp ):
+	_oshun_lib.efield__g00( G.data.ctypes.data_as(np__c.POINTER(np__c.c_double)), G.data.ctypes.shape,
+									pr.ctypes.data_as(np__c.POINTER(np__c.c_double)), dp )
+
+def efield__make_gh__cpp( G, H, F, l, harmonic_index, invpr, dp, Hp0_l ):
+	_oshun_lib.efield__make_gh(	G.data.ctypes.data_as(np__c.POINTER(np__c.c_double)),
+											H.data.ctypes.data_as(np__c.POINTER(np__c.c_double)),
+											F.ctypes.data_as(np__c.POINTER(np__c.c_double)), F.ctypes.shape,
+											l, harmonic_index,
+											invpr.ctypes.data_as(np__c.POINTER(np__c.c_double)), dp, Hp0_l )
+
+#----- Spatial/momentum derivatives ------
+def hcv__dx__cpp( data, order ):
+	_oshun_lib.hcv__dx( data.ctypes.data_as(np__c.POINTER(np__c.c_double)), data.ctypes.shape, order )
+
+def hcv__dp__cpp( data ):
+	_oshun_lib.hcv__dp( data.ctypes.data_as(np__c.POINTER(np__c.c_double)), data.ctypes.shape )
+
+def field__dx__cpp( data, order, dx ):
+	_oshun_lib.field__dx( data.ctypes.data_as(np__c.POINTER(np__c.c_double)), data.shape[0], order, dx )
+
+# 'arrays' are [x, ...] numpy arrays; cells [first_cell, first_cell+num_cells) of each go to/from 'buffer'
+def guard_cells__arguments( arrays ):
+	pointers = (np__c.POINTER(np__c.c_double) * len(arrays))( *[a.ctypes.data_as(np__c.POINTER(np__c.c_double)) for a in arrays] )
+	cell_sizes = (np__c.c_longlong * len(arrays))( *[a.size // a.shape[0] for a in arrays] )
+	return pointers, cell_sizes
+
+def guard_cells__pack__cpp( arrays, first_cell, num_cells, buffer ):
+	pointers, cell_sizes = guard_cells__arguments( arrays )
+	_oshun_lib.guard_cells__pack( pointers, cell_sizes, len(arrays), first_cell, num_cells, buffer.ctypes.data_as(np__c.POINTER(np__c.c_double)) )
+
+def guard_cells__unpack__cpp( arrays, first_cell, num_cells, buffer ):
+	pointers, cell_sizes = guard_cells__arguments( arrays )
+	_oshun_lib.guard_cells__unpack( pointers, cell_sizes, len(arrays), first_cell, num_cells, buffer.ctypes.data_as(np__c.POINTER(np__c.c_double)) )
+
+def spatial_advection__calc__cpp( F, Fh, vr, A1, A2, order ):
+	_oshun_lib.spatial_advection__calc(	F.ctypes.data_as(np__c.POINTER(np__c.c_double)), F.ctypes.shape,
+														Fh.ctypes.data_as(np__c.POINTER(np__c.c_double)),
+														vr.ctypes.data_as(np__c.POINTER(np__c.c_double)),
+														A1.ctypes.data_as(np__c.POINTER(np__c.c_double)),
+														A2.ctypes.data_as(np__c.POINTER(np__c.c_double)), order )
+
 	
 #----------- collisons.....
 def init__fokker_plank_implicit__cpp(	vr, vr3, 
@@ -253,6 +335,9 @@ def fokker_plank__advance_1__cpp( Yin, species, state, CFG, n_step, time, dt ):
 	_oshun_lib.fokker_plank__implicit__advance_1( n_step,time, dt );
 def fokker_plank__advance_flm__cpp( Yin, species, state, CFG, n_step, time, dt ):	
 	_oshun_lib.fokker_plank__implicit__advance_flm( n_step,time, dt );
+def fokker_plank__implicit__advance_cells__cpp( F, num_boundry_cells, l_begin, l_end, dt ):
+	_oshun_lib.fokker_plank__implicit__advance_cells( 	F.ctypes.data_as(np__c.POINTER(np__c.c_double)), F.ctypes.shape,
+																	num_boundry_cells, l_begin, l_end, dt );
 
 # note: 'implcit_FP_object' is assigned in the FokkerPlank __init__ functoion
 # TODO: make this less random and magical
@@ -52,25 +52,25 @@ class UpdateBoundriesMPI:
 	# TODO: stupid way to write this but I am so tired.. should be subclassed object and just take over for the non _mirror function
 	def update_mirror(self, state, CFG ):
 		mpi_axis = mpi_info.mpi_axes[0]
-		# fix up species distributions..
+		lower_is_mirror = mpi_info.is_I_root()
+		upper_is_mirror = mpi_info.is_I_last_node()
+		
+		# interior sides go through the batched exchange..
+		mpi_axis.exchange_guard_cells( self.guard_cell_arrays(state), lower_is_mirror, upper_is_mirror )
+		
+		# .. and the edges of the domain are reflected in place
 		for i in xrange(0, len(state.species)):
-			mpi_axis.reconcile_boundries_F_mirror( state.species[i].F )
+			if lower_is_mirror:
+				mpi_axis.mirror_F( state.species[i].F, lower=True )
+			if upper_is_mirror:
+				mpi_axis.mirror_F( state.species[i].F, lower=False )
 		
-		# fix up field distributions..
-		data = state.E_field.components[0]
-		mpi_axis.reconcile_boundries_field_mirror( data )
 		# in 1-D, the Ex field does not need any sign changes when using mirror boundries.
-
-		if state.use_external_E_field:
-			
-			data = state.E_field__external.components[0]
-			mpi_axis.reconcile_boundries_field_mirror( data )
-			#print "DONE DIING FILED!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!"
-		
-		# fix up field distributions..
-		data = state.B_field.components[0]
-		mpi_axis.reconcile_boundries_field_mirror( data )
-		# maybe Jay too..
+		for data in self.guard_cell_arrays(state, fields_only=True):
+			if lower_is_mirror:
+				mpi_axis.mirror_field( data, lower=True )
+			if upper_is_mirror:
+				mpi_axis.mirror_field( data, lower=False )
 
 	def update_perodic(self, state, CFG):
 		
@@ -79,24 +79,21 @@ class UpdateBoundriesMPI:
 		# this writes a test pattern inot the distirbution function
 		#self.test_distribution(state)
 		
-		# fix up species distributions..
-		for i in xrange(0, len(state.species)):
-			mpi_axis.reconcile_boundries_F( state.species[i].F )
-		
-		# fix up field distributions..
-		data = state.E_field.components[0]
-		mpi_axis.reconcile_boundries_field( data )
-		
+		mpi_axis.exchange_guard_cells( self.guard_cell_arrays(state) )
+	
+	# all the [x, ...] arrays whose guard cells are exchanged: every species
+	#	distribution function, Ex (and the external Ex if used) and Bx. Maybe Jay too..
+	def guard_cell_arrays(self, state, fields_only=False):
+		arrays = []
+		if fields_only == False:
+			for i in xrange(0, len(state.species)):
+				arrays.append( state.species[i].F.distribution_function_data )
+		
+		arrays.append( state.E_field.components[0] )
 		if state.use_external_E_field:
-			
-			data = state.E_field__external.components[0]
-			mpi_axis.reconcile_boundries_field( data )
-			#print "DONE DIING FILED!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!"
-		
-		# fix up field distributions..
-		data = state.B_field.components[0]
-		mpi_axis.reconcile_boundries_field( data )
-		# maybe Jay too..
+			arrays.append( state.E_field__external.components[0] )
+		arrays.append( state.B_field.components[0] )
+		return arrays
 
 	def update_diagnostic_data(self, buffer):
 		if len(buffer.shape) == 3:
@@ -326,6 +323,107 @@ class AxisMpi:
 		self.field_send_lower = np.empty( (E_field.num_boundry_cells[0][1],) )
 		self.field_send_upper = np.empty( (E_field.num_boundry_cells[0][0],) )
 		
+		# the batched exchange sets itself up on first use (see 'exchange_guard_cells')
+		self.exchange_layout = None
+		self.exchange_requests = []
+	
+	# Sets up one contiguous send and receive buffer per neighbour, sized for all the
+	#	arrays in 'layout', and persistent MPI requests on them. Messages going to the
+	#	lower neighbour use tag 1, those going up use tag 2 (the two neighbours are
+	#	the same node when there are only 2 nodes).
+	def init_exchange(self, layout):
+		import OshunGlobalState as GLOBAL
+		
+		for request in self.exchange_requests:
+			request.Free()
+		
+		cell_sizes, lower_is_mirror, upper_is_mirror = layout
+		num_bdry_cells_L = int(self.num_boundry_cells[0,0]); num_bdry_cells_U = int(self.num_boundry_cells[0,1]);
+		values_per_cell = sum(cell_sizes)
+		
+		self.exchange_send_lower = np.empty( (num_bdry_cells_U*values_per_cell,) )
+		self.exchange_recv_lower = np.empty( (num_bdry_cells_L*values_per_cell,) )
+		self.exchange_send_upper = np.empty( (num_bdry_cells_L*values_per_cell,) )
+		self.exchange_recv_upper = np.empty( (num_bdry_cells_U*values_per_cell,) )
+		
+		self.exchange_recv_requests = []; self.exchange_send_requests = []
+		if lower_is_mirror == False:
+			self.exchange_recv_requests.append( mpi_info.comm.Recv_init(self.exchange_recv_lower, source = self.lower_neighbor, tag = 2) )
+			self.exchange_send_requests.append( mpi_info.comm.Send_init(self.exchange_send_lower,   dest = self.lower_neighbor, tag = 1) )
+		if upper_is_mirror == False:
+			self.exchange_recv_requests.append( mpi_info.comm.Recv_init(self.exchange_recv_upper, source = self.upper_neighbor, tag = 1) )
+			self.exchange_send_requests.append( mpi_info.comm.Send_init(self.exchange_send_upper,   dest = self.upper_neighbor, tag = 2) )
+		self.exchange_requests = self.exchange_recv_requests + self.exchange_send_requests
+		
+		if GLOBAL.USE_C_VERSION:
+			from OshunCInterface import guard_cells__pack__cpp, guard_cells__unpack__cpp
+			self.pack_guard_cells   = guard_cells__pack__cpp
+			self.unpack_guard_cells = guard_cells__unpack__cpp
+		else:
+			self.pack_guard_cells   = self.pack_guard_cells__numpy
+			self.unpack_guard_cells = self.unpack_guard_cells__numpy
+		
+		self.exchange_layout = layout
+	
+	def pack_guard_cells__numpy(self, arrays, first_cell, num_cells, buffer):
+		start = 0
+		for a in arrays:
+			block = a[first_cell:first_cell+num_cells].ravel()
+			buffer[start:start+block.size] = block
+			start += block.size
+	
+	def unpack_guard_cells__numpy(self, arrays, first_cell, num_cells, buffer):
+		start = 0
+		for a in arrays:
+			block = a[first_cell:first_cell+num_cells]
+			block[...] = buffer[start:start+block.size].reshape(block.shape)
+			start += block.size
+	
+	# Fills the guard cells of every array in 'arrays' ([x, ...] numpy arrays with the same number
+	#	of x cells) from the neighbours with one message each way per neighbour. Sides flagged
+	#	as mirror are left alone (the caller reflects those in place).
+	def exchange_guard_cells(self, arrays, lower_is_mirror=False, upper_is_mirror=False):
+		layout = ( tuple([a.size // a.shape[0] for a in arrays]), lower_is_mirror, upper_is_mirror )
+		if layout != self.exchange_layout:
+			self.init_exchange(layout)
+		
+		num_bdry_cells_L = int(self.num_boundry_cells[0,0]); num_bdry_cells_U = int(self.num_boundry_cells[0,1]);
+		num_total_cells = arrays[0].shape[0]
+		
+		MPI.Prequest.Startall(self.exchange_recv_requests)
+		if lower_is_mirror == False:
+			self.pack_guard_cells(arrays, num_bdry_cells_L, num_bdry_cells_U, self.exchange_send_lower)
+		if upper_is_mirror == False:
+			self.pack_guard_cells(arrays, num_total_cells-num_bdry_cells_L-num_bdry_cells_U, num_bdry_cells_L, self.exchange_send_upper)
+		MPI.Prequest.Startall(self.exchange_send_requests)
+		
+		MPI.Request.Waitall(self.exchange_recv_requests)
+		if lower_is_mirror == False:
+			self.unpack_guard_cells(arrays, 0, num_bdry_cells_L, self.exchange_recv_lower)
+		if upper_is_mirror == False:
+			self.unpack_guard_cells(arrays, num_total_cells-num_bdry_cells_U, num_bdry_cells_U, self.exchange_recv_upper)
+		MPI.Request.Waitall(self.exchange_send_requests)
+	
+	# the in-place reflections done by the edge nodes in 'reconcile_boundries_F_mirror'..
+	def mirror_F(self, F, lower=True):
+		if lower:
+			self.prepare_send_buffer(self.buffer_send_lower, F, lower=True, mirror=True)
+			self.process_recv_buffer(self.buffer_send_lower, F, lower=True)
+		else:
+			self.prepare_send_buffer(self.buffer_send_upper, F, lower=False, mirror=True)
+			self.process_recv_buffer(self.buffer_send_upper, F, lower=False)
+	
+	# .. and in 'reconcile_boundries_field_mirror'
+	def mirror_field(self, field, lower=True):
+		num_bdry_cells_L = self.num_boundry_cells[0,0]; num_bdry_cells_U = self.num_boundry_cells[0,1];
+		num_total_cells = field.shape[0]
+		if lower:
+			source_start = num_bdry_cells_L+num_bdry_cells_U-1; source_end = num_bdry_cells_L-1
+			field[0:num_bdry_cells_L] = field[source_start:source_end:-1]
+		else:
+			src_start = (num_total_cells-num_bdry_cells_L-num_bdry_cells_U) - 1; src_end = num_total_cells-num_bdry_cells_U - 1
+			field[num_total_cells-num_bdry_cells_U:num_total_cells] = field[src_end:src_start:-1]
+		
 	
 	def prepare_send_buffer_mirror__wrapper(self,buffer, F, lower=True, mirror=False ):
 		# call the normal prepare_send_buffer